@@ -146,7 +146,7 @@ std::shared_ptr<Analyzer::Expr> AggExpr::deep_copy() const {
                            aggtype,
                            arg == nullptr ? nullptr : arg->deep_copy(),
                            is_distinct,
-                           error_rate);
+                           arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> CaseExpr::deep_copy() const {
@@ -1706,7 +1706,7 @@ std::shared_ptr<Analyzer::Expr> AggExpr::rewrite_with_child_targetlist(
                            aggtype,
                            arg ? arg->rewrite_with_child_targetlist(tlist) : nullptr,
                            is_distinct,
-                           error_rate);
+                           arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> AggExpr::rewrite_agg_to_var(
@@ -2055,6 +2055,12 @@ bool AggExpr::operator==(const Expr& rhs) const {
   if (aggtype != rhs_ae.get_aggtype() || is_distinct != rhs_ae.get_is_distinct()) {
     return false;
   }
+  if (aggtype == kAPPROX_PERCENTILE) {
+    CHECK(arg1 && rhs_ae.get_arg1());
+    if (arg1->get_constval().doubleval != rhs_ae.get_arg1()->get_constval().doubleval) {
+      return false;
+    }
+  }
   if (arg.get() == rhs_ae.get_arg()) {
     return true;
   }
@@ -2349,6 +2355,9 @@ void AggExpr::print() const {
     case kSAMPLE:
       agg = "SAMPLE";
       break;
+    case kAPPROX_PERCENTILE:
+      agg = "APPROX_PERCENTILE";
+      break;
   }
   std::cout << "(" << agg;
   if (is_distinct) {
@@ -18,12 +18,16 @@
 #define CHUNKMETADATA_H
 
 #include <stddef.h>
+#include <memory>
 #include "../Shared/sqltypes.h"
+#include "ChunkValueSketch.h"
 
 struct ChunkStats {
   Datum min;
   Datum max;
   bool has_nulls;
+  // snapshot of the values of the chunk, null if the encoder doesn't keep one
+  std::shared_ptr<const ChunkValueSketch> value_sketch;
 };
 
 struct ChunkMetadata {
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    ChunkValueSketch.h
+ * @brief   Bloom filter and distinct count sketch over the values of a chunk.
+ *
+ * Kept by the encoders of integer, time and dictionary encoded columns as data
+ * gets appended and persisted with the chunk metadata, which is why both parts have
+ * a fixed size: they must fit in the metadata page. The bloom filter lets fragment
+ * skipping prune equalities whose constant is inside [min, max]. It is given up
+ * once half of its bits are set, it wouldn't filter much anymore, while the
+ * distinct count keeps going. The values are the ones the executor sees, after
+ * decoding, as 64-bit integers.
+ */
+
+#ifndef CHUNKVALUESKETCH_H
+#define CHUNKVALUESKETCH_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+class ChunkValueSketch {
+ public:
+  ChunkValueSketch() : has_bloom_filter_(true) {
+    bloom_filter_.fill(0);
+    ndv_registers_.fill(0);
+  }
+
+  template <typename T>
+  void add(const T* data, const size_t count, const T null_val) {
+    for (size_t i = 0; i < count; ++i) {
+      if (data[i] != null_val) {
+        add(static_cast<int64_t>(data[i]));
+      }
+    }
+    if (has_bloom_filter_ && bloomFilterBitsSet() > bloom_filter_bits / 2) {
+      has_bloom_filter_ = false;
+      bloom_filter_.fill(0);
+    }
+  }
+
+  bool hasBloomFilter() const { return has_bloom_filter_; }
+
+  // False only if none of the values is val.
+  bool mayContain(const int64_t val) const {
+    if (!has_bloom_filter_) {
+      return true;
+    }
+    const auto h = mix(val);
+    for (size_t i = 0; i < bloom_filter_hash_count; ++i) {
+      const auto bit_idx = bloomFilterBit(h, i);
+      if (!(bloom_filter_[bit_idx >> 6] & (uint64_t(1) << (bit_idx & 63)))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // HyperLogLog estimate, with linear counting for the small cardinalities.
+  size_t approxDistinctCount() const {
+    double sum{0};
+    size_t zero_count{0};
+    for (const auto reg : ndv_registers_) {
+      sum += 1.0 / (uint64_t(1) << reg);
+      zero_count += reg == 0;
+    }
+    const double m = ndv_register_count;
+    const double estimate = 0.709 * m * m / sum;
+    if (estimate <= 2.5 * m && zero_count) {
+      return std::llround(m * std::log(m / zero_count));
+    }
+    return std::llround(estimate);
+  }
+
+  void write(FILE* f) const {
+    const int8_t has_bloom_filter = has_bloom_filter_;
+    fwrite(&has_bloom_filter, sizeof(int8_t), 1, f);
+    fwrite(bloom_filter_.data(), sizeof(uint64_t), bloom_filter_.size(), f);
+    fwrite(ndv_registers_.data(), sizeof(uint8_t), ndv_registers_.size(), f);
+  }
+
+  void read(FILE* f) {
+    int8_t has_bloom_filter{0};
+    fread(&has_bloom_filter, sizeof(int8_t), 1, f);
+    has_bloom_filter_ = has_bloom_filter;
+    fread(bloom_filter_.data(), sizeof(uint64_t), bloom_filter_.size(), f);
+    fread(ndv_registers_.data(), sizeof(uint8_t), ndv_registers_.size(), f);
+  }
+
+  static const size_t bloom_filter_bits{1 << 14};
+  static const size_t bloom_filter_hash_count{3};
+  static const size_t ndv_register_count{64};
+
+ private:
+  // The hash is persisted with the sketch, don't change it.
+  static uint64_t mix(const int64_t val) {
+    auto h = static_cast<uint64_t>(val);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  // Consecutive 14 bit slices of the low half of the hash.
+  static size_t bloomFilterBit(const uint64_t h, const size_t i) {
+    return (h >> (14 * i)) & (bloom_filter_bits - 1);
+  }
+
+  size_t bloomFilterBitsSet() const {
+    size_t bits_set{0};
+    for (const auto word : bloom_filter_) {
+      bits_set += __builtin_popcountll(word);
+    }
+    return bits_set;
+  }
+
+  void add(const int64_t val) {
+    const auto h = mix(val);
+    if (has_bloom_filter_) {
+      for (size_t i = 0; i < bloom_filter_hash_count; ++i) {
+        const auto bit_idx = bloomFilterBit(h, i);
+        bloom_filter_[bit_idx >> 6] |= uint64_t(1) << (bit_idx & 63);
+      }
+    }
+    // The top 6 bits pick the register, the rank comes from the other 58.
+    const auto reg_idx = h >> 58;
+    const auto w = h & ((uint64_t(1) << 58) - 1);
+    const uint8_t rank = w ? __builtin_clzll(w) - 6 + 1 : 59;
+    ndv_registers_[reg_idx] = std::max(ndv_registers_[reg_idx], rank);
+  }
+
+  bool has_bloom_filter_;
+  std::array<uint64_t, bloom_filter_bits / 64> bloom_filter_;
+  std::array<uint8_t, ndv_register_count> ndv_registers_;
+};
+
+#endif  // CHUNKVALUESKETCH_H
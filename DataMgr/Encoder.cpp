@@ -22,8 +22,10 @@
 #include "NoneEncoder.h"
 #include "StringNoneEncoder.h"
 
-Encoder* Encoder::Create(Data_Namespace::AbstractBuffer* buffer,
-                         const SQLTypeInfo sqlType) {
+namespace {
+
+Encoder* create_encoder(Data_Namespace::AbstractBuffer* buffer,
+                        const SQLTypeInfo& sqlType) {
   switch (sqlType.get_compression()) {
     case kENCODING_NONE: {
       switch (sqlType.get_type()) {
@@ -188,11 +190,65 @@ Encoder* Encoder::Create(Data_Namespace::AbstractBuffer* buffer,
   return 0;
 }
 
+bool keeps_value_sketch(const SQLTypeInfo& sqlType) {
+  return sqlType.is_integer() || sqlType.is_decimal() || sqlType.is_time() ||
+         (sqlType.is_string() && sqlType.get_compression() == kENCODING_DICT);
+}
+
+}  // namespace
+
+Encoder* Encoder::Create(Data_Namespace::AbstractBuffer* buffer,
+                         const SQLTypeInfo sqlType) {
+  auto encoder = create_encoder(buffer, sqlType);
+  if (encoder) {
+    encoder->keeps_value_sketch_ = keeps_value_sketch(sqlType);
+  }
+  return encoder;
+}
+
 void Encoder::getMetadata(ChunkMetadata& chunkMetadata) {
   // chunkMetadata = metadataTemplate_; // invoke copy constructor
   chunkMetadata.sqlType = buffer_->sqlType;
   chunkMetadata.numBytes = buffer_->size();
   chunkMetadata.numElements = numElems;
+  chunkMetadata.chunkStats.value_sketch.reset();
+  if (keeps_value_sketch_ && value_sketch_) {
+    chunkMetadata.chunkStats.value_sketch =
+        std::make_shared<const ChunkValueSketch>(*value_sketch_);
+  }
+}
+
+void Encoder::writeValueSketch(FILE* f) {
+  const int8_t has_value_sketch = keeps_value_sketch_ && value_sketch_;
+  fwrite(&has_value_sketch, sizeof(int8_t), 1, f);
+  if (has_value_sketch) {
+    value_sketch_->write(f);
+  }
+}
+
+void Encoder::readValueSketch(FILE* f) {
+  int8_t has_value_sketch{0};
+  fread(&has_value_sketch, sizeof(int8_t), 1, f);
+  if (has_value_sketch) {
+    value_sketch_ = std::make_shared<ChunkValueSketch>();
+    value_sketch_->read(f);
+  } else if (numElems) {
+    dropValueSketch();
+  }
+}
+
+// The values which got into the chunk in other ways than appends aren't in the
+// sketch, it can't be trusted anymore.
+void Encoder::dropValueSketch() {
+  keeps_value_sketch_ = false;
+  value_sketch_.reset();
+}
+
+void Encoder::copyValueSketch(const Encoder* copyFromEncoder) {
+  keeps_value_sketch_ = copyFromEncoder->keeps_value_sketch_;
+  const auto& value_sketch = copyFromEncoder->value_sketch_;
+  value_sketch_ =
+      value_sketch ? std::make_shared<ChunkValueSketch>(*value_sketch) : nullptr;
 }
 
 ChunkMetadata Encoder::getMetadata(const SQLTypeInfo& ti) {
@@ -208,6 +264,14 @@ void Encoder::updateStats(const double, const bool) {
   CHECK(false);
 }
 
+void Encoder::updateStats(const int64_t*, const size_t, const int64_t) {
+  CHECK(false);
+}
+
+void Encoder::updateStats(const double*, const size_t, const double) {
+  CHECK(false);
+}
+
 void Encoder::reduceStats(const Encoder&) {
   CHECK(false);
 }
@@ -23,6 +23,7 @@
 
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <stdexcept>
 #include <vector>
 
@@ -37,7 +38,8 @@ class Encoder {
  public:
   static Encoder* Create(Data_Namespace::AbstractBuffer* buffer,
                          const SQLTypeInfo sqlType);
-  Encoder(Data_Namespace::AbstractBuffer* buffer) : numElems(0), buffer_(buffer) {}
+  Encoder(Data_Namespace::AbstractBuffer* buffer)
+      : numElems(0), buffer_(buffer), keeps_value_sketch_(false) {}
   virtual ChunkMetadata appendData(int8_t*& srcData,
                                    const size_t numAppendElems,
                                    const bool replicating = false) = 0;
@@ -46,16 +48,46 @@ class Encoder {
   virtual ChunkMetadata getMetadata(const SQLTypeInfo& ti);
   virtual void updateStats(const int64_t val, const bool is_null);
   virtual void updateStats(const double val, const bool is_null);
+  // Same as calling the overloads above for every value, nulls are the values equal
+  // to null_val.
+  virtual void updateStats(const int64_t* vals,
+                           const size_t count,
+                           const int64_t null_val);
+  virtual void updateStats(const double* vals, const size_t count, const double null_val);
   virtual void reduceStats(const Encoder&);
   virtual void copyMetadata(const Encoder* copyFromEncoder) = 0;
   virtual void writeMetadata(FILE* f /*, const size_t offset*/) = 0;
   virtual void readMetadata(FILE* f /*, const size_t offset*/) = 0;
+  // The value sketch is written after the metadata of the encoder, chunks written
+  // before it existed have none.
+  void writeValueSketch(FILE* f);
+  void readValueSketch(FILE* f);
+  void dropValueSketch();
   size_t numElems;
   virtual ~Encoder() {}
 
  protected:
+  template <typename T>
+  void updateValueSketch(const T* data, const size_t count, const T null_val) {
+    if (!keeps_value_sketch_ || !count) {
+      return;
+    }
+    if (!value_sketch_) {
+      value_sketch_ = std::make_shared<ChunkValueSketch>();
+    }
+    value_sketch_->add(data, count, null_val);
+  }
+
+  void copyValueSketch(const Encoder* copyFromEncoder);
+
   Data_Namespace::AbstractBuffer* buffer_;
   // ChunkMetadata metadataTemplate_;
+
+ private:
+  // Whether the values appended so far are all in value_sketch_, which is only
+  // allocated with the first of them.
+  bool keeps_value_sketch_;
+  std::shared_ptr<ChunkValueSketch> value_sketch_;
 };
 
 #endif  // Encoder_h
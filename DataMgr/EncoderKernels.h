@@ -0,0 +1,105 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file EncoderKernels.h
+ * @brief Batch kernels for the fixed width encoders.
+ *
+ * The loop bodies are kept free of data dependent branches: nulls and values
+ * which don't survive narrowing are masked out of min / max with selects and
+ * the flags are or-ed into accumulators, so the compiler can vectorize every
+ * kernel for any pair of source and destination widths.
+ */
+
+#ifndef ENCODER_KERNELS_H
+#define ENCODER_KERNELS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+namespace EncoderKernels {
+
+template <typename T>
+struct BatchStats {
+  T min;
+  T max;
+  bool has_nulls;
+  bool has_overflow;
+
+  BatchStats()
+      : min(std::numeric_limits<T>::max())
+      , max(std::numeric_limits<T>::lowest())
+      , has_nulls(false)
+      , has_overflow(false) {}
+};
+
+// Min / max / null detection over values stored as is. The values can also come in a
+// wider type S, like the ones the executor passes to updateStats: they are compared
+// with the null sentinel first and narrowed to T after.
+template <typename S, typename T = S>
+BatchStats<T> compute_stats(const S* data, const size_t count, const S null_val) {
+  BatchStats<T> stats;
+  T min = stats.min;
+  T max = stats.max;
+  bool has_nulls = false;
+  for (size_t i = 0; i < count; ++i) {
+    const bool is_null = data[i] == null_val;
+    // don't narrow the sentinel, it might not fit T
+    const T val = static_cast<T>(is_null ? S(0) : data[i]);
+    has_nulls |= is_null;
+    min = std::min(min, is_null ? stats.min : val);
+    max = std::max(max, is_null ? stats.max : val);
+  }
+  stats.min = min;
+  stats.max = max;
+  stats.has_nulls = has_nulls;
+  return stats;
+}
+
+// Narrows src into dst and computes min / max / null detection on the source
+// values. The null sentinel is the minimum of the destination type, values
+// which don't round trip through V are flagged and excluded from min / max.
+template <typename T, typename V>
+BatchStats<T> encode_and_compute_stats(const T* src, V* dst, const size_t count) {
+  BatchStats<T> stats;
+  const T null_val = static_cast<T>(std::numeric_limits<V>::min());
+  T min = stats.min;
+  T max = stats.max;
+  bool has_nulls = false;
+  bool has_overflow = false;
+  for (size_t i = 0; i < count; ++i) {
+    const T val = src[i];
+    const V encoded_val = static_cast<V>(val);
+    dst[i] = encoded_val;
+    const bool is_overflow = static_cast<T>(encoded_val) != val;
+    const bool is_null = !is_overflow && val == null_val;
+    const bool skip = is_overflow || is_null;
+    has_overflow |= is_overflow;
+    has_nulls |= is_null;
+    min = std::min(min, skip ? stats.min : val);
+    max = std::max(max, skip ? stats.max : val);
+  }
+  stats.min = min;
+  stats.max = max;
+  stats.has_nulls = has_nulls;
+  stats.has_overflow = has_overflow;
+  return stats;
+}
+
+}  // namespace EncoderKernels
+
+#endif  // ENCODER_KERNELS_H
@@ -394,7 +394,7 @@ void FileBuffer::readMetadata(const Page& page) {
                                        // encodingType, encodingBits all as int
   fread((int8_t*)&(typeData[0]), sizeof(int), typeData.size(), f);
   int version = typeData[0];
-  CHECK(version == METADATA_VERSION);  // add backward compatibility code here
+  CHECK(version >= 0 && version <= METADATA_VERSION);
   hasEncoder = static_cast<bool>(typeData[1]);
   if (hasEncoder) {
     sqlType.set_type(static_cast<SQLTypes>(typeData[2]));
@@ -407,6 +407,12 @@ void FileBuffer::readMetadata(const Page& page) {
     sqlType.set_size(typeData[9]);
     initEncoder(sqlType);
     encoder->readMetadata(f);
+    if (version >= 1) {
+      encoder->readValueSketch(f);
+    } else if (encoder->numElems) {
+      // version 0 pages have no value sketch
+      encoder->dropValueSketch();
+    }
   }
 }
 
@@ -436,6 +442,7 @@ void FileBuffer::writeMetadata(const int epoch) {
   fwrite((int8_t*)&(typeData[0]), sizeof(int), typeData.size(), f);
   if (hasEncoder) {  // redundant
     encoder->writeMetadata(f);
+    encoder->writeValueSketch(f);
   }
   metadataPages_.epochs.push_back(epoch);
   metadataPages_.pageVersions.push_back(page);
@@ -32,7 +32,7 @@
 using namespace Data_Namespace;
 
 #define NUM_METADATA 10
-#define METADATA_VERSION 0
+#define METADATA_VERSION 1
 
 namespace File_Namespace {
 
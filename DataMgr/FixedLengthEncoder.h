@@ -17,11 +17,13 @@
 #ifndef FIXED_LENGTH_ENCODER_H
 #define FIXED_LENGTH_ENCODER_H
 #include <glog/logging.h>
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
 #include "AbstractBuffer.h"
 #include "Encoder.h"
+#include "EncoderKernels.h"
 
 template <typename T, typename V>
 class FixedLengthEncoder : public Encoder {
@@ -37,23 +39,23 @@ class FixedLengthEncoder : public Encoder {
                            const bool replicating = false) {
     T* unencodedData = reinterpret_cast<T*>(srcData);
     auto encodedData = std::unique_ptr<V[]>(new V[numAppendElems]);
-    for (size_t i = 0; i < numAppendElems; ++i) {
-      size_t ri = replicating ? 0 : i;
-      encodedData.get()[ri] = static_cast<V>(unencodedData[ri]);
-      if (unencodedData[ri] != encodedData.get()[ri]) {
-        LOG(ERROR) << "Fixed encoding failed, Unencoded: " +
-                          std::to_string(unencodedData[ri]) +
-                          " encoded: " + std::to_string(encodedData.get()[ri]);
-      } else {
-        T data = unencodedData[ri];
-        if (data == std::numeric_limits<V>::min())
-          has_nulls = true;
-        else {
-          dataMin = std::min(dataMin, data);
-          dataMax = std::max(dataMax, data);
-        }
-      }
+    // a replicated value is encoded once and then broadcast
+    const size_t numEncodeElems =
+        replicating ? std::min<size_t>(numAppendElems, 1) : numAppendElems;
+    const auto stats = EncoderKernels::encode_and_compute_stats(
+        unencodedData, encodedData.get(), numEncodeElems);
+    if (replicating && numEncodeElems > 0) {
+      std::fill(encodedData.get(), encodedData.get() + numAppendElems, encodedData[0]);
     }
+    if (stats.has_overflow) {
+      logEncodingFailures(unencodedData, numEncodeElems);
+    }
+    has_nulls |= stats.has_nulls;
+    dataMin = std::min(dataMin, stats.min);
+    dataMax = std::max(dataMax, stats.max);
+    // the sketch sees the values as stored, like the queries do
+    updateValueSketch(
+        encodedData.get(), numEncodeElems, std::numeric_limits<V>::min());
     numElems += numAppendElems;
 
     // assume always CPU_BUFFER?
@@ -79,6 +81,7 @@ class FixedLengthEncoder : public Encoder {
 
   // Only called from the executor for synthesized meta-information.
   void updateStats(const int64_t val, const bool is_null) {
+    dropValueSketch();
     if (is_null) {
       has_nulls = true;
     } else {
@@ -90,6 +93,7 @@ class FixedLengthEncoder : public Encoder {
 
   // Only called from the executor for synthesized meta-information.
   void updateStats(const double val, const bool is_null) {
+    dropValueSketch();
     if (is_null) {
       has_nulls = true;
     } else {
@@ -99,6 +103,16 @@ class FixedLengthEncoder : public Encoder {
     }
   }
 
+  // Only called from the executor for synthesized meta-information.
+  void updateStats(const int64_t* vals, const size_t count, const int64_t null_val) {
+    updateStatsBatch(vals, count, null_val);
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  void updateStats(const double* vals, const size_t count, const double null_val) {
+    updateStatsBatch(vals, count, null_val);
+  }
+
   // Only called from the executor for synthesized meta-information.
   void reduceStats(const Encoder& that) {
     const auto that_typed = static_cast<const FixedLengthEncoder<T, V>&>(that);
@@ -116,6 +130,7 @@ class FixedLengthEncoder : public Encoder {
     dataMin = castedEncoder->dataMin;
     dataMax = castedEncoder->dataMax;
     has_nulls = castedEncoder->has_nulls;
+    copyValueSketch(copyFromEncoder);
   }
 
   void writeMetadata(FILE* f) {
@@ -137,6 +152,28 @@ class FixedLengthEncoder : public Encoder {
   T dataMax;
   bool has_nulls;
 
+ private:
+  template <typename S>
+  void updateStatsBatch(const S* vals, const size_t count, const S null_val) {
+    dropValueSketch();
+    const auto stats = EncoderKernels::compute_stats<S, T>(vals, count, null_val);
+    has_nulls |= stats.has_nulls;
+    dataMin = std::min(dataMin, stats.min);
+    dataMax = std::max(dataMax, stats.max);
+  }
+
+  // slow path, only taken once a batch is known to hold values that don't fit V
+  void logEncodingFailures(const T* unencodedData, const size_t numElems) {
+    for (size_t i = 0; i < numElems; ++i) {
+      const V encodedVal = static_cast<V>(unencodedData[i]);
+      if (unencodedData[i] != encodedVal) {
+        LOG(ERROR) << "Fixed encoding failed, Unencoded: " +
+                          std::to_string(unencodedData[i]) +
+                          " encoded: " + std::to_string(encodedVal);
+      }
+    }
+  }
+
 };  // FixedLengthEncoder
 
 #endif  // FIXED_LENGTH_ENCODER_H
@@ -17,8 +17,12 @@
 #ifndef NONE_ENCODER_H
 #define NONE_ENCODER_H
 
+#include <algorithm>
+#include <memory>
+
 #include "AbstractBuffer.h"
 #include "Encoder.h"
+#include "EncoderKernels.h"
 
 template <typename T>
 T none_encoded_null_value() {
@@ -39,21 +43,22 @@ class NoneEncoder : public Encoder {
                            const size_t numAppendElems,
                            const bool replicating = false) {
     T* unencodedData = reinterpret_cast<T*>(srcData);
-    std::unique_ptr<T> encodedData;
-    if (replicating)
+    const size_t numStatsElems =
+        replicating ? std::min<size_t>(numAppendElems, 1) : numAppendElems;
+    std::unique_ptr<T[]> encodedData;
+    if (replicating) {
       encodedData.reset(new T[numAppendElems]);
-    for (size_t i = 0; i < numAppendElems; ++i) {
-      size_t ri = replicating ? 0 : i;
-      T data = unencodedData[ri];
-      if (replicating)
-        encodedData.get()[i] = data;
-      if (data == none_encoded_null_value<T>())
-        has_nulls = true;
-      else {
-        dataMin = std::min(dataMin, data);
-        dataMax = std::max(dataMax, data);
+      if (numStatsElems > 0) {
+        std::fill(
+            encodedData.get(), encodedData.get() + numAppendElems, unencodedData[0]);
       }
     }
+    const auto stats = EncoderKernels::compute_stats(
+        unencodedData, numStatsElems, none_encoded_null_value<T>());
+    has_nulls |= stats.has_nulls;
+    dataMin = std::min(dataMin, stats.min);
+    dataMax = std::max(dataMax, stats.max);
+    updateValueSketch(unencodedData, numStatsElems, none_encoded_null_value<T>());
     numElems += numAppendElems;
     buffer_->append(replicating ? (int8_t*)encodedData.get() : srcData,
                     numAppendElems * sizeof(T));
@@ -78,6 +83,7 @@ class NoneEncoder : public Encoder {
 
   // Only called from the executor for synthesized meta-information.
   void updateStats(const int64_t val, const bool is_null) {
+    dropValueSketch();
     if (is_null) {
       has_nulls = true;
     } else {
@@ -89,6 +95,7 @@ class NoneEncoder : public Encoder {
 
   // Only called from the executor for synthesized meta-information.
   void updateStats(const double val, const bool is_null) {
+    dropValueSketch();
     if (is_null) {
       has_nulls = true;
     } else {
@@ -98,6 +105,16 @@ class NoneEncoder : public Encoder {
     }
   }
 
+  // Only called from the executor for synthesized meta-information.
+  void updateStats(const int64_t* vals, const size_t count, const int64_t null_val) {
+    updateStatsBatch(vals, count, null_val);
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  void updateStats(const double* vals, const size_t count, const double null_val) {
+    updateStatsBatch(vals, count, null_val);
+  }
+
   // Only called from the executor for synthesized meta-information.
   void reduceStats(const Encoder& that) {
     const auto that_typed = static_cast<const NoneEncoder&>(that);
@@ -130,12 +147,23 @@ class NoneEncoder : public Encoder {
     dataMin = castedEncoder->dataMin;
     dataMax = castedEncoder->dataMax;
     has_nulls = castedEncoder->has_nulls;
+    copyValueSketch(copyFromEncoder);
   }
 
   T dataMin;
   T dataMax;
   bool has_nulls;
 
+ private:
+  template <typename S>
+  void updateStatsBatch(const S* vals, const size_t count, const S null_val) {
+    dropValueSketch();
+    const auto stats = EncoderKernels::compute_stats<S, T>(vals, count, null_val);
+    has_nulls |= stats.has_nulls;
+    dataMin = std::min(dataMin, stats.min);
+    dataMax = std::max(dataMax, stats.max);
+  }
+
 };  // class NoneEncoder
 
 #endif  // NONE_ENCODER_H
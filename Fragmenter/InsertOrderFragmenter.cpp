@@ -19,6 +19,7 @@
 #include <boost/lexical_cast.hpp>
 #include <cassert>
 #include <cmath>
+#include <future>
 #include <iostream>
 #include <limits>
 #include <thread>
@@ -27,10 +28,13 @@
 #include "../DataMgr/DataMgr.h"
 #include "../DataMgr/LockMgr.h"
 #include "../Shared/checked_alloc.h"
+#include "../Shared/scope.h"
 #include "../Shared/thread_count.h"
 
 #define DROP_FRAGMENT_FACTOR \
   0.97  // drop to 97% of max so we don't keep adding and dropping fragments
+#define MIN_ROWS_FOR_PARALLEL_APPEND \
+  10000  // below this column appends aren't worth the thread launches
 
 using Chunk_NS::Chunk;
 using Data_Namespace::AbstractBuffer;
@@ -381,6 +385,9 @@ void InsertOrderFragmenter::insertDataImpl(InsertData& insertDataStruct) {
   }
   size_t startFragment = fragmentInfoVec_.size() - 1;
 
+  // first carve the batch into per-fragment slices, creating the fragments it
+  // spills into, then append the columns of all slices in parallel below
+  std::vector<FragmentInsertSlice> slices;
   while (numRowsLeft > 0) {  // may have to create multiple fragments for bulk insert
     // loop until done inserting all rows
     CHECK_LE(currentFragment->shadowNumTuples, maxFragmentRows_);
@@ -433,31 +440,22 @@ void InsertOrderFragmenter::insertDataImpl(InsertData& insertDataStruct) {
     CHECK_GT(numRowsToInsert, size_t(0));  // would put us into an endless loop as we'd
                                            // never be able to insert anything
 
-    // for each column, append the data in the appropriate insert buffer
-    for (size_t i = 0; i < insertDataStruct.columnIds.size(); ++i) {
-      int columnId = insertDataStruct.columnIds[i];
-      auto colMapIt = columnMap_.find(columnId);
-      assert(colMapIt != columnMap_.end());
-      currentFragment->shadowChunkMetadataMap[columnId] =
-          colMapIt->second.appendData(dataCopy[i], numRowsToInsert, numRowsInserted);
-      auto varLenColInfoIt = varLenColInfo_.find(columnId);
-      if (varLenColInfoIt != varLenColInfo_.end()) {
-        varLenColInfoIt->second = colMapIt->second.get_buffer()->size();
-      }
-    }
-    if (hasMaterializedRowId_) {
-      size_t startId = maxFragmentRows_ * currentFragment->fragmentId +
+    FragmentInsertSlice slice;
+    slice.fragment = currentFragment;
+    slice.startRow = numRowsInserted;
+    slice.numRows = numRowsToInsert;
+    slice.startRowId = maxFragmentRows_ * currentFragment->fragmentId +
                        currentFragment->shadowNumTuples;
-      int64_t* rowIdData = new int64_t[numRowsToInsert];
-      for (size_t i = 0; i < numRowsToInsert; ++i) {
-        rowIdData[i] = i + startId;
-      }
-      DataBlockPtr rowIdBlock;
-      rowIdBlock.numbersPtr = reinterpret_cast<int8_t*>(rowIdData);
-      auto colMapIt = columnMap_.find(rowIdColId_);
-      currentFragment->shadowChunkMetadataMap[rowIdColId_] =
-          colMapIt->second.appendData(rowIdBlock, numRowsToInsert, numRowsInserted);
-      delete[] rowIdData;
+    for (const auto& colMapIt : columnMap_) {
+      slice.buffers[colMapIt.first] = std::make_pair(colMapIt.second.get_buffer(),
+                                                     colMapIt.second.get_index_buf());
+    }
+    slices.push_back(slice);
+
+    // a slice only ends short of the fragment row limit when a var-len chunk is
+    // full, so the fragment it fills can't take any more rows of this batch
+    for (auto& varLenColInfoIt : varLenColInfo_) {
+      varLenColInfoIt.second = maxChunkSize_;
     }
 
     currentFragment->shadowNumTuples =
@@ -465,6 +463,15 @@ void InsertOrderFragmenter::insertDataImpl(InsertData& insertDataStruct) {
     numRowsLeft -= numRowsToInsert;
     numRowsInserted += numRowsToInsert;
   }
+
+  appendSlices(insertDataStruct, dataCopy, slices);
+
+  // resume the byte counters from the chunks of the fragment filled last
+  for (auto& varLenColInfoIt : varLenColInfo_) {
+    auto colMapIt = columnMap_.find(varLenColInfoIt.first);
+    CHECK(colMapIt != columnMap_.end());
+    varLenColInfoIt.second = colMapIt->second.get_buffer()->size();
+  }
   {  // Need to narrow scope of this lock, or SELECT and COPY_FROM enters a dead lock
     // after SELECT has locked UpdateDeleteLock and COPY_FROM has locked
     // fragmentInfoMutex_ while SELECT waits for fragmentInfoMutex_ and COPY_FROM waits
@@ -482,6 +489,84 @@ void InsertOrderFragmenter::insertDataImpl(InsertData& insertDataStruct) {
   dropFragmentsToSize(maxRows_);
 }
 
+void InsertOrderFragmenter::appendSlices(const InsertData& insertDataStruct,
+                                         std::vector<DataBlockPtr>& dataCopy,
+                                         const std::vector<FragmentInsertSlice>& slices) {
+  // one task per column, each walking the slices in order so that the
+  // fixed-width source pointers of dataCopy advance as they would serially
+  const size_t numColumns = insertDataStruct.columnIds.size();
+  const size_t numTasks = numColumns + (hasMaterializedRowId_ ? 1 : 0);
+  std::vector<std::vector<ChunkMetadata>> sliceMetadata(
+      slices.size(), std::vector<ChunkMetadata>(numTasks));
+
+  auto appendColumn = [&](const size_t taskId) {
+    const bool isRowIdTask = taskId == numColumns;
+    const int columnId =
+        isRowIdTask ? rowIdColId_ : insertDataStruct.columnIds[taskId];
+    auto colMapIt = columnMap_.find(columnId);
+    CHECK(colMapIt != columnMap_.end());
+    for (size_t sliceId = 0; sliceId < slices.size(); ++sliceId) {
+      const auto& slice = slices[sliceId];
+      const auto& buffers = slice.buffers.at(columnId);
+      // the fragmenter keeps the pins of the fragment buffers,
+      // so the borrowed chunk must not unpin them on exit
+      Chunk chunk(buffers.first, buffers.second, colMapIt->second.get_column_desc());
+      ScopeGuard releaseChunkBuffers = [&chunk] {
+        chunk.set_buffer(nullptr);
+        chunk.set_index_buf(nullptr);
+      };
+      if (isRowIdTask) {
+        std::unique_ptr<int64_t[]> rowIdData(new int64_t[slice.numRows]);
+        for (size_t i = 0; i < slice.numRows; ++i) {
+          rowIdData[i] = i + slice.startRowId;
+        }
+        DataBlockPtr rowIdBlock;
+        rowIdBlock.numbersPtr = reinterpret_cast<int8_t*>(rowIdData.get());
+        sliceMetadata[sliceId][taskId] =
+            chunk.appendData(rowIdBlock, slice.numRows, slice.startRow);
+      } else {
+        sliceMetadata[sliceId][taskId] =
+            chunk.appendData(dataCopy[taskId], slice.numRows, slice.startRow);
+      }
+    }
+  };
+
+  const size_t numRowsAppended = slices.back().startRow + slices.back().numRows;
+  const size_t numThreads =
+      numRowsAppended < MIN_ROWS_FOR_PARALLEL_APPEND
+          ? 1
+          : std::min(numTasks, static_cast<size_t>(cpu_threads()));
+  if (numThreads <= 1) {
+    for (size_t taskId = 0; taskId < numTasks; ++taskId) {
+      appendColumn(taskId);
+    }
+  } else {
+    std::vector<std::future<void>> threads;
+    for (size_t threadId = 0; threadId < numThreads; ++threadId) {
+      threads.emplace_back(std::async(std::launch::async, [&, threadId] {
+        for (size_t taskId = threadId; taskId < numTasks; taskId += numThreads) {
+          appendColumn(taskId);
+        }
+      }));
+    }
+    for (auto& t : threads) {
+      t.wait();
+    }
+    for (auto& t : threads) {
+      t.get();
+    }
+  }
+
+  for (size_t sliceId = 0; sliceId < slices.size(); ++sliceId) {
+    auto fragment = slices[sliceId].fragment;
+    for (size_t taskId = 0; taskId < numTasks; ++taskId) {
+      const int columnId =
+          taskId == numColumns ? rowIdColId_ : insertDataStruct.columnIds[taskId];
+      fragment->shadowChunkMetadataMap[columnId] = sliceMetadata[sliceId][taskId];
+    }
+  }
+}
+
 FragmentInfo* InsertOrderFragmenter::createNewFragment(
     const Data_Namespace::MemoryLevel memoryLevel) {
   // also sets the new fragment as the insertBuffer for each column
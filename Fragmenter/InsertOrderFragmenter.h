@@ -193,6 +193,27 @@ class InsertOrderFragmenter : public AbstractFragmenter {
   void insertDataImpl(InsertData& insertDataStruct);
   void replicateData(const InsertData& insertDataStruct);
 
+  /**
+   * @brief rows of one insert batch that go into a single fragment, along
+   * with the chunk buffers (data, index) of that fragment for each column
+   */
+  struct FragmentInsertSlice {
+    FragmentInfo* fragment;
+    size_t startRow;
+    size_t numRows;
+    size_t startRowId;
+    std::map<int, std::pair<AbstractBuffer*, AbstractBuffer*>> buffers;
+  };
+
+  /**
+   * @brief appends the columns of all slices concurrently, one task per column,
+   * and merges the resulting chunk metadata into the shadow metadata of each
+   * fragment afterwards
+   */
+  void appendSlices(const InsertData& insertDataStruct,
+                    std::vector<DataBlockPtr>& dataCopy,
+                    const std::vector<FragmentInsertSlice>& slices);
+
   InsertOrderFragmenter(const InsertOrderFragmenter&);
   InsertOrderFragmenter& operator=(const InsertOrderFragmenter&);
   // FIX-ME:  Temporary lock; needs removing.
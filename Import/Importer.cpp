@@ -27,6 +27,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/dynamic_bitset.hpp>
 #include <boost/filesystem.hpp>
+#include <atomic>
 #include <csignal>
 #include <cstdio>
 #include <cstdlib>
@@ -52,6 +53,7 @@
 #include "../Shared/measure.h"
 #include "../Shared/scope.h"
 #include "../Shared/shard_key.h"
+#include "../Shared/thread_count.h"
 #include "../Shared/unreachable.h"
 
 #include <iostream>
@@ -1996,21 +1998,48 @@ static ImportStatus import_thread_shapefile(
   return import_status;
 }
 
-static size_t find_end(const char* buffer, size_t size, const CopyParams& copy_params) {
-  int i;
-  // @TODO(wei) line_delim is in quotes note supported
+// Returns the size of the complete lines at the start of buffer, which has to begin
+// a line, 0 if there are none. A line_delim within a quoted field doesn't end a line,
+// quotes are matched the way get_row does. If a quote is still open and no line ended
+// before it, the last line_delim ends the lines, so that an unmatched quote doesn't
+// hold back the rest of the input; get_row reports it.
+static size_t find_lines_end(const char* buffer,
+                             const size_t size,
+                             const CopyParams& copy_params) {
+  int64_t i;
+  if (copy_params.quoted) {
+    bool in_quote = false;
+    int64_t last_line_end = -1;
+    for (i = 0; i < static_cast<int64_t>(size); i++) {
+      if (buffer[i] == copy_params.escape && i + 1 < static_cast<int64_t>(size) &&
+          buffer[i + 1] == copy_params.quote) {
+        i++;
+      } else if (buffer[i] == copy_params.quote) {
+        in_quote = !in_quote;
+      } else if (!in_quote && buffer[i] == copy_params.line_delim) {
+        last_line_end = i;
+      }
+    }
+    if (last_line_end >= 0 || !in_quote) {
+      return last_line_end + 1;
+    }
+  }
   for (i = size - 1; i >= 0 && buffer[i] != copy_params.line_delim; i--) {
     ;
   }
+  return i + 1;
+}
 
-  if (i < 0) {
+static size_t find_end(const char* buffer, size_t size, const CopyParams& copy_params) {
+  const auto end = find_lines_end(buffer, size, copy_params);
+  if (!end) {
     int slen = size < 50 ? size : 50;
     std::string showMsgStr(buffer, buffer + slen);
     LOG(ERROR) << "No line delimiter in block. Block was of size " << size
                << " bytes, first few characters " << showMsgStr;
     return size;
   }
-  return i + 1;
+  return end;
 }
 
 bool Loader::loadNoCheckpoint(
@@ -2355,13 +2384,13 @@ ImportStatus Detector::importDelimited(const std::string& file_path,
         line1 = line;
       } else if (line == line1) {
         continue;
+      } else {
+        sample_line(line, n);
       }
 
-      raw_data += std::string(line, n);
-      raw_data += copy_params.line_delim;
       ++import_status.rows_completed;
       if (std::chrono::steady_clock::now() > end_time) {
-        if (import_status.rows_completed > 10000) {
+        if (import_status.rows_completed > copy_params.detect_sample_rows) {
           break;
         }
       }
@@ -2379,8 +2408,124 @@ ImportStatus Detector::importDelimited(const std::string& file_path,
 }
 
 void Detector::read_file() {
-  // this becomes analogous to Importer::import()
-  (void)DataStreamSink::archivePlumber();
+  if (!read_file_sampled()) {
+    // this becomes analogous to Importer::import()
+    (void)DataStreamSink::archivePlumber();
+  }
+  finish_sample();
+}
+
+namespace {
+
+bool has_archive_signature(const char* buf, const size_t len) {
+  static const std::vector<std::string> signatures{std::string("\x1f\x8b", 2),
+                                                   std::string("BZh", 3),
+                                                   std::string("\xfd" "7zXZ", 5),
+                                                   std::string("7z\xbc\xaf", 4),
+                                                   std::string("PK\x03\x04", 4),
+                                                   std::string("Rar!", 4),
+                                                   std::string("\x28\xb5\x2f\xfd", 4),
+                                                   std::string("\x04\x22\x4d\x18", 4)};
+  for (const auto& signature : signatures) {
+    if (len >= signature.size() && !memcmp(buf, signature.data(), signature.size())) {
+      return true;
+    }
+  }
+  // tar
+  return len >= 262 && !memcmp(buf + 257, "ustar", 5);
+}
+
+}  // namespace
+
+// Large uncompressed local files are read in blocks at evenly spaced offsets,
+// so that the sample covers the whole file rather than whatever part of its
+// head can be streamed within the timeout.
+bool Detector::read_file_sampled() {
+  const size_t num_blocks = 256;
+  const size_t block_size = 1 << 16;
+  boost::system::error_code ec;
+  if (copy_params.is_parquet || !boost::filesystem::is_regular_file(file_path, ec)) {
+    return false;
+  }
+  const size_t file_size = boost::filesystem::file_size(file_path, ec);
+  if (ec || file_size < 4 * num_blocks * block_size) {
+    return false;
+  }
+  std::ifstream file(file_path.string(), std::ios::binary);
+  std::vector<char> block(block_size);
+  for (size_t block_idx = 0; block_idx < num_blocks; ++block_idx) {
+    file.seekg(block_idx * (file_size / num_blocks));
+    file.read(block.data(), block.size());
+    const char* p = block.data();
+    const char* block_end = p + file.gcount();
+    if (block_idx == 0) {
+      if (static_cast<size_t>(file.gcount()) < block_size ||
+          has_archive_signature(p, block_size)) {
+        return false;
+      }
+    } else {
+      // skip the tail of the line the block starts in
+      p = static_cast<const char*>(memchr(p, copy_params.line_delim, block_end - p));
+      if (!p) {
+        continue;
+      }
+      ++p;
+    }
+    while (p < block_end) {
+      const char* line_end =
+          static_cast<const char*>(memchr(p, copy_params.line_delim, block_end - p));
+      if (!line_end) {
+        // partial line at the end of the block
+        break;
+      }
+      const size_t len = line_end - p;
+      if (line1.empty()) {
+        line1.assign(p, len);
+      } else if (len > 0 && line1.compare(0, std::string::npos, p, len)) {
+        sample_line(p, len);
+      }
+      p = line_end + 1;
+    }
+    if (line1.empty()) {
+      // first line doesn't fit a block, stream the file instead
+      return false;
+    }
+  }
+  return true;
+}
+
+void Detector::sample_line(const char* line, const size_t len) {
+  const size_t sample_rows = std::max<size_t>(copy_params.detect_sample_rows, 1);
+  if (sampled_lines.size() < sample_rows) {
+    sampled_lines.emplace_back(lines_seen, std::string(line, len));
+  } else {
+    std::uniform_int_distribution<size_t> dist(0, lines_seen);
+    const auto slot = dist(sample_rng);
+    if (slot < sample_rows) {
+      sampled_lines[slot] = std::make_pair(lines_seen, std::string(line, len));
+    }
+  }
+  ++lines_seen;
+}
+
+void Detector::finish_sample() {
+  if (line1.empty()) {
+    return;
+  }
+  // keep the sampled lines in file order behind the possible header line
+  std::sort(sampled_lines.begin(),
+            sampled_lines.end(),
+            [](const std::pair<size_t, std::string>& lhs,
+               const std::pair<size_t, std::string>& rhs) {
+              return lhs.first < rhs.first;
+            });
+  raw_data = line1;
+  raw_data += copy_params.line_delim;
+  for (const auto& sampled_line : sampled_lines) {
+    raw_data += sampled_line.second;
+    raw_data += copy_params.line_delim;
+  }
+  sampled_lines.clear();
 }
 
 void Detector::detect_row_delimiter() {
@@ -2429,7 +2574,7 @@ bool try_cast(const std::string& str) {
 inline char* try_strptimes(const char* str, const std::vector<std::string>& formats) {
   std::tm tm_struct;
   char* buf;
-  for (auto format : formats) {
+  for (const auto& format : formats) {
     buf = strptime(str, format.c_str(), &tm_struct);
     if (buf) {
       return buf;
@@ -2438,9 +2583,45 @@ inline char* try_strptimes(const char* str, const std::vector<std::string>& form
   return nullptr;
 }
 
+// strchr alone would also find the terminating NUL of chars
+inline bool is_any_of(const char c, const char* chars) {
+  return c != '\0' && strchr(chars, c);
+}
+
+// Cheap pre-checks so that most strings which can't be numbers or dates
+// never reach lexical_cast or strptime, whose failures are expensive.
+inline bool may_be_number(const std::string& str) {
+  size_t i = 0;
+  while (i < str.size() && isspace(static_cast<unsigned char>(str[i]))) {
+    ++i;
+  }
+  if (i < str.size() && (str[i] == '+' || str[i] == '-')) {
+    ++i;
+  }
+  if (i < str.size() && is_any_of(str[i], "iInN")) {
+    // inf, infinity and nan
+    return true;
+  }
+  for (; i < str.size(); ++i) {
+    const auto c = static_cast<unsigned char>(str[i]);
+    if (!isdigit(c) && !isspace(c) && !is_any_of(str[i], ".eE+-")) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// all the date and time formats tried begin with a numeric field
+inline bool may_be_datetime(const char* str) {
+  while (isspace(static_cast<unsigned char>(*str))) {
+    ++str;
+  }
+  return isdigit(static_cast<unsigned char>(*str));
+}
+
 SQLTypes Detector::detect_sqltype(const std::string& str) {
   SQLTypes type = kTEXT;
-  if (try_cast<double>(str)) {
+  if (may_be_number(str) && try_cast<double>(str)) {
     type = kDOUBLE;
     /*if (try_cast<bool>(str)) {
       type = kBOOLEAN;
@@ -2490,19 +2671,22 @@ SQLTypes Detector::detect_sqltype(const std::string& str) {
   }
 
   // check for time types
-  if (type == kTEXT) {
+  if (type == kTEXT && may_be_datetime(str.c_str())) {
     // @TODO
     // make these tests more robust so they don't match stuff they should not
+    static const std::vector<std::string> date_formats{
+        "%Y-%m-%d", "%m/%d/%Y", "%d-%b-%y", "%d/%b/%Y"};
+    static const std::vector<std::string> time_formats{"%T %z", "%T", "%H%M%S", "%R"};
     char* buf;
-    buf = try_strptimes(str.c_str(), {"%Y-%m-%d", "%m/%d/%Y", "%d-%b-%y", "%d/%b/%Y"});
+    buf = try_strptimes(str.c_str(), date_formats);
     if (buf) {
       type = kDATE;
       if (*buf == 'T' || *buf == ' ' || *buf == ':') {
         buf++;
       }
     }
-    buf = try_strptimes(buf == nullptr ? str.c_str() : buf,
-                        {"%T %z", "%T", "%H%M%S", "%R"});
+    const char* time_str = buf == nullptr ? str.c_str() : buf;
+    buf = may_be_datetime(time_str) ? try_strptimes(time_str, time_formats) : nullptr;
     if (buf) {
       if (type == kDATE) {
         type = kTIMESTAMP;
@@ -2524,22 +2708,26 @@ std::vector<SQLTypes> Detector::detect_column_types(const std::vector<std::strin
 }
 
 bool Detector::more_restrictive_sqltype(const SQLTypes a, const SQLTypes b) {
-  static std::array<int, kSQLTYPE_LAST> typeorder;
-  typeorder[kCHAR] = 0;
-  typeorder[kBOOLEAN] = 2;
-  typeorder[kSMALLINT] = 3;
-  typeorder[kINT] = 4;
-  typeorder[kBIGINT] = 5;
-  typeorder[kFLOAT] = 6;
-  typeorder[kDOUBLE] = 7;
-  typeorder[kTIMESTAMP] = 8;
-  typeorder[kTIME] = 9;
-  typeorder[kDATE] = 10;
-  typeorder[kPOINT] = 11;
-  typeorder[kLINESTRING] = 11;
-  typeorder[kPOLYGON] = 11;
-  typeorder[kMULTIPOLYGON] = 11;
-  typeorder[kTEXT] = 12;
+  // built once, this gets called concurrently by the detection threads
+  static const std::array<int, kSQLTYPE_LAST> typeorder = [] {
+    std::array<int, kSQLTYPE_LAST> typeorder{};
+    typeorder[kCHAR] = 0;
+    typeorder[kBOOLEAN] = 2;
+    typeorder[kSMALLINT] = 3;
+    typeorder[kINT] = 4;
+    typeorder[kBIGINT] = 5;
+    typeorder[kFLOAT] = 6;
+    typeorder[kDOUBLE] = 7;
+    typeorder[kTIMESTAMP] = 8;
+    typeorder[kTIME] = 9;
+    typeorder[kDATE] = 10;
+    typeorder[kPOINT] = 11;
+    typeorder[kLINESTRING] = 11;
+    typeorder[kPOLYGON] = 11;
+    typeorder[kMULTIPOLYGON] = 11;
+    typeorder[kTEXT] = 12;
+    return typeorder;
+  }();
 
   // note: b < a instead of a < b because the map is ordered most to least restrictive
   return typeorder[b] < typeorder[a];
@@ -2574,27 +2762,40 @@ std::vector<SQLTypes> Detector::find_best_sqltypes(
   }
   auto end_time = std::chrono::steady_clock::now() + timeout;
   size_t num_cols = raw_rows.front().size();
-  std::vector<SQLTypes> best_types(num_cols, kCHAR);
-  std::vector<size_t> non_null_col_counts(num_cols, 0);
+  size_t max_cols = num_cols;
   for (auto row = row_begin; row != row_end; row++) {
-    while (best_types.size() < row->size() || non_null_col_counts.size() < row->size()) {
-      best_types.push_back(kCHAR);
-      non_null_col_counts.push_back(0);
-    }
-    for (size_t col_idx = 0; col_idx < row->size(); col_idx++) {
-      // do not count nulls
-      if (row->at(col_idx) == "" || !row->at(col_idx).compare(copy_params.null_str)) {
-        continue;
-      }
-      SQLTypes t = detect_sqltype(row->at(col_idx));
-      non_null_col_counts[col_idx]++;
-      if (!more_restrictive_sqltype(best_types[col_idx], t)) {
-        best_types[col_idx] = t;
+    max_cols = std::max(max_cols, row->size());
+  }
+  std::vector<SQLTypes> best_types(max_cols, kCHAR);
+  std::vector<size_t> non_null_col_counts(max_cols, 0);
+  // columns are striped over the threads, each one walks all the rows
+  const size_t num_threads =
+      std::max<size_t>(std::min<size_t>(max_cols, cpu_threads()), 1);
+  std::vector<std::future<void>> detect_threads;
+  for (size_t thread_idx = 0; thread_idx < num_threads; ++thread_idx) {
+    detect_threads.push_back(std::async(std::launch::async, [&, thread_idx] {
+      for (auto row = row_begin; row != row_end; row++) {
+        for (size_t col_idx = thread_idx; col_idx < row->size();
+             col_idx += num_threads) {
+          // do not count nulls
+          if (row->at(col_idx) == "" ||
+              !row->at(col_idx).compare(copy_params.null_str)) {
+            continue;
+          }
+          SQLTypes t = detect_sqltype(row->at(col_idx));
+          non_null_col_counts[col_idx]++;
+          if (!more_restrictive_sqltype(best_types[col_idx], t)) {
+            best_types[col_idx] = t;
+          }
+        }
+        if (std::chrono::steady_clock::now() > end_time) {
+          break;
+        }
       }
-    }
-    if (std::chrono::steady_clock::now() > end_time) {
-      break;
-    }
+    }));
+  }
+  for (auto& detect_thread : detect_threads) {
+    detect_thread.get();
   }
   for (size_t col_idx = 0; col_idx < num_cols; col_idx++) {
     // if we don't have any non-null values for this column make it text to be
@@ -2619,13 +2820,24 @@ std::vector<EncodingType> Detector::find_best_encodings(
   std::vector<EncodingType> best_encodes(num_cols, kENCODING_NONE);
   std::vector<size_t> num_rows_per_col(num_cols, 1);
   std::vector<std::unordered_set<std::string>> count_set(num_cols);
-  for (auto row = row_begin; row != row_end; row++) {
-    for (size_t col_idx = 0; col_idx < row->size(); col_idx++) {
-      if (IS_STRING(best_types[col_idx])) {
-        count_set[col_idx].insert(row->at(col_idx));
-        num_rows_per_col[col_idx]++;
+  const size_t num_threads =
+      std::max<size_t>(std::min<size_t>(num_cols, cpu_threads()), 1);
+  std::vector<std::future<void>> count_threads;
+  for (size_t thread_idx = 0; thread_idx < num_threads; ++thread_idx) {
+    count_threads.push_back(std::async(std::launch::async, [&, thread_idx] {
+      for (auto row = row_begin; row != row_end; row++) {
+        for (size_t col_idx = thread_idx; col_idx < row->size();
+             col_idx += num_threads) {
+          if (IS_STRING(best_types[col_idx])) {
+            count_set[col_idx].insert(row->at(col_idx));
+            num_rows_per_col[col_idx]++;
+          }
+        }
       }
-    }
+    }));
+  }
+  for (auto& count_thread : count_threads) {
+    count_thread.get();
   }
   for (size_t col_idx = 0; col_idx < num_cols; col_idx++) {
     if (IS_STRING(best_types[col_idx])) {
@@ -2789,6 +3001,13 @@ void DataStreamSink::import_compressed(std::vector<std::string>& file_paths) {
   signal(SIGPIPE, SIG_IGN);
 
   std::exception_ptr teptr;
+  std::mutex teptr_mutex;
+  auto set_teptr = [&](std::exception_ptr eptr) {
+    std::lock_guard<std::mutex> lock(teptr_mutex);
+    if (!teptr) {  // no replace
+      teptr = eptr;
+    }
+  };
   // create a thread to read uncompressed byte stream out of pipe and
   // feed into importDelimited()
   ImportStatus ret;
@@ -2804,9 +3023,7 @@ void DataStreamSink::import_compressed(std::vector<std::string>& file_paths) {
       // it can be feed into other function such like importParquet, etc
       ret = importDelimited(file_path, true);
     } catch (...) {
-      if (!teptr) {  // no replace
-        teptr = std::current_exception();
-      }
+      set_teptr(std::current_exception());
     }
 
     if (p_file) {
@@ -2815,19 +3032,96 @@ void DataStreamSink::import_compressed(std::vector<std::string>& file_paths) {
     p_file = 0;
   });
 
-  // create a thread to iterate all files (in all archives) and
-  // forward the uncompressed byte stream to fd[1] which is
-  // then feed into importDelimited, importParquet, and etc.
-  auto th_pipe_writer = std::thread([&]() {
+  // files are decompressed concurrently, one libarchive stream per file, so
+  // gzipped inputs are no longer bound to the inflate speed of a single core.
+  // s3 urls are expanded into object keys which are landed through one shared
+  // S3Archive, and the detector needs the first line of the first file at the
+  // head of the stream to detect a header, so both of them stay with a single
+  // writer.
+  const std::string S3_objkey_url_scheme = "s3ok";
+  size_t num_pipe_writers = 1;
+  if (nullptr == dynamic_cast<Detector*>(this)) {
+    bool has_s3_url = false;
+    for (const auto& file_path : file_paths) {
+      std::map<int, std::string> url_parts;
+      Archive::parse_url(file_path, url_parts);
+      has_s3_url |= "s3" == url_parts[2];
+    }
+    if (!has_s3_url) {
+      num_pipe_writers = copy_params.threads > 0
+                             ? static_cast<size_t>(copy_params.threads)
+                             : static_cast<size_t>(sysconf(_SC_NPROCESSORS_CONF));
+      num_pipe_writers = std::max(std::min(num_pipe_writers, file_paths.size()), 1ul);
+    }
+  }
+
+  std::atomic<size_t> next_file_idx{0};
+  std::atomic<bool> stop{false};
+  std::mutex pipe_write_mutex;
+
+  // forward whole lines only, so that lines of concurrently decompressed
+  // files never get interleaved with each other in the single pipe.
+  auto write_to_pipe = [&](const char* buf, size_t size) {
+    std::lock_guard<std::mutex> lock(pipe_write_mutex);
+    // In very rare occasions the write pipe somehow operates in a mode similar to
+    // non-blocking while pipe(fds) should behave like pipe2(fds, 0) which means
+    // blocking mode. On such a unreliable blocking mode, a possible fix is to
+    // loop reading till no bytes left, otherwise the annoying `failed to write
+    // pipe: Success`...
+    for (ssize_t nread = 0, nleft = size; nleft > 0; nleft -= (nread > 0 ? nread : 0)) {
+      nread = write(fd[1], buf + (size - nleft), nleft);
+      if (nread == nleft) {
+        break;  // done
+      }
+      // no exception when too many rejected
+      if (import_status.load_truncated) {
+        stop = true;
+        break;
+      }
+      // not to overwrite original error
+      if (nread < 0 && !(errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+        throw std::runtime_error(std::string("failed or interrupted write to pipe: ") +
+                                 strerror(errno));
+      }
+    }
+  };
+
+  auto flush_staged_lines = [&](std::vector<char>& staged, const bool end_of_file) {
+    if (staged.empty()) {
+      return;
+    }
+    size_t nlines_bytes = staged.size();
+    if (end_of_file) {
+      // terminate the last line of a file so that it does not get
+      // glued to the first line of whichever file is forwarded next
+      if (staged.back() != copy_params.line_delim) {
+        staged.push_back(copy_params.line_delim);
+        ++nlines_bytes;
+      }
+    } else {
+      nlines_bytes = find_lines_end(staged.data(), staged.size(), copy_params);
+      if (0 == nlines_bytes) {
+        return;  // keep staging until a line completes
+      }
+    }
+    write_to_pipe(staged.data(), nlines_bytes);
+    staged.erase(staged.begin(), staged.begin() + nlines_bytes);
+  };
+
+  // iterate all files (in all archives) and forward the uncompressed byte
+  // stream to fd[1] which is then feed into importDelimited, importParquet,
+  // and etc.
+  auto pipe_writer = [&]() {
+    constexpr size_t pipe_writer_staging_size = 1 << 20;
     std::unique_ptr<S3Archive> us3arch;
-    bool stop = false;
-    for (size_t fi = 0; !stop && fi < file_paths.size(); fi++) {
+    std::vector<char> staged;
+    staged.reserve(2 * pipe_writer_staging_size);
+    for (size_t fi = 0; !stop && (fi = next_file_idx++) < file_paths.size();) {
       try {
         auto file_path = file_paths[fi];
         std::unique_ptr<Archive> uarch;
         std::map<int, std::string> url_parts;
         Archive::parse_url(file_path, url_parts);
-        const std::string S3_objkey_url_scheme = "s3ok";
         if ("file" == url_parts[2] || "" == url_parts[2]) {
           uarch.reset(new PosixFileArchive(file_path, copy_params.plain_text));
         } else if ("s3" == url_parts[2]) {
@@ -2904,35 +3198,19 @@ void DataStreamSink::import_compressed(std::vector<std::string>& file_paths) {
               }
               just_saw_header = false;
             }
-            // In very rare occasions the write pipe somehow operates in a mode similar to
-            // non-blocking while pipe(fds) should behave like pipe2(fds, 0) which means
-            // blocking mode. On such a unreliable blocking mode, a possible fix is to
-            // loop reading till no bytes left, otherwise the annoying `failed to write
-            // pipe: Success`...
             if (size2 > 0) {
-              for (int nread = 0, nleft = size2; nleft > 0;
-                   nleft -= (nread > 0 ? nread : 0)) {
-                nread = write(fd[1], buf2, nleft);
-                if (nread == nleft) {
-                  break;  // done
-                }
-                // no exception when too many rejected
-                if (import_status.load_truncated) {
-                  stop = true;
-                  break;
-                }
-                // not to overwrite original error
-                if (nread < 0 &&
-                    !(errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
-                  throw std::runtime_error(
-                      std::string("failed or interrupted write to pipe: ") +
-                      strerror(errno));
-                }
+              staged.insert(staged.end(), buf2, buf2 + size2);
+              if (staged.size() >= pipe_writer_staging_size) {
+                flush_staged_lines(staged, false);
               }
             }
           }
+          if (!stop) {
+            flush_staged_lines(staged, true);
+          }
         }
       } catch (...) {
+        stop = true;
         // when import is aborted because too many data errors or because end of a
         // detection, any exception thrown by s3 sdk or libarchive is okay and should be
         // suppressed.
@@ -2944,18 +3222,24 @@ void DataStreamSink::import_compressed(std::vector<std::string>& file_paths) {
             break;
           }
         }
-        if (!teptr) {  // no replace
-          teptr = std::current_exception();
-        }
+        set_teptr(std::current_exception());
         break;
       }
+      staged.clear();
     }
-    // close writer end
-    close(fd[1]);
-  });
+  };
+
+  std::vector<std::thread> th_pipe_writers;
+  for (size_t i = 0; i < num_pipe_writers; ++i) {
+    th_pipe_writers.emplace_back(pipe_writer);
+  }
+  for (auto& th_pipe_writer : th_pipe_writers) {
+    th_pipe_writer.join();
+  }
+  // close writer end
+  close(fd[1]);
 
   th_pipe_reader.join();
-  th_pipe_writer.join();
 
   // rethrow any exception happened herebefore
   if (teptr) {
@@ -3155,6 +3439,18 @@ ImportStatus Importer::importDelimited(const std::string& file_path,
     }
   }
 
+  checkpointStringDictionaries();
+  // must set import_status.load_truncated before closing this end of pipe
+  // otherwise, the thread on the other end would throw an unwanted 'write()'
+  // exception
+  import_status.load_truncated = load_truncated;
+
+  fclose(p_file);
+  p_file = nullptr;
+  return import_status;
+}
+
+void Importer::checkpointStringDictionaries() {
   if (loader->get_table_desc()->persistenceLevel ==
       Data_Namespace::MemoryLevel::DISK_LEVEL) {  // only checkpoint disk-resident tables
     auto ms = measure<>::execution([&]() {
@@ -3174,14 +3470,69 @@ ImportStatus Importer::importDelimited(const std::string& file_path,
                 << std::endl;
     }
   }
-  // must set import_status.load_truncated before closing this end of pipe
-  // otherwise, the thread on the other end would throw an unwanted 'write()'
-  // exception
-  import_status.load_truncated = load_truncated;
+}
 
-  fclose(p_file);
-  p_file = nullptr;
-  return import_status;
+ImportStatus Importer::importDelimitedBuffer(const std::shared_ptr<const char>& sbuffer,
+                                             const size_t size) {
+  ImportStatus batch_status;
+  // a failed load only fails the batch it happened in
+  load_failed = false;
+  if (copy_params.threads == 0) {
+    max_threads = static_cast<size_t>(sysconf(_SC_NPROCESSORS_CONF));
+  } else {
+    max_threads = static_cast<size_t>(copy_params.threads);
+  }
+  if (import_buffers_vec.empty()) {
+    for (size_t i = 0; i < max_threads; i++) {
+      import_buffers_vec.push_back(std::vector<std::unique_ptr<TypedImportBuffer>>());
+      for (const auto cd : loader->get_column_descs()) {
+        import_buffers_vec[i].push_back(std::unique_ptr<TypedImportBuffer>(
+            new TypedImportBuffer(cd, loader->get_string_dict(cd))));
+      }
+    }
+  }
+  CHECK_LE(max_threads, import_buffers_vec.size());
+
+  // render groups of poly columns only matter to the file based imports,
+  // streamed rows go into render group 0 like the ones inserted with sql
+  const ColumnIdToRenderGroupAnalyzerMapType columnIdToRenderGroupAnalyzerMap;
+
+  // split the batch into whole lines, one slice per thread. A slice ends with the
+  // last line which ends within its share of what's left, or within twice, four
+  // times... that share if a line is longer; the last thread gets the rest.
+  std::vector<std::future<ImportStatus>> threads;
+  for (size_t begin_pos = 0, thread_id = 0; begin_pos < size; ++thread_id) {
+    CHECK_LT(thread_id, max_threads);
+    const size_t slice_size =
+        (size - begin_pos + max_threads - thread_id - 1) / (max_threads - thread_id);
+    size_t end_pos = size;
+    for (size_t window = slice_size; begin_pos + window < size; window *= 2) {
+      const auto lines_end =
+          find_lines_end(sbuffer.get() + begin_pos, window, copy_params);
+      if (lines_end) {
+        end_pos = begin_pos + lines_end;
+        break;
+      }
+    }
+    threads.push_back(std::async(std::launch::async,
+                                 import_thread_delimited,
+                                 thread_id,
+                                 this,
+                                 sbuffer,
+                                 begin_pos,
+                                 end_pos,
+                                 size,
+                                 columnIdToRenderGroupAnalyzerMap));
+    begin_pos = end_pos;
+  }
+  for (auto& p : threads) {
+    p.wait();
+  }
+  for (auto& p : threads) {
+    batch_status += p.get();
+  }
+  import_status += batch_status;
+  return batch_status;
 }
 
 void Loader::checkpoint() {
@@ -39,6 +39,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <random>
 #include <string>
 #include "../Catalog/Catalog.h"
 #include "../Catalog/TableDescriptor.h"
@@ -96,6 +97,8 @@ struct CopyParams {
   SQLTypes geo_coords_type;
   int32_t geo_coords_srid;
   bool sanitize_column_names;
+  // number of rows the detector samples across the input
+  size_t detect_sample_rows = 10000;
 
   CopyParams()
       : delimiter(',')
@@ -727,10 +730,17 @@ class Detector : public DataStreamSink {
                       const std::vector<SQLTypes>& rest_types);
   void find_best_sqltypes_and_headers();
   ImportStatus importDelimited(const std::string& file_path, const bool decompressed);
+  bool read_file_sampled();
+  void sample_line(const char* line, const size_t len);
+  void finish_sample();
   std::string raw_data;
   boost::filesystem::path file_path;
   std::chrono::duration<double> timeout{1};
   std::string line1;
+  // reservoir of (line number, line) over all lines but the first
+  std::vector<std::pair<size_t, std::string>> sampled_lines;
+  size_t lines_seen = 0;
+  std::mt19937_64 sample_rng{0};
 };
 
 class ImporterUtils {
@@ -796,6 +806,11 @@ class Importer : public DataStreamSink {
   ~Importer();
   ImportStatus import();
   ImportStatus importDelimited(const std::string& file_path, const bool decompressed);
+  // parses an in-memory block of whole delimited lines on up to max_threads
+  // threads and loads it without checkpointing the table
+  ImportStatus importDelimitedBuffer(const std::shared_ptr<const char>& sbuffer,
+                                     const size_t size);
+  void checkpointStringDictionaries();
   ImportStatus importGDAL(std::map<std::string, std::string> colname_to_src);
   const CopyParams& get_copy_params() const { return copy_params; }
   const std::list<const ColumnDescriptor*>& get_column_descs() const {
@@ -830,6 +845,8 @@ class Importer : public DataStreamSink {
       const CopyParams& copy_params);
   static bool gdalSupportsNetworkFileAccess();
   Catalog_Namespace::Catalog& get_catalog() { return loader->get_catalog(); }
+  Loader* get_loader() const { return loader.get(); }
+  bool get_load_failed() const { return load_failed; }
   static void set_geo_physical_import_buffer(
       const Catalog_Namespace::Catalog& catalog,
       const ColumnDescriptor* cd,
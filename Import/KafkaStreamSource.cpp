@@ -0,0 +1,158 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "KafkaStreamSource.h"
+
+#include <glog/logging.h>
+#include <stdexcept>
+
+#include "rdkafkacpp.h"
+
+namespace Importer_NS {
+
+namespace {
+
+void set_conf(RdKafka::Conf* conf, const std::string& name, const std::string& value) {
+  std::string errstr;
+  if (conf->set(name, value, errstr) != RdKafka::Conf::CONF_OK) {
+    throw std::runtime_error("Kafka config " + name + ": " + errstr);
+  }
+}
+
+}  // namespace
+
+KafkaStreamSource::KafkaStreamSource(const std::string& brokers,
+                                     const std::string& group_id,
+                                     const std::string& topic,
+                                     const std::vector<int32_t>& partitions)
+    : topic_(topic), partitions_(partitions) {
+  std::unique_ptr<RdKafka::Conf> conf(RdKafka::Conf::create(RdKafka::Conf::CONF_GLOBAL));
+  set_conf(conf.get(), "metadata.broker.list", brokers);
+  set_conf(conf.get(), "group.id", group_id);
+  // offsets are committed by the ingestor once a micro batch is checkpointed
+  set_conf(conf.get(), "enable.auto.commit", "false");
+  set_conf(conf.get(), "enable.auto.offset.store", "false");
+  std::string errstr;
+  consumer_.reset(RdKafka::KafkaConsumer::create(conf.get(), errstr));
+  if (!consumer_) {
+    throw std::runtime_error("Failed to create Kafka consumer: " + errstr);
+  }
+  assign({});
+}
+
+KafkaStreamSource::~KafkaStreamSource() {
+  if (consumer_) {
+    consumer_->close();
+  }
+}
+
+void KafkaStreamSource::assign(const std::map<int32_t, int64_t>& offsets) {
+  std::vector<RdKafka::TopicPartition*> topic_partitions;
+  for (const auto partition : partitions_) {
+    const auto it = offsets.find(partition);
+    topic_partitions.push_back(RdKafka::TopicPartition::create(
+        topic_,
+        partition,
+        it == offsets.end() ? RdKafka::Topic::OFFSET_STORED : it->second));
+  }
+  const auto err = consumer_->assign(topic_partitions);
+  RdKafka::TopicPartition::destroy(topic_partitions);
+  if (err != RdKafka::ERR_NO_ERROR) {
+    throw std::runtime_error("Failed to assign Kafka partitions of " + topic_ + ": " +
+                             RdKafka::err2str(err));
+  }
+}
+
+std::vector<StreamMessage> KafkaStreamSource::consume(
+    const size_t max_messages,
+    const std::chrono::milliseconds timeout) {
+  std::vector<StreamMessage> messages;
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (messages.size() < max_messages) {
+    const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now());
+    // after the first message only drain what the client already prefetched
+    const int timeout_ms = messages.empty() ? std::max<int>(remaining.count(), 0) : 0;
+    std::unique_ptr<RdKafka::Message> message(consumer_->consume(timeout_ms));
+    switch (message->err()) {
+      case RdKafka::ERR_NO_ERROR:
+        messages.push_back({message->partition(),
+                            message->offset(),
+                            std::string(static_cast<const char*>(message->payload()),
+                                        message->len())});
+        break;
+      case RdKafka::ERR__TIMED_OUT:
+      case RdKafka::ERR__PARTITION_EOF:
+        return messages;
+      default:
+        throw std::runtime_error("Kafka consume failed: " + message->errstr());
+    }
+  }
+  return messages;
+}
+
+void KafkaStreamSource::commit(const StreamCheckpoint& checkpoint) {
+  std::vector<RdKafka::TopicPartition*> topic_partitions;
+  for (const auto& partition_offset : checkpoint.offsets) {
+    topic_partitions.push_back(RdKafka::TopicPartition::create(
+        topic_, partition_offset.first, partition_offset.second));
+  }
+  const auto err = consumer_->commitSync(topic_partitions);
+  RdKafka::TopicPartition::destroy(topic_partitions);
+  if (err != RdKafka::ERR_NO_ERROR) {
+    throw std::runtime_error("Kafka offset commit failed: " + RdKafka::err2str(err));
+  }
+}
+
+void KafkaStreamSource::seek(const std::map<int32_t, int64_t>& offsets) {
+  assign(offsets);
+}
+
+std::map<int32_t, int64_t> KafkaStreamSource::getStartOffsets() {
+  const int timeout_ms = 10000;
+  std::vector<RdKafka::TopicPartition*> topic_partitions;
+  for (const auto partition : partitions_) {
+    topic_partitions.push_back(RdKafka::TopicPartition::create(topic_, partition));
+  }
+  const auto err = consumer_->committed(topic_partitions, timeout_ms);
+  std::map<int32_t, int64_t> offsets;
+  for (const auto topic_partition : topic_partitions) {
+    offsets[topic_partition->partition()] = topic_partition->offset();
+  }
+  RdKafka::TopicPartition::destroy(topic_partitions);
+  if (err != RdKafka::ERR_NO_ERROR) {
+    throw std::runtime_error("Failed to read Kafka offsets of " + topic_ + ": " +
+                             RdKafka::err2str(err));
+  }
+  for (auto& partition_offset : offsets) {
+    if (partition_offset.second >= 0) {
+      continue;
+    }
+    // without a committed offset the consumer starts at the end of the partition
+    int64_t low{0};
+    int64_t high{0};
+    const auto err = consumer_->query_watermark_offsets(
+        topic_, partition_offset.first, &low, &high, timeout_ms);
+    if (err != RdKafka::ERR_NO_ERROR) {
+      throw std::runtime_error("Failed to read Kafka offsets of " + topic_ + ": " +
+                               RdKafka::err2str(err));
+    }
+    partition_offset.second = high;
+  }
+  return offsets;
+}
+
+}  // namespace Importer_NS
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file KafkaStreamSource.h
+ * @brief StreamSource consuming a set of partitions of a Kafka topic
+ *
+ * Partitions are assigned explicitly rather than through a group subscription:
+ * the offsets a StreamIngestor checkpoints with the table epoch must not move
+ * to another consumer in a rebalance.
+ */
+
+#ifndef _KAFKASTREAMSOURCE_H_
+#define _KAFKASTREAMSOURCE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "StreamIngestor.h"
+
+namespace RdKafka {
+class KafkaConsumer;
+}
+
+namespace Importer_NS {
+
+class KafkaStreamSource : public StreamSource {
+ public:
+  KafkaStreamSource(const std::string& brokers,
+                    const std::string& group_id,
+                    const std::string& topic,
+                    const std::vector<int32_t>& partitions);
+  ~KafkaStreamSource() override;
+
+  std::vector<StreamMessage> consume(const size_t max_messages,
+                                     const std::chrono::milliseconds timeout) override;
+  void commit(const StreamCheckpoint& checkpoint) override;
+  void seek(const std::map<int32_t, int64_t>& offsets) override;
+  std::map<int32_t, int64_t> getStartOffsets() override;
+
+ private:
+  void assign(const std::map<int32_t, int64_t>& offsets);
+
+  const std::string topic_;
+  const std::vector<int32_t> partitions_;
+  std::unique_ptr<RdKafka::KafkaConsumer> consumer_;
+};
+
+}  // namespace Importer_NS
+
+#endif  // _KAFKASTREAMSOURCE_H_
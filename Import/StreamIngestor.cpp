@@ -0,0 +1,209 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StreamIngestor.h"
+
+#include <glog/logging.h>
+#include <boost/filesystem.hpp>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "../Shared/measure.h"
+
+namespace Importer_NS {
+
+namespace {
+
+std::string get_checkpoint_path(const Catalog_Namespace::Catalog& catalog,
+                                 const TableDescriptor* td) {
+  return catalog.get_basePath() + "/mapd_data/DB_" +
+         std::to_string(catalog.get_currentDB().dbId) + "_TABLE_" +
+         std::to_string(td->tableId) + "_STREAM_CHECKPOINT";
+}
+
+}  // namespace
+
+StreamIngestor::StreamIngestor(Catalog_Namespace::Catalog& catalog,
+                               const TableDescriptor* td,
+                               const CopyParams& copy_params,
+                               StreamSource& source,
+                               const MicroBatchPolicy& policy)
+    : catalog_(catalog)
+    , td_(td)
+    , copy_params_(copy_params)
+    , source_(source)
+    , policy_(policy)
+    , checkpoint_path_(get_checkpoint_path(catalog, td))
+    , importer_(new Importer(catalog, td, td->tableName, copy_params)) {
+  CHECK_GT(policy_.max_rows, size_t(0));
+}
+
+StreamCheckpoint StreamIngestor::readCheckpoint(const std::string& checkpoint_path) {
+  StreamCheckpoint checkpoint;
+  std::ifstream in(checkpoint_path);
+  if (!in) {
+    return checkpoint;
+  }
+  in >> checkpoint.epoch;
+  int32_t partition;
+  int64_t offset;
+  while (in >> partition >> offset) {
+    checkpoint.offsets[partition] = offset;
+  }
+  return checkpoint;
+}
+
+void StreamIngestor::writeCheckpoint(const std::string& checkpoint_path,
+                                     const StreamCheckpoint& checkpoint) {
+  // write aside and rename, a crash must leave either the old or the new one
+  const auto tmp_path = checkpoint_path + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::trunc);
+    out << checkpoint.epoch << "\n";
+    for (const auto& partition_offset : checkpoint.offsets) {
+      out << partition_offset.first << " " << partition_offset.second << "\n";
+    }
+    out.flush();
+    if (!out) {
+      throw std::runtime_error("failed to write stream checkpoint " + tmp_path);
+    }
+  }
+  boost::filesystem::rename(tmp_path, checkpoint_path);
+}
+
+void StreamIngestor::recover() {
+  checkpoint_ = readCheckpoint(checkpoint_path_);
+  auto loader = importer_->get_loader();
+  bool new_partitions{false};
+  for (const auto& partition_offset : source_.getStartOffsets()) {
+    new_partitions |= checkpoint_.offsets.insert(partition_offset).second;
+  }
+  if (checkpoint_.epoch < 0 || new_partitions) {
+    // nothing of the new partitions has been loaded, the table is at the epoch
+    // a crash in the middle of their first batch has to go back to
+    if (checkpoint_.epoch < 0) {
+      checkpoint_.epoch = loader->getTableEpoch();
+    }
+    writeCheckpoint(checkpoint_path_, checkpoint_);
+  }
+  if (checkpoint_.epoch >= 0 && loader->getTableEpoch() > checkpoint_.epoch) {
+    // the last batch got checkpointed into the table but its offsets never
+    // became durable, so the source is going to deliver it again
+    LOG(WARNING) << "Rolling table " << td_->tableName << " back from epoch "
+                 << loader->getTableEpoch() << " to stream checkpoint epoch "
+                 << checkpoint_.epoch;
+    loader->setTableEpoch(checkpoint_.epoch);
+  }
+  if (!checkpoint_.offsets.empty()) {
+    source_.seek(checkpoint_.offsets);
+  }
+}
+
+void StreamIngestor::rollback(const int32_t start_epoch) {
+  importer_->get_loader()->setTableEpoch(start_epoch);
+  if (!checkpoint_.offsets.empty()) {
+    source_.seek(checkpoint_.offsets);
+  }
+}
+
+ImportStatus StreamIngestor::ingestMicroBatch() {
+  ImportStatus batch_status;
+  const auto batch_start = std::chrono::steady_clock::now();
+  auto next_offsets = checkpoint_.offsets;
+  std::string batch;
+  size_t row_count = 0;
+  while (row_count < policy_.max_rows && batch.size() < policy_.max_bytes) {
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - batch_start);
+    if (elapsed >= policy_.max_latency) {
+      break;
+    }
+    const auto messages =
+        source_.consume(policy_.max_rows - row_count, policy_.max_latency - elapsed);
+    for (const auto& message : messages) {
+      if (message.payload.empty()) {
+        continue;
+      }
+      batch += message.payload;
+      if (message.payload.back() != copy_params_.line_delim) {
+        batch += copy_params_.line_delim;
+      }
+      auto& next_offset = next_offsets[message.partition];
+      next_offset = std::max(next_offset, message.offset + 1);
+      ++row_count;
+    }
+  }
+  if (batch.empty()) {
+    if (next_offsets != checkpoint_.offsets) {
+      // only empty messages, nothing to load but their offsets
+      StreamCheckpoint checkpoint{next_offsets, checkpoint_.epoch};
+      source_.commit(checkpoint);
+      checkpoint_ = checkpoint;
+    }
+    return batch_status;
+  }
+
+  auto loader = importer_->get_loader();
+  const auto start_epoch = loader->getTableEpoch();
+  std::shared_ptr<char> sbuffer(new char[batch.size()], std::default_delete<char[]>());
+  memcpy(sbuffer.get(), batch.data(), batch.size());
+  auto load_ms = measure<>::execution([&]() {
+    batch_status = importer_->importDelimitedBuffer(sbuffer, batch.size());
+  });
+  if (importer_->get_load_failed() ||
+      batch_status.rows_rejected > copy_params_.max_reject) {
+    rollback(start_epoch);
+    throw std::runtime_error("Stream micro batch into " + td_->tableName +
+                             " failed, rejected " +
+                             std::to_string(batch_status.rows_rejected) + " rows");
+  }
+
+  loader->checkpoint();
+  importer_->checkpointStringDictionaries();
+  StreamCheckpoint checkpoint{next_offsets, loader->getTableEpoch()};
+  try {
+    writeCheckpoint(checkpoint_path_, checkpoint);
+  } catch (...) {
+    rollback(start_epoch);
+    throw;
+  }
+  checkpoint_ = checkpoint;
+  // the local checkpoint is authoritative, the source only gets the offsets
+  // so that its own consumer group position follows along
+  try {
+    source_.commit(checkpoint_);
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Failed to commit stream offsets of " << td_->tableName << ": "
+                 << e.what();
+  }
+
+  import_status_ += batch_status;
+  VLOG(1) << "Stream micro batch of " << row_count << " messages into "
+          << td_->tableName << ": " << batch_status.rows_completed << " rows loaded, "
+          << batch_status.rows_rejected << " rejected in " << load_ms << " ms, epoch "
+          << checkpoint_.epoch;
+  return batch_status;
+}
+
+void StreamIngestor::run(const std::atomic<bool>& stop) {
+  recover();
+  while (!stop) {
+    ingestMicroBatch();
+  }
+}
+
+}  // namespace Importer_NS
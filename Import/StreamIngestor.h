@@ -0,0 +1,118 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file StreamIngestor.h
+ * @brief Server side ingestion of message streams into a table
+ *
+ * Messages are pulled from a StreamSource in micro batches, parsed in parallel
+ * straight into the TypedImportBuffers of an Importer and checkpointed once per
+ * micro batch. The next offset of every partition is recorded together with the
+ * table epoch the batch was checkpointed at, so that a batch which got
+ * checkpointed but whose offsets did not become durable is rolled back on
+ * recovery instead of being loaded twice.
+ */
+
+#ifndef _STREAMINGESTOR_H_
+#define _STREAMINGESTOR_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Importer.h"
+
+namespace Importer_NS {
+
+struct StreamMessage {
+  int32_t partition;
+  int64_t offset;
+  std::string payload;
+};
+
+// next offset to consume for each partition along with the table epoch
+// the messages before these offsets were checkpointed at
+struct StreamCheckpoint {
+  std::map<int32_t, int64_t> offsets;
+  int32_t epoch = -1;
+};
+
+class StreamSource {
+ public:
+  virtual ~StreamSource() {}
+  // returns up to max_messages messages, blocking for at most timeout
+  virtual std::vector<StreamMessage> consume(const size_t max_messages,
+                                             const std::chrono::milliseconds timeout) = 0;
+  virtual void commit(const StreamCheckpoint& checkpoint) = 0;
+  // rewinds the partitions to the given offsets
+  virtual void seek(const std::map<int32_t, int64_t>& offsets) = 0;
+  // offsets the next consume starts from in every partition
+  virtual std::map<int32_t, int64_t> getStartOffsets() = 0;
+};
+
+struct MicroBatchPolicy {
+  size_t max_rows = 100000;
+  size_t max_bytes = 1 << 26;
+  std::chrono::milliseconds max_latency{1000};
+};
+
+class StreamIngestor {
+ public:
+  StreamIngestor(Catalog_Namespace::Catalog& catalog,
+                 const TableDescriptor* td,
+                 const CopyParams& copy_params,
+                 StreamSource& source,
+                 const MicroBatchPolicy& policy);
+
+  // brings the table back to the epoch of the last durable checkpoint
+  // and rewinds the source to the offsets recorded with it. Partitions the
+  // checkpoint doesn't know yet are recorded at the offsets the source starts
+  // from, so that even the first batch can be rolled back.
+  void recover();
+  // consumes, loads and checkpoints one micro batch
+  ImportStatus ingestMicroBatch();
+  // recovers, then ingests micro batches until stop is set
+  void run(const std::atomic<bool>& stop);
+
+  const StreamCheckpoint& get_checkpoint() const { return checkpoint_; }
+  const std::string& get_checkpoint_path() const { return checkpoint_path_; }
+  const ImportStatus& get_import_status() const { return import_status_; }
+
+  static StreamCheckpoint readCheckpoint(const std::string& checkpoint_path);
+  static void writeCheckpoint(const std::string& checkpoint_path,
+                              const StreamCheckpoint& checkpoint);
+
+ private:
+  void rollback(const int32_t start_epoch);
+
+  Catalog_Namespace::Catalog& catalog_;
+  const TableDescriptor* td_;
+  const CopyParams copy_params_;
+  StreamSource& source_;
+  const MicroBatchPolicy policy_;
+  const std::string checkpoint_path_;
+  std::unique_ptr<Importer> importer_;
+  StreamCheckpoint checkpoint_;
+  ImportStatus import_status_;
+};
+
+}  // namespace Importer_NS
+
+#endif  // _STREAMINGESTOR_H_
@@ -409,11 +409,52 @@ int main(int argc, char** argv) {
                              ->default_value(g_inner_join_fragment_skipping)
                              ->implicit_value(true),
                          "Enable/disable inner join fragment skipping.");
+  desc_adv.add_options()(
+      "late-materialization",
+      po::value<bool>(&g_enable_late_materialization)
+          ->default_value(g_enable_late_materialization)
+          ->implicit_value(true),
+      "Enable/disable fetching the lazily read columns of a projection only for the "
+      "fragments with rows passing the filter.");
+  desc_adv.add_options()(
+      "partitioned-hash-build-threshold",
+      po::value<size_t>(&g_partitioned_hash_build_threshold)
+          ->default_value(g_partitioned_hash_build_threshold),
+      "Number of rows of the inner table of a perfect hash join from which its CPU "
+      "hash table is built in cache-sized partitions. Only the build is partitioned, "
+      "the probes and the layout of the table stay the same.");
   desc_adv.add_options()("disable-shared-mem-group-by",
                          po::value<bool>(&g_enable_smem_group_by)
                              ->default_value(g_enable_smem_group_by)
                              ->implicit_value(false),
                          "Enable/disable using GPU shared memory for GROUP BY.");
+  desc_adv.add_options()(
+      "reduction-spill-threshold",
+      po::value<size_t>(&g_reduction_spill_threshold)
+          ->default_value(g_reduction_spill_threshold),
+      "Size in bytes of a merged GROUP BY buffer above which the reduction spills "
+      "partitions to the data directory, 0 to never spill. Defaults to a quarter of "
+      "the physical memory.");
+  desc_adv.add_options()(
+      "result-cache-size",
+      po::value<size_t>(&g_result_cache_size)->default_value(g_result_cache_size),
+      "Size in bytes of the cache of query results, keyed by query plan and table "
+      "epochs, 0 to disable.");
+  desc_adv.add_options()(
+      "cursor-memory-budget",
+      po::value<size_t>(&g_cursor_memory_budget)->default_value(g_cursor_memory_budget),
+      "Size in bytes of the query results server-side cursors keep open, 0 to disable "
+      "cursors.");
+  desc_adv.add_options()(
+      "cursor-ttl",
+      po::value<size_t>(&g_cursor_ttl_seconds)->default_value(g_cursor_ttl_seconds),
+      "Seconds a cursor stays open without being fetched from.");
+  desc_adv.add_options()(
+      "subquery-result-cache-entries",
+      po::value<size_t>(&g_subquery_result_cache_entries)
+          ->default_value(g_subquery_result_cache_entries),
+      "Number of small uncorrelated subquery results reused across queries until "
+      "their input tables change, 0 to disable.");
   desc_adv.add_options()(
       "idle-session-duration",
       po::value<int>(&idle_session_duration)->default_value(idle_session_duration),
@@ -23,6 +23,9 @@
 std::vector<std::pair<BaselineJoinHashTable::HashTableCacheKey,
                       BaselineJoinHashTable::HashTableCacheValue>>
     BaselineJoinHashTable::hash_table_cache_;
+std::vector<std::pair<BaselineJoinHashTable::HashTableCacheKey,
+                      std::shared_ptr<const RuntimeJoinFilter>>>
+    BaselineJoinHashTable::runtime_filter_cache_;
 std::mutex BaselineJoinHashTable::hash_table_cache_mutex_;
 
 namespace {
@@ -229,6 +232,73 @@ void BaselineJoinHashTable::reify(const int device_count) {
                        JoinHashTableInterface::HashType::OneToMany);
     reifyWithLayout(device_count, JoinHashTableInterface::HashType::OneToMany);
   }
+  const auto& query_info = get_inner_query_info(getInnerTableId(), query_infos_).info;
+  buildRuntimeFilters(query_info.fragments);
+}
+
+void BaselineJoinHashTable::buildRuntimeFilters(
+    const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments) {
+  if (fragments.empty()) {
+    return;
+  }
+  const auto inner_outer_pairs = normalize_column_pairs(
+      condition_.get(), *executor_->getCatalog(), executor_->getTemporaryTables());
+  const auto composite_key_info = get_composite_key_info(inner_outer_pairs, executor_);
+  size_t num_elements = 0;
+  for (const auto& fragment : fragments) {
+    num_elements += fragment.getNumTuples();
+  }
+  for (size_t i = 0; i < inner_outer_pairs.size(); ++i) {
+    const auto inner_col = inner_outer_pairs[i].first;
+    auto outer_col = get_runtime_filter_outer_col(
+        inner_col, inner_outer_pairs[i].second, condition_->get_optype());
+    if (!outer_col) {
+      continue;
+    }
+    // Keyed like the hash tables, but on this key component alone so that other
+    // joins on the same inner column find it too.
+    const HashTableCacheKey cache_key{
+        num_elements, {composite_key_info.cache_key_chunks[i]}, condition_->get_optype()};
+    auto cached_filter = getRuntimeFilterFromCache(cache_key);
+    if (cached_filter) {
+      runtime_filters_.push_back({outer_col, cached_filter});
+      runtime_filter_key_components_.push_back(i);
+      continue;
+    }
+    // The filter is only used on the host, fetch the keys there even if the hash
+    // table lives on the GPU.
+    std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks_owner;
+    const int8_t* col_buff = nullptr;
+    size_t elem_count = 0;
+    if (fragments.size() > 1) {
+      std::tie(col_buff, elem_count) =
+          getAllColumnFragments(*inner_col, fragments, chunks_owner);
+    } else {
+      std::tie(col_buff, elem_count) =
+          Executor::ExecutionDispatch::getColumnFragment(executor_,
+                                                         *inner_col,
+                                                         fragments.front(),
+                                                         Data_Namespace::CPU_LEVEL,
+                                                         0,
+                                                         chunks_owner,
+                                                         column_cache_);
+    }
+    const auto& ti = inner_col->get_type_info();
+    const JoinColumnTypeInfo type_info{static_cast<size_t>(ti.get_size()),
+                                       0,
+                                       inline_fixed_encoding_null_val(ti),
+                                       false,
+                                       0,
+                                       is_unsigned_type(ti)};
+    const JoinColumn join_column{col_buff, elem_count};
+    const auto filter =
+        std::make_shared<const RuntimeJoinFilter>(join_column, type_info, cpu_threads());
+    if (getInnerTableId() > 0) {
+      putRuntimeFilterToCache(cache_key, filter);
+    }
+    runtime_filters_.push_back({outer_col, filter});
+    runtime_filter_key_components_.push_back(i);
+  }
 }
 
 namespace {
@@ -1001,10 +1071,12 @@ llvm::Value* BaselineJoinHashTable::codegenSlot(const CompilationOptions& co,
   const auto key_ptr_lv =
       LL_BUILDER.CreatePointerCast(key_buff_lv, llvm::Type::getInt8PtrTy(LL_CONTEXT));
   const auto key_size_lv = LL_INT(inner_outer_pairs.size() * key_component_width);
-  return executor_->cgen_state_->emitExternalCall(
-      "baseline_hash_join_idx_" + std::to_string(key_component_width * 8),
-      get_int_type(64, LL_CONTEXT),
-      {hash_ptr, key_ptr_lv, key_size_lv, LL_INT(entry_count_)});
+  return codegenRuntimeFilterProbe(key_buff_lv, [&]() {
+    return executor_->cgen_state_->emitExternalCall(
+        "baseline_hash_join_idx_" + std::to_string(key_component_width * 8),
+        get_int_type(64, LL_CONTEXT),
+        {hash_ptr, key_ptr_lv, key_size_lv, LL_INT(entry_count_)});
+  });
 }
 
 HashJoinMatchingSet BaselineJoinHashTable::codegenMatchingSet(
@@ -1024,13 +1096,15 @@ HashJoinMatchingSet BaselineJoinHashTable::codegenMatchingSet(
           ? LL_BUILDER.CreatePointerCast(hash_ptr, composite_dict_ptr_type)
           : LL_BUILDER.CreateIntToPtr(hash_ptr, composite_dict_ptr_type);
   const auto key_component_count = inner_outer_pairs.size();
-  const auto key = executor_->cgen_state_->emitExternalCall(
-      "get_composite_key_index_" + std::to_string(key_component_width * 8),
-      get_int_type(64, LL_CONTEXT),
-      {key_buff_lv,
-       LL_INT(key_component_count),
-       composite_key_dict,
-       LL_INT(entry_count_)});
+  const auto key = codegenRuntimeFilterProbe(key_buff_lv, [&]() {
+    return executor_->cgen_state_->emitExternalCall(
+        "get_composite_key_index_" + std::to_string(key_component_width * 8),
+        get_int_type(64, LL_CONTEXT),
+        {key_buff_lv,
+         LL_INT(key_component_count),
+         composite_key_dict,
+         LL_INT(entry_count_)});
+  });
   auto one_to_many_ptr = hash_ptr;
   if (one_to_many_ptr->getType()->isPointerTy()) {
     one_to_many_ptr =
@@ -1083,6 +1157,45 @@ llvm::Value* BaselineJoinHashTable::codegenKey(const CompilationOptions& co) {
   return key_buff_lv;
 }
 
+// Skips the probe of the hash table when a key component is outside the range of
+// the build side keys and yields -1, the index of a missing key, instead.
+llvm::Value* BaselineJoinHashTable::codegenRuntimeFilterProbe(
+    llvm::Value* key_buff_lv,
+    const std::function<llvm::Value*()>& probe) {
+  llvm::Value* in_range_lv{nullptr};
+  for (size_t i = 0; i < runtime_filters_.size(); ++i) {
+    const auto& filter = runtime_filters_[i].filter;
+    const auto key_comp_lv = LL_BUILDER.CreateSExt(
+        LL_BUILDER.CreateLoad(
+            LL_BUILDER.CreateGEP(key_buff_lv, LL_INT(runtime_filter_key_components_[i]))),
+        get_int_type(64, LL_CONTEXT));
+    const auto key_comp_in_range_lv = LL_BUILDER.CreateAnd(
+        LL_BUILDER.CreateICmpSGE(key_comp_lv, LL_INT(filter->getMin())),
+        LL_BUILDER.CreateICmpSLE(key_comp_lv, LL_INT(filter->getMax())));
+    in_range_lv = in_range_lv ? LL_BUILDER.CreateAnd(in_range_lv, key_comp_in_range_lv)
+                              : key_comp_in_range_lv;
+  }
+  if (!in_range_lv) {
+    return probe();
+  }
+  const auto out_of_range_bb = LL_BUILDER.GetInsertBlock();
+  const auto parent_func = out_of_range_bb->getParent();
+  const auto probe_bb =
+      llvm::BasicBlock::Create(LL_CONTEXT, "runtime_filter_probe", parent_func);
+  const auto probe_done_bb =
+      llvm::BasicBlock::Create(LL_CONTEXT, "runtime_filter_probe_done", parent_func);
+  LL_BUILDER.CreateCondBr(in_range_lv, probe_bb, probe_done_bb);
+  LL_BUILDER.SetInsertPoint(probe_bb);
+  const auto probe_lv = probe();
+  const auto probe_end_bb = LL_BUILDER.GetInsertBlock();
+  LL_BUILDER.CreateBr(probe_done_bb);
+  LL_BUILDER.SetInsertPoint(probe_done_bb);
+  auto slot_lv = LL_BUILDER.CreatePHI(probe_lv->getType(), 2);
+  slot_lv->addIncoming(probe_lv, probe_end_bb);
+  slot_lv->addIncoming(LL_INT(int64_t(-1)), out_of_range_bb);
+  return slot_lv;
+}
+
 llvm::Value* BaselineJoinHashTable::codegenOneToManySlot(
     const CompilationOptions& co,
     const size_t index,
@@ -1216,6 +1329,29 @@ ssize_t BaselineJoinHashTable::getApproximateTupleCountFromCache(
   return -1;
 }
 
+std::shared_ptr<const RuntimeJoinFilter> BaselineJoinHashTable::getRuntimeFilterFromCache(
+    const HashTableCacheKey& key) const {
+  std::lock_guard<std::mutex> hash_table_cache_lock(hash_table_cache_mutex_);
+  for (const auto& kv : runtime_filter_cache_) {
+    if (kv.first == key) {
+      return kv.second;
+    }
+  }
+  return nullptr;
+}
+
+void BaselineJoinHashTable::putRuntimeFilterToCache(
+    const HashTableCacheKey& key,
+    const std::shared_ptr<const RuntimeJoinFilter>& filter) {
+  std::lock_guard<std::mutex> hash_table_cache_lock(hash_table_cache_mutex_);
+  for (const auto& kv : runtime_filter_cache_) {
+    if (kv.first == key) {
+      return;
+    }
+  }
+  runtime_filter_cache_.emplace_back(key, filter);
+}
+
 bool BaselineJoinHashTable::isBitwiseEq() const {
   return condition_->get_optype() == kBW_EQ;
 }
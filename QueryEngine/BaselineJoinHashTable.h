@@ -27,6 +27,7 @@
 #include <cuda.h>
 #endif
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <mutex>
 #include <thread>
@@ -66,10 +67,16 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
 
   JoinHashTableInterface::HashType getHashType() const noexcept override;
 
+  const std::vector<OuterColumnRuntimeFilter>& getRuntimeFilters() const
+      noexcept override {
+    return runtime_filters_;
+  }
+
   static auto yieldCacheInvalidator() -> std::function<void()> {
     return []() -> void {
       std::lock_guard<std::mutex> guard(hash_table_cache_mutex_);
       hash_table_cache_.clear();
+      runtime_filter_cache_.clear();
     };
   }
 
@@ -120,6 +127,9 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
 
   void checkHashJoinReplicationConstraint(const int table_id) const;
 
+  void buildRuntimeFilters(
+      const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments);
+
   int initHashTableForDevice(const std::vector<JoinColumn>& join_columns,
                              const std::vector<JoinColumnTypeInfo>& join_column_types,
                              const JoinHashTableInterface::HashType layout,
@@ -147,6 +157,9 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
 
   llvm::Value* codegenKey(const CompilationOptions&);
 
+  llvm::Value* codegenRuntimeFilterProbe(llvm::Value* key_buff_lv,
+                                         const std::function<llvm::Value*()>& probe);
+
   struct HashTableCacheKey {
     const size_t num_elements;
     const std::vector<ChunkKey> chunk_keys;
@@ -164,6 +177,12 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
 
   ssize_t getApproximateTupleCountFromCache(const HashTableCacheKey&) const;
 
+  std::shared_ptr<const RuntimeJoinFilter> getRuntimeFilterFromCache(
+      const HashTableCacheKey&) const;
+
+  void putRuntimeFilterToCache(const HashTableCacheKey&,
+                               const std::shared_ptr<const RuntimeJoinFilter>&);
+
   bool isBitwiseEq() const;
 
   const std::shared_ptr<Analyzer::BinOper> condition_;
@@ -184,6 +203,9 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
   std::mutex linearized_multifrag_column_mutex_;
   RowSetMemoryOwner linearized_multifrag_column_owner_;
   JoinHashTableInterface::HashType layout_;
+  std::vector<OuterColumnRuntimeFilter> runtime_filters_;
+  // key component of each runtime filter
+  std::vector<size_t> runtime_filter_key_components_;
 
   struct HashTableCacheValue {
     const std::shared_ptr<std::vector<int8_t>> buffer;
@@ -192,6 +214,10 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
   };
 
   static std::vector<std::pair<HashTableCacheKey, HashTableCacheValue>> hash_table_cache_;
+  // filters of single key components, guarded by hash_table_cache_mutex_ as well
+  static std::vector<
+      std::pair<HashTableCacheKey, std::shared_ptr<const RuntimeJoinFilter>>>
+      runtime_filter_cache_;
   static std::mutex hash_table_cache_mutex_;
 
   static const int ERR_FAILED_TO_FETCH_COLUMN{-3};
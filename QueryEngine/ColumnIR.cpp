@@ -500,7 +500,11 @@ llvm::Value* Executor::posArg(const Analyzer::Expr* expr) const {
 
 const Analyzer::ColumnVar* Executor::hashJoinLhs(const Analyzer::ColumnVar* rhs) const {
   for (const auto tautological_eq : plan_state_->join_info_.equi_join_tautologies_) {
-    CHECK(IS_EQUIVALENCE(tautological_eq->get_optype()));
+    // Range join tables bound the inner column, they don't make it equal to another,
+    // and spatial join tables have no tautology.
+    if (!tautological_eq || !IS_EQUIVALENCE(tautological_eq->get_optype())) {
+      continue;
+    }
     if (dynamic_cast<const Analyzer::ExpressionTuple*>(
             tautological_eq->get_left_operand())) {
       auto lhs_col = hashJoinLhsTuple(rhs, tautological_eq.get());
@@ -19,6 +19,7 @@
 #include "../Shared/thread_count.h"
 
 #include <atomic>
+#include <functional>
 #include <future>
 #include <numeric>
 
@@ -44,7 +45,9 @@ ColumnarResults::ColumnarResults(
     const size_t num_columns,
     const std::vector<SQLTypeInfo>& target_types)
     : column_buffers_(num_columns)
-    , num_rows_(use_parallel_algorithms(rows) ? rows.entryCount() : rows.rowCount())
+    , num_rows_(use_parallel_algorithms(rows) || rows.isDirectColumnarConversionPossible()
+                    ? rows.entryCount()
+                    : rows.rowCount())
     , target_types_(target_types) {
   column_buffers_.resize(num_columns);
   for (size_t i = 0; i < num_columns; ++i) {
@@ -59,51 +62,18 @@ ColumnarResults::ColumnarResults(
         checked_malloc(num_rows_ * target_types[i].get_size()));
     row_set_mem_owner->addColBuffer(column_buffers_[i]);
   }
+  if (rows.isDirectColumnarConversionPossible()) {
+    materializeAllColumnsDirectly(rows, num_columns);
+    return;
+  }
   std::atomic<size_t> row_idx{0};
-  const auto do_work = [num_columns, &target_types, this](
-                           const std::vector<TargetValue>& crt_row,
-                           const size_t row_idx) {
+  const auto do_work = [num_columns, this](const std::vector<TargetValue>& crt_row,
+                                           const size_t row_idx) {
     for (size_t i = 0; i < num_columns; ++i) {
       const auto col_val = crt_row[i];
       const auto scalar_col_val = boost::get<ScalarTargetValue>(&col_val);
       CHECK(scalar_col_val);
-      auto i64_p = boost::get<int64_t>(scalar_col_val);
-      const auto& type_info = target_types[i];
-      if (i64_p) {
-        const auto val = fixed_encoding_nullable_val(*i64_p, type_info);
-        switch (target_types[i].get_size()) {
-          case 1:
-            ((int8_t*)column_buffers_[i])[row_idx] = static_cast<int8_t>(val);
-            break;
-          case 2:
-            ((int16_t*)column_buffers_[i])[row_idx] = static_cast<int16_t>(val);
-            break;
-          case 4:
-            ((int32_t*)column_buffers_[i])[row_idx] = static_cast<int32_t>(val);
-            break;
-          case 8:
-            ((int64_t*)column_buffers_[i])[row_idx] = val;
-            break;
-          default:
-            CHECK(false);
-        }
-      } else {
-        CHECK(target_types[i].is_fp());
-        switch (target_types[i].get_type()) {
-          case kFLOAT: {
-            auto float_p = boost::get<float>(scalar_col_val);
-            ((float*)column_buffers_[i])[row_idx] = static_cast<float>(*float_p);
-            break;
-          }
-          case kDOUBLE: {
-            auto double_p = boost::get<double>(scalar_col_val);
-            ((double*)column_buffers_[i])[row_idx] = static_cast<double>(*double_p);
-            break;
-          }
-          default:
-            CHECK(false);
-        }
-      }
+      writeBackCell(*scalar_col_val, row_idx, i);
     }
   };
   if (use_parallel_algorithms(rows)) {
@@ -150,6 +120,110 @@ ColumnarResults::ColumnarResults(
   rows.moveToBegin();
 }
 
+void ColumnarResults::writeBackCell(const ScalarTargetValue& col_val,
+                                    const size_t row_idx,
+                                    const size_t column_idx) {
+  const auto& type_info = target_types_[column_idx];
+  auto i64_p = boost::get<int64_t>(&col_val);
+  if (i64_p) {
+    const auto val = fixed_encoding_nullable_val(*i64_p, type_info);
+    switch (type_info.get_size()) {
+      case 1:
+        ((int8_t*)column_buffers_[column_idx])[row_idx] = static_cast<int8_t>(val);
+        break;
+      case 2:
+        ((int16_t*)column_buffers_[column_idx])[row_idx] = static_cast<int16_t>(val);
+        break;
+      case 4:
+        ((int32_t*)column_buffers_[column_idx])[row_idx] = static_cast<int32_t>(val);
+        break;
+      case 8:
+        ((int64_t*)column_buffers_[column_idx])[row_idx] = val;
+        break;
+      default:
+        CHECK(false);
+    }
+  } else {
+    CHECK(type_info.is_fp());
+    switch (type_info.get_type()) {
+      case kFLOAT: {
+        auto float_p = boost::get<float>(&col_val);
+        ((float*)column_buffers_[column_idx])[row_idx] = static_cast<float>(*float_p);
+        break;
+      }
+      case kDOUBLE: {
+        auto double_p = boost::get<double>(&col_val);
+        ((double*)column_buffers_[column_idx])[row_idx] = static_cast<double>(*double_p);
+        break;
+      }
+      default:
+        CHECK(false);
+    }
+  }
+}
+
+// Reads the columns of a projection target by target instead of building a row
+// for every entry. The non-empty entries of every chunk are counted first, which
+// tells each chunk where its rows go and keeps them in entry order.
+void ColumnarResults::materializeAllColumnsDirectly(const ResultSet& rows,
+                                                    const size_t num_columns) {
+  const auto entry_count = rows.entryCount();
+  const size_t worker_count = use_parallel_algorithms(rows) ? cpu_threads() : 1;
+  const size_t stride = (entry_count + worker_count - 1) / worker_count;
+  const size_t chunk_count = stride ? (entry_count + stride - 1) / stride : 0;
+  const auto run_chunks = [chunk_count, stride, entry_count](
+                              const std::function<void(size_t, size_t, size_t)>& work) {
+    if (chunk_count <= 1) {
+      if (chunk_count) {
+        work(0, 0, entry_count);
+      }
+      return;
+    }
+    std::vector<std::future<void>> chunk_threads;
+    for (size_t chunk_idx = 0; chunk_idx < chunk_count; ++chunk_idx) {
+      const auto start_entry = chunk_idx * stride;
+      const auto end_entry = std::min(start_entry + stride, entry_count);
+      chunk_threads.push_back(
+          std::async(std::launch::async, work, chunk_idx, start_entry, end_entry));
+    }
+    for (auto& child : chunk_threads) {
+      child.wait();
+    }
+    for (auto& child : chunk_threads) {
+      child.get();
+    }
+  };
+  std::vector<size_t> chunk_row_offsets(chunk_count + 1, 0);
+  run_chunks([&rows, &chunk_row_offsets](
+                 const size_t chunk_idx, const size_t start, const size_t end) {
+    size_t non_empty_count{0};
+    for (size_t i = start; i < end; ++i) {
+      if (!rows.isRowAtEmpty(i)) {
+        ++non_empty_count;
+      }
+    }
+    chunk_row_offsets[chunk_idx + 1] = non_empty_count;
+  });
+  std::partial_sum(
+      chunk_row_offsets.begin(), chunk_row_offsets.end(), chunk_row_offsets.begin());
+  run_chunks([this, &rows, &chunk_row_offsets, num_columns](
+                 const size_t chunk_idx, const size_t start, const size_t end) {
+    auto row_idx = chunk_row_offsets[chunk_idx];
+    for (size_t i = start; i < end; ++i) {
+      if (rows.isRowAtEmpty(i)) {
+        continue;
+      }
+      for (size_t col_idx = 0; col_idx < num_columns; ++col_idx) {
+        writeBackCell(rows.getColumnValueNoTranslations(i, col_idx), row_idx, col_idx);
+      }
+      ++row_idx;
+    }
+    CHECK_EQ(chunk_row_offsets[chunk_idx + 1], row_idx);
+  });
+  num_rows_ = chunk_row_offsets.back();
+  rows.setCachedRowCount(num_rows_);
+}
+
 ColumnarResults::ColumnarResults(
     const std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
     const IteratorTable& table,
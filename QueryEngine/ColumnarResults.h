@@ -88,6 +88,11 @@ class ColumnarResults {
   ColumnarResults(const size_t num_rows, const std::vector<SQLTypeInfo>& target_types)
       : num_rows_(num_rows), target_types_(target_types) {}
 
+  void writeBackCell(const ScalarTargetValue& col_val,
+                     const size_t row_idx,
+                     const size_t column_idx);
+  void materializeAllColumnsDirectly(const ResultSet& rows, const size_t num_columns);
+
   std::vector<const int8_t*> column_buffers_;
   size_t num_rows_;
   const std::vector<SQLTypeInfo> target_types_;
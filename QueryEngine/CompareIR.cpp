@@ -184,7 +184,8 @@ llvm::Value* Executor::codegenCmp(const Analyzer::BinOper* bin_oper,
                                   const CompilationOptions& co) {
   for (size_t i = 0; i < plan_state_->join_info_.equi_join_tautologies_.size(); ++i) {
     const auto& equi_join_tautology = plan_state_->join_info_.equi_join_tautologies_[i];
-    if (*equi_join_tautology == *bin_oper) {
+    // Spatial join tables only narrow down the candidates, they have no tautology.
+    if (equi_join_tautology && *equi_join_tautology == *bin_oper) {
       return plan_state_->join_info_.join_hash_tables_[i]->codegenSlotIsValid(co, i);
     }
   }
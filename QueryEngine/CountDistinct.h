@@ -26,10 +26,11 @@
 #define QUERYENGINE_COUNTDISTINCT_H
 
 #include "CountDistinctDescriptor.h"
+#include "CountDistinctSet.h"
 #include "HyperLogLog.h"
+#include "SparseHyperLogLog.h"
 
 #include <bitset>
-#include <set>
 #include <vector>
 
 typedef std::vector<CountDistinctDescriptor> CountDistinctDescriptors;
@@ -93,8 +94,12 @@ inline int64_t count_distinct_set_size(
     }
     return bitmap_set_size(set_vals, count_distinct_desc.bitmapSizeBytes());
   }
-  CHECK(count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet);
-  return reinterpret_cast<std::set<int64_t>*>(set_handle)->size();
+  if (count_distinct_desc.impl_type_ == CountDistinctImplType::SparseHll) {
+    return hll_size(*reinterpret_cast<const SparseHyperLogLog*>(set_handle),
+                    count_distinct_desc.bitmap_sz_bits);
+  }
+  CHECK(count_distinct_desc.impl_type_ == CountDistinctImplType::Set);
+  return reinterpret_cast<CountDistinctSet*>(set_handle)->size();
 }
 
 inline void count_distinct_set_union(
@@ -141,12 +146,19 @@ inline void count_distinct_set_union(
                                       : old_count_distinct_desc.bitmapPaddedSizeBytes();
       bitmap_set_union(new_set, old_set, bitmap_byte_sz);
     }
+  } else if (new_count_distinct_desc.impl_type_ == CountDistinctImplType::SparseHll) {
+    CHECK(old_count_distinct_desc.impl_type_ == CountDistinctImplType::SparseHll);
+    CHECK_EQ(new_count_distinct_desc.bitmap_sz_bits, old_count_distinct_desc.bitmap_sz_bits);
+    auto old_set = reinterpret_cast<SparseHyperLogLog*>(old_set_handle);
+    auto new_set = reinterpret_cast<SparseHyperLogLog*>(new_set_handle);
+    new_set->unite(*old_set, new_count_distinct_desc.bitmap_sz_bits);
+    *old_set = *new_set;
   } else {
-    CHECK(old_count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet);
-    auto old_set = reinterpret_cast<std::set<int64_t>*>(old_set_handle);
-    auto new_set = reinterpret_cast<std::set<int64_t>*>(new_set_handle);
-    new_set->insert(old_set->begin(), old_set->end());
-    old_set->insert(new_set->begin(), new_set->end());
+    CHECK(old_count_distinct_desc.impl_type_ == CountDistinctImplType::Set);
+    auto old_set = reinterpret_cast<CountDistinctSet*>(old_set_handle);
+    auto new_set = reinterpret_cast<CountDistinctSet*>(new_set_handle);
+    new_set->unite(*old_set);
+    *old_set = *new_set;
   }
 }
 
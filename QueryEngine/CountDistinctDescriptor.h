@@ -39,7 +39,9 @@ inline size_t bitmap_bits_to_bytes(const size_t bitmap_sz) {
   return bitmap_byte_sz;
 }
 
-enum class CountDistinctImplType { Invalid, Bitmap, StdSet };
+// SparseHll holds the registers of an APPROX_COUNT_DISTINCT as a SparseHyperLogLog,
+// Bitmap as a dense array.
+enum class CountDistinctImplType { Invalid, Bitmap, Set, SparseHll };
 
 struct CountDistinctDescriptor {
   CountDistinctImplType impl_type_;
@@ -0,0 +1,380 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    CountDistinctSet.h
+ * @brief   Exact COUNT(DISTINCT) set for arguments whose range is too large for a
+ *          bitmap.
+ *
+ * The set starts as a sorted vector, turns into an open addressing hash set once
+ * it outgrows it and, when the values turn out to be clustered, into a roaring
+ * style compressed bitmap: values are split into containers by their upper 48 bits
+ * and each container holds the lower 16 bits either as a sorted array or, once
+ * dense, as a 2^16 bit bitmap. Compressed sets are unified container by container.
+ *
+ * Included by the runtime functions, which get compiled to bitcode as C++11 and
+ * without glog, keep it that way.
+ */
+
+#ifndef QUERYENGINE_COUNTDISTINCTSET_H
+#define QUERYENGINE_COUNTDISTINCTSET_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class CountDistinctSet {
+ public:
+  enum class Impl { SortedVector, HashSet, Compressed };
+
+  CountDistinctSet() : impl_(Impl::SortedVector), size_(0), has_empty_key_(false) {}
+
+  CountDistinctSet(const CountDistinctSet& that)
+      : values_(that.values_)
+      , impl_(that.impl_)
+      , size_(that.size_)
+      , has_empty_key_(that.has_empty_key_)
+      , containers_(that.containers_ ? new ContainerMap(*that.containers_) : nullptr) {}
+
+  CountDistinctSet& operator=(const CountDistinctSet& that) {
+    if (this != &that) {
+      CountDistinctSet copy(that);
+      swap(copy);
+    }
+    return *this;
+  }
+
+  void insert(const int64_t val) {
+    switch (impl_) {
+      case Impl::SortedVector:
+        insertSorted(val);
+        break;
+      case Impl::HashSet:
+        insertHashed(val);
+        break;
+      case Impl::Compressed:
+        insertCompressed(val);
+        break;
+    }
+  }
+
+  size_t size() const { return size_; }
+
+  Impl getImpl() const { return impl_; }
+
+  void unite(const CountDistinctSet& that) {
+    if (this == &that || !that.size_) {
+      return;
+    }
+    if (impl_ == Impl::Compressed && that.impl_ == Impl::Compressed) {
+      for (const auto& kv : *that.containers_) {
+        auto& container = (*containers_)[kv.first];
+        size_ -= container.cardinality;
+        container.unite(kv.second);
+        size_ += container.cardinality;
+      }
+      return;
+    }
+    if (that.impl_ == Impl::Compressed && that.size_ >= size_) {
+      // add the values of the smaller set to a copy of the compressed one
+      CountDistinctSet united(that);
+      forEach([&united](const int64_t val) { united.insert(val); });
+      swap(united);
+      return;
+    }
+    if (impl_ == Impl::SortedVector && that.impl_ == Impl::SortedVector) {
+      std::vector<int64_t> united;
+      united.reserve(values_.size() + that.values_.size());
+      std::set_union(values_.begin(),
+                     values_.end(),
+                     that.values_.begin(),
+                     that.values_.end(),
+                     std::back_inserter(united));
+      if (united.size() <= max_sorted_vector_size) {
+        values_.swap(united);
+        size_ = values_.size();
+        return;
+      }
+    }
+    that.forEach([this](const int64_t val) { insert(val); });
+  }
+
+  template <class FUNC>
+  void forEach(FUNC func) const {
+    switch (impl_) {
+      case Impl::SortedVector:
+        for (const auto val : values_) {
+          func(val);
+        }
+        break;
+      case Impl::HashSet:
+        for (const auto val : values_) {
+          if (val != empty_key()) {
+            func(val);
+          }
+        }
+        if (has_empty_key_) {
+          func(empty_key());
+        }
+        break;
+      case Impl::Compressed:
+        for (const auto& kv : *containers_) {
+          kv.second.forEach(kv.first, func);
+        }
+        break;
+    }
+  }
+
+  void swap(CountDistinctSet& that) {
+    values_.swap(that.values_);
+    std::swap(impl_, that.impl_);
+    std::swap(size_, that.size_);
+    std::swap(has_empty_key_, that.has_empty_key_);
+    containers_.swap(that.containers_);
+  }
+
+  static const size_t max_sorted_vector_size{64};
+  // The hash set only gets compressed once it is this big and its values share a
+  // container with at least min_values_per_container others on average.
+  static const size_t min_compressed_size{1 << 16};
+  static const size_t min_values_per_container{16};
+
+ private:
+  struct Container {
+    Container() : cardinality(0) {}
+
+    bool insert(const uint16_t low) {
+      if (!bitmap.empty()) {
+        auto& word = bitmap[low >> 6];
+        const uint64_t bit = uint64_t(1) << (low & 63);
+        if (word & bit) {
+          return false;
+        }
+        word |= bit;
+        ++cardinality;
+        return true;
+      }
+      auto it = std::lower_bound(array.begin(), array.end(), low);
+      if (it != array.end() && *it == low) {
+        return false;
+      }
+      if (array.size() < max_array_size) {
+        array.insert(it, low);
+        ++cardinality;
+        return true;
+      }
+      toBitmap();
+      return insert(low);
+    }
+
+    void unite(const Container& that) {
+      if (!that.bitmap.empty()) {
+        if (bitmap.empty()) {
+          toBitmap();
+        }
+        cardinality = 0;
+        for (size_t i = 0; i < bitmap_word_count; ++i) {
+          bitmap[i] |= that.bitmap[i];
+          cardinality += __builtin_popcountll(bitmap[i]);
+        }
+        return;
+      }
+      if (!bitmap.empty()) {
+        for (const auto low : that.array) {
+          insert(low);
+        }
+        return;
+      }
+      std::vector<uint16_t> united;
+      united.reserve(array.size() + that.array.size());
+      std::set_union(array.begin(),
+                     array.end(),
+                     that.array.begin(),
+                     that.array.end(),
+                     std::back_inserter(united));
+      array.swap(united);
+      cardinality = array.size();
+      if (array.size() > max_array_size) {
+        toBitmap();
+      }
+    }
+
+    void toBitmap() {
+      bitmap.assign(bitmap_word_count, 0);
+      for (const auto low : array) {
+        bitmap[low >> 6] |= uint64_t(1) << (low & 63);
+      }
+      std::vector<uint16_t>().swap(array);
+    }
+
+    template <class FUNC>
+    void forEach(const int64_t high, FUNC& func) const {
+      const auto base = static_cast<uint64_t>(high) << 16;
+      if (bitmap.empty()) {
+        for (const auto low : array) {
+          func(static_cast<int64_t>(base | low));
+        }
+        return;
+      }
+      for (size_t i = 0; i < bitmap_word_count; ++i) {
+        for (auto word = bitmap[i]; word; word &= word - 1) {
+          const uint64_t low = (i << 6) + __builtin_ctzll(word);
+          func(static_cast<int64_t>(base | low));
+        }
+      }
+    }
+
+    // past this size the bitmap is smaller than the sorted array
+    static const size_t max_array_size{4096};
+    static const size_t bitmap_word_count{(1 << 16) / 64};
+
+    size_t cardinality;
+    std::vector<uint16_t> array;
+    std::vector<uint64_t> bitmap;
+  };
+
+  using ContainerMap = std::unordered_map<int64_t, Container>;
+
+  static int64_t high_bits(const int64_t val) { return val >> 16; }
+
+  static uint16_t low_bits(const int64_t val) {
+    return static_cast<uint16_t>(static_cast<uint64_t>(val) & 0xffff);
+  }
+
+  // marks the free hash set slots
+  static constexpr int64_t empty_key() { return std::numeric_limits<int64_t>::min(); }
+
+  static uint64_t hash(const int64_t val) {
+    auto h = static_cast<uint64_t>(val);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  void insertSorted(const int64_t val) {
+    auto it = std::lower_bound(values_.begin(), values_.end(), val);
+    if (it != values_.end() && *it == val) {
+      return;
+    }
+    if (values_.size() < max_sorted_vector_size) {
+      values_.insert(it, val);
+      ++size_;
+      return;
+    }
+    std::vector<int64_t> sorted_values;
+    sorted_values.swap(values_);
+    values_.assign(initial_hash_set_capacity, empty_key());
+    impl_ = Impl::HashSet;
+    size_ = 0;
+    for (const auto sorted_val : sorted_values) {
+      insertHashed(sorted_val);
+    }
+    insertHashed(val);
+  }
+
+  void insertHashed(const int64_t val) {
+    if (val == empty_key()) {
+      if (!has_empty_key_) {
+        has_empty_key_ = true;
+        ++size_;
+      }
+      return;
+    }
+    if (!placeHashed(val)) {
+      return;
+    }
+    ++size_;
+    if (2 * size_ > values_.size()) {
+      growHashSet();
+    }
+  }
+
+  // returns false if the value was already there
+  bool placeHashed(const int64_t val) {
+    const auto mask = values_.size() - 1;
+    for (auto slot = hash(val) & mask;; slot = (slot + 1) & mask) {
+      if (values_[slot] == val) {
+        return false;
+      }
+      if (values_[slot] == empty_key()) {
+        values_[slot] = val;
+        return true;
+      }
+    }
+  }
+
+  void growHashSet() {
+    if (size_ >= min_compressed_size && isClustered()) {
+      compress();
+      return;
+    }
+    std::vector<int64_t> old_values(2 * values_.size(), empty_key());
+    old_values.swap(values_);
+    for (const auto val : old_values) {
+      if (val != empty_key()) {
+        placeHashed(val);
+      }
+    }
+  }
+
+  bool isClustered() const {
+    std::vector<int64_t> high_keys;
+    high_keys.reserve(size_);
+    forEach([&high_keys](const int64_t val) { high_keys.push_back(high_bits(val)); });
+    std::sort(high_keys.begin(), high_keys.end());
+    const auto container_count = static_cast<size_t>(
+        std::unique(high_keys.begin(), high_keys.end()) - high_keys.begin());
+    return size_ >= container_count * min_values_per_container;
+  }
+
+  void compress() {
+    std::unique_ptr<ContainerMap> containers(new ContainerMap());
+    forEach([&containers](const int64_t val) {
+      (*containers)[high_bits(val)].insert(low_bits(val));
+    });
+    std::vector<int64_t>().swap(values_);
+    has_empty_key_ = false;
+    containers_.swap(containers);
+    impl_ = Impl::Compressed;
+  }
+
+  void insertCompressed(const int64_t val) {
+    if ((*containers_)[high_bits(val)].insert(low_bits(val))) {
+      ++size_;
+    }
+  }
+
+  static const size_t initial_hash_set_capacity{4 * max_sorted_vector_size};
+
+  // sorted values or hash set slots, depending on impl_
+  std::vector<int64_t> values_;
+  Impl impl_;
+  size_t size_;
+  // whether empty_key(), which marks the free hash set slots, is in the set
+  bool has_empty_key_;
+  std::unique_ptr<ContainerMap> containers_;
+};
+
+#endif  // QUERYENGINE_COUNTDISTINCTSET_H
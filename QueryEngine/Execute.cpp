@@ -22,6 +22,7 @@
 #include "EquiJoinCondition.h"
 #include "ExecutionException.h"
 #include "ExpressionRewrite.h"
+#include "FragmentSkipping.h"
 #include "GpuMemUtils.h"
 #include "InPlaceSort.h"
 #include "JsonAccessors.h"
@@ -67,6 +68,7 @@ unsigned g_trivial_loop_join_threshold{1000};
 bool g_left_deep_join_optimization{true};
 bool g_from_table_reordering{true};
 bool g_inner_join_fragment_skipping{false};
+bool g_enable_late_materialization{true};
 extern bool g_enable_smem_group_by;
 
 Executor::Executor(const int db_id,
@@ -816,12 +818,14 @@ RowSetPtr Executor::reduceMultiDeviceResults(
   }
 
   return reduceMultiDeviceResultSets(
+      ra_exe_unit,
       results_per_device,
       row_set_mem_owner,
       ResultSet::fixupQueryMemoryDescriptor(query_mem_desc));
 }
 
 RowSetPtr Executor::reduceMultiDeviceResultSets(
+    const RelAlgExecutionUnit& ra_exe_unit,
     std::vector<std::pair<ResultPtr, std::vector<size_t>>>& results_per_device,
     std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
     const QueryMemoryDescriptor& query_mem_desc) const {
@@ -830,42 +834,29 @@ RowSetPtr Executor::reduceMultiDeviceResultSets(
   const auto& first = boost::get<RowSetPtr>(results_per_device.front().first);
   CHECK(first);
 
+  // scattered partial aggregates repeat their keys, reduce them even from one kernel
   if (query_mem_desc.getGroupByColRangeType() == GroupByColRangeType::MultiCol &&
-      results_per_device.size() > 1) {
-    const auto total_entry_count = std::accumulate(
-        results_per_device.begin(),
-        results_per_device.end(),
-        size_t(0),
-        [](const size_t init, const std::pair<ResultPtr, std::vector<size_t>>& rs) {
-          const auto& r = boost::get<RowSetPtr>(rs.first);
-          return init + r->getQueryMemDesc().getEntryCount();
-        });
-    CHECK(total_entry_count);
-    auto query_mem_desc = first->getQueryMemDesc();
-    query_mem_desc.setEntryCount(total_entry_count);
-    reduced_results = std::make_shared<ResultSet>(first->getTargetInfos(),
-                                                  ExecutorDeviceType::CPU,
-                                                  query_mem_desc,
-                                                  row_set_mem_owner,
-                                                  this);
-    auto result_storage = reduced_results->allocateStorage(plan_state_->init_agg_vals_);
-    reduced_results->initializeStorage();
-    switch (query_mem_desc.getEffectiveKeyWidth()) {
-      case 4:
-        first->getStorage()->moveEntriesToBuffer<int32_t>(
-            result_storage->getUnderlyingBuffer(), query_mem_desc.getEntryCount());
-        break;
-      case 8:
-        first->getStorage()->moveEntriesToBuffer<int64_t>(
-            result_storage->getUnderlyingBuffer(), query_mem_desc.getEntryCount());
-        break;
-      default:
-        CHECK(false);
-    }
-  } else {
-    reduced_results = first;
-  }
-
+      (results_per_device.size() > 1 ||
+       first->getQueryMemDesc().scattersPartialAggregates())) {
+    // the manager merges in memory, radix partitioned or through spill files
+    std::vector<ResultSet*> result_sets;
+    for (const auto& result : results_per_device) {
+      const auto& rows = boost::get<RowSetPtr>(result.first);
+      CHECK(rows);
+      result_sets.push_back(rows.get());
+    }
+    // only the leaves see partial groups, the sort of the aggregator decides
+    const auto& sort_info = ra_exe_unit.sort_info;
+    const size_t top_n =
+        !g_cluster && sort_info.limit ? sort_info.limit + sort_info.offset : 0;
+    ResultSetManager rs_manager;
+    const auto reduced = rs_manager.reduce(result_sets, sort_info.order_entries, top_n);
+    reduced_results = rs_manager.getOwnResultSet();
+    CHECK_EQ(reduced_results.get(), reduced);
+    return reduced_results;
+  }
+
+  reduced_results = first;
   for (size_t i = 1; i < results_per_device.size(); ++i) {
     const auto& result = boost::get<RowSetPtr>(results_per_device[i].first);
     reduced_results->getStorage()->reduce(*(result->getStorage()));
@@ -1086,7 +1077,15 @@ ResultPtr Executor::executeWorkUnit(int32_t* error_code,
       continue;
     }
     if (options.just_explain) {
-      return executeExplain(execution_dispatch);
+      QueryFragmentDescriptor fragment_descriptor(ra_exe_unit, query_infos);
+      fragment_descriptor.buildFragmentKernelMap(ra_exe_unit,
+                                                 execution_dispatch.getFragOffsets(),
+                                                 1,
+                                                 ExecutorDeviceType::CPU,
+                                                 false,
+                                                 g_inner_join_fragment_skipping,
+                                                 this);
+      return executeExplain(execution_dispatch, fragment_descriptor);
     }
 
     for (const auto target_expr : ra_exe_unit.target_exprs) {
@@ -1169,7 +1168,8 @@ ResultPtr Executor::executeWorkUnit(int32_t* error_code,
                                      this);
 }
 
-RowSetPtr Executor::executeExplain(const ExecutionDispatch& execution_dispatch) {
+RowSetPtr Executor::executeExplain(const ExecutionDispatch& execution_dispatch,
+                                   const QueryFragmentDescriptor& fragment_descriptor) {
   std::string explained_plan;
   const auto llvm_ir_cpu = execution_dispatch.getIR(ExecutorDeviceType::CPU);
   if (!llvm_ir_cpu.empty()) {
@@ -1180,6 +1180,10 @@ RowSetPtr Executor::executeExplain(const ExecutionDispatch& execution_dispatch)
     explained_plan += (std::string(llvm_ir_cpu.empty() ? "" : "\n") +
                        "IR for the GPU:\n===============\n" + llvm_ir_gpu);
   }
+  explained_plan += "\nFragment skipping:\n==================\n" +
+                    std::to_string(fragment_descriptor.getSkippedOuterFragmentCount()) +
+                    " of " + std::to_string(fragment_descriptor.getOuterFragmentCount()) +
+                    " fragments of the outer table skipped\n";
   return std::make_shared<ResultSet>(explained_plan);
 }
 
@@ -1246,8 +1250,8 @@ void fill_entries_for_empty_input(std::vector<TargetInfo>& target_infos,
         entry.push_back(reinterpret_cast<int64_t>(count_distinct_buffer));
         continue;
       }
-      if (count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet) {
-        auto count_distinct_set = new std::set<int64_t>();
+      if (count_distinct_desc.impl_type_ == CountDistinctImplType::Set) {
+        auto count_distinct_set = new CountDistinctSet();
         CHECK(row_set_mem_owner);
         row_set_mem_owner->addCountDistinctSet(count_distinct_set);
         entry.push_back(reinterpret_cast<int64_t>(count_distinct_set));
@@ -1257,6 +1261,9 @@ void fill_entries_for_empty_input(std::vector<TargetInfo>& target_infos,
     const bool float_argument_input = takes_float_argument(agg_info);
     if (agg_info.agg_kind == kCOUNT || agg_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
       entry.push_back(0);
+    } else if (agg_info.agg_kind == kAPPROX_PERCENTILE) {
+      // no sketch, reads back as null
+      entry.push_back(0);
     } else if (agg_info.agg_kind == kAVG) {
       entry.push_back(inline_null_val(agg_info.agg_arg_type, float_argument_input));
       entry.push_back(0);
@@ -1446,6 +1453,12 @@ void Executor::dispatchFragments(
                                              use_multifrag_kernel,
                                              g_inner_join_fragment_skipping,
                                              this);
+  if (g_enable_debug_timer) {
+    LOG(INFO) << "Fragment skipping: "
+              << fragment_descriptor.getSkippedOuterFragmentCount() << " of "
+              << fragment_descriptor.getOuterFragmentCount()
+              << " fragments of the outer table skipped";
+  }
   if (eo.with_watchdog && fragment_descriptor.shouldCheckWorkUnitWatchdog()) {
     checkWorkUnitWatchdog(ra_exe_unit, *catalog_);
   }
@@ -1753,7 +1766,8 @@ Executor::FetchResult Executor::fetchChunks(
     const FragmentsList& selected_fragments,
     const Catalog_Namespace::Catalog& cat,
     std::list<ChunkIter>& chunk_iterators,
-    std::list<std::shared_ptr<Chunk_NS::Chunk>>& chunks) {
+    std::list<std::shared_ptr<Chunk_NS::Chunk>>& chunks,
+    const bool defer_lazy_columns) {
   INJECT_TIMER(fetchChunks);
   const auto& col_global_ids = ra_exe_unit.input_col_descs;
   std::vector<std::vector<size_t>> selected_fragments_crossjoin;
@@ -1771,6 +1785,7 @@ Executor::FetchResult Executor::fetchChunks(
   std::vector<std::vector<const int8_t*>> all_frag_iter_buffers;
   std::vector<std::vector<int64_t>> all_num_rows;
   std::vector<std::vector<uint64_t>> all_frag_offsets;
+  std::vector<DeferredColumn> deferred_columns;
   const auto extra_tab_id_to_frag_offsets =
       get_table_id_to_frag_offsets(ra_exe_unit.extra_input_descs, all_tables_fragments);
   const bool needs_fetch_iterators =
@@ -1805,10 +1820,22 @@ Executor::FetchResult Executor::fetchChunks(
       }
       CHECK_LT(frag_id, fragments->size());
       auto memory_level_for_column = memory_level;
-      if (plan_state_->columns_to_fetch_.find(
-              std::make_pair(col_id->getScanDesc().getTableId(), col_id->getColId())) ==
+      const auto table_col_id = std::make_pair(table_id, col_id->getColId());
+      if (plan_state_->columns_to_fetch_.find(table_col_id) ==
           plan_state_->columns_to_fetch_.end()) {
         memory_level_for_column = Data_Namespace::CPU_LEVEL;
+        // The kernel only reads the position of the rows of lazily fetched columns,
+        // the result set reads their values for the rows which passed the filter.
+        if (defer_lazy_columns && !is_rowid &&
+            col_id->getScanDesc().getSourceType() == InputSourceType::TABLE &&
+            plan_state_->columns_to_not_fetch_.count(table_col_id)) {
+          deferred_columns.push_back({all_frag_col_buffers.size(),
+                                      it->second,
+                                      table_id,
+                                      static_cast<int>(frag_id),
+                                      col_id->getColId()});
+          continue;
+        }
       }
       if (col_id->getScanDesc().getSourceType() == InputSourceType::RESULT) {
         frag_col_buffers[it->second] =
@@ -1859,7 +1886,44 @@ Executor::FetchResult Executor::fetchChunks(
                                       ra_exe_unit.input_descs,
                                       all_tables_fragments,
                                       isOuterLoopJoin());
-  return {all_frag_col_buffers, all_frag_iter_buffers, all_num_rows, all_frag_offsets};
+  return {all_frag_col_buffers,
+          all_frag_iter_buffers,
+          all_num_rows,
+          all_frag_offsets,
+          deferred_columns};
+}
+
+void Executor::fetchDeferredColumns(
+    const ExecutionDispatch& execution_dispatch,
+    const FetchResult& fetch_result,
+    const ResultPtr& device_results,
+    const int device_id,
+    const std::map<int, const TableFragments*>& all_tables_fragments,
+    std::list<ChunkIter>& chunk_iterators,
+    std::list<std::shared_ptr<Chunk_NS::Chunk>>& chunks) {
+  INJECT_TIMER(fetchDeferredColumns);
+  const auto rows_pp = boost::get<RowSetPtr>(&device_results);
+  if (!rows_pp || !*rows_pp) {
+    return;
+  }
+  const auto& rows = *rows_pp;
+  // a projection fills its output from the first entry on, the fragments of a kernel
+  // which didn't output any row never load the columns
+  if (rows->definitelyHasNoRows() || rows->isRowAtEmpty(0)) {
+    return;
+  }
+  for (const auto& deferred_column : fetch_result.deferred_columns) {
+    const auto col_buffer = execution_dispatch.getScanColumn(deferred_column.table_id,
+                                                             deferred_column.frag_id,
+                                                             deferred_column.col_id,
+                                                             all_tables_fragments,
+                                                             chunks,
+                                                             chunk_iterators,
+                                                             Data_Namespace::CPU_LEVEL,
+                                                             device_id);
+    rows->setLazyColumnBuffer(
+        deferred_column.frag_idx, deferred_column.local_col_id, col_buffer);
+  }
 }
 
 std::vector<size_t> Executor::getFragmentCount(const FragmentsList& selected_fragments,
@@ -2039,8 +2103,11 @@ int32_t Executor::executePlanWithoutGroupBy(
       CHECK(agg_info.is_agg);
       int64_t val1;
       const bool float_argument_input = takes_float_argument(agg_info);
-      if (is_distinct_target(agg_info)) {
-        CHECK(agg_info.agg_kind == kCOUNT || agg_info.agg_kind == kAPPROX_COUNT_DISTINCT);
+      if (is_distinct_target(agg_info) || agg_info.agg_kind == kAPPROX_PERCENTILE) {
+        // all the fragments of the kernel share the set, bitmap or sketch
+        CHECK(agg_info.agg_kind == kCOUNT ||
+              agg_info.agg_kind == kAPPROX_COUNT_DISTINCT ||
+              agg_info.agg_kind == kAPPROX_PERCENTILE);
         val1 = out_vec[out_vec_idx][0];
         error_code = 0;
       } else {
@@ -3051,6 +3118,12 @@ std::pair<bool, int64_t> Executor::skipFragment(
         if (!lhs_col || !lhs_col->get_table_id() || lhs_col->get_rte_idx()) {
           continue;
         }
+        // The cast can change the values, a timestamp cast to a date for example,
+        // compare with the range of the cast chunk values instead.
+        if (!qual_may_hold_in_fragment(comp_expr.get(), fragment, table_id, this)) {
+          return {true, -1};
+        }
+        continue;
       } else {
         continue;
       }
@@ -3070,6 +3143,7 @@ std::pair<bool, int64_t> Executor::skipFragment(
     int64_t chunk_max{0};
     bool is_rowid{false};
     size_t start_rowid{0};
+    const ChunkValueSketch* value_sketch{nullptr};
     if (chunk_meta_it == fragment.getChunkMetadataMap().end()) {
       auto cd = get_column_descriptor(col_id, table_id, *catalog_);
       if (cd->isVirtualCol) {
@@ -3084,6 +3158,13 @@ std::pair<bool, int64_t> Executor::skipFragment(
       const auto& chunk_type = lhs_col->get_type_info();
       chunk_min = extract_min_stat(chunk_meta_it->second.chunkStats, chunk_type);
       chunk_max = extract_max_stat(chunk_meta_it->second.chunkStats, chunk_type);
+      // The sketch holds the values as stored, a cast on the column doesn't preserve
+      // equality with them.
+      const auto& rhs_ti = rhs_const->get_type_info();
+      if (lhs == lhs_col && (rhs_ti.get_type() == chunk_type.get_type() ||
+                             (rhs_ti.is_integer() && chunk_type.is_integer()))) {
+        value_sketch = chunk_meta_it->second.chunkStats.value_sketch.get();
+      }
     }
     const auto rhs_val = codegenIntConst(rhs_const)->getSExtValue();
     switch (comp_expr->get_optype()) {
@@ -3112,6 +3193,8 @@ std::pair<bool, int64_t> Executor::skipFragment(
           return {true, -1};
         } else if (is_rowid) {
           return {false, rhs_val - start_rowid};
+        } else if (value_sketch && !value_sketch->mayContain(rhs_val)) {
+          return {true, -1};
         }
         break;
       default:
@@ -3178,6 +3261,85 @@ std::pair<bool, int64_t> Executor::skipFragmentInnerJoins(
   return skip_frag;
 }
 
+/*
+ *   The skipFragmentFilters evaluates the filters which aren't simple quals, i.e. AND /
+ * OR trees of comparisons, IN lists and null checks over monotonic expressions of the
+ * columns, against the chunk metadata of the fragment (see FragmentSkipping.h).
+ *   - A filter which references other tables than the outer one cannot skip, unless
+ * the outer table part of an AND is enough.
+ */
+bool Executor::skipFragmentFilters(const InputDescriptor& table_desc,
+                                   const RelAlgExecutionUnit& ra_exe_unit,
+                                   const Fragmenter_Namespace::FragmentInfo& fragment) {
+  const int table_id = table_desc.getTableId();
+  if (table_desc.getSourceType() == InputSourceType::RESULT &&
+      boost::get<IterTabPtr>(&get_temporary_table(temporary_tables_, table_id))) {
+    return false;
+  }
+  for (const auto& qual : ra_exe_unit.quals) {
+    if (!qual_may_hold_in_fragment(qual.get(), fragment, table_id, this)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ *   The skipFragmentRuntimeJoinFilters uses the runtime filters built along with the
+ * join hash tables: a fragment of the outer table is skipped if the chunk metadata
+ * range of an outer join column doesn't contain any of the build side keys.
+ *   - Only inner joins can skip, a row of the outer table without a match is still
+ * part of the result of a left join.
+ *   - Only physical outer tables have chunk metadata we can trust for this.
+ */
+bool Executor::skipFragmentRuntimeJoinFilters(
+    const InputDescriptor& table_desc,
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const Fragmenter_Namespace::FragmentInfo& fragment) {
+  if (table_desc.getSourceType() != InputSourceType::TABLE) {
+    return false;
+  }
+  for (const auto& join_hash_table : plan_state_->join_info_.join_hash_tables_) {
+    if (ra_exe_unit.inner_joins.empty()) {
+      if (ra_exe_unit.join_type != JoinType::INNER ||
+          !ra_exe_unit.outer_join_quals.empty()) {
+        continue;
+      }
+    } else {
+      const auto inner_rte_idx = join_hash_table->getInnerTableRteIdx();
+      CHECK_GT(inner_rte_idx, 0);
+      CHECK_LE(static_cast<size_t>(inner_rte_idx), ra_exe_unit.inner_joins.size());
+      if (ra_exe_unit.inner_joins[inner_rte_idx - 1].type != JoinType::INNER) {
+        continue;
+      }
+    }
+    for (const auto& runtime_filter : join_hash_table->getRuntimeFilters()) {
+      const auto outer_col = runtime_filter.outer_col.get();
+      CHECK(outer_col);
+      if (outer_col->get_rte_idx() ||
+          outer_col->get_table_id() != table_desc.getTableId()) {
+        continue;
+      }
+      const auto chunk_meta_it =
+          fragment.getChunkMetadataMap().find(outer_col->get_column_id());
+      if (chunk_meta_it == fragment.getChunkMetadataMap().end()) {
+        continue;
+      }
+      const auto& chunk_type = outer_col->get_type_info();
+      const auto& chunk_stats = chunk_meta_it->second.chunkStats;
+      const auto chunk_min = extract_min_stat(chunk_stats, chunk_type);
+      const auto chunk_max = extract_max_stat(chunk_stats, chunk_type);
+      if (chunk_min > chunk_max) {
+        continue;
+      }
+      if (!runtime_filter.filter->mayContainAnyOf(chunk_min, chunk_max)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 std::map<std::pair<int, ::QueryRenderer::QueryRenderManager*>, std::shared_ptr<Executor>>
     Executor::executors_;
 std::mutex Executor::execute_mutex_;
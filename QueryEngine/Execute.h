@@ -76,6 +76,10 @@ extern bool g_null_div_by_zero;
 extern bool g_bigint_count;
 extern bool g_fast_strcmp;
 extern bool g_inner_join_fragment_skipping;
+extern bool g_enable_late_materialization;
+extern size_t g_reduction_spill_threshold;
+extern size_t g_partitioned_hash_build_threshold;
+extern size_t g_subquery_result_cache_entries;
 
 class ExecutionResult;
 
@@ -736,11 +740,21 @@ class Executor {
     std::unordered_set<size_t> sharded_range_table_indices_;
   };
 
+  struct DeferredColumn {
+    size_t frag_idx;  // index in FetchResult::col_buffers
+    int local_col_id;
+    int table_id;
+    int frag_id;
+    int col_id;
+  };
+
   struct FetchResult {
     std::vector<std::vector<const int8_t*>> col_buffers;
     std::vector<std::vector<const int8_t*>> iter_buffers;
     std::vector<std::vector<int64_t>> num_rows;
     std::vector<std::vector<uint64_t>> frag_offsets;
+    // Lazily read columns left null in col_buffers, see fetchDeferredColumns.
+    std::vector<DeferredColumn> deferred_columns;
   };
 
 #ifdef ENABLE_MULTIFRAG_JOIN
@@ -921,7 +935,7 @@ class Executor {
                      std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
                      const UpdateLogForFragment::Callback& cb) __attribute__((hot));
 
-  RowSetPtr executeExplain(const ExecutionDispatch&);
+  RowSetPtr executeExplain(const ExecutionDispatch&, const QueryFragmentDescriptor&);
 
   // TODO(alex): remove
   ExecutorDeviceType getDeviceTypeForTargets(
@@ -983,7 +997,16 @@ class Executor {
                           const FragmentsList& selected_fragments,
                           const Catalog_Namespace::Catalog&,
                           std::list<ChunkIter>&,
-                          std::list<std::shared_ptr<Chunk_NS::Chunk>>&);
+                          std::list<std::shared_ptr<Chunk_NS::Chunk>>&,
+                          const bool defer_lazy_columns);
+
+  void fetchDeferredColumns(const ExecutionDispatch&,
+                            const FetchResult& fetch_result,
+                            const ResultPtr& device_results,
+                            const int device_id,
+                            const std::map<int, const TableFragments*>&,
+                            std::list<ChunkIter>&,
+                            std::list<std::shared_ptr<Chunk_NS::Chunk>>&);
 
   std::pair<std::vector<std::vector<int64_t>>, std::vector<std::vector<uint64_t>>>
   getRowCountAndOffsetForAllFrags(
@@ -1079,6 +1102,7 @@ class Executor {
       std::shared_ptr<RowSetMemoryOwner>,
       const QueryMemoryDescriptor&) const;
   RowSetPtr reduceMultiDeviceResultSets(
+      const RelAlgExecutionUnit&,
       std::vector<std::pair<ResultPtr, std::vector<size_t>>>& all_fragment_results,
       std::shared_ptr<RowSetMemoryOwner>,
       const QueryMemoryDescriptor&) const;
@@ -1252,6 +1276,14 @@ class Executor {
       const std::vector<uint64_t>& frag_offsets,
       const size_t frag_idx);
 
+  bool skipFragmentFilters(const InputDescriptor& table_desc,
+                           const RelAlgExecutionUnit& ra_exe_unit,
+                           const Fragmenter_Namespace::FragmentInfo& fragment);
+
+  bool skipFragmentRuntimeJoinFilters(const InputDescriptor& table_desc,
+                                      const RelAlgExecutionUnit& ra_exe_unit,
+                                      const Fragmenter_Namespace::FragmentInfo& fragment);
+
   typedef std::vector<std::string> CodeCacheKey;
   typedef std::vector<std::tuple<void*,
                                  std::unique_ptr<llvm::ExecutionEngine>,
@@ -1733,6 +1765,8 @@ class Executor {
   friend class JoinHashTable;
   friend class LeafAggregator;
   friend class QueryRewriter;
+  friend class RangeJoinTable;
+  friend class SpatialJoinTable;
   friend class PendingExecutionClosure;
   friend class RelAlgExecutor;
 };
@@ -217,9 +217,21 @@ void Executor::ExecutionDispatch::runImpl(const ExecutorDeviceType chosen_device
     gpu_lock.reset(
         new std::lock_guard<std::mutex>(executor_->gpu_exec_mutex_[chosen_device_id]));
   }
+  const CompilationResult& compilation_result =
+      chosen_device_type == ExecutorDeviceType::GPU ? compilation_result_gpu_
+                                                    : compilation_result_cpu_;
+  const bool do_render = render_info_ && render_info_->isPotentialInSituRender();
+  // Projections over a single table read the lazily fetched columns only for the rows
+  // which passed the filter, load them after the kernel ran and only if it output rows.
+  const bool defer_lazy_columns =
+      g_enable_late_materialization && !do_render &&
+      ra_exe_unit_.input_descs.size() == 1 &&
+      compilation_result.query_mem_desc.getGroupByColRangeType() ==
+          GroupByColRangeType::Projection &&
+      !compilation_result.query_mem_desc.usesCachedContext();
   FetchResult fetch_result;
+  std::map<int, const TableFragments*> all_tables_fragments;
   try {
-    std::map<int, const TableFragments*> all_tables_fragments;
     QueryFragmentDescriptor::computeAllTablesFragments(
         all_tables_fragments, ra_exe_unit_, query_infos_);
 
@@ -232,7 +244,8 @@ void Executor::ExecutionDispatch::runImpl(const ExecutorDeviceType chosen_device
                                           frag_list,
                                           cat_,
                                           *chunk_iterators_ptr,
-                                          chunks);
+                                          chunks,
+                                          defer_lazy_columns);
     if (fetch_result.num_rows.empty()) {
       return;
     }
@@ -249,13 +262,9 @@ void Executor::ExecutionDispatch::runImpl(const ExecutorDeviceType chosen_device
     *error_code_ = ERR_OUT_OF_GPU_MEM;
     return;
   }
-  const CompilationResult& compilation_result =
-      chosen_device_type == ExecutorDeviceType::GPU ? compilation_result_gpu_
-                                                    : compilation_result_cpu_;
   CHECK(!compilation_result.query_mem_desc.usesCachedContext() ||
         !ra_exe_unit_.scan_limit);
   std::unique_ptr<QueryExecutionContext> query_exe_context_owned;
-  const bool do_render = render_info_ && render_info_->isPotentialInSituRender();
   try {
     OOM_TRACE_PUSH();
     query_exe_context_owned =
@@ -361,6 +370,22 @@ void Executor::ExecutionDispatch::runImpl(const ExecutorDeviceType chosen_device
                                             ra_exe_unit_.input_descs.size(),
                                             do_render ? render_info_ : nullptr);
   }
+  if (!fetch_result.deferred_columns.empty()) {
+    try {
+      OOM_TRACE_PUSH();
+      executor_->fetchDeferredColumns(*this,
+                                      fetch_result,
+                                      device_results,
+                                      chosen_device_id,
+                                      all_tables_fragments,
+                                      *chunk_iterators_ptr,
+                                      chunks);
+    } catch (const OutOfMemory&) {
+      std::lock_guard<std::mutex> lock(reduce_mutex_);
+      *error_code_ = ERR_OUT_OF_GPU_MEM;
+      return;
+    }
+  }
   if (auto rows_pp = boost::get<RowSetPtr>(&device_results)) {
     if (auto& rows_ptr = *rows_pp) {
       std::list<std::shared_ptr<Chunk_NS::Chunk>> chunks_to_hold;
@@ -283,7 +283,7 @@ class DeepCopyVisitor : public ScalarExprVisitor<std::shared_ptr<Analyzer::Expr>
                                        agg->get_aggtype(),
                                        arg,
                                        agg->get_is_distinct(),
-                                       agg->get_error_rate());
+                                       agg->get_arg1());
   }
 };
 
@@ -0,0 +1,406 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FragmentSkipping.h"
+#include "DateTruncate.h"
+#include "Execute.h"
+#include "ExpressionRange.h"
+#include "ExtractFromTime.h"
+#include "GroupByAndAggregate.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+bool is_integral(const SQLTypeInfo& ti) {
+  return ti.is_integer() || ti.is_boolean();
+}
+
+// The values of these types are compared as the 64-bit integers we store.
+bool is_int_domain(const SQLTypeInfo& ti) {
+  return is_integral(ti) || ti.is_decimal() || ti.is_time() ||
+         (ti.is_string() && ti.get_compression() == kENCODING_DICT);
+}
+
+bool same_int_domain(const SQLTypeInfo& lhs_ti, const SQLTypeInfo& rhs_ti) {
+  if (!is_int_domain(lhs_ti) || !is_int_domain(rhs_ti)) {
+    return false;
+  }
+  if (is_integral(lhs_ti) || is_integral(rhs_ti)) {
+    return is_integral(lhs_ti) && is_integral(rhs_ti);
+  }
+  if (lhs_ti.is_decimal() || rhs_ti.is_decimal()) {
+    return lhs_ti.is_decimal() && rhs_ti.is_decimal() &&
+           lhs_ti.get_scale() == rhs_ti.get_scale();
+  }
+  if (lhs_ti.is_string() || rhs_ti.is_string()) {
+    // A transient dictionary id stands for the regular dictionary it extends.
+    return lhs_ti.is_string() && rhs_ti.is_string() &&
+           std::abs(lhs_ti.get_comp_param()) == std::abs(rhs_ti.get_comp_param());
+  }
+  return lhs_ti.get_type() == rhs_ti.get_type() &&
+         lhs_ti.get_dimension() == rhs_ti.get_dimension();
+}
+
+SQLOps negate_comparison(const SQLOps optype) {
+  switch (optype) {
+    case kEQ:
+      return kNE;
+    case kNE:
+      return kEQ;
+    case kLT:
+      return kGE;
+    case kGE:
+      return kLT;
+    case kGT:
+      return kLE;
+    case kLE:
+      return kGT;
+    default:
+      CHECK(false);
+  }
+  return optype;
+}
+
+bool is_empty(const ExpressionRange& range) {
+  return range.getIntMin() > range.getIntMax();
+}
+
+bool is_single_value(const ExpressionRange& range) {
+  return range.getIntMin() == range.getIntMax();
+}
+
+// Whether some non-null value of lhs_range compares true with one of rhs_range.
+bool ranges_may_compare(const SQLOps optype,
+                        const ExpressionRange& lhs_range,
+                        const ExpressionRange& rhs_range) {
+  if (is_empty(lhs_range) || is_empty(rhs_range)) {
+    return false;
+  }
+  switch (optype) {
+    case kEQ:
+      return lhs_range.getIntMin() <= rhs_range.getIntMax() &&
+             rhs_range.getIntMin() <= lhs_range.getIntMax();
+    case kNE:
+      return !is_single_value(lhs_range) || !is_single_value(rhs_range) ||
+             lhs_range.getIntMin() != rhs_range.getIntMin();
+    case kLT:
+      return lhs_range.getIntMin() < rhs_range.getIntMax();
+    case kLE:
+      return lhs_range.getIntMin() <= rhs_range.getIntMax();
+    case kGT:
+      return lhs_range.getIntMax() > rhs_range.getIntMin();
+    case kGE:
+      return lhs_range.getIntMax() >= rhs_range.getIntMin();
+    default:
+      CHECK(false);
+  }
+  return true;
+}
+
+class FragmentQualEvaluator {
+ public:
+  FragmentQualEvaluator(const Fragmenter_Namespace::FragmentInfo& fragment,
+                        const int table_id,
+                        const Executor* executor)
+      : fragment_(fragment), table_id_(table_id), executor_(executor) {}
+
+  // False only if no row of the fragment satisfies qual, or NOT qual if negated.
+  // Negations are pushed down to the leaves, De Morgan's laws hold for the three
+  // valued logic as well.
+  bool mayHold(const Analyzer::Expr* qual, const bool negated) const {
+    const auto likelihood_expr = dynamic_cast<const Analyzer::LikelihoodExpr*>(qual);
+    if (likelihood_expr) {
+      return mayHold(likelihood_expr->get_arg(), negated);
+    }
+    const auto u_oper = dynamic_cast<const Analyzer::UOper*>(qual);
+    if (u_oper) {
+      return mayHold(u_oper, negated);
+    }
+    const auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(qual);
+    if (bin_oper) {
+      return mayHold(bin_oper, negated);
+    }
+    const auto in_values = dynamic_cast<const Analyzer::InValues*>(qual);
+    if (in_values) {
+      return mayHold(in_values, negated);
+    }
+    const auto in_integer_set = dynamic_cast<const Analyzer::InIntegerSet*>(qual);
+    if (in_integer_set) {
+      return mayHold(in_integer_set, negated);
+    }
+    return true;
+  }
+
+ private:
+  bool mayHold(const Analyzer::UOper* u_oper, const bool negated) const {
+    switch (u_oper->get_optype()) {
+      case kNOT:
+        return mayHold(u_oper->get_operand(), !negated);
+      case kISNULL:
+      case kISNOTNULL: {
+        const auto range = getRange(u_oper->get_operand());
+        if (range.getType() != ExpressionRangeType::Integer) {
+          return true;
+        }
+        const bool is_null_check = (u_oper->get_optype() == kISNULL) != negated;
+        return is_null_check ? range.hasNulls() : !is_empty(range);
+      }
+      default:
+        return true;
+    }
+  }
+
+  bool mayHold(const Analyzer::BinOper* bin_oper, const bool negated) const {
+    const auto optype = bin_oper->get_optype();
+    if (IS_LOGIC(optype)) {
+      const bool is_and = (optype == kAND) != negated;
+      const bool lhs_may_hold = mayHold(bin_oper->get_left_operand(), negated);
+      if (lhs_may_hold != is_and) {
+        return lhs_may_hold;
+      }
+      return mayHold(bin_oper->get_right_operand(), negated);
+    }
+    if (!IS_COMPARISON(optype) || optype == kBW_EQ ||
+        bin_oper->get_qualifier() != kONE) {
+      return true;
+    }
+    const auto lhs = bin_oper->get_left_operand();
+    const auto rhs = bin_oper->get_right_operand();
+    if (!same_int_domain(lhs->get_type_info(), rhs->get_type_info())) {
+      return true;
+    }
+    const auto actual_optype = negated ? negate_comparison(optype) : optype;
+    // Dictionary ids follow the insertion order, not the order of the strings.
+    if (lhs->get_type_info().is_string() && actual_optype != kEQ &&
+        actual_optype != kNE) {
+      return true;
+    }
+    const auto lhs_range = getRange(lhs);
+    const auto rhs_range = getRange(rhs);
+    if (lhs_range.getType() != ExpressionRangeType::Integer ||
+        rhs_range.getType() != ExpressionRangeType::Integer) {
+      return true;
+    }
+    if (!ranges_may_compare(actual_optype, lhs_range, rhs_range)) {
+      return false;
+    }
+    if (actual_optype == kEQ) {
+      return valueMayBeIn(lhs_range, rhs) && valueMayBeIn(rhs_range, lhs);
+    }
+    return true;
+  }
+
+  bool mayHold(const Analyzer::InValues* in_values, const bool negated) const {
+    const auto arg = in_values->get_arg();
+    std::vector<int64_t> values;
+    for (const auto& value : in_values->get_value_list()) {
+      if (!same_int_domain(arg->get_type_info(), value->get_type_info())) {
+        return true;
+      }
+      const auto value_range = getRange(value.get());
+      if (value_range.getType() != ExpressionRangeType::Integer ||
+          !is_single_value(value_range)) {
+        return true;
+      }
+      values.push_back(value_range.getIntMin());
+    }
+    return valuesMayHold(arg, values, negated);
+  }
+
+  bool mayHold(const Analyzer::InIntegerSet* in_integer_set, const bool negated) const {
+    // The values of an IN subquery are already in the domain of the argument.
+    return valuesMayHold(
+        in_integer_set->get_arg(), in_integer_set->get_value_list(), negated);
+  }
+
+  bool valuesMayHold(const Analyzer::Expr* arg,
+                     const std::vector<int64_t>& values,
+                     const bool negated) const {
+    const auto arg_range = getRange(arg);
+    if (arg_range.getType() != ExpressionRangeType::Integer) {
+      return true;
+    }
+    if (is_empty(arg_range)) {
+      return false;
+    }
+    if (negated) {
+      return !is_single_value(arg_range) ||
+             std::find(values.begin(), values.end(), arg_range.getIntMin()) ==
+                 values.end();
+    }
+    for (const auto val : values) {
+      if (val >= arg_range.getIntMin() && val <= arg_range.getIntMax() &&
+          valueMayBeIn(ExpressionRange::makeIntRange(val, val, 0, false), arg)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Consults the value sketch of the chunk when a column is compared with one value.
+  bool valueMayBeIn(const ExpressionRange& value_range,
+                    const Analyzer::Expr* expr) const {
+    if (!is_single_value(value_range)) {
+      return true;
+    }
+    const auto chunk_stats = getChunkStats(expr);
+    if (!chunk_stats || !chunk_stats->value_sketch) {
+      return true;
+    }
+    return chunk_stats->value_sketch->mayContain(value_range.getIntMin());
+  }
+
+  const ChunkStats* getChunkStats(const Analyzer::Expr* expr) const {
+    const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(expr);
+    if (!col_var || dynamic_cast<const Analyzer::Var*>(expr) ||
+        col_var->get_rte_idx() || col_var->get_table_id() != table_id_ ||
+        !is_int_domain(col_var->get_type_info())) {
+      return nullptr;
+    }
+    const auto& chunk_metadata_map = fragment_.getChunkMetadataMap();
+    const auto chunk_meta_it = chunk_metadata_map.find(col_var->get_column_id());
+    if (chunk_meta_it == chunk_metadata_map.end()) {
+      return nullptr;
+    }
+    return &chunk_meta_it->second.chunkStats;
+  }
+
+  ExpressionRange getRange(const Analyzer::Expr* expr) const {
+    if (dynamic_cast<const Analyzer::ColumnVar*>(expr)) {
+      const auto chunk_stats = getChunkStats(expr);
+      if (!chunk_stats) {
+        return ExpressionRange::makeInvalidRange();
+      }
+      const auto& col_ti = expr->get_type_info();
+      return ExpressionRange::makeIntRange(extract_min_stat(*chunk_stats, col_ti),
+                                           extract_max_stat(*chunk_stats, col_ti),
+                                           0,
+                                           chunk_stats->has_nulls);
+    }
+    const auto constant = dynamic_cast<const Analyzer::Constant*>(expr);
+    if (constant) {
+      const auto& ti = constant->get_type_info();
+      if (constant->get_is_null() || !is_int_domain(ti) || ti.is_string()) {
+        return ExpressionRange::makeInvalidRange();
+      }
+      const auto val = extract_from_datum(constant->get_constval(), ti);
+      return ExpressionRange::makeIntRange(val, val, 0, false);
+    }
+    const auto u_oper = dynamic_cast<const Analyzer::UOper*>(expr);
+    if (u_oper && u_oper->get_optype() == kCAST) {
+      return getCastRange(u_oper);
+    }
+    const auto datetrunc_expr = dynamic_cast<const Analyzer::DatetruncExpr*>(expr);
+    if (datetrunc_expr) {
+      const auto from_expr = datetrunc_expr->get_from_expr();
+      if (from_expr->get_type_info().get_dimension()) {
+        return ExpressionRange::makeInvalidRange();
+      }
+      const auto arg_range = getRange(from_expr);
+      if (arg_range.getType() != ExpressionRangeType::Integer || is_empty(arg_range)) {
+        return arg_range;
+      }
+      const auto field = datetrunc_expr->get_field();
+      return ExpressionRange::makeIntRange(DateTruncate(field, arg_range.getIntMin()),
+                                           DateTruncate(field, arg_range.getIntMax()),
+                                           0,
+                                           arg_range.hasNulls());
+    }
+    const auto extract_expr = dynamic_cast<const Analyzer::ExtractExpr*>(expr);
+    if (extract_expr) {
+      const auto from_expr = extract_expr->get_from_expr();
+      const auto field = extract_expr->get_field();
+      if ((field != kYEAR && field != kEPOCH) ||
+          from_expr->get_type_info().get_dimension()) {
+        return ExpressionRange::makeInvalidRange();
+      }
+      const auto arg_range = getRange(from_expr);
+      if (arg_range.getType() != ExpressionRangeType::Integer || is_empty(arg_range) ||
+          field == kEPOCH) {
+        return arg_range;
+      }
+      return ExpressionRange::makeIntRange(ExtractFromTime(kYEAR, arg_range.getIntMin()),
+                                           ExtractFromTime(kYEAR, arg_range.getIntMax()),
+                                           0,
+                                           arg_range.hasNulls());
+    }
+    return ExpressionRange::makeInvalidRange();
+  }
+
+  // Only the casts which preserve the order of the values have a range.
+  ExpressionRange getCastRange(const Analyzer::UOper* u_oper) const {
+    const auto& ti = u_oper->get_type_info();
+    const auto operand = u_oper->get_operand();
+    const auto& operand_ti = operand->get_type_info();
+    const auto constant = dynamic_cast<const Analyzer::Constant*>(operand);
+    if (constant && ti.is_string() && ti.get_compression() == kENCODING_DICT &&
+        operand_ti.is_string()) {
+      // A string literal compared with a dictionary encoded column.
+      const auto row_set_mem_owner = executor_->getRowSetMemoryOwner();
+      if (constant->get_is_null() || !row_set_mem_owner) {
+        return ExpressionRange::makeInvalidRange();
+      }
+      const auto sdp = executor_->getStringDictionaryProxy(
+          ti.get_comp_param(), row_set_mem_owner, true);
+      CHECK(sdp);
+      const int64_t str_id = sdp->getIdOfString(*constant->get_constval().stringval);
+      return str_id < 0 ? ExpressionRange::makeInvalidRange()
+                        : ExpressionRange::makeIntRange(str_id, str_id, 0, false);
+    }
+    const auto arg_range = getRange(operand);
+    if (arg_range.getType() != ExpressionRangeType::Integer || is_empty(arg_range)) {
+      return arg_range;
+    }
+    if (is_integral(ti) && is_integral(operand_ti)) {
+      return ti.get_size() >= operand_ti.get_size() ? arg_range
+                                                    : ExpressionRange::makeInvalidRange();
+    }
+    if ((ti.is_decimal() || ti.is_string()) && same_int_domain(ti, operand_ti)) {
+      return arg_range;
+    }
+    if (ti.is_time() && operand_ti.is_time() && !ti.get_dimension() &&
+        !operand_ti.get_dimension()) {
+      if (operand_ti.get_type() == kTIMESTAMP && ti.get_type() == kDATE) {
+        // Generated like a date_trunc on day in the executor.
+        return ExpressionRange::makeIntRange(DateTruncate(dtDAY, arg_range.getIntMin()),
+                                             DateTruncate(dtDAY, arg_range.getIntMax()),
+                                             0,
+                                             arg_range.hasNulls());
+      }
+      if (operand_ti.get_type() == ti.get_type() ||
+          (operand_ti.get_type() == kDATE && ti.get_type() == kTIMESTAMP)) {
+        return arg_range;
+      }
+    }
+    return ExpressionRange::makeInvalidRange();
+  }
+
+  const Fragmenter_Namespace::FragmentInfo& fragment_;
+  const int table_id_;
+  const Executor* executor_;
+};
+
+}  // namespace
+
+bool qual_may_hold_in_fragment(const Analyzer::Expr* qual,
+                               const Fragmenter_Namespace::FragmentInfo& fragment,
+                               const int table_id,
+                               const Executor* executor) {
+  return FragmentQualEvaluator(fragment, table_id, executor).mayHold(qual, false);
+}
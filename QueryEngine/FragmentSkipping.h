@@ -0,0 +1,49 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    FragmentSkipping.h
+ * @brief   Evaluation of filters against the chunk metadata of a fragment.
+ *
+ * The columns of the fragment become intervals, [min, max] from the chunk stats,
+ * which go through the monotonic expressions on top of them (widening casts,
+ * timestamp to date casts, date_trunc, extract of the year). Comparisons, IN lists
+ * and null checks are decided on the intervals, with the value sketch of the chunk
+ * refining the equalities. AND, OR and NOT combine the answers, so filters which
+ * aren't simple quals can skip fragments as well. Anything else is assumed to hold.
+ */
+
+#ifndef QUERYENGINE_FRAGMENTSKIPPING_H
+#define QUERYENGINE_FRAGMENTSKIPPING_H
+
+namespace Analyzer {
+class Expr;
+}  // namespace Analyzer
+
+namespace Fragmenter_Namespace {
+class FragmentInfo;
+}  // namespace Fragmenter_Namespace
+
+class Executor;
+
+// False only if no row of the fragment of table table_id can satisfy qual. Only the
+// columns of the outer table, i.e. range table index 0, are looked at.
+bool qual_may_hold_in_fragment(const Analyzer::Expr* qual,
+                               const Fragmenter_Namespace::FragmentInfo& fragment,
+                               const int table_id,
+                               const Executor* executor);
+
+#endif  // QUERYENGINE_FRAGMENTSKIPPING_H
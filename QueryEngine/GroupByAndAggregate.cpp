@@ -45,6 +45,7 @@
 #include <llvm/IR/MDBuilder.h>
 #endif
 
+#include <limits>
 #include <numeric>
 #include <thread>
 
@@ -57,6 +58,20 @@ extern size_t g_leaf_count;
 
 namespace {
 
+// Used by allocateCountDistinctBuffers in place of a bitmap size for the count
+// distinct slots which don't use a bitmap and for the APPROX_PERCENTILE slots.
+const ssize_t set_bitmap_size{-1};
+const ssize_t sparse_hll_bitmap_size{-2};
+const ssize_t quantile_sketch_bitmap_size{-3};
+
+double get_approx_percentile_param(const Analyzer::Expr* target_expr) {
+  const auto agg_expr = dynamic_cast<const Analyzer::AggExpr*>(target_expr);
+  CHECK(agg_expr && agg_expr->get_aggtype() == kAPPROX_PERCENTILE);
+  const auto quantile = agg_expr->get_arg1();
+  CHECK(quantile && quantile->get_type_info().get_type() == kDOUBLE);
+  return quantile->get_constval().doubleval;
+}
+
 void check_total_bitmap_memory(const QueryMemoryDescriptor& query_mem_desc) {
   const int32_t groups_buffer_entry_count =
       query_mem_desc.getEntryCount() + query_mem_desc.getEntryCountSmall();
@@ -382,8 +397,16 @@ void QueryExecutionContext::initColumnPerRow(const QueryMemoryDescriptor& query_
     } else {
       CHECK_EQ(static_cast<size_t>(query_mem_desc.getColumnWidth(col_idx).compact),
                sizeof(int64_t));
-      init_val =
-          bm_sz > 0 ? allocateCountDistinctBitmap(bm_sz) : allocateCountDistinctSet();
+      if (bm_sz > 0) {
+        init_val = allocateCountDistinctBitmap(bm_sz);
+      } else if (bm_sz == sparse_hll_bitmap_size) {
+        init_val = allocateCountDistinctSparseHll();
+      } else if (bm_sz == quantile_sketch_bitmap_size) {
+        CHECK_LT(col_idx, quantile_params_.size());
+        init_val = allocateQuantileSketch(quantile_params_[col_idx]);
+      } else {
+        init_val = allocateCountDistinctSet();
+      }
       ++init_vec_idx;
     }
     switch (query_mem_desc.getColumnWidth(col_idx).compact) {
@@ -466,7 +489,7 @@ void QueryExecutionContext::initColumnarGroups(int64_t* groups_buffer,
                                                const bool keyless) {
   for (const auto target_expr : executor_->plan_state_->target_exprs_) {
     const auto agg_info = target_info(target_expr);
-    CHECK(!is_distinct_target(agg_info));
+    CHECK(!is_distinct_target(agg_info) && agg_info.agg_kind != kAPPROX_PERCENTILE);
   }
   const bool need_padding = !query_mem_desc_.isCompactLayoutIsometric();
   const int32_t agg_col_count = query_mem_desc_.getColCount();
@@ -508,7 +531,9 @@ void QueryExecutionContext::initColumnarGroups(int64_t* groups_buffer,
 }
 
 // deferred is true for group by queries; initGroups will allocate a bitmap
-// for each group slot
+// for each group slot. Slots which need a set, sparse HyperLogLog or quantile
+// sketch instead get set_bitmap_size, sparse_hll_bitmap_size or
+// quantile_sketch_bitmap_size.
 std::vector<ssize_t> QueryExecutionContext::allocateCountDistinctBuffers(
     const bool deferred) {
   const size_t agg_col_count{query_mem_desc_.getColCount()};
@@ -536,14 +561,31 @@ std::vector<ssize_t> QueryExecutionContext::allocateCountDistinctBuffers(
         } else {
           init_agg_vals_[agg_col_idx] = allocateCountDistinctBitmap(bitmap_byte_sz);
         }
+      } else if (count_distinct_desc.impl_type_ == CountDistinctImplType::SparseHll) {
+        if (deferred) {
+          agg_bitmap_size[agg_col_idx] = sparse_hll_bitmap_size;
+        } else {
+          init_agg_vals_[agg_col_idx] = allocateCountDistinctSparseHll();
+        }
       } else {
-        CHECK(count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet);
+        CHECK(count_distinct_desc.impl_type_ == CountDistinctImplType::Set);
         if (deferred) {
-          agg_bitmap_size[agg_col_idx] = -1;
+          agg_bitmap_size[agg_col_idx] = set_bitmap_size;
         } else {
           init_agg_vals_[agg_col_idx] = allocateCountDistinctSet();
         }
       }
+    } else if (agg_info.agg_kind == kAPPROX_PERCENTILE) {
+      CHECK_EQ(static_cast<size_t>(query_mem_desc_.getColumnWidth(agg_col_idx).actual),
+               sizeof(int64_t));
+      const auto quantile = get_approx_percentile_param(target_expr);
+      if (deferred) {
+        agg_bitmap_size[agg_col_idx] = quantile_sketch_bitmap_size;
+        quantile_params_.resize(agg_col_count);
+        quantile_params_[agg_col_idx] = quantile;
+      } else {
+        init_agg_vals_[agg_col_idx] = allocateQuantileSketch(quantile);
+      }
     }
     if (agg_info.agg_kind == kAVG) {
       ++agg_col_idx;
@@ -567,8 +609,20 @@ int64_t QueryExecutionContext::allocateCountDistinctBitmap(const size_t bitmap_b
   return reinterpret_cast<int64_t>(count_distinct_buffer);
 }
 
+int64_t QueryExecutionContext::allocateCountDistinctSparseHll() {
+  auto sparse_hll = new SparseHyperLogLog();
+  row_set_mem_owner_->addCountDistinctSparseHll(sparse_hll);
+  return reinterpret_cast<int64_t>(sparse_hll);
+}
+
+int64_t QueryExecutionContext::allocateQuantileSketch(const double quantile) {
+  auto quantile_sketch = new QuantileSketch(quantile);
+  row_set_mem_owner_->addQuantileSketch(quantile_sketch);
+  return reinterpret_cast<int64_t>(quantile_sketch);
+}
+
 int64_t QueryExecutionContext::allocateCountDistinctSet() {
-  auto count_distinct_set = new std::set<int64_t>();
+  auto count_distinct_set = new CountDistinctSet();
   row_set_mem_owner_->addCountDistinctSet(count_distinct_set);
   return reinterpret_cast<int64_t>(count_distinct_set);
 }
@@ -1907,6 +1961,163 @@ std::vector<ssize_t> target_expr_proj_indices(const RelAlgExecutionUnit& ra_exe_
   return target_indices;
 }
 
+// The CPU kernels of a baseline group by each fill a buffer sized from the group count
+// estimate. When it's bigger than the last level cache and than the fragments of the
+// only input table, the kernels append one partial aggregate entry per matching row
+// instead (see get_scatter_group_value), to a buffer with as many entries as the
+// largest fragment has rows. The reduction scatters those entries into cache sized
+// partitions and merges the groups of every partition on its own. Returns the entry
+// count of the kernel buffers, 0 if the kernels should aggregate in place.
+size_t get_scatter_entry_count(const RelAlgExecutionUnit& ra_exe_unit,
+                               const std::vector<InputTableInfo>& query_infos,
+                               const QueryMemoryDescriptor& query_mem_desc) {
+  if (ra_exe_unit.input_descs.size() != 1 || query_infos.size() != 1 ||
+      !query_mem_desc.countDistinctDescriptorsLogicallyEmpty() ||
+      query_mem_desc.getBufferSizeBytes(ExecutorDeviceType::CPU) <=
+          (size_t(32) << 20)) {
+    return 0;
+  }
+  for (const auto& groupby_expr : ra_exe_unit.groupby_exprs) {
+    // an unnested array puts a row in several groups
+    const auto uoper = dynamic_cast<const Analyzer::UOper*>(groupby_expr.get());
+    if (uoper && uoper->get_optype() == kUNNEST) {
+      return 0;
+    }
+  }
+  for (const auto target_expr : ra_exe_unit.target_exprs) {
+    // the entries would each get a sketch
+    const auto agg_expr = dynamic_cast<const Analyzer::AggExpr*>(target_expr);
+    if (agg_expr && agg_expr->get_aggtype() == kAPPROX_PERCENTILE) {
+      return 0;
+    }
+  }
+  size_t max_fragment_rows{0};
+  for (const auto& fragment : query_infos.front().info.fragments) {
+    max_fragment_rows = std::max(max_fragment_rows, fragment.getNumTuples());
+  }
+  return max_fragment_rows < query_mem_desc.getEntryCount() ? max_fragment_rows : 0;
+}
+
+// Lexical rank of every string of a dictionary, by string id.
+std::vector<int64_t> get_string_ranks(StringDictionaryProxy* sdp) {
+  const auto strings = sdp->getDictionary()->copyStrings();
+  std::vector<int32_t> sorted_ids(strings->size());
+  std::iota(sorted_ids.begin(), sorted_ids.end(), 0);
+  std::sort(sorted_ids.begin(),
+            sorted_ids.end(),
+            [&strings](const int32_t lhs, const int32_t rhs) {
+              return (*strings)[lhs] < (*strings)[rhs];
+            });
+  std::vector<int64_t> string_ranks(std::max(sorted_ids.size(), size_t(1)));
+  for (size_t rank = 0; rank < sorted_ids.size(); ++rank) {
+    string_ranks[sorted_ids[rank]] = rank;
+  }
+  return string_ranks;
+}
+
+// Packs the order entries of a projection sorted on several columns into the key of
+// its streaming top-n heaps, using the value ranges of the entries. Floats take the
+// 32 bits which order them, dictionary-encoded string columns their rank in the
+// dictionary, on CPU only since the ranks stay in host memory. Empty if one of the
+// entries is of another type, is an integer without a known range or if they'd need
+// more than 62 bits, which keeps the key away from the empty key marker. Doubles need
+// 64 bits on their own and never fit.
+std::vector<streaming_top_n::PackedKeyField> get_streaming_top_n_packed_key(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<InputTableInfo>& query_infos,
+    const ExecutorDeviceType device_type,
+    const std::shared_ptr<RowSetMemoryOwner>& row_set_mem_owner,
+    const Executor* executor) {
+  const auto& order_entries = ra_exe_unit.sort_info.order_entries;
+  if (order_entries.size() < 2 || !ra_exe_unit.sort_info.limit ||
+      ra_exe_unit.sort_info.algorithm != SortAlgorithm::StreamingTopN) {
+    return {};
+  }
+  const size_t max_key_bits{62};
+  // sorting the strings of bigger dictionaries costs more than sorting the rows
+  const size_t max_ranked_strings{1000000};
+  std::vector<streaming_top_n::PackedKeyField> packed_key;
+  std::vector<size_t> field_bits;
+  std::vector<StringDictionaryProxy*> field_sdps;
+  size_t key_bits{0};
+  for (const auto& order_entry : order_entries) {
+    CHECK_GT(order_entry.tle_no, 0);
+    const size_t target_idx = order_entry.tle_no - 1;
+    CHECK_LT(target_idx, ra_exe_unit.target_exprs.size());
+    const auto target_expr = ra_exe_unit.target_exprs[target_idx];
+    const auto& ti = target_expr->get_type_info();
+    int64_t min{0};
+    int64_t max{0};
+    StringDictionaryProxy* sdp{nullptr};
+    if (ti.get_type() == kFLOAT) {
+      max = std::numeric_limits<uint32_t>::max();
+    } else if (ti.is_string()) {
+      // other string expressions may yield ids of transient strings
+      if (device_type != ExecutorDeviceType::CPU || g_cluster ||
+          ti.get_compression() != kENCODING_DICT ||
+          !dynamic_cast<const Analyzer::ColumnVar*>(target_expr)) {
+        return {};
+      }
+      sdp = executor->getStringDictionaryProxy(
+          ti.get_comp_param(), row_set_mem_owner, true);
+      CHECK(sdp);
+      if (sdp->storageEntryCount() > max_ranked_strings) {
+        return {};
+      }
+      max = std::max(sdp->storageEntryCount(), size_t(1)) - 1;
+    } else if (ti.is_integer() || ti.is_decimal() || ti.is_time()) {
+      const auto expr_range = getExpressionRange(
+          redirect_expr(target_expr, ra_exe_unit.input_col_descs).get(),
+          query_infos,
+          executor,
+          boost::make_optional(ra_exe_unit.simple_quals));
+      if (expr_range.getType() != ExpressionRangeType::Integer ||
+          expr_range.getIntMax() < expr_range.getIntMin()) {
+        return {};
+      }
+      min = expr_range.getIntMin();
+      max = expr_range.getIntMax();
+    } else {
+      return {};
+    }
+    const uint64_t value_span = static_cast<uint64_t>(max) - static_cast<uint64_t>(min);
+    if (value_span >= (uint64_t(1) << max_key_bits)) {
+      return {};
+    }
+    const bool has_nulls = !ti.get_notnull();
+    const uint64_t max_rank = value_span + (has_nulls ? 1 : 0);
+    size_t bits{0};
+    while (bits < 64 && (max_rank >> bits)) {
+      ++bits;
+    }
+    key_bits += bits;
+    if (key_bits > max_key_bits) {
+      return {};
+    }
+    packed_key.push_back({target_idx,
+                          order_entry.is_desc,
+                          order_entry.nulls_first,
+                          has_nulls,
+                          min,
+                          max,
+                          0,
+                          nullptr});
+    field_bits.push_back(bits);
+    field_sdps.push_back(sdp);
+  }
+  size_t shift{0};
+  for (size_t i = packed_key.size(); i > 0; --i) {
+    packed_key[i - 1].shift = shift;
+    shift += field_bits[i - 1];
+    if (field_sdps[i - 1]) {
+      // the memory owner keeps the ranks until the query is done
+      packed_key[i - 1].string_ranks =
+          row_set_mem_owner->addArray(get_string_ranks(field_sdps[i - 1]))->data();
+    }
+  }
+  return packed_key;
+}
+
 }  // namespace
 
 void GroupByAndAggregate::initQueryMemoryDescriptor(
@@ -2174,6 +2385,14 @@ void GroupByAndAggregate::initQueryMemoryDescriptor(
           {},
           {},
           false);
+      if (device_type_ == ExecutorDeviceType::CPU) {
+        const auto scatter_entry_count =
+            get_scatter_entry_count(ra_exe_unit_, query_infos_, query_mem_desc_);
+        if (scatter_entry_count) {
+          query_mem_desc_.setEntryCount(scatter_entry_count);
+          query_mem_desc_.setScattersPartialAggregates(true);
+        }
+      }
       return;
     }
     case GroupByColRangeType::Projection: {
@@ -2221,6 +2440,9 @@ void GroupByAndAggregate::initQueryMemoryDescriptor(
                                 {},
                                 {},
                                 false);
+      query_mem_desc_.setStreamingTopNPackedKey(
+          get_streaming_top_n_packed_key(
+              ra_exe_unit_, query_infos_, device_type_, row_set_mem_owner_, executor_));
       if (use_streaming_top_n(ra_exe_unit_, query_mem_desc_)) {
         query_mem_desc_.setEntryCount(ra_exe_unit_.sort_info.offset +
                                       ra_exe_unit_.sort_info.limit);
@@ -2376,10 +2598,10 @@ CountDistinctDescriptors GroupByAndAggregate::initCountDistinctDescriptors() {
           GroupByColRangeType::OneColGuessedRange, 0, 0, 0, false};
       auto arg_range_info =
           arg_ti.is_fp() ? no_range_info : getExprRangeInfo(agg_expr->get_arg());
-      CountDistinctImplType count_distinct_impl_type{CountDistinctImplType::StdSet};
+      CountDistinctImplType count_distinct_impl_type{CountDistinctImplType::Set};
       int64_t bitmap_sz_bits{0};
       if (agg_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
-        const auto error_rate = agg_expr->get_error_rate();
+        const auto error_rate = agg_expr->get_arg1();
         if (error_rate) {
           CHECK(error_rate->get_type_info().get_type() == kSMALLINT);
           CHECK_GE(error_rate->get_constval().smallintval, 1);
@@ -2406,17 +2628,26 @@ CountDistinctDescriptors GroupByAndAggregate::initCountDistinctDescriptors() {
           bitmap_sz_bits = arg_range_info.max - arg_range_info.min + 1;
           const int64_t MAX_BITMAP_BITS{8 * 1000 * 1000 * 1000L};
           if (bitmap_sz_bits <= 0 || bitmap_sz_bits > MAX_BITMAP_BITS) {
-            count_distinct_impl_type = CountDistinctImplType::StdSet;
+            count_distinct_impl_type = CountDistinctImplType::Set;
           }
         }
       }
       if (agg_info.agg_kind == kAPPROX_COUNT_DISTINCT &&
-          count_distinct_impl_type == CountDistinctImplType::StdSet &&
+          count_distinct_impl_type == CountDistinctImplType::Set &&
           !(arg_ti.is_array() || arg_ti.is_geometry())) {
         count_distinct_impl_type = CountDistinctImplType::Bitmap;
       }
+      if (agg_info.agg_kind == kAPPROX_COUNT_DISTINCT &&
+          count_distinct_impl_type == CountDistinctImplType::Bitmap &&
+          device_type_ == ExecutorDeviceType::CPU && !ra_exe_unit_.groupby_exprs.empty() &&
+          !g_cluster) {
+        // Most groups only see a few distinct values, don't allocate all the registers
+        // for each of them up front. Leaves keep the dense layout since the aggregator
+        // expects flat buffers.
+        count_distinct_impl_type = CountDistinctImplType::SparseHll;
+      }
       if (g_enable_watchdog &&
-          count_distinct_impl_type == CountDistinctImplType::StdSet) {
+          count_distinct_impl_type == CountDistinctImplType::Set) {
         throw WatchdogException("Cannot use a fast path for COUNT distinct");
       }
       const auto sub_bitmap_count =
@@ -2695,7 +2926,8 @@ bool GroupByAndAggregate::gpuCanHandleOrderEntries(
     auto agg_expr = static_cast<Analyzer::AggExpr*>(target_expr);
     if (agg_expr->get_is_distinct() || agg_expr->get_aggtype() == kAVG ||
         agg_expr->get_aggtype() == kMIN || agg_expr->get_aggtype() == kMAX ||
-        agg_expr->get_aggtype() == kAPPROX_COUNT_DISTINCT) {
+        agg_expr->get_aggtype() == kAPPROX_COUNT_DISTINCT ||
+        agg_expr->get_aggtype() == kAPPROX_PERCENTILE) {
       return false;
     }
     if (agg_expr->get_arg()) {
@@ -2833,8 +3065,10 @@ bool GroupByAndAggregate::codegen(llvm::Value* filter_result,
     }
 
     if (is_group_by) {
-      if (query_mem_desc_.getGroupByColRangeType() == GroupByColRangeType::Projection &&
-          !use_streaming_top_n(ra_exe_unit_, query_mem_desc_)) {
+      // the count of matched rows is the next output entry
+      if ((query_mem_desc_.getGroupByColRangeType() == GroupByColRangeType::Projection &&
+           !use_streaming_top_n(ra_exe_unit_, query_mem_desc_)) ||
+          query_mem_desc_.scattersPartialAggregates()) {
         const auto crt_match = get_arg_by_name(ROW_FUNC, "crt_match");
         LL_BUILDER.CreateStore(LL_INT(int32_t(1)), crt_match);
         auto total_matched_ptr = get_arg_by_name(ROW_FUNC, "total_matched");
@@ -2939,7 +3173,68 @@ llvm::Value* GroupByAndAggregate::codegenOutputSlot(llvm::Value* groups_buffer,
   }
   const int32_t row_size_quad =
       outputColumnar() ? 0 : query_mem_desc_.getRowSize() / sizeof(int64_t);
-  if (use_streaming_top_n(ra_exe_unit_, query_mem_desc_)) {
+  if (use_streaming_top_n(ra_exe_unit_, query_mem_desc_) &&
+      !query_mem_desc_.getStreamingTopNPackedKey().empty()) {
+    llvm::Value* key_lv = LL_INT(int64_t(0));
+    for (const auto& field : query_mem_desc_.getStreamingTopNPackedKey()) {
+      CHECK_LT(field.target_idx, ra_exe_unit_.target_exprs.size());
+      const auto order_entry_expr = ra_exe_unit_.target_exprs[field.target_idx];
+      const auto& oe_ti = order_entry_expr->get_type_info();
+      const auto oe_lv = executor_->codegen(order_entry_expr, true, co).front();
+      llvm::Value* val_lv{nullptr};
+      llvm::Value* is_null_lv{nullptr};
+      if (oe_ti.get_type() == kFLOAT) {
+        const auto fp_lv = executor_->castToTypeIn(oe_lv, 32);
+        is_null_lv = LL_BUILDER.CreateFCmpOEQ(
+            fp_lv, LL_FP(static_cast<float>(inline_fp_null_val(oe_ti))));
+        // flips the sign bit of positive values and every bit of negative ones, the
+        // unsigned order of the bits is then the order of the values
+        const auto bits_lv = LL_BUILDER.CreateZExt(
+            LL_BUILDER.CreateBitCast(fp_lv, get_int_type(32, LL_CONTEXT)),
+            get_int_type(64, LL_CONTEXT));
+        val_lv = LL_BUILDER.CreateSelect(
+            LL_BUILDER.CreateICmpUGE(bits_lv, LL_INT(int64_t(0x80000000))),
+            LL_BUILDER.CreateXor(bits_lv, LL_INT(int64_t(0xffffffff))),
+            LL_BUILDER.CreateOr(bits_lv, LL_INT(int64_t(0x80000000))));
+      } else {
+        val_lv = executor_->castToTypeIn(oe_lv, 64);
+        const auto null_lv = LL_INT(inline_int_null_val(oe_ti));
+        is_null_lv = LL_BUILDER.CreateICmpEQ(val_lv, null_lv);
+        if (field.string_ranks) {
+          CHECK(co.device_type_ == ExecutorDeviceType::CPU);
+          // a hoisted handle keeps the generated code the same from query to query
+          Datum string_ranks_handle;
+          string_ranks_handle.bigintval = reinterpret_cast<int64_t>(field.string_ranks);
+          llvm::Value* string_ranks_lv = LL_INT(string_ranks_handle.bigintval);
+          if (co.hoist_literals_) {
+            const Analyzer::Constant string_ranks_literal(
+                kBIGINT, false, string_ranks_handle);
+            const auto string_ranks_lvs = executor_->codegenHoistedConstants(
+                {&string_ranks_literal}, kENCODING_NONE, 0);
+            CHECK_EQ(size_t(1), string_ranks_lvs.size());
+            string_ranks_lv = string_ranks_lvs.front();
+          }
+          val_lv = emitCall("get_string_rank", {string_ranks_lv, val_lv, null_lv});
+        }
+      }
+      llvm::Value* rank_lv = field.is_desc
+                                 ? LL_BUILDER.CreateSub(LL_INT(field.max), val_lv)
+                                 : LL_BUILDER.CreateSub(val_lv, LL_INT(field.min));
+      if (field.has_nulls) {
+        // nulls rank either before all the values or after them
+        if (field.nulls_first) {
+          rank_lv = LL_BUILDER.CreateAdd(rank_lv, LL_INT(int64_t(1)));
+        }
+        const int64_t null_rank = field.nulls_first ? 0 : field.max - field.min + 1;
+        rank_lv = LL_BUILDER.CreateSelect(is_null_lv, LL_INT(null_rank), rank_lv);
+      }
+      const auto shift_lv = LL_INT(static_cast<int64_t>(field.shift));
+      key_lv = LL_BUILDER.CreateOr(key_lv, LL_BUILDER.CreateShl(rank_lv, shift_lv));
+    }
+    const uint32_t n = ra_exe_unit_.sort_info.offset + ra_exe_unit_.sort_info.limit;
+    return emitCall("get_bin_from_k_heap_packed_key",
+                    {groups_buffer, LL_INT(n), LL_INT(row_size_quad), key_lv});
+  } else if (use_streaming_top_n(ra_exe_unit_, query_mem_desc_)) {
     const auto& only_order_entry = ra_exe_unit_.sort_info.order_entries.front();
     CHECK_GE(only_order_entry.tle_no, int(1));
     const size_t target_idx = only_order_entry.tle_no - 1;
@@ -3155,6 +3450,22 @@ std::tuple<llvm::Value*, llvm::Value*> GroupByAndAggregate::codegenGroupBy(
                                                  llvm::Type::getInt64PtrTy(LL_CONTEXT));
       }
 #endif
+      if (query_mem_desc_.scattersPartialAggregates()) {
+        CHECK(co.device_type_ == ExecutorDeviceType::CPU);
+        const auto pos_lv =
+            LL_BUILDER.CreateLoad(get_arg_by_name(ROW_FUNC, "old_total_matched"));
+        return std::make_tuple(
+            emitCall("get_scatter_group_value",
+                     {&*groups_buffer,
+                      LL_INT(static_cast<int32_t>(query_mem_desc_.getEntryCount())),
+                      pos_lv,
+                      &*group_key,
+                      &*key_size_lv,
+                      LL_INT(static_cast<int32_t>(key_width)),
+                      LL_INT(row_size_quad),
+                      &*(++arg_it)}),
+            nullptr);
+      }
       return std::make_tuple(
           emitCall(co.with_dynamic_watchdog_ ? "get_group_value_with_watchdog"
                                              : "get_group_value",
@@ -3252,6 +3563,8 @@ std::vector<std::string> agg_fn_base_names(const TargetInfo& target_info) {
       return {"agg_approximate_count_distinct"};
     case kSAMPLE:
       return {"agg_id"};
+    case kAPPROX_PERCENTILE:
+      return {"agg_approx_percentile"};
     default:
       abort();
   }
@@ -3759,8 +4072,13 @@ void GroupByAndAggregate::codegenCountDistinct(
       query_mem_desc.getCountDistinctDescriptor(target_idx);
   CHECK(count_distinct_descriptor.impl_type_ != CountDistinctImplType::Invalid);
   if (agg_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
-    CHECK(count_distinct_descriptor.impl_type_ == CountDistinctImplType::Bitmap);
     agg_args.push_back(LL_INT(int32_t(count_distinct_descriptor.bitmap_sz_bits)));
+    if (count_distinct_descriptor.impl_type_ == CountDistinctImplType::SparseHll) {
+      CHECK(device_type == ExecutorDeviceType::CPU);
+      emitCall("agg_approximate_count_distinct_sparse", agg_args);
+      return;
+    }
+    CHECK(count_distinct_descriptor.impl_type_ == CountDistinctImplType::Bitmap);
     if (device_type == ExecutorDeviceType::GPU) {
       const auto base_dev_addr = getAdditionalLiteral(-1);
       const auto base_host_addr = getAdditionalLiteral(-2);
@@ -262,6 +262,8 @@ class QueryExecutionContext : boost::noncopyable {
   std::vector<ssize_t> allocateCountDistinctBuffers(const bool deferred);
   int64_t allocateCountDistinctBitmap(const size_t bitmap_byte_sz);
   int64_t allocateCountDistinctSet();
+  int64_t allocateCountDistinctSparseHll();
+  int64_t allocateQuantileSketch(const double quantile);
 
   std::vector<ColumnLazyFetchInfo> getColLazyFetchInfo(
       const std::vector<Analyzer::Expr*>& target_exprs) const;
@@ -293,6 +295,8 @@ class QueryExecutionContext : boost::noncopyable {
   int8_t* count_distinct_bitmap_host_mem_;
   int8_t* count_distinct_bitmap_crt_ptr_;
   size_t count_distinct_bitmap_mem_bytes_;
+  // APPROX_PERCENTILE quantiles by slot, for the sketches initGroups allocates
+  std::vector<double> quantile_params_;
 
   friend class Executor;
   friend void copy_group_by_buffers_from_gpu(
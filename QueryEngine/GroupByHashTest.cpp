@@ -265,6 +265,60 @@ TEST(SetGetTest, OneKeyAllCollisions) {
   ASSERT_EQ(gv, nullptr);
 }
 
+TEST(SetGetTest, OneKeyPowerOfTwo) {
+  const int32_t groups_buffer_entry_count{16};
+  const int32_t key_qw_count{1};
+  const int32_t row_size_quad{key_qw_count + 1};
+  GroupsBuffer gb(groups_buffer_entry_count, key_qw_count, 0);
+  int64_t key_start = 31;
+  for (int32_t i = 0; i < groups_buffer_entry_count; ++i) {
+    int64_t key = key_start + i;
+    auto gv = get_group_value(gb,
+                              groups_buffer_entry_count,
+                              &key,
+                              key_qw_count,
+                              sizeof(int64_t),
+                              row_size_quad);
+    ASSERT_NE(gv, nullptr);
+    *gv = key + 100;
+  }
+  for (int32_t i = 0; i < groups_buffer_entry_count; ++i) {
+    int64_t key = key_start + i;
+    auto gv = get_group_value(gb,
+                              groups_buffer_entry_count,
+                              &key,
+                              key_qw_count,
+                              sizeof(int64_t),
+                              row_size_quad);
+    ASSERT_NE(gv, nullptr);
+    ASSERT_EQ(*gv, key + 100);
+  }
+  int64_t key = key_start + groups_buffer_entry_count;
+  auto gv = get_group_value(
+      gb, groups_buffer_entry_count, &key, key_qw_count, sizeof(int64_t), row_size_quad);
+  ASSERT_EQ(gv, nullptr);
+}
+
+TEST(HashSlotTest, SlotsFollowTheHash) {
+  for (const uint32_t entry_count : {1u, 1000u, 1024u, 3000000019u}) {
+    uint32_t prev_slot{0};
+    for (uint64_t h = 0; h <= UINT32_MAX; h += 65537) {
+      const auto slot = get_group_hash_slot(h, entry_count);
+      ASSERT_LT(slot, entry_count);
+      ASSERT_LE(prev_slot, slot);
+      prev_slot = slot;
+    }
+    ASSERT_EQ(entry_count - 1, get_group_hash_slot(UINT32_MAX, entry_count));
+  }
+  ASSERT_EQ(uint32_t(500), get_group_hash_slot(uint32_t(1) << 31, 1000));
+}
+
+TEST(HashSlotTest, ProbeWrapsAround) {
+  ASSERT_EQ(uint32_t(1), get_group_probe_slot(0, 1000));
+  ASSERT_EQ(uint32_t(0), get_group_probe_slot(999, 1000));
+  ASSERT_EQ(uint32_t(0), get_group_probe_slot(0, 1));
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
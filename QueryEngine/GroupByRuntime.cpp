@@ -23,6 +23,18 @@ extern "C" ALWAYS_INLINE DEVICE uint32_t key_hash(const int64_t* key,
   return MurmurHash1(key, key_byte_width * key_count, 0);
 }
 
+// Maps the hash to a slot with a multiply and a shift, no integer division, for any
+// entry count. The slot grows with the hash, which the reduction partitions rely on.
+extern "C" ALWAYS_INLINE DEVICE uint32_t
+get_group_hash_slot(const uint32_t h, const uint32_t groups_buffer_entry_count) {
+  return (static_cast<uint64_t>(h) * groups_buffer_entry_count) >> 32;
+}
+
+extern "C" ALWAYS_INLINE DEVICE uint32_t
+get_group_probe_slot(const uint32_t slot, const uint32_t groups_buffer_entry_count) {
+  return slot + 1 < groups_buffer_entry_count ? slot + 1 : 0;
+}
+
 extern "C" NEVER_INLINE DEVICE int64_t* get_group_value(
     int64_t* groups_buffer,
     const uint32_t groups_buffer_entry_count,
@@ -31,20 +43,21 @@ extern "C" NEVER_INLINE DEVICE int64_t* get_group_value(
     const uint32_t key_width,
     const uint32_t row_size_quad,
     const int64_t* init_vals) {
-  uint32_t h = key_hash(key, key_count, key_width) % groups_buffer_entry_count;
+  uint32_t h = get_group_hash_slot(key_hash(key, key_count, key_width),
+                                   groups_buffer_entry_count);
   int64_t* matching_group = get_matching_group_value(
       groups_buffer, h, key, key_count, key_width, row_size_quad, init_vals);
   if (matching_group) {
     return matching_group;
   }
-  uint32_t h_probe = (h + 1) % groups_buffer_entry_count;
+  uint32_t h_probe = get_group_probe_slot(h, groups_buffer_entry_count);
   while (h_probe != h) {
     matching_group = get_matching_group_value(
         groups_buffer, h_probe, key, key_count, key_width, row_size_quad, init_vals);
     if (matching_group) {
       return matching_group;
     }
-    h_probe = (h_probe + 1) % groups_buffer_entry_count;
+    h_probe = get_group_probe_slot(h_probe, groups_buffer_entry_count);
   }
   return NULL;
 }
@@ -59,21 +72,22 @@ extern "C" NEVER_INLINE DEVICE int64_t* get_group_value_with_watchdog(
     const uint32_t key_width,
     const uint32_t row_size_quad,
     const int64_t* init_vals) {
-  uint32_t h = key_hash(key, key_count, key_width) % groups_buffer_entry_count;
+  uint32_t h = get_group_hash_slot(key_hash(key, key_count, key_width),
+                                   groups_buffer_entry_count);
   int64_t* matching_group = get_matching_group_value(
       groups_buffer, h, key, key_count, key_width, row_size_quad, init_vals);
   if (matching_group) {
     return matching_group;
   }
   uint32_t watchdog_countdown = 100;
-  uint32_t h_probe = (h + 1) % groups_buffer_entry_count;
+  uint32_t h_probe = get_group_probe_slot(h, groups_buffer_entry_count);
   while (h_probe != h) {
     matching_group = get_matching_group_value(
         groups_buffer, h_probe, key, key_count, key_width, row_size_quad, init_vals);
     if (matching_group) {
       return matching_group;
     }
-    h_probe = (h_probe + 1) % groups_buffer_entry_count;
+    h_probe = get_group_probe_slot(h_probe, groups_buffer_entry_count);
     if (--watchdog_countdown == 0) {
       if (dynamic_watchdog()) {
         return NULL;
@@ -84,25 +98,45 @@ extern "C" NEVER_INLINE DEVICE int64_t* get_group_value_with_watchdog(
   return NULL;
 }
 
+// Baseline group by kernels which scatter partial aggregates don't look the key up:
+// every matching row gets the next entry of the buffer, pos being the number of rows
+// matched so far, and the reduction merges the entries of the same group.
+extern "C" ALWAYS_INLINE DEVICE int64_t* get_scatter_group_value(
+    int64_t* groups_buffer,
+    const uint32_t groups_buffer_entry_count,
+    const uint32_t pos,
+    const int64_t* key,
+    const uint32_t key_count,
+    const uint32_t key_width,
+    const uint32_t row_size_quad,
+    const int64_t* init_vals) {
+  if (pos < groups_buffer_entry_count) {
+    return get_matching_group_value(
+        groups_buffer, pos, key, key_count, key_width, row_size_quad, init_vals);
+  }
+  return NULL;
+}
+
 extern "C" NEVER_INLINE DEVICE int64_t* get_group_value_columnar(
     int64_t* groups_buffer,
     const uint32_t groups_buffer_entry_count,
     const int64_t* key,
     const uint32_t key_qw_count) {
-  uint32_t h = key_hash(key, key_qw_count, sizeof(int64_t)) % groups_buffer_entry_count;
+  uint32_t h = get_group_hash_slot(key_hash(key, key_qw_count, sizeof(int64_t)),
+                                   groups_buffer_entry_count);
   int64_t* matching_group = get_matching_group_value_columnar(
       groups_buffer, h, key, key_qw_count, groups_buffer_entry_count);
   if (matching_group) {
     return matching_group;
   }
-  uint32_t h_probe = (h + 1) % groups_buffer_entry_count;
+  uint32_t h_probe = get_group_probe_slot(h, groups_buffer_entry_count);
   while (h_probe != h) {
     matching_group = get_matching_group_value_columnar(
         groups_buffer, h_probe, key, key_qw_count, groups_buffer_entry_count);
     if (matching_group) {
       return matching_group;
     }
-    h_probe = (h_probe + 1) % groups_buffer_entry_count;
+    h_probe = get_group_probe_slot(h_probe, groups_buffer_entry_count);
   }
   return NULL;
 }
@@ -112,21 +146,22 @@ extern "C" NEVER_INLINE DEVICE int64_t* get_group_value_columnar_with_watchdog(
     const uint32_t groups_buffer_entry_count,
     const int64_t* key,
     const uint32_t key_qw_count) {
-  uint32_t h = key_hash(key, key_qw_count, sizeof(int64_t)) % groups_buffer_entry_count;
+  uint32_t h = get_group_hash_slot(key_hash(key, key_qw_count, sizeof(int64_t)),
+                                   groups_buffer_entry_count);
   int64_t* matching_group = get_matching_group_value_columnar(
       groups_buffer, h, key, key_qw_count, groups_buffer_entry_count);
   if (matching_group) {
     return matching_group;
   }
   uint32_t watchdog_countdown = 100;
-  uint32_t h_probe = (h + 1) % groups_buffer_entry_count;
+  uint32_t h_probe = get_group_probe_slot(h, groups_buffer_entry_count);
   while (h_probe != h) {
     matching_group = get_matching_group_value_columnar(
         groups_buffer, h_probe, key, key_qw_count, groups_buffer_entry_count);
     if (matching_group) {
       return matching_group;
     }
-    h_probe = (h_probe + 1) % groups_buffer_entry_count;
+    h_probe = get_group_probe_slot(h_probe, groups_buffer_entry_count);
     if (--watchdog_countdown == 0) {
       if (dynamic_watchdog()) {
         return NULL;
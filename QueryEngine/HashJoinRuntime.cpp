@@ -30,6 +30,7 @@
 #include "../StringDictionary/StringDictionaryProxy.h"
 #include "RuntimeFunctions.h"
 
+#include <atomic>
 #include <future>
 #endif
 
@@ -962,6 +963,146 @@ void inclusive_scan(InputIterator first,
   }
 }
 
+namespace {
+
+// Slot of row i of the inner join column in a perfect hash table, after the same
+// null handling and dictionary translation as fill_hash_join_buff; -1 for the rows
+// which are left out of the table.
+int32_t get_partitioned_hash_slot(const JoinColumn& join_column,
+                                  const JoinColumnTypeInfo& type_info,
+                                  const StringDictionaryProxy* sd_inner_proxy,
+                                  const StringDictionaryProxy* sd_outer_proxy,
+                                  const size_t i) {
+  int64_t elem = type_info.is_unsigned
+                     ? fixed_width_unsigned_decode_noinline(
+                           join_column.col_buff, type_info.elem_sz, i)
+                     : fixed_width_int_decode_noinline(
+                           join_column.col_buff, type_info.elem_sz, i);
+  if (elem == type_info.null_val) {
+    if (!type_info.uses_bw_eq) {
+      return -1;
+    }
+    elem = type_info.translated_null_val;
+  }
+  if (sd_inner_proxy &&
+      (!type_info.uses_bw_eq || elem != type_info.translated_null_val)) {
+    CHECK(sd_outer_proxy);
+    const auto outer_id = sd_outer_proxy->getIdOfString(sd_inner_proxy->getString(elem));
+    if (outer_id == StringDictionary::INVALID_STR_ID) {
+      return -1;
+    }
+    elem = outer_id;
+  }
+  return elem - type_info.min_val;
+}
+
+}  // namespace
+
+int fill_hash_join_buff_partitioned(int32_t* buff,
+                                    const int32_t hash_entry_count,
+                                    const int32_t invalid_slot_val,
+                                    const JoinColumn& join_column,
+                                    const JoinColumnTypeInfo& type_info,
+                                    const void* sd_inner_proxy,
+                                    const void* sd_outer_proxy,
+                                    const int32_t cpu_thread_count) {
+  CHECK_GT(cpu_thread_count, 0);
+  const auto sd_inner_dict_proxy =
+      static_cast<const StringDictionaryProxy*>(sd_inner_proxy);
+  const auto sd_outer_dict_proxy =
+      static_cast<const StringDictionaryProxy*>(sd_outer_proxy);
+  const size_t partition_count =
+      (hash_entry_count + partitioned_hash_build_entry_count - 1) /
+      partitioned_hash_build_entry_count;
+  const size_t num_elems = join_column.num_elems;
+  const size_t step = (num_elems + cpu_thread_count - 1) / cpu_thread_count;
+  // Slot of every row and, for every thread, how many of its rows go to each
+  // partition, so that the rows can be scattered without synchronization.
+  std::vector<int32_t> row_slots(num_elems);
+  std::vector<std::vector<size_t>> partition_offsets(
+      cpu_thread_count, std::vector<size_t>(partition_count, 0));
+  std::vector<std::future<void>> partition_threads;
+  for (int32_t cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
+    partition_threads.push_back(std::async(std::launch::async, [&, cpu_thread_idx] {
+      auto& partition_sizes = partition_offsets[cpu_thread_idx];
+      const size_t end = std::min((cpu_thread_idx + 1) * step, num_elems);
+      for (size_t i = cpu_thread_idx * step; i < end; ++i) {
+        const auto slot = get_partitioned_hash_slot(
+            join_column, type_info, sd_inner_dict_proxy, sd_outer_dict_proxy, i);
+        row_slots[i] = slot;
+        if (slot >= 0) {
+          ++partition_sizes[slot / partitioned_hash_build_entry_count];
+        }
+      }
+    }));
+  }
+  for (auto& child : partition_threads) {
+    child.get();
+  }
+  std::vector<size_t> partition_starts(partition_count + 1);
+  size_t entry_count = 0;
+  for (size_t partition_idx = 0; partition_idx < partition_count; ++partition_idx) {
+    partition_starts[partition_idx] = entry_count;
+    for (auto& partition_sizes : partition_offsets) {
+      const auto partition_size = partition_sizes[partition_idx];
+      partition_sizes[partition_idx] = entry_count;
+      entry_count += partition_size;
+    }
+  }
+  partition_starts[partition_count] = entry_count;
+  // Pairs of slot and row id, grouped by partition.
+  std::vector<std::pair<int32_t, int32_t>> partitioned_entries(entry_count);
+  partition_threads.clear();
+  for (int32_t cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
+    partition_threads.push_back(std::async(std::launch::async, [&, cpu_thread_idx] {
+      auto& offsets = partition_offsets[cpu_thread_idx];
+      const size_t end = std::min((cpu_thread_idx + 1) * step, num_elems);
+      for (size_t i = cpu_thread_idx * step; i < end; ++i) {
+        const auto slot = row_slots[i];
+        if (slot >= 0) {
+          partitioned_entries[offsets[slot / partitioned_hash_build_entry_count]++] =
+              std::make_pair(slot, static_cast<int32_t>(i));
+        }
+      }
+    }));
+  }
+  for (auto& child : partition_threads) {
+    child.get();
+  }
+  // Every partition owns a cache-sized, disjoint range of slots, which its thread
+  // initializes and fills without atomics.
+  std::atomic<size_t> next_partition_idx{0};
+  std::vector<std::future<int>> build_threads;
+  for (int32_t cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
+    build_threads.push_back(std::async(std::launch::async, [&] {
+      for (auto partition_idx = next_partition_idx++; partition_idx < partition_count;
+           partition_idx = next_partition_idx++) {
+        const size_t slot_start = partition_idx * partitioned_hash_build_entry_count;
+        const size_t slot_end =
+            std::min(slot_start + partitioned_hash_build_entry_count,
+                     static_cast<size_t>(hash_entry_count));
+        std::fill(buff + slot_start, buff + slot_end, invalid_slot_val);
+        for (size_t i = partition_starts[partition_idx];
+             i < partition_starts[partition_idx + 1];
+             ++i) {
+          const auto& entry = partitioned_entries[i];
+          if (buff[entry.first] != invalid_slot_val) {
+            return -1;
+          }
+          buff[entry.first] = entry.second;
+        }
+      }
+      return 0;
+    }));
+  }
+  int err = 0;
+  for (auto& child : build_threads) {
+    const auto partial_err = child.get();
+    err = err ? err : partial_err;
+  }
+  return err;
+}
+
 void fill_one_to_many_hash_table(int32_t* buff,
                                  const int32_t hash_entry_count,
                                  const int32_t invalid_slot_val,
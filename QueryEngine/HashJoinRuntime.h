@@ -121,6 +121,23 @@ void fill_hash_join_buff_on_device_sharded(int32_t* buff,
                                            const size_t block_size_x,
                                            const size_t grid_size_x);
 
+// Number of slots of the partitions of fill_hash_join_buff_partitioned, 256 KB.
+constexpr int32_t partitioned_hash_build_entry_count{1 << 16};
+
+// Same result as fill_hash_join_buff, built for large inner tables: the rows are
+// first radix-partitioned on the high bits of their slot, then every partition is
+// written by a single thread, so that the writes stay within a cache-sized region
+// of the buffer. The buffer gets initialized as well. This only speeds up the build,
+// the outer rows still probe the whole table.
+int fill_hash_join_buff_partitioned(int32_t* buff,
+                                    const int32_t hash_entry_count,
+                                    const int32_t invalid_slot_val,
+                                    const JoinColumn& join_column,
+                                    const JoinColumnTypeInfo& type_info,
+                                    const void* sd_inner_proxy,
+                                    const void* sd_outer_proxy,
+                                    const int32_t cpu_thread_count);
+
 void fill_one_to_many_hash_table(int32_t* buff,
                                  const int32_t hash_entry_count,
                                  const int32_t invalid_slot_val,
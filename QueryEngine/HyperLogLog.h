@@ -26,7 +26,9 @@
 #define QUERYENGINE_HYPERLOGLOG_H
 
 #include "CountDistinctDescriptor.h"
+#include "SparseHyperLogLog.h"
 
+#include <algorithm>
 #include <cmath>
 
 inline double get_alpha(const size_t m) {
@@ -54,57 +56,67 @@ inline double get_beta(const uint32_t zeros) {
   return beta;
 }
 
-template <typename T>
-inline double get_harmonic_mean_denominator(T* M, uint32_t m) {
-  double accumulator = 0.0;
-
-  for (unsigned i = 0; i < m; i++) {
-    accumulator += (1.0 / (1ULL << M[i]));
-  }
-  return accumulator;
+inline double get_beta_adjusted_estimate(const size_t m,
+                                        const uint32_t z,
+                                        const double harmonic_mean_denominator) {
+  return (get_alpha(m) * m * (m - z) * (1 / (get_beta(z) + harmonic_mean_denominator)));
 }
 
-template <typename T>
-inline double get_beta_adjusted_estimate(const size_t m, const uint32_t z, T* M) {
-  return (get_alpha(m) * m * (m - z) *
-          (1 / (get_beta(z) + get_harmonic_mean_denominator(M, m))));
+inline double get_alpha_adjusted_estimate(const size_t m,
+                                         const double harmonic_mean_denominator) {
+  return (get_alpha(m) * m * m) * (1 / harmonic_mean_denominator);
 }
 
-template <typename T>
-inline double get_alpha_adjusted_estimate(const size_t m, T* M) {
-  return (get_alpha(m) * m * m) * (1 / get_harmonic_mean_denominator(M, m));
-};
-
-template <typename T>
-inline uint32_t count_zeros(T* M, size_t m) {
-  uint32_t zeros = 0;
-  for (uint32_t i = 0; i < m; i++) {
-    if (M[i] == 0) {
-      zeros++;
-    }
-  }
-  return zeros;
-}
+// Registers hold ranks between 0 and 64 - b + 1.
+constexpr size_t hll_max_rank{64};
 
-template <class T>
-inline size_t hll_size(const T* M, const size_t bitmap_sz_bits) {
+// The estimate only depends on how many registers hold each rank.
+inline size_t hll_size_from_rank_counts(const uint32_t* rank_counts,
+                                        const size_t bitmap_sz_bits) {
   size_t m = 1 << bitmap_sz_bits;
 
-  uint32_t zeros = count_zeros(M, m);
-  double estimate = get_alpha_adjusted_estimate(m, M);
+  const uint32_t zeros = rank_counts[0];
+  double harmonic_mean_denominator = 0.0;
+  for (int rank = hll_max_rank; rank >= 0; --rank) {
+    harmonic_mean_denominator += ldexp(rank_counts[rank], -rank);
+  }
+  double estimate = get_alpha_adjusted_estimate(m, harmonic_mean_denominator);
   if (estimate <= 2.5 * m) {
     if (zeros != 0) {
       estimate = m * log(static_cast<double>(m) / zeros);
     }
   } else {
     if (bitmap_sz_bits == 14) {  // Apply LogLog-Beta adjustment only when p=14
-      estimate = get_beta_adjusted_estimate(m, zeros, M);
+      estimate = get_beta_adjusted_estimate(m, zeros, harmonic_mean_denominator);
     }
   }
   // No correction for large estimates since we're using 64-bit hashes.
   return estimate;
 }
 
+// A single pass building the rank histogram, instead of a division and a shift per
+// register for the harmonic mean plus another pass counting the zeros.
+template <class T>
+inline size_t hll_size(const T* M, const size_t bitmap_sz_bits) {
+  const size_t m = 1 << bitmap_sz_bits;
+  uint32_t rank_counts[hll_max_rank + 1] = {};
+  for (size_t r = 0; r < m; ++r) {
+    ++rank_counts[M[r]];
+  }
+  return hll_size_from_rank_counts(rank_counts, bitmap_sz_bits);
+}
+
+inline size_t hll_size(const SparseHyperLogLog& hll, const size_t bitmap_sz_bits) {
+  if (hll.isDense()) {
+    return hll_size(hll.denseRegisters(), bitmap_sz_bits);
+  }
+  uint32_t rank_counts[hll_max_rank + 1] = {};
+  rank_counts[0] = (1 << bitmap_sz_bits) - hll.sparseRegisterCount();
+  hll.forEachSparseRegister(
+      [&rank_counts](const uint32_t, const uint8_t rank) { ++rank_counts[rank]; });
+  return hll_size_from_rank_counts(rank_counts, bitmap_sz_bits);
+}
+
 template <class T1, class T2>
 inline void hll_unify(T1* lhs, T2* rhs, const size_t m) {
   for (size_t r = 0; r < m; ++r) {
@@ -112,6 +124,17 @@ inline void hll_unify(T1* lhs, T2* rhs, const size_t m) {
   }
 }
 
+// Same register width on both sides, a branch free loop over non-aliasing buffers
+// which gets compiled to packed max instructions.
+template <class T>
+inline void hll_unify(T* __restrict lhs, T* __restrict rhs, const size_t m) {
+  for (size_t r = 0; r < m; ++r) {
+    const auto reg = std::max(lhs[r], rhs[r]);
+    lhs[r] = reg;
+    rhs[r] = reg;
+  }
+}
+
 inline int hll_size_for_rate(const int err_percent) {
   double err_rate{static_cast<double>(err_percent) / 100.0};
   double k = ceil(2 * log2(1.04 / err_rate));
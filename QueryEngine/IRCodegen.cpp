@@ -17,6 +17,8 @@
 #include "../Parser/ParserNode.h"
 #include "Execute.h"
 #include "MaxwellCodegenPatch.h"
+#include "RangeJoinTable.h"
+#include "SpatialJoinTable.h"
 #include "RelAlgTranslator.h"
 
 // Driver methods for the IR generation.
@@ -534,6 +536,52 @@ std::shared_ptr<JoinHashTableInterface> Executor::buildCurrentLevelHashTable(
       }
     }
   }
+  if (!current_level_hash_table &&
+      current_level_join_conditions.type == JoinType::INNER &&
+      !current_level_join_conditions.quals.empty()) {
+    // The quals are filters already, spatial and range joins only narrow down the
+    // inner rows.
+    std::set<int> rte_idx_set;
+    for (const auto& join_qual : current_level_join_conditions.quals) {
+      join_qual->collect_rte_idx(rte_idx_set);
+    }
+    const int inner_rte_idx = rte_idx_set.empty() ? 0 : *rte_idx_set.rbegin();
+    const auto memory_level = co.device_type_ == ExecutorDeviceType::GPU
+                                  ? MemoryLevel::GPU_LEVEL
+                                  : MemoryLevel::CPU_LEVEL;
+    std::shared_ptr<Analyzer::BinOper> tautology;
+    try {
+      current_level_hash_table =
+          SpatialJoinTable::getInstance(current_level_join_conditions.quals,
+                                        inner_rte_idx,
+                                        query_infos,
+                                        memory_level,
+                                        deviceCount(co.device_type_),
+                                        this);
+    } catch (const HashJoinFail& e) {
+      fail_reasons.push_back(e.what());
+    }
+    if (!current_level_hash_table) {
+      try {
+        const auto range_join_table =
+            RangeJoinTable::getInstance(current_level_join_conditions.quals,
+                                        inner_rte_idx,
+                                        query_infos,
+                                        ra_exe_unit,
+                                        memory_level,
+                                        column_cache,
+                                        this);
+        tautology = range_join_table->getTautology();
+        current_level_hash_table = range_join_table;
+      } catch (const HashJoinFail& e) {
+        fail_reasons.push_back(e.what());
+      }
+    }
+    if (current_level_hash_table) {
+      plan_state_->join_info_.join_hash_tables_.push_back(current_level_hash_table);
+      plan_state_->join_info_.equi_join_tautologies_.push_back(tautology);
+    }
+  }
   return current_level_hash_table;
 }
 
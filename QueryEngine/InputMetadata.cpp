@@ -81,6 +81,29 @@ bool uses_int_meta(const SQLTypeInfo& col_ti) {
          (col_ti.is_string() && col_ti.get_compression() == kENCODING_DICT);
 }
 
+// Values of a column collected to update the stats of its dummy encoder in batches.
+struct ColumnStatsBatch {
+  std::vector<int64_t> int_vals;
+  std::vector<double> fp_vals;
+};
+
+constexpr size_t column_stats_batch_size{4096};
+
+void flush_column_stats(Encoder* dummy_encoder,
+                        ColumnStatsBatch& batch,
+                        const SQLTypeInfo& col_ti) {
+  if (!batch.int_vals.empty()) {
+    dummy_encoder->updateStats(
+        &batch.int_vals[0], batch.int_vals.size(), inline_int_null_val(col_ti));
+    batch.int_vals.clear();
+  }
+  if (!batch.fp_vals.empty()) {
+    dummy_encoder->updateStats(
+        &batch.fp_vals[0], batch.fp_vals.size(), inline_fp_null_val(col_ti));
+    batch.fp_vals.clear();
+  }
+}
+
 std::map<int, ChunkMetadata> synthesize_metadata(const ResultSet* rows) {
   rows->moveToBegin();
   std::vector<std::vector<std::unique_ptr<Encoder>>> dummy_encoders;
@@ -92,31 +115,33 @@ std::map<int, ChunkMetadata> synthesize_metadata(const ResultSet* rows) {
       dummy_encoders.back().emplace_back(Encoder::Create(nullptr, col_ti));
     }
   }
+  std::vector<std::vector<ColumnStatsBatch>> stats_batches(
+      worker_count, std::vector<ColumnStatsBatch>(rows->colCount()));
   const auto do_work = [rows](const std::vector<TargetValue>& crt_row,
-                              std::vector<std::unique_ptr<Encoder>>& dummy_encoders) {
+                              std::vector<std::unique_ptr<Encoder>>& dummy_encoders,
+                              std::vector<ColumnStatsBatch>& stats_batches) {
     for (size_t i = 0; i < rows->colCount(); ++i) {
       const auto& col_ti = rows->getColType(i);
       const auto& col_val = crt_row[i];
       const auto scalar_col_val = boost::get<ScalarTargetValue>(&col_val);
       CHECK(scalar_col_val);
+      auto& batch = stats_batches[i];
       if (uses_int_meta(col_ti)) {
         const auto i64_p = boost::get<int64_t>(scalar_col_val);
         CHECK(i64_p);
-        dummy_encoders[i]->updateStats(*i64_p, *i64_p == inline_int_null_val(col_ti));
+        batch.int_vals.push_back(*i64_p);
       } else if (col_ti.is_fp()) {
         switch (col_ti.get_type()) {
           case kFLOAT: {
             const auto float_p = boost::get<float>(scalar_col_val);
             CHECK(float_p);
-            dummy_encoders[i]->updateStats(*float_p,
-                                           *float_p == inline_fp_null_val(col_ti));
+            batch.fp_vals.push_back(*float_p);
             break;
           }
           case kDOUBLE: {
             const auto double_p = boost::get<double>(scalar_col_val);
             CHECK(double_p);
-            dummy_encoders[i]->updateStats(*double_p,
-                                           *double_p == inline_fp_null_val(col_ti));
+            batch.fp_vals.push_back(*double_p);
             break;
           }
           default:
@@ -126,6 +151,9 @@ std::map<int, ChunkMetadata> synthesize_metadata(const ResultSet* rows) {
         throw std::runtime_error(col_ti.get_type_name() +
                                  " is not supported in temporary table.");
       }
+      if (batch.int_vals.size() + batch.fp_vals.size() == column_stats_batch_size) {
+        flush_column_stats(dummy_encoders[i].get(), batch, col_ti);
+      }
     }
   };
   if (use_parallel_algorithms(*rows)) {
@@ -140,12 +168,14 @@ std::map<int, ChunkMetadata> synthesize_metadata(const ResultSet* rows) {
       const auto end_entry = std::min(start_entry + stride, entry_count);
       compute_stats_threads.push_back(
           std::async(std::launch::async,
-                     [rows, &do_work, &dummy_encoders](
+                     [rows, &do_work, &dummy_encoders, &stats_batches](
                          const size_t start, const size_t end, const size_t worker_idx) {
                        for (size_t i = start; i < end; ++i) {
                          const auto crt_row = rows->getRowAtNoTranslations(i);
                          if (!crt_row.empty()) {
-                           do_work(crt_row, dummy_encoders[worker_idx]);
+                           do_work(crt_row,
+                                   dummy_encoders[worker_idx],
+                                   stats_batches[worker_idx]);
                          }
                        }
                      },
@@ -165,10 +195,17 @@ std::map<int, ChunkMetadata> synthesize_metadata(const ResultSet* rows) {
       if (crt_row.empty()) {
         break;
       }
-      do_work(crt_row, dummy_encoders[0]);
+      do_work(crt_row, dummy_encoders[0], stats_batches[0]);
     }
     rows->moveToBegin();
   }
+  for (size_t worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
+    for (size_t i = 0; i < rows->colCount(); ++i) {
+      flush_column_stats(dummy_encoders[worker_idx][i].get(),
+                         stats_batches[worker_idx][i],
+                         rows->getColType(i));
+    }
+  }
   std::map<int, ChunkMetadata> metadata_map;
   for (size_t worker_idx = 1; worker_idx < worker_count; ++worker_idx) {
     CHECK_LT(worker_idx, dummy_encoders.size());
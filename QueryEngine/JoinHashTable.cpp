@@ -27,6 +27,8 @@
 #include <numeric>
 #include <thread>
 
+size_t g_partitioned_hash_build_threshold{1 << 22};
+
 std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*> normalize_column_pair(
     const Analyzer::Expr* lhs,
     const Analyzer::Expr* rhs,
@@ -134,6 +136,9 @@ size_t get_hash_entry_count(const ExpressionRange& col_range, const bool is_bw_e
 std::vector<std::pair<JoinHashTable::JoinHashTableCacheKey,
                       std::shared_ptr<std::vector<int32_t>>>>
     JoinHashTable::join_hash_table_cache_;
+std::vector<std::pair<JoinHashTable::JoinHashTableCacheKey,
+                      std::shared_ptr<const RuntimeJoinFilter>>>
+    JoinHashTable::runtime_filter_cache_;
 std::mutex JoinHashTable::join_hash_table_cache_mutex_;
 
 size_t get_shard_count(const Analyzer::BinOper* join_condition,
@@ -372,6 +377,30 @@ bool needs_dictionary_translation(const Analyzer::ColumnVar* inner_col,
   return outer_ti.get_comp_param() != inner_ti.get_comp_param();
 }
 
+std::shared_ptr<Analyzer::ColumnVar> get_runtime_filter_outer_col(
+    const Analyzer::ColumnVar* inner_col,
+    const Analyzer::Expr* outer_expr,
+    const SQLOps optype) {
+  // Nulls are equal for the bitwise equality, the filter doesn't keep them.
+  if (optype != kEQ) {
+    return nullptr;
+  }
+  const auto outer_col = dynamic_cast<const Analyzer::ColumnVar*>(outer_expr);
+  if (!outer_col) {
+    return nullptr;
+  }
+  const auto& inner_ti = inner_col->get_type_info();
+  const auto& outer_ti = outer_col->get_type_info();
+  if (!inner_ti.is_integer() && !inner_ti.is_time()) {
+    return nullptr;
+  }
+  if (inner_ti.get_type() != outer_ti.get_type() ||
+      inner_ti.get_dimension() != outer_ti.get_dimension()) {
+    return nullptr;
+  }
+  return std::dynamic_pointer_cast<Analyzer::ColumnVar>(outer_col->deep_copy());
+}
+
 std::deque<Fragmenter_Namespace::FragmentInfo> only_shards_for_device(
     const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments,
     const int device_id,
@@ -464,6 +493,55 @@ void JoinHashTable::reify(const int device_count) {
       init_thread.get();
     }
   }
+  buildRuntimeFilters(query_info.fragments);
+}
+
+void JoinHashTable::buildRuntimeFilters(
+    const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments) {
+  const auto& catalog = *executor_->getCatalog();
+  const auto cols = get_cols(qual_bin_oper_, catalog, executor_->temporary_tables_);
+  const auto inner_col = cols.first;
+  CHECK(inner_col);
+  auto outer_col =
+      get_runtime_filter_outer_col(inner_col, cols.second, qual_bin_oper_->get_optype());
+  if (!outer_col) {
+    return;
+  }
+  size_t num_elements = 0;
+  for (const auto& fragment : fragments) {
+    num_elements += fragment.getNumTuples();
+  }
+  const JoinHashTableCacheKey cache_key{col_range_,
+                                       *inner_col,
+                                       *outer_col,
+                                       num_elements,
+                                       genHashTableKey(fragments, cols.second, inner_col),
+                                       qual_bin_oper_->get_optype()};
+  const auto cached_filter = getRuntimeFilterFromCache(cache_key);
+  if (cached_filter) {
+    runtime_filters_.push_back({outer_col, cached_filter});
+    return;
+  }
+  // The filter is only used on the host, fetch the keys there even if the hash
+  // table lives on the GPU. For a CPU table, the column comes from the cache.
+  std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks_owner;
+  ThrustAllocator dev_buff_owner(&catalog.get_dataMgr(), 0);
+  const auto col_buff_and_count = fetchFragments(
+      inner_col, fragments, Data_Namespace::CPU_LEVEL, 0, chunks_owner, dev_buff_owner);
+  const auto& ti = inner_col->get_type_info();
+  const JoinColumn join_column{col_buff_and_count.first, col_buff_and_count.second};
+  const JoinColumnTypeInfo type_info{static_cast<size_t>(ti.get_size()),
+                                     0,
+                                     inline_fixed_encoding_null_val(ti),
+                                     false,
+                                     0,
+                                     is_unsigned_type(ti)};
+  const auto filter =
+      std::make_shared<const RuntimeJoinFilter>(join_column, type_info, cpu_threads());
+  if (inner_col->get_table_id() > 0) {
+    putRuntimeFilterToCache(cache_key, filter);
+  }
+  runtime_filters_.push_back({outer_col, filter});
 }
 
 std::pair<const int8_t*, size_t> JoinHashTable::fetchFragments(
@@ -711,50 +789,66 @@ int JoinHashTable::initHashTableOnCpu(
       CHECK(sd_outer_proxy);
     }
     int thread_count = cpu_threads();
-    std::vector<std::thread> init_cpu_buff_threads;
-    for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
-      init_cpu_buff_threads.emplace_back(
-          [this, hash_entry_count, hash_join_invalid_val, thread_idx, thread_count] {
-            init_hash_join_buff(&(*cpu_hash_table_buff_)[0],
-                                hash_entry_count,
-                                hash_join_invalid_val,
-                                thread_idx,
-                                thread_count);
-          });
-    }
-    for (auto& t : init_cpu_buff_threads) {
-      t.join();
-    }
-    init_cpu_buff_threads.clear();
-    for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
-      init_cpu_buff_threads.emplace_back([this,
-                                          hash_join_invalid_val,
-                                          col_buff,
-                                          num_elements,
-                                          sd_inner_proxy,
-                                          sd_outer_proxy,
-                                          thread_idx,
-                                          thread_count,
-                                          &ti,
-                                          &err] {
-        int partial_err = fill_hash_join_buff(&(*cpu_hash_table_buff_)[0],
-                                              hash_join_invalid_val,
-                                              {col_buff, num_elements},
-                                              {static_cast<size_t>(ti.get_size()),
-                                               col_range_.getIntMin(),
-                                               inline_fixed_encoding_null_val(ti),
-                                               isBitwiseEq(),
-                                               col_range_.getIntMax() + 1,
-                                               is_unsigned_type(ti)},
-                                              sd_inner_proxy,
-                                              sd_outer_proxy,
-                                              thread_idx,
-                                              thread_count);
-        __sync_val_compare_and_swap(&err, 0, partial_err);
-      });
-    }
-    for (auto& t : init_cpu_buff_threads) {
-      t.join();
+    if (num_elements >= g_partitioned_hash_build_threshold) {
+      err = fill_hash_join_buff_partitioned(&(*cpu_hash_table_buff_)[0],
+                                            hash_entry_count,
+                                            hash_join_invalid_val,
+                                            {col_buff, num_elements},
+                                            {static_cast<size_t>(ti.get_size()),
+                                             col_range_.getIntMin(),
+                                             inline_fixed_encoding_null_val(ti),
+                                             isBitwiseEq(),
+                                             col_range_.getIntMax() + 1,
+                                             is_unsigned_type(ti)},
+                                            sd_inner_proxy,
+                                            sd_outer_proxy,
+                                            thread_count);
+    } else {
+      std::vector<std::thread> init_cpu_buff_threads;
+      for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+        init_cpu_buff_threads.emplace_back(
+            [this, hash_entry_count, hash_join_invalid_val, thread_idx, thread_count] {
+              init_hash_join_buff(&(*cpu_hash_table_buff_)[0],
+                                  hash_entry_count,
+                                  hash_join_invalid_val,
+                                  thread_idx,
+                                  thread_count);
+            });
+      }
+      for (auto& t : init_cpu_buff_threads) {
+        t.join();
+      }
+      init_cpu_buff_threads.clear();
+      for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+        init_cpu_buff_threads.emplace_back([this,
+                                            hash_join_invalid_val,
+                                            col_buff,
+                                            num_elements,
+                                            sd_inner_proxy,
+                                            sd_outer_proxy,
+                                            thread_idx,
+                                            thread_count,
+                                            &ti,
+                                            &err] {
+          int partial_err = fill_hash_join_buff(&(*cpu_hash_table_buff_)[0],
+                                                hash_join_invalid_val,
+                                                {col_buff, num_elements},
+                                                {static_cast<size_t>(ti.get_size()),
+                                                 col_range_.getIntMin(),
+                                                 inline_fixed_encoding_null_val(ti),
+                                                 isBitwiseEq(),
+                                                 col_range_.getIntMax() + 1,
+                                                 is_unsigned_type(ti)},
+                                                sd_inner_proxy,
+                                                sd_outer_proxy,
+                                                thread_idx,
+                                                thread_count);
+          __sync_val_compare_and_swap(&err, 0, partial_err);
+        });
+      }
+      for (auto& t : init_cpu_buff_threads) {
+        t.join();
+      }
     }
     if (err) {
       cpu_hash_table_buff_.reset();
@@ -1132,6 +1226,29 @@ void JoinHashTable::putHashTableOnCpuToCache(
   join_hash_table_cache_.emplace_back(cache_key, cpu_hash_table_buff_);
 }
 
+std::shared_ptr<const RuntimeJoinFilter> JoinHashTable::getRuntimeFilterFromCache(
+    const JoinHashTableCacheKey& key) const {
+  std::lock_guard<std::mutex> join_hash_table_cache_lock(join_hash_table_cache_mutex_);
+  for (const auto& kv : runtime_filter_cache_) {
+    if (kv.first == key) {
+      return kv.second;
+    }
+  }
+  return nullptr;
+}
+
+void JoinHashTable::putRuntimeFilterToCache(
+    const JoinHashTableCacheKey& key,
+    const std::shared_ptr<const RuntimeJoinFilter>& filter) {
+  std::lock_guard<std::mutex> join_hash_table_cache_lock(join_hash_table_cache_mutex_);
+  for (const auto& kv : runtime_filter_cache_) {
+    if (kv.first == key) {
+      return;
+    }
+  }
+  runtime_filter_cache_.emplace_back(key, filter);
+}
+
 llvm::Value* JoinHashTable::codegenHashTableLoad(const size_t table_idx) {
   const auto hash_ptr = codegenHashTableLoad(table_idx, executor_);
   if (hash_ptr->getType()->isIntegerTy(64)) {
@@ -91,6 +91,11 @@ class JoinHashTable : public JoinHashTableInterface {
 
   HashType getHashType() const noexcept override { return hash_type_; }
 
+  const std::vector<OuterColumnRuntimeFilter>& getRuntimeFilters() const
+      noexcept override {
+    return runtime_filters_;
+  }
+
   static llvm::Value* codegenOneToManyHashJoin(
       const std::vector<llvm::Value*>& hash_join_idx_args_in,
       const size_t inner_rte_idx,
@@ -114,6 +119,7 @@ class JoinHashTable : public JoinHashTableInterface {
     return []() -> void {
       std::lock_guard<std::mutex> guard(join_hash_table_cache_mutex_);
       join_hash_table_cache_.clear();
+      runtime_filter_cache_.clear();
     };
   }
 
@@ -168,6 +174,8 @@ class JoinHashTable : public JoinHashTableInterface {
       const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments,
       const int device_id);
   void checkHashJoinReplicationConstraint(const int table_id) const;
+  void buildRuntimeFilters(
+      const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments);
   void initHashTableForDevice(
       const ChunkKey& chunk_key,
       const int8_t* col_buff,
@@ -249,6 +257,7 @@ class JoinHashTable : public JoinHashTableInterface {
   std::pair<const int8_t*, size_t> linearized_multifrag_column_;
   std::mutex linearized_multifrag_column_mutex_;
   RowSetMemoryOwner linearized_multifrag_column_owner_;
+  std::vector<OuterColumnRuntimeFilter> runtime_filters_;
 
   struct JoinHashTableCacheKey {
     const ExpressionRange col_range;
@@ -268,8 +277,17 @@ class JoinHashTable : public JoinHashTableInterface {
   static std::vector<
       std::pair<JoinHashTableCacheKey, std::shared_ptr<std::vector<int32_t>>>>
       join_hash_table_cache_;
+  // guarded by join_hash_table_cache_mutex_ as well
+  static std::vector<
+      std::pair<JoinHashTableCacheKey, std::shared_ptr<const RuntimeJoinFilter>>>
+      runtime_filter_cache_;
   static std::mutex join_hash_table_cache_mutex_;
 
+  std::shared_ptr<const RuntimeJoinFilter> getRuntimeFilterFromCache(
+      const JoinHashTableCacheKey&) const;
+  void putRuntimeFilterToCache(const JoinHashTableCacheKey&,
+                               const std::shared_ptr<const RuntimeJoinFilter>&);
+
   static const int ERR_MULTI_FRAG{-2};
   static const int ERR_FAILED_TO_FETCH_COLUMN{-3};
   static const int ERR_FAILED_TO_JOIN_ON_VIRTUAL_COLUMN{-4};
@@ -309,6 +327,14 @@ std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*> normalize_column_pa
     const Catalog_Namespace::Catalog& cat,
     const TemporaryTables* temporary_tables);
 
+// Copy of the outer column of a join condition on which the probe side can use a
+// runtime filter, null if there is none: the filter keeps the inner key values as
+// they are, which only match an outer column of the same integer or time type.
+std::shared_ptr<Analyzer::ColumnVar> get_runtime_filter_outer_col(
+    const Analyzer::ColumnVar* inner_col,
+    const Analyzer::Expr* outer_expr,
+    const SQLOps optype);
+
 std::deque<Fragmenter_Namespace::FragmentInfo> only_shards_for_device(
     const std::deque<Fragmenter_Namespace::FragmentInfo>& fragments,
     const int device_id,
@@ -18,7 +18,14 @@
 
 #include <llvm/IR/Value.h>
 #include <cstdint>
+#include <memory>
+#include <vector>
 #include "CompilationOptions.h"
+#include "RuntimeJoinFilter.h"
+
+namespace Analyzer {
+class ColumnVar;
+}  // namespace Analyzer
 
 class TooManyHashEntries : public std::runtime_error {
  public:
@@ -59,6 +66,12 @@ class MultiFragJoinNotSupported : public HashJoinFail {
 };
 #endif
 
+// Build side keys of a join condition, for the probe side column they're compared to.
+struct OuterColumnRuntimeFilter {
+  std::shared_ptr<Analyzer::ColumnVar> outer_col;
+  std::shared_ptr<const RuntimeJoinFilter> filter;
+};
+
 struct HashJoinMatchingSet {
   llvm::Value* elements;
   llvm::Value* count;
@@ -87,6 +100,10 @@ class JoinHashTableInterface {
   };
 
   virtual HashType getHashType() const noexcept = 0;
+
+  // Summaries of the inner keys, empty if no key component qualifies for one.
+  virtual const std::vector<OuterColumnRuntimeFilter>& getRuntimeFilters() const
+      noexcept = 0;
 };
 
 #endif  // QUERYENGINE_JOINHASHTABLEINTERFACE_H
@@ -16,6 +16,7 @@
 
 #include "CompareKeysInl.h"
 #include "MurmurHash.h"
+#include "SpatialJoinGrid.h"
 
 DEVICE bool compare_to_key(const int8_t* entry,
                            const int8_t* key,
@@ -129,3 +130,76 @@ get_composite_key_index_64(const int64_t* key,
   return get_composite_key_index_impl(
       key, key_component_count, composite_key_dict, entry_count);
 }
+
+// Adds offset to the outer value of a range join bound, saturating on overflow:
+// a wider bound is safe, the join condition gets evaluated on the matches anyway.
+FORCE_INLINE DEVICE int64_t range_join_bound_val(const int64_t val,
+                                                 const int64_t offset) {
+  if (offset > 0 && val > INT64_MAX - offset) {
+    return INT64_MAX;
+  }
+  if (offset < 0 && val < INT64_MIN - offset) {
+    return INT64_MIN;
+  }
+  return val + offset;
+}
+
+// Position of the first of the sorted keys of a range join table which is greater
+// than or equal to val + offset, entry_count if there's none.
+extern "C" NEVER_INLINE DEVICE int64_t range_join_lower_bound(const int64_t* sorted_keys,
+                                                              const int64_t entry_count,
+                                                              const int64_t val,
+                                                              const int64_t offset) {
+  const auto bound_val = range_join_bound_val(val, offset);
+  int64_t lo = 0;
+  int64_t hi = entry_count;
+  while (lo < hi) {
+    const auto mid = lo + (hi - lo) / 2;
+    if (sorted_keys[mid] < bound_val) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+// Position of the first of the sorted keys of a range join table which is greater
+// than val + offset, entry_count if there's none.
+extern "C" NEVER_INLINE DEVICE int64_t range_join_upper_bound(const int64_t* sorted_keys,
+                                                              const int64_t entry_count,
+                                                              const int64_t val,
+                                                              const int64_t offset) {
+  const auto bound_val = range_join_bound_val(val, offset);
+  int64_t lo = 0;
+  int64_t hi = entry_count;
+  while (lo < hi) {
+    const auto mid = lo + (hi - lo) / 2;
+    if (sorted_keys[mid] <= bound_val) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+// Cell of the uniform grid of a spatial join table which contains (x, y), -1 if the
+// point is outside of the grid.
+extern "C" ALWAYS_INLINE DEVICE int64_t spatial_join_cell(const double x,
+                                                        const double y,
+                                                        const double min_x,
+                                                        const double max_x,
+                                                        const double min_y,
+                                                        const double max_y,
+                                                        const double inv_cell_width,
+                                                        const double inv_cell_height,
+                                                        const int64_t dim_x,
+                                                        const int64_t dim_y) {
+  const auto cell_x = spatial_join_grid_coord(x, min_x, max_x, inv_cell_width, dim_x);
+  const auto cell_y = spatial_join_grid_coord(y, min_y, max_y, inv_cell_height, dim_y);
+  if (cell_x < 0 || cell_y < 0) {
+    return -1;
+  }
+  return cell_y * dim_x + cell_x;
+}
@@ -411,6 +411,7 @@ declare i64* @get_bin_from_k_heap_int32_t(i64*, i32, i32, i32, i1, i1, i1, i32,
 declare i64* @get_bin_from_k_heap_int64_t(i64*, i32, i32, i32, i1, i1, i1, i64, i64);
 declare i64* @get_bin_from_k_heap_float(i64*, i32, i32, i32, i1, i1, i1, float, float);
 declare i64* @get_bin_from_k_heap_double(i64*, i32, i32, i32, i1, i1, i1, double, double);
+declare i64* @get_bin_from_k_heap_packed_key(i64*, i32, i32, i64);
 )" + gen_array_any_all_sigs() +
     gen_translate_null_key_sigs();
 
@@ -950,6 +951,9 @@ std::vector<std::string> get_agg_fnames(const std::vector<Analyzer::Expr*>& targ
       case kAPPROX_COUNT_DISTINCT:
         result.push_back("agg_approximate_count_distinct");
         break;
+      case kAPPROX_PERCENTILE:
+        result.push_back("agg_approx_percentile_double");
+        break;
       default:
         CHECK(false);
     }
@@ -1223,12 +1227,18 @@ Executor::CompilationResult Executor::compileWorkUnit(
     for (size_t i = 0; i < num_count_distinct_descs; i++) {
       const auto& count_distinct_descriptor =
           query_mem_desc.getCountDistinctDescriptor(i);
-      if (count_distinct_descriptor.impl_type_ == CountDistinctImplType::StdSet ||
+      if (count_distinct_descriptor.impl_type_ == CountDistinctImplType::Set ||
           (count_distinct_descriptor.impl_type_ != CountDistinctImplType::Invalid &&
            !co.hoist_literals_)) {
         throw QueryMustRunOnCpu();
       }
     }
+    // the quantile sketches live in host memory
+    for (const auto target_expr : ra_exe_unit.target_exprs) {
+      if (target_info(target_expr).agg_kind == kAPPROX_PERCENTILE) {
+        throw QueryMustRunOnCpu();
+      }
+    }
   }
 
   if (co.device_type_ == ExecutorDeviceType::GPU &&
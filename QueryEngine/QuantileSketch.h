@@ -0,0 +1,197 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    QuantileSketch.h
+ * @brief   Mergeable quantile sketch backing APPROX_PERCENTILE.
+ *
+ * A merging t-digest: values are buffered and periodically merged into a sorted
+ * list of centroids whose sizes are bounded by the arcsine scale function, which
+ * keeps the centroids near both tails small. The number of centroids is bounded
+ * by the compression, independently of the number of values. Two sketches merge
+ * by pooling their centroids, which is what the result set reduction does.
+ *
+ * Included by the runtime functions, which get compiled to bitcode as C++11 and
+ * without glog, keep it that way.
+ */
+
+#ifndef QUERYENGINE_QUANTILESKETCH_H
+#define QUERYENGINE_QUANTILESKETCH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+class QuantileSketch {
+ public:
+  explicit QuantileSketch(const double quantile)
+      : quantile_(quantile)
+      , total_weight_(0)
+      , min_(std::numeric_limits<double>::infinity())
+      , max_(-std::numeric_limits<double>::infinity()) {}
+
+  void add(const double value) {
+    buffer_.push_back({value, 1});
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+    if (buffer_.size() >= buffer_capacity) {
+      compress();
+    }
+  }
+
+  void merge(const QuantileSketch& that) {
+    if (this == &that || that.empty()) {
+      return;
+    }
+    buffer_.insert(buffer_.end(), that.centroids_.begin(), that.centroids_.end());
+    buffer_.insert(buffer_.end(), that.buffer_.begin(), that.buffer_.end());
+    min_ = std::min(min_, that.min_);
+    max_ = std::max(max_, that.max_);
+    compress();
+  }
+
+  bool empty() const { return centroids_.empty() && buffer_.empty(); }
+
+  // The quantile the query asked for, between 0 and 1.
+  double getQuantileParam() const { return quantile_; }
+
+  // Estimate of the requested quantile, NaN for an empty sketch.
+  double quantile() const {
+    if (buffer_.empty()) {
+      return quantile(centroids_, total_weight_);
+    }
+    std::vector<Centroid> centroids(centroids_);
+    std::vector<Centroid> buffer(buffer_);
+    double total_weight{0};
+    merge_centroids(centroids, buffer, total_weight);
+    return quantile(centroids, total_weight);
+  }
+
+  void compress() { merge_centroids(centroids_, buffer_, total_weight_); }
+
+  size_t centroidCount() const { return centroids_.size(); }
+
+  static const size_t compression{200};
+  static const size_t buffer_capacity{2 * compression};
+
+ private:
+  struct Centroid {
+    double mean;
+    double weight;
+  };
+
+  static constexpr double pi{3.14159265358979323846};
+
+  // The arcsine scale function and its inverse. A centroid may span at most one
+  // unit of k.
+  static double k_of_q(const double q) {
+    return compression / (2 * pi) * std::asin(2 * q - 1);
+  }
+
+  static double q_of_k(const double k) {
+    if (k >= compression / 4.) {
+      return 1;
+    }
+    return (std::sin(2 * pi * k / compression) + 1) / 2;
+  }
+
+  static void merge_centroids(std::vector<Centroid>& centroids,
+                              std::vector<Centroid>& buffer,
+                              double& total_weight) {
+    if (buffer.empty()) {
+      return;
+    }
+    buffer.insert(buffer.end(), centroids.begin(), centroids.end());
+    std::sort(buffer.begin(), buffer.end(), [](const Centroid& lhs, const Centroid& rhs) {
+      return lhs.mean < rhs.mean;
+    });
+    double total{0};
+    for (const auto& centroid : buffer) {
+      total += centroid.weight;
+    }
+    centroids.clear();
+    auto current = buffer.front();
+    double weight_so_far{0};
+    double weight_limit = total * q_of_k(k_of_q(0) + 1);
+    for (size_t i = 1; i < buffer.size(); ++i) {
+      const auto& next = buffer[i];
+      if (weight_so_far + current.weight + next.weight <= weight_limit) {
+        current.weight += next.weight;
+        current.mean += (next.mean - current.mean) * next.weight / current.weight;
+        continue;
+      }
+      weight_so_far += current.weight;
+      centroids.push_back(current);
+      weight_limit = total * q_of_k(k_of_q(weight_so_far / total) + 1);
+      current = next;
+    }
+    centroids.push_back(current);
+    buffer.clear();
+    total_weight = total;
+  }
+
+  // Interpolates between the centroid means, which sit in the middle of their
+  // weight, and uses the exact minimum and maximum for the tails.
+  double quantile(const std::vector<Centroid>& centroids,
+                  const double total_weight) const {
+    if (centroids.empty()) {
+      return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (centroids.size() == 1) {
+      return centroids.front().mean;
+    }
+    const double index = quantile_ * total_weight;
+    const auto& first = centroids.front();
+    if (index < first.weight / 2) {
+      return min_ + (first.mean - min_) * index / (first.weight / 2);
+    }
+    double weight_so_far = first.weight / 2;
+    for (size_t i = 0; i + 1 < centroids.size(); ++i) {
+      const double delta = (centroids[i].weight + centroids[i + 1].weight) / 2;
+      if (weight_so_far + delta > index) {
+        const double fraction = (index - weight_so_far) / delta;
+        return centroids[i].mean +
+               fraction * (centroids[i + 1].mean - centroids[i].mean);
+      }
+      weight_so_far += delta;
+    }
+    const auto& last = centroids.back();
+    const double fraction = std::min((index - weight_so_far) / (last.weight / 2), 1.);
+    return last.mean + fraction * (max_ - last.mean);
+  }
+
+  double quantile_;
+  std::vector<Centroid> centroids_;
+  // values and centroids not merged into centroids_ yet
+  std::vector<Centroid> buffer_;
+  double total_weight_;
+  double min_;
+  double max_;
+};
+
+// Estimate of the sketch an APPROX_PERCENTILE slot points to, NaN if there is no
+// sketch or it is empty.
+inline double approx_percentile_value(const int64_t sketch_ptr) {
+  if (!sketch_ptr) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  return reinterpret_cast<const QuantileSketch*>(sketch_ptr)->quantile();
+}
+
+#endif  // QUERYENGINE_QUANTILESKETCH_H
@@ -94,7 +94,14 @@ void QueryFragmentDescriptor::buildFragmentPerKernelMap(
     const auto& fragment = (*outer_fragments)[i];
     const auto skip_frag = executor->skipFragment(
         outer_table_desc, fragment, ra_exe_unit.simple_quals, frag_offsets, i);
-    if (skip_frag.first) {
+    if (skip_frag.first ||
+        executor->skipFragmentFilters(outer_table_desc, ra_exe_unit, fragment)) {
+      ++skipped_outer_fragments_;
+      continue;
+    }
+    if (skip_frag.second == -1 && executor->skipFragmentRuntimeJoinFilters(
+                                      outer_table_desc, ra_exe_unit, fragment)) {
+      ++skipped_outer_fragments_;
       continue;
     }
     // NOTE: Using kernel index instead of frag index now
@@ -168,7 +175,14 @@ void QueryFragmentDescriptor::buildMultifragKernelMap(
       skip_frag = executor->skipFragmentInnerJoins(
           outer_table_desc, ra_exe_unit, fragment, frag_offsets, outer_frag_id);
     }
-    if (skip_frag.first) {
+    if (skip_frag.first ||
+        executor->skipFragmentFilters(outer_table_desc, ra_exe_unit, fragment)) {
+      ++skipped_outer_fragments_;
+      continue;
+    }
+    if (skip_frag.second == -1 && executor->skipFragmentRuntimeJoinFilters(
+                                      outer_table_desc, ra_exe_unit, fragment)) {
+      ++skipped_outer_fragments_;
       continue;
     }
     const int device_id =
@@ -98,8 +98,14 @@ class QueryFragmentDescriptor {
     return rowid_lookup_key_ < 0 && fragments_per_kernel_.size() > 0;
   }
 
+  size_t getOuterFragmentCount() const { return outer_fragments_size_; }
+
+  // Outer fragments the filters or the join keys rule out, judging by their metadata.
+  size_t getSkippedOuterFragmentCount() const { return skipped_outer_fragments_; }
+
  protected:
   size_t outer_fragments_size_ = 0;
+  size_t skipped_outer_fragments_ = 0;
   int64_t rowid_lookup_key_ = -1;
 
   std::map<int, const TableFragments*> selected_tables_fragments_;
@@ -53,6 +53,7 @@ QueryMemoryDescriptor::QueryMemoryDescriptor()
     , output_columnar_(false)
     , render_output_(false)
     , must_use_baseline_sort_(false)
+    , scatters_partial_aggregates_(false)
     , force_4byte_float_(false) {
 }
 
@@ -80,6 +81,7 @@ QueryMemoryDescriptor::QueryMemoryDescriptor(const Executor* executor,
     , output_columnar_(false)
     , render_output_(false)
     , must_use_baseline_sort_(false)
+    , scatters_partial_aggregates_(false)
     , force_4byte_float_(false) {
 }
 
@@ -110,6 +112,7 @@ QueryMemoryDescriptor::QueryMemoryDescriptor(const GroupByColRangeType hash_type
     , output_columnar_(false)
     , render_output_(false)
     , must_use_baseline_sort_(false)
+    , scatters_partial_aggregates_(false)
     , force_4byte_float_(false) {
 }
 
@@ -168,6 +171,7 @@ QueryMemoryDescriptor::QueryMemoryDescriptor(
     , key_column_pad_bytes_(key_column_pad_bytes)
     , target_column_pad_bytes_(target_column_pad_bytes)
     , must_use_baseline_sort_(must_use_baseline_sort)
+    , scatters_partial_aggregates_(false)
     , force_4byte_float_(false) {
 }
 
@@ -192,6 +196,9 @@ bool QueryMemoryDescriptor::operator==(const QueryMemoryDescriptor& other) const
   if (force_4byte_float_ != other.force_4byte_float_) {
     return false;
   }
+  if (scatters_partial_aggregates_ != other.scatters_partial_aggregates_) {
+    return false;
+  }
   if (group_col_widths_ != other.group_col_widths_) {
     return false;
   }
@@ -27,6 +27,7 @@
 
 #include "CompilationOptions.h"
 #include "CountDistinct.h"
+#include "StreamingTopN.h"
 
 #include <glog/logging.h>
 
@@ -225,6 +226,14 @@ class QueryMemoryDescriptor {
   size_t getEntryCount() const { return entry_count_; }
   void setEntryCount(const size_t val) { entry_count_ = val; }
 
+  const std::vector<streaming_top_n::PackedKeyField>& getStreamingTopNPackedKey() const {
+    return streaming_top_n_packed_key_;
+  }
+  void setStreamingTopNPackedKey(
+      const std::vector<streaming_top_n::PackedKeyField>& packed_key) {
+    streaming_top_n_packed_key_ = packed_key;
+  }
+
   size_t getEntryCountSmall() const { return entry_count_small_; }
   void setEntryCountSmall(const size_t val) { entry_count_small_ = val; }
 
@@ -267,6 +276,11 @@ class QueryMemoryDescriptor {
 
   bool mustUseBaselineSort() const { return must_use_baseline_sort_; }
 
+  bool scattersPartialAggregates() const { return scatters_partial_aggregates_; }
+  void setScattersPartialAggregates(const bool val) {
+    scatters_partial_aggregates_ = val;
+  }
+
   // TODO(adb): remove and store this info more naturally in another
   // member
   bool forceFourByteFloat() const { return force_4byte_float_; }
@@ -371,6 +385,11 @@ class QueryMemoryDescriptor {
   std::vector<int8_t> key_column_pad_bytes_;
   std::vector<int8_t> target_column_pad_bytes_;
   bool must_use_baseline_sort_;
+  // baseline only: the kernels append one entry per matching row instead of
+  // aggregating them, the buffer must be reduced even if there's only one
+  bool scatters_partial_aggregates_;
+  // empty unless the streaming top-n heaps order on several order entries
+  std::vector<streaming_top_n::PackedKeyField> streaming_top_n_packed_key_;
 
   bool force_4byte_float_;
 
@@ -0,0 +1,459 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RangeJoinTable.h"
+#include "Execute.h"
+#include "ExpressionRewrite.h"
+#include "RuntimeFunctions.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <set>
+
+namespace {
+
+bool is_range_join_type(const SQLTypeInfo& ti) {
+  return ti.is_integer() || ti.is_decimal() || ti.is_time();
+}
+
+bool is_lower_bound(const SQLOps optype) {
+  return optype == kGT || optype == kGE;
+}
+
+// The column itself or the column under a widening integer cast, which doesn't
+// change the values.
+std::shared_ptr<Analyzer::ColumnVar> get_range_join_col(
+    const std::shared_ptr<Analyzer::Expr>& expr) {
+  auto col = std::dynamic_pointer_cast<Analyzer::ColumnVar>(expr);
+  if (col) {
+    return is_range_join_type(col->get_type_info()) ? col : nullptr;
+  }
+  const auto cast = std::dynamic_pointer_cast<Analyzer::UOper>(expr);
+  if (!cast || cast->get_optype() != kCAST) {
+    return nullptr;
+  }
+  col = std::dynamic_pointer_cast<Analyzer::ColumnVar>(cast->get_own_operand());
+  if (!col) {
+    return nullptr;
+  }
+  const auto& col_ti = col->get_type_info();
+  const auto& cast_ti = cast->get_type_info();
+  return col_ti.is_integer() && cast_ti.is_integer() &&
+                 cast_ti.get_size() >= col_ti.get_size()
+             ? col
+             : nullptr;
+}
+
+// Values of two columns can be subtracted if they're compared in the same units.
+bool have_same_units(const SQLTypeInfo& lhs_ti, const SQLTypeInfo& rhs_ti) {
+  return (lhs_ti.is_integer() && rhs_ti.is_integer()) ||
+         (lhs_ti.get_type() == rhs_ti.get_type() &&
+          lhs_ti.get_scale() == rhs_ti.get_scale());
+}
+
+// Largest col - key for a lower bound on col, largest key - col for an upper bound,
+// over the rows where neither is null. False on overflow.
+bool get_derived_bound_offset(const std::vector<int64_t>& keys,
+                              const int64_t key_null_val,
+                              const std::vector<int64_t>& col_vals,
+                              const int64_t col_null_val,
+                              const bool is_lower,
+                              int64_t& offset) {
+  CHECK_EQ(keys.size(), col_vals.size());
+  int64_t max_diff{0};
+  bool found_row{false};
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (keys[i] == key_null_val || col_vals[i] == col_null_val) {
+      continue;
+    }
+    int64_t diff{0};
+    if (is_lower ? __builtin_sub_overflow(col_vals[i], keys[i], &diff)
+                 : __builtin_sub_overflow(keys[i], col_vals[i], &diff)) {
+      return false;
+    }
+    max_diff = found_row ? std::max(max_diff, diff) : diff;
+    found_row = true;
+  }
+  if (!is_lower) {
+    offset = max_diff;
+    return true;
+  }
+  // key >= col - max(col - key) >= outer value - max(col - key)
+  if (max_diff == std::numeric_limits<int64_t>::min()) {
+    return false;
+  }
+  offset = -max_diff;
+  return true;
+}
+
+void sort_entries(std::vector<std::pair<int64_t, int32_t>>& entries) {
+  const size_t thread_count = cpu_threads();
+  if (entries.size() < 100000 || thread_count < 2) {
+    std::sort(entries.begin(), entries.end());
+    return;
+  }
+  const size_t step = (entries.size() + thread_count - 1) / thread_count;
+  std::vector<size_t> run_starts;
+  std::vector<std::future<void>> sort_threads;
+  for (size_t start = 0; start < entries.size(); start += step) {
+    const size_t end = std::min(start + step, entries.size());
+    run_starts.push_back(start);
+    sort_threads.push_back(std::async(std::launch::async, [&entries, start, end] {
+      std::sort(entries.begin() + start, entries.begin() + end);
+    }));
+  }
+  for (auto& child : sort_threads) {
+    child.get();
+  }
+  run_starts.push_back(entries.size());
+  while (run_starts.size() > 2) {
+    std::vector<size_t> merged_run_starts;
+    std::vector<std::future<void>> merge_threads;
+    for (size_t i = 0; i + 2 < run_starts.size(); i += 2) {
+      const auto first = run_starts[i];
+      const auto middle = run_starts[i + 1];
+      const auto last = run_starts[i + 2];
+      merged_run_starts.push_back(first);
+      merge_threads.push_back(
+          std::async(std::launch::async, [&entries, first, middle, last] {
+            std::inplace_merge(entries.begin() + first,
+                               entries.begin() + middle,
+                               entries.begin() + last);
+          }));
+    }
+    if (run_starts.size() % 2 == 0) {
+      merged_run_starts.push_back(run_starts[run_starts.size() - 2]);
+    }
+    merged_run_starts.push_back(entries.size());
+    for (auto& child : merge_threads) {
+      child.get();
+    }
+    run_starts.swap(merged_run_starts);
+  }
+}
+
+}  // namespace
+
+std::shared_ptr<RangeJoinTable> RangeJoinTable::getInstance(
+    const std::list<std::shared_ptr<Analyzer::Expr>>& join_quals,
+    const int inner_rte_idx,
+    const std::vector<InputTableInfo>& query_infos,
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const Data_Namespace::MemoryLevel memory_level,
+    ColumnCacheMap& column_cache,
+    Executor* executor) {
+  std::vector<Bound> bounds;
+  for (const auto& join_qual : join_quals) {
+    collectBounds(join_qual, inner_rte_idx, bounds);
+  }
+  if (bounds.empty()) {
+    throw HashJoinFail("No range join condition found");
+  }
+  // Prefer a column bounded on both sides, the iteration domain is exact then.
+  std::shared_ptr<Analyzer::ColumnVar> key_col;
+  int key_col_sides{0};
+  for (const auto& bound : bounds) {
+    bool has_lower{false};
+    bool has_upper{false};
+    for (const auto& col_bound : bounds) {
+      if (*col_bound.inner_col == *bound.inner_col) {
+        has_lower = has_lower || is_lower_bound(col_bound.optype);
+        has_upper = has_upper || !is_lower_bound(col_bound.optype);
+      }
+    }
+    const int sides = static_cast<int>(has_lower) + static_cast<int>(has_upper);
+    if (sides > key_col_sides) {
+      key_col = bound.inner_col;
+      key_col_sides = sides;
+    }
+  }
+  CHECK(key_col);
+  const auto& catalog = *executor->getCatalog();
+  for (const auto& bound : bounds) {
+    const auto cd = get_column_descriptor_maybe(
+        bound.inner_col->get_column_id(), bound.inner_col->get_table_id(), catalog);
+    if (cd && cd->isVirtualCol) {
+      throw FailedToJoinOnVirtualColumn();
+    }
+  }
+  if (g_cluster && key_col->get_table_id() >= 0) {
+    const auto inner_td = catalog.getMetadataForTable(key_col->get_table_id());
+    CHECK(inner_td);
+    if (!table_is_replicated(inner_td)) {
+      throw HashJoinFail("Join table " + inner_td->tableName + " must be replicated");
+    }
+  }
+  // The sorted column is only kept on the host.
+  if (memory_level == Data_Namespace::GPU_LEVEL) {
+    throw QueryMustRunOnCpu();
+  }
+  std::vector<Bound> key_bounds;
+  std::vector<Bound> other_bounds;
+  for (const auto& bound : bounds) {
+    if (*bound.inner_col == *key_col) {
+      key_bounds.push_back(bound);
+    } else {
+      other_bounds.push_back(bound);
+    }
+  }
+  auto range_join_table = std::shared_ptr<RangeJoinTable>(
+      new RangeJoinTable(key_col, query_infos, column_cache, executor));
+  try {
+    range_join_table->reify(key_bounds, other_bounds, ra_exe_unit);
+  } catch (const HashJoinFail&) {
+    throw;
+  } catch (const std::exception& e) {
+    throw HashJoinFail(std::string("Could not build the range join table | ") +
+                       e.what());
+  }
+  return range_join_table;
+}
+
+void RangeJoinTable::collectBounds(const std::shared_ptr<Analyzer::Expr>& qual,
+                                   const int inner_rte_idx,
+                                   std::vector<Bound>& bounds) {
+  const auto bin_oper = std::dynamic_pointer_cast<Analyzer::BinOper>(qual);
+  if (!bin_oper) {
+    return;
+  }
+  const auto optype = bin_oper->get_optype();
+  if (optype == kAND) {
+    collectBounds(bin_oper->get_own_left_operand(), inner_rte_idx, bounds);
+    collectBounds(bin_oper->get_own_right_operand(), inner_rte_idx, bounds);
+    return;
+  }
+  if ((optype != kLT && optype != kLE && optype != kGT && optype != kGE) ||
+      bin_oper->get_qualifier() != kONE) {
+    return;
+  }
+  const auto& lhs_ti = bin_oper->get_left_operand()->get_type_info();
+  const auto& rhs_ti = bin_oper->get_right_operand()->get_type_info();
+  if (!is_range_join_type(lhs_ti) || lhs_ti.get_type() != rhs_ti.get_type() ||
+      lhs_ti.get_scale() != rhs_ti.get_scale()) {
+    return;
+  }
+  for (const bool inner_is_lhs : {true, false}) {
+    const auto inner_col = get_range_join_col(inner_is_lhs
+                                                  ? bin_oper->get_own_left_operand()
+                                                  : bin_oper->get_own_right_operand());
+    if (!inner_col || inner_col->get_rte_idx() != inner_rte_idx) {
+      continue;
+    }
+    const auto outer_expr = inner_is_lhs ? bin_oper->get_own_right_operand()
+                                         : bin_oper->get_own_left_operand();
+    std::set<int> outer_rte_idx_set;
+    outer_expr->collect_rte_idx(outer_rte_idx_set);
+    if (outer_rte_idx_set.empty() || *outer_rte_idx_set.rbegin() >= inner_rte_idx) {
+      continue;
+    }
+    bounds.push_back({inner_col,
+                      outer_expr,
+                      inner_is_lhs ? optype : COMMUTE_COMPARISON(optype),
+                      bin_oper});
+    return;
+  }
+}
+
+RangeJoinTable::RangeJoinTable(const std::shared_ptr<Analyzer::ColumnVar>& key_col,
+                               const std::vector<InputTableInfo>& query_infos,
+                               ColumnCacheMap& column_cache,
+                               Executor* executor)
+    : key_col_(key_col)
+    , query_infos_(query_infos)
+    , column_cache_(column_cache)
+    , executor_(executor)
+    , entry_count_(0) {}
+
+void RangeJoinTable::reify(const std::vector<Bound>& key_bounds,
+                           const std::vector<Bound>& other_bounds,
+                           const RelAlgExecutionUnit& ra_exe_unit) {
+  CHECK(!key_bounds.empty());
+  tautology_ = key_bounds.front().qual;
+  for (const auto& bound : key_bounds) {
+    auto& key_bound = is_lower_bound(bound.optype) ? lower_bound_ : upper_bound_;
+    if (!key_bound) {
+      key_bound.reset(new KeyBound{bound, false, 0});
+    }
+  }
+  const auto keys = fetchColumn(key_col_.get(), ra_exe_unit);
+  if (keys.size() > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+    throw TooManyHashEntries();
+  }
+  const auto key_null_val = inline_fixed_encoding_null_val(key_col_->get_type_info());
+  const auto& key_ti = key_bounds.front().outer_expr->get_type_info();
+  for (const auto& bound : other_bounds) {
+    const bool is_lower = is_lower_bound(bound.optype);
+    auto& key_bound = is_lower ? lower_bound_ : upper_bound_;
+    if (key_bound || !have_same_units(key_ti, bound.outer_expr->get_type_info())) {
+      continue;
+    }
+    const auto col_vals = fetchColumn(bound.inner_col.get(), ra_exe_unit);
+    int64_t offset{0};
+    if (get_derived_bound_offset(
+            keys,
+            key_null_val,
+            col_vals,
+            inline_fixed_encoding_null_val(bound.inner_col->get_type_info()),
+            is_lower,
+            offset)) {
+      key_bound.reset(new KeyBound{bound, true, offset});
+    }
+  }
+  std::vector<std::pair<int64_t, int32_t>> entries;
+  entries.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (keys[i] != key_null_val) {
+      entries.emplace_back(keys[i], static_cast<int32_t>(i));
+    }
+  }
+  sort_entries(entries);
+  entry_count_ = entries.size();
+  cpu_buff_.resize(entry_count_ * (sizeof(int64_t) + sizeof(int32_t)));
+  auto sorted_keys = reinterpret_cast<int64_t*>(cpu_buff_.data());
+  auto row_ids = reinterpret_cast<int32_t*>(sorted_keys + entry_count_);
+  for (size_t i = 0; i < entry_count_; ++i) {
+    sorted_keys[i] = entries[i].first;
+    row_ids[i] = entries[i].second;
+  }
+}
+
+// Decoded values of a column of the inner table, in the order of the row ids the
+// query sees: the fragments one after the other.
+std::vector<int64_t> RangeJoinTable::fetchColumn(const Analyzer::ColumnVar* col,
+                                                 const RelAlgExecutionUnit& ra_exe_unit) {
+  const auto redirected_col = std::dynamic_pointer_cast<Analyzer::ColumnVar>(
+      redirect_expr(col, ra_exe_unit.input_col_descs));
+  CHECK(redirected_col);
+  const auto& ti = redirected_col->get_type_info();
+  const auto& fragments =
+      get_inner_query_info(redirected_col->get_table_id(), query_infos_).info.fragments;
+  std::vector<int64_t> col_vals;
+  std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks_owner;
+  for (const auto& fragment : fragments) {
+    const int8_t* col_buff{nullptr};
+    size_t elem_count{0};
+    std::tie(col_buff, elem_count) =
+        Executor::ExecutionDispatch::getColumnFragment(executor_,
+                                                       *redirected_col,
+                                                       fragment,
+                                                       Data_Namespace::CPU_LEVEL,
+                                                       0,
+                                                       chunks_owner,
+                                                       column_cache_);
+    if (!col_buff) {
+      continue;
+    }
+    for (size_t i = 0; i < elem_count; ++i) {
+      col_vals.push_back(is_unsigned_type(ti) ? fixed_width_unsigned_decode_noinline(
+                                                    col_buff, ti.get_size(), i)
+                                              : fixed_width_int_decode_noinline(
+                                                    col_buff, ti.get_size(), i));
+    }
+  }
+  return col_vals;
+}
+
+int64_t RangeJoinTable::getJoinHashBuffer(const ExecutorDeviceType device_type,
+                                          const int device_id) noexcept {
+  CHECK(device_type == ExecutorDeviceType::CPU);
+  return cpu_buff_.empty() ? 0 : reinterpret_cast<int64_t>(&cpu_buff_[0]);
+}
+
+#define LL_CONTEXT executor_->cgen_state_->context_
+#define LL_BUILDER executor_->cgen_state_->ir_builder_
+#define LL_INT(v) executor_->ll_int(v)
+
+// Rows of the iteration domain satisfy the tautology, the other quals are filters.
+llvm::Value* RangeJoinTable::codegenSlotIsValid(const CompilationOptions&,
+                                                const size_t) {
+  return executor_->ll_bool(true);
+}
+
+llvm::Value* RangeJoinTable::codegenSlot(const CompilationOptions&, const size_t) {
+  CHECK(false);
+  return nullptr;
+}
+
+HashJoinMatchingSet RangeJoinTable::codegenMatchingSet(const CompilationOptions& co,
+                                                       const size_t index) {
+  auto buff_lv = JoinHashTable::codegenHashTableLoad(index, executor_);
+  if (buff_lv->getType()->isPointerTy()) {
+    buff_lv = LL_BUILDER.CreatePtrToInt(buff_lv, llvm::Type::getInt64Ty(LL_CONTEXT));
+  }
+  CHECK(buff_lv->getType()->isIntegerTy(64));
+  const auto keys_lv =
+      LL_BUILDER.CreateIntToPtr(buff_lv, llvm::Type::getInt64PtrTy(LL_CONTEXT));
+  llvm::Value* is_null_lv = executor_->ll_bool(false);
+  const auto begin_lv = lower_bound_
+                            ? codegenBound(*lower_bound_, true, keys_lv, co, is_null_lv)
+                            : LL_INT(int64_t(0));
+  const auto end_lv = upper_bound_
+                          ? codegenBound(*upper_bound_, false, keys_lv, co, is_null_lv)
+                          : LL_INT(static_cast<int64_t>(entry_count_));
+  const auto is_empty_lv =
+      LL_BUILDER.CreateOr(is_null_lv, LL_BUILDER.CreateICmpSLE(end_lv, begin_lv));
+  const auto count_lv = LL_BUILDER.CreateSelect(
+      is_empty_lv, LL_INT(int64_t(0)), LL_BUILDER.CreateSub(end_lv, begin_lv));
+  const auto row_ids_lv = LL_BUILDER.CreateIntToPtr(
+      LL_BUILDER.CreateAdd(buff_lv,
+                           LL_INT(static_cast<int64_t>(entry_count_ * sizeof(int64_t)))),
+      llvm::Type::getInt32PtrTy(LL_CONTEXT));
+  return {LL_BUILDER.CreateGEP(row_ids_lv, begin_lv), count_lv, begin_lv};
+}
+
+// Position of the bound in the sorted keys; ORs whether the outer value is null,
+// which matches no row, into is_null_lv.
+llvm::Value* RangeJoinTable::codegenBound(const KeyBound& key_bound,
+                                          const bool is_lower,
+                                          llvm::Value* keys_lv,
+                                          const CompilationOptions& co,
+                                          llvm::Value*& is_null_lv) {
+  const auto& bound = key_bound.bound;
+  const auto val_lvs = executor_->codegen(bound.outer_expr.get(), true, co);
+  CHECK_EQ(size_t(1), val_lvs.size());
+  const auto& outer_ti = bound.outer_expr->get_type_info();
+  if (!outer_ti.get_notnull()) {
+    is_null_lv = LL_BUILDER.CreateOr(
+        is_null_lv,
+        LL_BUILDER.CreateICmpEQ(val_lvs.front(), executor_->inlineIntNull(outer_ti)));
+  }
+  // A derived bound is never strict, it includes the keys at the bound value.
+  const bool includes_bound_val =
+      key_bound.is_derived || bound.optype == kGE || bound.optype == kLE;
+  const std::string fname = is_lower == includes_bound_val ? "range_join_lower_bound"
+                                                           : "range_join_upper_bound";
+  return executor_->cgen_state_->emitCall(
+      fname,
+      {keys_lv,
+       LL_INT(static_cast<int64_t>(entry_count_)),
+       executor_->castToTypeIn(val_lvs.front(), 64),
+       LL_INT(key_bound.offset)});
+}
+
+#undef LL_INT
+#undef LL_BUILDER
+#undef LL_CONTEXT
+
+int RangeJoinTable::getInnerTableId() const noexcept {
+  return key_col_->get_table_id();
+}
+
+int RangeJoinTable::getInnerTableRteIdx() const noexcept {
+  return key_col_->get_rte_idx();
+}
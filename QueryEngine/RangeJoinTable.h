@@ -0,0 +1,145 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    RangeJoinTable.h
+ * @brief   Sorted inner column for joins on <, <=, > and >= comparisons.
+ *
+ * Joins such as a.x < b.y or a.ts BETWEEN b.start AND b.end can't use a hash table.
+ * Instead of a loop join over the whole inner table, the non-null values of an inner
+ * column are sorted along with their row ids, and the bounds the outer values give
+ * for it are binary searched: the rows in between are the iteration domain.
+ *
+ * A bound on another column of the inner table can stand in for a missing one,
+ * through the largest difference between the two columns. For the BETWEEN above,
+ * b.start <= a.ts is a bound on b.start and b.end >= a.ts gives
+ * b.start >= a.ts - max(b.end - b.start). The join quals remain filters, except for
+ * one bound on the sorted column which holds by construction.
+ */
+
+#ifndef QUERYENGINE_RANGEJOINTABLE_H
+#define QUERYENGINE_RANGEJOINTABLE_H
+
+#include "../Analyzer/Analyzer.h"
+#include "../DataMgr/MemoryLevel.h"
+#include "ColumnarResults.h"
+#include "InputMetadata.h"
+#include "JoinHashTableInterface.h"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <vector>
+
+class Executor;
+
+class RangeJoinTable : public JoinHashTableInterface {
+ public:
+  // Throws HashJoinFail if the quals don't bound a column of the inner table at
+  // inner_rte_idx by expressions of the outer tables.
+  static std::shared_ptr<RangeJoinTable> getInstance(
+      const std::list<std::shared_ptr<Analyzer::Expr>>& join_quals,
+      const int inner_rte_idx,
+      const std::vector<InputTableInfo>& query_infos,
+      const RelAlgExecutionUnit& ra_exe_unit,
+      const Data_Namespace::MemoryLevel memory_level,
+      ColumnCacheMap& column_cache,
+      Executor* executor);
+
+  int64_t getJoinHashBuffer(const ExecutorDeviceType device_type,
+                            const int device_id) noexcept override;
+
+  llvm::Value* codegenSlotIsValid(const CompilationOptions&, const size_t) override;
+
+  llvm::Value* codegenSlot(const CompilationOptions&, const size_t) override;
+
+  HashJoinMatchingSet codegenMatchingSet(const CompilationOptions&,
+                                         const size_t) override;
+
+  int getInnerTableId() const noexcept override;
+
+  int getInnerTableRteIdx() const noexcept override;
+
+  JoinHashTableInterface::HashType getHashType() const noexcept override {
+    return JoinHashTableInterface::HashType::OneToMany;
+  }
+
+  const std::vector<OuterColumnRuntimeFilter>& getRuntimeFilters() const
+      noexcept override {
+    return runtime_filters_;
+  }
+
+  // The qual on the sorted column which every row of the iteration domain satisfies.
+  const std::shared_ptr<Analyzer::BinOper>& getTautology() const { return tautology_; }
+
+  size_t getEntryCount() const { return entry_count_; }
+
+  virtual ~RangeJoinTable() {}
+
+ private:
+  // inner_col op outer_expr, with op one of kLT, kLE, kGT and kGE.
+  struct Bound {
+    std::shared_ptr<Analyzer::ColumnVar> inner_col;
+    std::shared_ptr<Analyzer::Expr> outer_expr;
+    SQLOps optype;
+    std::shared_ptr<Analyzer::BinOper> qual;
+  };
+
+  // Bound on the sorted column; for a bound on another column, the difference
+  // between the two columns which makes it one is added to the outer value.
+  struct KeyBound {
+    Bound bound;
+    bool is_derived;
+    int64_t offset;
+  };
+
+  // Appends the bounds qual gives, looking through AND, to bounds.
+  static void collectBounds(const std::shared_ptr<Analyzer::Expr>& qual,
+                            const int inner_rte_idx,
+                            std::vector<Bound>& bounds);
+
+  RangeJoinTable(const std::shared_ptr<Analyzer::ColumnVar>& key_col,
+                 const std::vector<InputTableInfo>& query_infos,
+                 ColumnCacheMap& column_cache,
+                 Executor* executor);
+
+  void reify(const std::vector<Bound>& key_bounds,
+             const std::vector<Bound>& other_bounds,
+             const RelAlgExecutionUnit& ra_exe_unit);
+
+  std::vector<int64_t> fetchColumn(const Analyzer::ColumnVar* col,
+                                   const RelAlgExecutionUnit& ra_exe_unit);
+
+  llvm::Value* codegenBound(const KeyBound& key_bound,
+                            const bool is_lower,
+                            llvm::Value* keys_lv,
+                            const CompilationOptions& co,
+                            llvm::Value*& is_null_lv);
+
+  const std::shared_ptr<Analyzer::ColumnVar> key_col_;
+  const std::vector<InputTableInfo>& query_infos_;
+  ColumnCacheMap& column_cache_;
+  Executor* executor_;
+  std::shared_ptr<Analyzer::BinOper> tautology_;
+  std::unique_ptr<KeyBound> lower_bound_;
+  std::unique_ptr<KeyBound> upper_bound_;
+  size_t entry_count_;
+  // The sorted keys, followed by the row ids in the same order.
+  std::vector<int8_t> cpu_buff_;
+  std::vector<OuterColumnRuntimeFilter> runtime_filters_;
+};
+
+#endif  // QUERYENGINE_RANGEJOINTABLE_H
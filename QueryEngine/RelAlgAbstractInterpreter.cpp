@@ -26,6 +26,7 @@
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#include <list>
 #include <string>
 #include <unordered_set>
 
@@ -203,6 +204,35 @@ bool RelProject::isIdentity() const {
 
 namespace {
 
+class RexWindowFunctionFinder : public RexVisitor<bool> {
+ public:
+  bool visitOperator(const RexOperator* rex_operator) const override {
+    if (dynamic_cast<const RexWindowFunctionOperator*>(rex_operator)) {
+      return true;
+    }
+    return RexVisitor::visitOperator(rex_operator);
+  }
+
+ protected:
+  bool aggregateResult(const bool& aggregate, const bool& next_result) const override {
+    return aggregate || next_result;
+  }
+};
+
+}  // namespace
+
+bool RelProject::hasWindowFunctionExpr() const {
+  RexWindowFunctionFinder window_function_finder;
+  for (const auto& scalar_expr : scalar_exprs_) {
+    if (window_function_finder.visit(scalar_expr.get())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+namespace {
+
 bool isRenamedInput(const RelAlgNode* node,
                     const size_t index,
                     const std::string& new_name) {
@@ -554,13 +584,107 @@ SQLTypeInfo parse_type(const rapidjson::Value& type_obj) {
   return ti;
 }
 
+std::vector<std::unique_ptr<const RexScalar>> parse_expr_array(
+    const rapidjson::Value& arr,
+    const Catalog_Namespace::Catalog& cat,
+    RelAlgExecutor* ra_executor) {
+  CHECK(arr.IsArray());
+  std::vector<std::unique_ptr<const RexScalar>> exprs;
+  for (auto arr_it = arr.Begin(); arr_it != arr.End(); ++arr_it) {
+    exprs.emplace_back(parse_scalar_expr(*arr_it, cat, ra_executor));
+  }
+  return exprs;
+}
+
+RexWindowFunctionOperator::RexWindowBound parse_window_bound(
+    const rapidjson::Value& window_bound_obj) {
+  CHECK(window_bound_obj.IsObject());
+  using BoundType = RexWindowFunctionOperator::BoundType;
+  const bool unbounded = json_bool(field(window_bound_obj, "unbounded"));
+  const bool preceding = json_bool(field(window_bound_obj, "preceding"));
+  const bool following = json_bool(field(window_bound_obj, "following"));
+  const bool is_current_row = json_bool(field(window_bound_obj, "is_current_row"));
+  if (is_current_row) {
+    return {BoundType::CURRENT_ROW, 0};
+  }
+  if (unbounded) {
+    return {preceding ? BoundType::UNBOUNDED_PRECEDING : BoundType::UNBOUNDED_FOLLOWING,
+            0};
+  }
+  CHECK(preceding || following);
+  const auto& offset_obj = field(window_bound_obj, "offset");
+  if (!offset_obj.IsObject() || !offset_obj.HasMember("literal")) {
+    throw QueryNotSupported("Window frame offsets must be constant");
+  }
+  std::unique_ptr<RexLiteral> offset_literal(parse_literal(offset_obj));
+  if (offset_literal->getType() != kDECIMAL || offset_literal->getScale() != 0 ||
+      offset_literal->getVal<int64_t>() < 0) {
+    throw QueryNotSupported("Window frame offsets must be non-negative integers");
+  }
+  return {preceding ? BoundType::EXPR_PRECEDING : BoundType::EXPR_FOLLOWING,
+          offset_literal->getVal<int64_t>()};
+}
+
+std::unique_ptr<RexOperator> parse_window_function(
+    const rapidjson::Value& expr,
+    const std::string& op_name,
+    std::vector<std::unique_ptr<const RexScalar>>& operands,
+    const SQLTypeInfo& ti,
+    const Catalog_Namespace::Catalog& cat,
+    RelAlgExecutor* ra_executor) {
+  const auto kind = to_window_function_kind(op_name);
+  if (json_bool(field(expr, "distinct"))) {
+    throw QueryNotSupported("DISTINCT window functions not supported");
+  }
+  auto partition_keys = parse_expr_array(field(expr, "partition_keys"), cat, ra_executor);
+  std::vector<std::unique_ptr<const RexScalar>> order_keys;
+  std::vector<SortField> collation;
+  const auto& order_keys_arr = field(expr, "order_keys");
+  CHECK(order_keys_arr.IsArray());
+  for (auto order_keys_arr_it = order_keys_arr.Begin();
+       order_keys_arr_it != order_keys_arr.End();
+       ++order_keys_arr_it) {
+    order_keys.emplace_back(
+        parse_scalar_expr(field(*order_keys_arr_it, "field"), cat, ra_executor));
+    const SortDirection sort_dir =
+        json_str(field(*order_keys_arr_it, "direction")) == std::string("DESCENDING")
+            ? SortDirection::Descending
+            : SortDirection::Ascending;
+    const NullSortedPosition null_pos =
+        json_str(field(*order_keys_arr_it, "nulls")) == std::string("FIRST")
+            ? NullSortedPosition::First
+            : NullSortedPosition::Last;
+    collation.emplace_back(collation.size(), sort_dir, null_pos);
+  }
+  const bool is_rows = json_bool(field(expr, "is_rows"));
+  const auto lower_bound = parse_window_bound(field(expr, "lower_bound"));
+  const auto upper_bound = parse_window_bound(field(expr, "upper_bound"));
+  const auto has_offset = [](const RexWindowFunctionOperator::RexWindowBound& bound) {
+    return bound.type == RexWindowFunctionOperator::BoundType::EXPR_PRECEDING ||
+           bound.type == RexWindowFunctionOperator::BoundType::EXPR_FOLLOWING;
+  };
+  if (!is_rows && (has_offset(lower_bound) || has_offset(upper_bound))) {
+    throw QueryNotSupported("RANGE window frames with an offset not supported");
+  }
+  return std::unique_ptr<RexOperator>(new RexWindowFunctionOperator(kind,
+                                                                    operands,
+                                                                    partition_keys,
+                                                                    order_keys,
+                                                                    collation,
+                                                                    lower_bound,
+                                                                    upper_bound,
+                                                                    is_rows,
+                                                                    ti));
+}
+
 std::unique_ptr<RexOperator> parse_operator(const rapidjson::Value& expr,
                                             const Catalog_Namespace::Catalog& cat,
                                             RelAlgExecutor* ra_executor) {
   const auto op_name = json_str(field(expr, "op"));
   const bool is_quantifier =
       op_name == std::string("PG_ANY") || op_name == std::string("PG_ALL");
-  const auto op = is_quantifier ? kFUNCTION : to_sql_op(op_name);
+  const bool is_window_function = expr.HasMember("partition_keys");
+  const auto op = is_quantifier || is_window_function ? kFUNCTION : to_sql_op(op_name);
   const auto& operators_json_arr = field(expr, "operands");
   CHECK(operators_json_arr.IsArray());
   std::vector<std::unique_ptr<const RexScalar>> operands;
@@ -572,6 +696,9 @@ std::unique_ptr<RexOperator> parse_operator(const rapidjson::Value& expr,
   const auto type_it = expr.FindMember("type");
   CHECK(type_it != expr.MemberEnd());
   const auto ti = parse_type(type_it->value);
+  if (is_window_function) {
+    return parse_window_function(expr, op_name, operands, ti, cat, ra_executor);
+  }
   if (op == kIN && expr.HasMember("subquery")) {
     auto subquery = parse_subquery(expr, cat, ra_executor);
     operands.emplace_back(std::move(subquery));
@@ -640,7 +767,9 @@ std::unique_ptr<const RexAgg> parse_aggregate_expr(const rapidjson::Value& expr)
   const auto distinct = json_bool(field(expr, "distinct"));
   const auto agg_ti = parse_type(field(expr, "type"));
   const auto operands = indices_from_json_array(field(expr, "operands"));
-  if (operands.size() > 1 && (operands.size() != 2 || agg != kAPPROX_COUNT_DISTINCT)) {
+  if (operands.size() > 1 &&
+      (operands.size() != 2 ||
+       (agg != kAPPROX_COUNT_DISTINCT && agg != kAPPROX_PERCENTILE))) {
     throw QueryNotSupported("Multiple arguments for aggregates aren't supported");
   }
   return std::unique_ptr<const RexAgg>(new RexAgg(agg, distinct, agg_ti, operands));
@@ -694,6 +823,24 @@ std::unique_ptr<const RexOperator> disambiguate_operator(
       disambiguated_operands.emplace_back(disambiguate_rex(operand, ra_output));
     }
   }
+  const auto rex_window_function_operator =
+      dynamic_cast<const RexWindowFunctionOperator*>(rex_operator);
+  if (rex_window_function_operator) {
+    std::vector<std::unique_ptr<const RexScalar>> disambiguated_partition_keys;
+    for (const auto& partition_key : rex_window_function_operator->getPartitionKeys()) {
+      disambiguated_partition_keys.emplace_back(
+          disambiguate_rex(partition_key.get(), ra_output));
+    }
+    std::vector<std::unique_ptr<const RexScalar>> disambiguated_order_keys;
+    for (const auto& order_key : rex_window_function_operator->getOrderKeys()) {
+      disambiguated_order_keys.emplace_back(disambiguate_rex(order_key.get(), ra_output));
+    }
+    return rex_window_function_operator->disambiguatedOperands(
+        disambiguated_operands,
+        disambiguated_partition_keys,
+        disambiguated_order_keys,
+        rex_window_function_operator->getCollation());
+  }
   return rex_operator->getDisambiguated(disambiguated_operands);
 }
 
@@ -1414,6 +1561,13 @@ void coalesce_joins(std::vector<std::shared_ptr<RelAlgNode>>& nodes) {
   nodes.swap(new_nodes);
 }
 
+// Window functions are evaluated by the executor in a separate step over the
+// projected input, keep their projections out of compound nodes.
+bool is_window_function_project(const std::shared_ptr<RelAlgNode>& ra_node) {
+  const auto project = std::dynamic_pointer_cast<const RelProject>(ra_node);
+  return project && project->hasWindowFunctionExpr();
+}
+
 void coalesce_nodes(std::vector<std::shared_ptr<RelAlgNode>>& nodes,
                     const std::vector<const RelAlgNode*>& left_deep_joins) {
   if (left_deep_joins.empty()) {
@@ -1433,7 +1587,8 @@ void coalesce_nodes(std::vector<std::shared_ptr<RelAlgNode>>& nodes,
           crt_pattern.push_back(size_t(nodeIt));
           crt_state = CoalesceState::Filter;
           nodeIt.advance(RANodeIterator::AdvancingMode::DUChain);
-        } else if (std::dynamic_pointer_cast<const RelProject>(ra_node)) {
+        } else if (std::dynamic_pointer_cast<const RelProject>(ra_node) &&
+                   !is_window_function_project(ra_node)) {
           crt_pattern.push_back(size_t(nodeIt));
           crt_state = CoalesceState::FirstProject;
           nodeIt.advance(RANodeIterator::AdvancingMode::DUChain);
@@ -1443,7 +1598,8 @@ void coalesce_nodes(std::vector<std::shared_ptr<RelAlgNode>>& nodes,
         break;
       }
       case CoalesceState::Filter: {
-        if (std::dynamic_pointer_cast<const RelProject>(ra_node)) {
+        if (std::dynamic_pointer_cast<const RelProject>(ra_node) &&
+            !is_window_function_project(ra_node)) {
           crt_pattern.push_back(size_t(nodeIt));
           crt_state = CoalesceState::FirstProject;
           nodeIt.advance(RANodeIterator::AdvancingMode::DUChain);
@@ -1491,6 +1647,35 @@ void coalesce_nodes(std::vector<std::shared_ptr<RelAlgNode>>& nodes,
   }
 }
 
+// A sort gets executed together with its input, which doesn't work for a projection
+// with window functions since those are evaluated in separate steps. Sort through
+// an identity projection of the window function results instead.
+void separate_window_function_sort_input(
+    std::vector<std::shared_ptr<RelAlgNode>>& nodes) {
+  std::list<std::shared_ptr<RelAlgNode>> node_list(nodes.begin(), nodes.end());
+  for (auto node_it = node_list.begin(); node_it != node_list.end(); ++node_it) {
+    const auto sort = std::dynamic_pointer_cast<RelSort>(*node_it);
+    if (!sort) {
+      continue;
+    }
+    CHECK_EQ(size_t(1), sort->inputCount());
+    const auto project =
+        std::dynamic_pointer_cast<const RelProject>(sort->getAndOwnInput(0));
+    if (!project || !project->hasWindowFunctionExpr()) {
+      continue;
+    }
+    std::vector<std::unique_ptr<const RexScalar>> scalar_exprs;
+    for (size_t i = 0; i < project->size(); ++i) {
+      scalar_exprs.emplace_back(boost::make_unique<RexInput>(project.get(), i));
+    }
+    auto identity_project =
+        std::make_shared<RelProject>(scalar_exprs, project->getFields(), project);
+    sort->replaceInput(project, identity_project);
+    node_list.insert(node_it, identity_project);
+  }
+  nodes.assign(node_list.begin(), node_list.end());
+}
+
 int64_t get_int_literal_field(const rapidjson::Value& obj,
                               const char field[],
                               const int64_t default_val) noexcept {
@@ -1559,6 +1744,7 @@ class RelAlgAbstractInterpreter {
     coalesce_nodes(nodes_, left_deep_joins);
     CHECK(nodes_.back().unique());
     create_left_deep_join(nodes_);
+    separate_window_function_sort_input(nodes_);
     return nodes_.back();
   }
 
@@ -1804,9 +1990,16 @@ std::unique_ptr<const RexSubQuery> parse_subquery(const rapidjson::Value& expr,
   CHECK_GE(operands.Size(), unsigned(0));
   const auto& subquery_ast = field(expr, "subquery");
 
+  // The node ids are local to the subquery, so identical subqueries serialize the
+  // same way and share the result of a single execution.
+  const auto subquery_ra = json_node_to_string(subquery_ast);
+  const auto registered_subquery = ra_executor->getRegisteredSubquery(subquery_ra);
+  if (registered_subquery) {
+    return registered_subquery->deepCopy();
+  }
   const auto ra = ra_interpret(subquery_ast, cat, ra_executor);
   auto subquery = std::make_shared<RexSubQuery>(ra);
-  ra_executor->registerSubquery(subquery);
+  ra_executor->registerSubquery(subquery, subquery_ra);
   return subquery->deepCopy();
 }
 
@@ -415,6 +415,197 @@ class RexFunctionOperator : public RexOperator {
   const std::string name_;
 };
 
+enum class SortDirection { Ascending, Descending };
+
+enum class NullSortedPosition { First, Last };
+
+class SortField {
+ public:
+  SortField(const size_t field,
+            const SortDirection sort_dir,
+            const NullSortedPosition nulls_pos)
+      : field_(field), sort_dir_(sort_dir), nulls_pos_(nulls_pos) {}
+
+  bool operator==(const SortField& that) const {
+    return field_ == that.field_ && sort_dir_ == that.sort_dir_ &&
+           nulls_pos_ == that.nulls_pos_;
+  }
+
+  size_t getField() const { return field_; }
+
+  SortDirection getSortDir() const { return sort_dir_; }
+
+  NullSortedPosition getNullsPosition() const { return nulls_pos_; }
+
+  std::string toString() const {
+    return "(" + std::to_string(field_) + " " +
+           (sort_dir_ == SortDirection::Ascending ? "asc" : "desc") + " " +
+           (nulls_pos_ == NullSortedPosition::First ? "nulls_first" : "nulls_last") + ")";
+  }
+
+ private:
+  const size_t field_;
+  const SortDirection sort_dir_;
+  const NullSortedPosition nulls_pos_;
+};
+
+class RexWindowFunctionOperator : public RexFunctionOperator {
+ public:
+  enum class BoundType {
+    UNBOUNDED_PRECEDING,
+    EXPR_PRECEDING,
+    CURRENT_ROW,
+    EXPR_FOLLOWING,
+    UNBOUNDED_FOLLOWING
+  };
+
+  // A frame bound; the offset is only used by the EXPR_PRECEDING and
+  // EXPR_FOLLOWING bounds, which Calcite only allows with constant offsets.
+  struct RexWindowBound {
+    BoundType type;
+    int64_t offset;
+
+    std::string toString() const {
+      switch (type) {
+        case BoundType::UNBOUNDED_PRECEDING:
+          return "unbounded_preceding";
+        case BoundType::EXPR_PRECEDING:
+          return std::to_string(offset) + "_preceding";
+        case BoundType::CURRENT_ROW:
+          return "current_row";
+        case BoundType::EXPR_FOLLOWING:
+          return std::to_string(offset) + "_following";
+        case BoundType::UNBOUNDED_FOLLOWING:
+          return "unbounded_following";
+      }
+      return "";
+    }
+  };
+
+  // The fields of the collation index the order keys.
+  RexWindowFunctionOperator(const SqlWindowFunctionKind kind,
+                            ConstRexScalarPtrVector& operands,
+                            ConstRexScalarPtrVector& partition_keys,
+                            ConstRexScalarPtrVector& order_keys,
+                            const std::vector<SortField>& collation,
+                            const RexWindowBound& lower_bound,
+                            const RexWindowBound& upper_bound,
+                            const bool is_rows,
+                            const SQLTypeInfo& ti)
+      : RexFunctionOperator(window_function_kind_name(kind), operands, ti)
+      , kind_(kind)
+      , partition_keys_(std::move(partition_keys))
+      , order_keys_(std::move(order_keys))
+      , collation_(collation)
+      , lower_bound_(lower_bound)
+      , upper_bound_(upper_bound)
+      , is_rows_(is_rows) {}
+
+  SqlWindowFunctionKind getKind() const { return kind_; }
+
+  const ConstRexScalarPtrVector& getPartitionKeys() const { return partition_keys_; }
+
+  const ConstRexScalarPtrVector& getOrderKeys() const { return order_keys_; }
+
+  const std::vector<SortField>& getCollation() const { return collation_; }
+
+  const RexWindowBound& getLowerBound() const { return lower_bound_; }
+
+  const RexWindowBound& getUpperBound() const { return upper_bound_; }
+
+  bool isRows() const { return is_rows_; }
+
+  // The partition and order keys have to be rebuilt along with the operands, use
+  // disambiguatedOperands() instead.
+  std::unique_ptr<const RexOperator> getDisambiguated(
+      std::vector<std::unique_ptr<const RexScalar>>& operands) const override {
+    CHECK(false);
+    return nullptr;
+  }
+
+  std::unique_ptr<const RexOperator> disambiguatedOperands(
+      ConstRexScalarPtrVector& operands,
+      ConstRexScalarPtrVector& partition_keys,
+      ConstRexScalarPtrVector& order_keys,
+      const std::vector<SortField>& collation) const {
+    return std::unique_ptr<const RexOperator>(
+        new RexWindowFunctionOperator(kind_,
+                                      operands,
+                                      partition_keys,
+                                      order_keys,
+                                      collation,
+                                      lower_bound_,
+                                      upper_bound_,
+                                      is_rows_,
+                                      getType()));
+  }
+
+  std::string toString() const override {
+    auto result = "(RexWindowFunctionOperator " + getName();
+    for (const auto& operand : operands_) {
+      result += (" " + operand->toString());
+    }
+    result += " partition[";
+    for (const auto& partition_key : partition_keys_) {
+      result += (" " + partition_key->toString());
+    }
+    result += " ] order[";
+    for (size_t i = 0; i < order_keys_.size(); ++i) {
+      result += (" " + order_keys_[i]->toString() + " " + collation_[i].toString());
+    }
+    result += " ] " + std::string(is_rows_ ? "rows" : "range") + " " +
+              lower_bound_.toString() + " " + upper_bound_.toString();
+    return result + ")";
+  }
+
+  static std::string window_function_kind_name(const SqlWindowFunctionKind kind) {
+    switch (kind) {
+      case SqlWindowFunctionKind::ROW_NUMBER:
+        return "ROW_NUMBER";
+      case SqlWindowFunctionKind::RANK:
+        return "RANK";
+      case SqlWindowFunctionKind::DENSE_RANK:
+        return "DENSE_RANK";
+      case SqlWindowFunctionKind::PERCENT_RANK:
+        return "PERCENT_RANK";
+      case SqlWindowFunctionKind::CUME_DIST:
+        return "CUME_DIST";
+      case SqlWindowFunctionKind::NTILE:
+        return "NTILE";
+      case SqlWindowFunctionKind::LAG:
+        return "LAG";
+      case SqlWindowFunctionKind::LEAD:
+        return "LEAD";
+      case SqlWindowFunctionKind::FIRST_VALUE:
+        return "FIRST_VALUE";
+      case SqlWindowFunctionKind::LAST_VALUE:
+        return "LAST_VALUE";
+      case SqlWindowFunctionKind::AVG:
+        return "AVG";
+      case SqlWindowFunctionKind::MIN:
+        return "MIN";
+      case SqlWindowFunctionKind::MAX:
+        return "MAX";
+      case SqlWindowFunctionKind::SUM:
+        return "SUM";
+      case SqlWindowFunctionKind::COUNT:
+        return "COUNT";
+      case SqlWindowFunctionKind::SUM_INTERNAL:
+        return "$SUM0";
+    }
+    return "";
+  }
+
+ private:
+  const SqlWindowFunctionKind kind_;
+  ConstRexScalarPtrVector partition_keys_;
+  ConstRexScalarPtrVector order_keys_;
+  const std::vector<SortField> collation_;
+  const RexWindowBound lower_bound_;
+  const RexWindowBound upper_bound_;
+  const bool is_rows_;
+};
+
 // Not a real node created by Calcite. Created by us because targets of a query
 // should reference the group by expressions instead of creating completely new one.
 class RexRef : public RexScalar {
@@ -660,6 +851,10 @@ class RelProject : public RelAlgNode, public ModifyManipulationTarget {
 
   bool isRenaming() const;
 
+  // True iff any of the projected expressions contains a window function, such
+  // projections get evaluated in several steps by the executor.
+  bool hasWindowFunctionExpr() const;
+
   size_t size() const override { return scalar_exprs_.size(); }
 
   const RexScalar* getProjectAt(const size_t idx) const {
@@ -1054,40 +1249,6 @@ class RelCompound : public RelAlgNode, public ModifyManipulationTarget {
                         // projected, just owned
 };
 
-enum class SortDirection { Ascending, Descending };
-
-enum class NullSortedPosition { First, Last };
-
-class SortField {
- public:
-  SortField(const size_t field,
-            const SortDirection sort_dir,
-            const NullSortedPosition nulls_pos)
-      : field_(field), sort_dir_(sort_dir), nulls_pos_(nulls_pos) {}
-
-  bool operator==(const SortField& that) const {
-    return field_ == that.field_ && sort_dir_ == that.sort_dir_ &&
-           nulls_pos_ == that.nulls_pos_;
-  }
-
-  size_t getField() const { return field_; }
-
-  SortDirection getSortDir() const { return sort_dir_; }
-
-  NullSortedPosition getNullsPosition() const { return nulls_pos_; }
-
-  std::string toString() const {
-    return "(" + std::to_string(field_) + " " +
-           (sort_dir_ == SortDirection::Ascending ? "asc" : "desc") + " " +
-           (nulls_pos_ == NullSortedPosition::First ? "nulls_first" : "nulls_last") + ")";
-  }
-
- private:
-  const size_t field_;
-  const SortDirection sort_dir_;
-  const NullSortedPosition nulls_pos_;
-};
-
 class RelSort : public RelAlgNode {
  public:
   RelSort(const std::vector<SortField>& collation,
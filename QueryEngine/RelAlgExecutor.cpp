@@ -19,19 +19,25 @@
 
 #include "CalciteDeserializerUtils.h"
 #include "CardinalityEstimator.h"
+#include "ColumnarResults.h"
 #include "EquiJoinCondition.h"
 #include "ExecutionException.h"
 #include "ExpressionRewrite.h"
 #include "InputMetadata.h"
 #include "QueryPhysicalInputsCollector.h"
 #include "RangeTableIndexVisitor.h"
+#include "RelAlgVisitor.h"
 #include "RexVisitor.h"
+#include "WindowFunctionEvaluator.h"
 
 #include "../Parser/ParserNode.h"
 #include "../Shared/measure.h"
 
 #include <algorithm>
 #include <numeric>
+#include <set>
+
+size_t g_subquery_result_cache_entries{0};
 
 namespace {
 
@@ -110,6 +116,102 @@ void scanForTablesAndAggsInRelAlgSeqForRender(std::vector<RaExecutionDesc>& exec
   }
 }
 
+bool uses_now(const RelAlgNode* ra);
+
+class RexUsesNowVisitor : public RexVisitor<bool> {
+ public:
+  bool visitSubQuery(const RexSubQuery* subquery) const override {
+    return uses_now(subquery->getRelAlg());
+  }
+
+  bool visitOperator(const RexOperator* rex_operator) const override {
+    // DATETIME('NOW') is the only form of DATETIME RelAlgTranslator accepts
+    const auto rex_function = dynamic_cast<const RexFunctionOperator*>(rex_operator);
+    if (rex_function && (rex_function->getName() == std::string("NOW") ||
+                         rex_function->getName() == std::string("DATETIME"))) {
+      return true;
+    }
+    return RexVisitor<bool>::visitOperator(rex_operator);
+  }
+
+ protected:
+  bool aggregateResult(const bool& aggregate, const bool& next_result) const override {
+    return aggregate || next_result;
+  }
+};
+
+class RelAlgUsesNowVisitor : public RelAlgVisitor<bool> {
+ public:
+  bool visitCompound(const RelCompound* compound) const override {
+    for (size_t i = 0; i < compound->getScalarSourcesSize(); ++i) {
+      if (rex_visitor_.visit(compound->getScalarSource(i))) {
+        return true;
+      }
+    }
+    const auto filter = compound->getFilterExpr();
+    return filter && rex_visitor_.visit(filter);
+  }
+
+  bool visitFilter(const RelFilter* filter) const override {
+    return rex_visitor_.visit(filter->getCondition());
+  }
+
+  bool visitJoin(const RelJoin* join) const override {
+    const auto condition = join->getCondition();
+    return condition && rex_visitor_.visit(condition);
+  }
+
+  bool visitMultiJoin(const RelMultiJoin* multi_join) const override {
+    for (size_t i = 0; i < multi_join->joinCount(); ++i) {
+      const auto condition = multi_join->getConditions()[i].get();
+      if (condition && rex_visitor_.visit(condition)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool visitLeftDeepInnerJoin(
+      const RelLeftDeepInnerJoin* left_deep_inner_join) const override {
+    const auto condition = left_deep_inner_join->getInnerCondition();
+    if (condition && rex_visitor_.visit(condition)) {
+      return true;
+    }
+    for (size_t nesting_level = 1;
+         nesting_level <= left_deep_inner_join->inputCount() - 1;
+         ++nesting_level) {
+      const auto outer_condition =
+          left_deep_inner_join->getOuterCondition(nesting_level);
+      if (outer_condition && rex_visitor_.visit(outer_condition)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool visitProject(const RelProject* project) const override {
+    for (size_t i = 0; i < project->size(); ++i) {
+      if (rex_visitor_.visit(project->getProjectAt(i))) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ protected:
+  bool aggregateResult(const bool& aggregate, const bool& next_result) const override {
+    return aggregate || next_result;
+  }
+
+ private:
+  RexUsesNowVisitor rex_visitor_;
+};
+
+bool uses_now(const RelAlgNode* ra) {
+  RelAlgUsesNowVisitor visitor;
+  return visitor.visit(ra);
+}
+
 }  // namespace
 
 ExecutionResult RelAlgExecutor::executeRelAlgQuery(const std::string& query_ra,
@@ -137,6 +239,7 @@ ExecutionResult RelAlgExecutor::executeRelAlgQueryNoRetry(const std::string& que
                                                           RenderInfo* render_info) {
   INJECT_TIMER(executeRelAlgQueryNoRetry);
   const auto ra = deserialize_ra_dag(query_ra, cat_, this);
+  uses_now_ = uses_now(ra.get());
   // capture the lock acquistion time
   auto clock_begin = timer_start();
   std::lock_guard<std::mutex> lock(executor_->execute_mutex_);
@@ -183,16 +286,96 @@ ExecutionResult RelAlgExecutor::executeRelAlgQueryNoRetry(const std::string& que
     }
     scanForTablesAndAggsInRelAlgSeqForRender(ed_list, render_info);
   }
-  // Dispatch the subqueries first
-  for (auto subquery : subqueries_) {
-    // Execute the subquery and cache the result.
-    RelAlgExecutor ra_executor(executor_, cat_);
-    auto result = ra_executor.executeRelAlgSubQuery(subquery.get(), co, eo);
-    subquery->setExecutionResult(std::make_shared<ExecutionResult>(result));
+  // Dispatch the subqueries first, identical ones have been registered only once
+  CHECK_EQ(subqueries_.size(), subquery_ras_.size());
+  for (size_t i = 0; i < subqueries_.size(); ++i) {
+    const auto& subquery = subqueries_[i];
+    subquery->setExecutionResult(
+        executeSubqueryWithCache(subquery.get(), subquery_ras_[i], co, eo));
   }
   return executeRelAlgSeq(ed_list, co, eo, render_info, queue_time_ms);
 }
 
+std::shared_ptr<const ExecutionResult> RelAlgExecutor::executeSubqueryWithCache(
+    const RexSubQuery* subquery,
+    const std::string& subquery_ra,
+    const CompilationOptions& co,
+    const ExecutionOptions& eo) {
+  const auto cache_key =
+      eo.just_explain ? std::string() : getSubqueryResultCacheKey(subquery, subquery_ra);
+  if (!cache_key.empty()) {
+    std::lock_guard<std::mutex> lock(subquery_result_cache_mutex_);
+    for (auto it = subquery_result_cache_.begin(); it != subquery_result_cache_.end();
+         ++it) {
+      if (it->first == cache_key) {
+        subquery_result_cache_.splice(
+            subquery_result_cache_.begin(), subquery_result_cache_, it);
+        return it->second;
+      }
+    }
+  }
+  RelAlgExecutor ra_executor(executor_, cat_);
+  auto result = std::make_shared<ExecutionResult>(
+      ra_executor.executeRelAlgSubQuery(subquery, co, eo));
+  if (cache_key.empty()) {
+    return result;
+  }
+  const auto& rows = result->getRows();
+  CHECK(rows);
+  // Only cache results which are cheap to hold on to, IN lists and scalars. Lazily
+  // fetched columns would keep the chunks of the input pinned.
+  if (rows->rowCount() > max_cached_subquery_rows) {
+    return result;
+  }
+  for (const auto& col_lazy_fetch : rows->getLazyFetchInfo()) {
+    if (col_lazy_fetch.is_lazily_fetched) {
+      return result;
+    }
+  }
+  std::lock_guard<std::mutex> lock(subquery_result_cache_mutex_);
+  subquery_result_cache_.emplace_front(cache_key, result);
+  while (subquery_result_cache_.size() > g_subquery_result_cache_entries) {
+    subquery_result_cache_.pop_back();
+  }
+  return result;
+}
+
+// Subquery results are reused across statements as long as none of the tables they
+// read got loaded into or checkpointed. Updates and deletes drop all of them through
+// yieldCacheInvalidator().
+std::string RelAlgExecutor::getSubqueryResultCacheKey(const RexSubQuery* subquery,
+                                                      const std::string& subquery_ra) {
+  if (!g_subquery_result_cache_entries || g_cluster) {
+    return "";
+  }
+  // NOW() is evaluated at execution time. The tables read by nested subqueries are
+  // not part of the key, leave those alone too.
+  if (subquery_ra.find("\"NOW\"") != std::string::npos ||
+      subquery_ra.find("\"subquery\"") != std::string::npos) {
+    return "";
+  }
+  const auto table_ids = get_physical_table_inputs(subquery->getRelAlg());
+  if (table_ids.empty()) {
+    return "";
+  }
+  const auto db_id = cat_.get_currentDB().dbId;
+  std::string cache_key = std::to_string(db_id) + ":";
+  for (const auto table_id : std::set<int>(table_ids.begin(), table_ids.end())) {
+    const auto td = cat_.getMetadataForTable(table_id);
+    CHECK(td);
+    if (td->isView) {
+      return "";
+    }
+    const auto epoch = cat_.getTableEpoch(db_id, table_id);
+    if (epoch < 0) {
+      return "";
+    }
+    cache_key += std::to_string(table_id) + "@" + std::to_string(epoch) + "#" +
+                 std::to_string(executor_->getTableInfo(table_id).getNumTuples()) + ",";
+  }
+  return cache_key + "|" + subquery_ra;
+}
+
 namespace {
 
 std::unordered_set<int> get_physical_table_ids(
@@ -1467,6 +1650,9 @@ ExecutionResult RelAlgExecutor::executeProject(const RelProject* project,
                                                const ExecutionOptions& eo,
                                                RenderInfo* render_info,
                                                const int64_t queue_time_ms) {
+  if (project->hasWindowFunctionExpr()) {
+    return executeWindowFunctionProject(project, co, eo, render_info, queue_time_ms);
+  }
   auto work_unit =
       createProjectWorkUnit(project, {{}, SortAlgorithm::Default, 0, 0}, eo.just_explain);
   CompilationOptions co_project = co;
@@ -1531,6 +1717,434 @@ ExecutionResult RelAlgExecutor::executeModify(const RelModify* modify,
   return {rs, empty_targets};
 }
 
+namespace {
+
+using WindowProjectInput = std::pair<const RelAlgNode*, unsigned>;
+
+// Collects the distinct window functions of a projection and the inputs it uses
+// outside of them.
+class RexWindowFunctionCollector : public RexVisitor<void*> {
+ public:
+  void* visitInput(const RexInput* input) const override {
+    const WindowProjectInput key{input->getSourceNode(), input->getIndex()};
+    if (std::find(inputs_.begin(), inputs_.end(), key) == inputs_.end()) {
+      inputs_.push_back(key);
+    }
+    return nullptr;
+  }
+
+  void* visitOperator(const RexOperator* rex_operator) const override {
+    const auto window_func = dynamic_cast<const RexWindowFunctionOperator*>(rex_operator);
+    if (!window_func) {
+      return RexVisitor<void*>::visitOperator(rex_operator);
+    }
+    const auto key = window_func->toString();
+    if (!window_function_idx_.count(key)) {
+      window_function_idx_.emplace(key, window_functions_.size());
+      window_functions_.push_back(window_func);
+    }
+    return nullptr;
+  }
+
+  const std::vector<WindowProjectInput>& getInputs() const { return inputs_; }
+
+  const std::vector<const RexWindowFunctionOperator*>& getWindowFunctions() const {
+    return window_functions_;
+  }
+
+  size_t getWindowFunctionIdx(const RexWindowFunctionOperator* window_func) const {
+    const auto it = window_function_idx_.find(window_func->toString());
+    CHECK(it != window_function_idx_.end());
+    return it->second;
+  }
+
+ private:
+  mutable std::vector<WindowProjectInput> inputs_;
+  mutable std::vector<const RexWindowFunctionOperator*> window_functions_;
+  mutable std::unordered_map<std::string, size_t> window_function_idx_;
+};
+
+// Rebinds a projection with window functions to the node which holds its inputs
+// followed by the window function results.
+class RexWindowFunctionResultBinder : public RexDeepCopyVisitor {
+ public:
+  RexWindowFunctionResultBinder(const RelAlgNode* window_results,
+                                const RexWindowFunctionCollector& collector)
+      : window_results_(window_results), collector_(collector) {}
+
+ protected:
+  RetType visitInput(const RexInput* input) const override {
+    const auto& inputs = collector_.getInputs();
+    const WindowProjectInput key{input->getSourceNode(), input->getIndex()};
+    const auto it = std::find(inputs.begin(), inputs.end(), key);
+    CHECK(it != inputs.end());
+    return boost::make_unique<RexInput>(window_results_, it - inputs.begin());
+  }
+
+  RetType visitWindowFunctionOperator(
+      const RexWindowFunctionOperator* window_func) const override {
+    return boost::make_unique<RexInput>(
+        window_results_,
+        collector_.getInputs().size() + collector_.getWindowFunctionIdx(window_func));
+  }
+
+ private:
+  const RelAlgNode* window_results_;
+  const RexWindowFunctionCollector& collector_;
+};
+
+// The expressions of the projection which materializes the inputs of the window
+// functions. Identical expressions share a column.
+class WindowInputProjection {
+ public:
+  size_t add(const RexScalar* expr) { return add(copier_.visit(expr), expr->toString()); }
+
+  // Casts the value arguments to the type of the window function, which can be
+  // wider. Strings keep their dictionary.
+  size_t addWithCast(const RexScalar* expr, const SQLTypeInfo& ti) {
+    if (ti.is_string()) {
+      return add(expr);
+    }
+    std::vector<std::unique_ptr<const RexScalar>> operands;
+    operands.push_back(copier_.visit(expr));
+    auto cast_expr = boost::make_unique<RexOperator>(kCAST, operands, ti);
+    const auto key = cast_expr->toString() + " " + ti.get_type_name();
+    return add(std::move(cast_expr), key);
+  }
+
+  bool empty() const { return exprs_.empty(); }
+
+  std::vector<std::unique_ptr<const RexScalar>>& getExpressions() { return exprs_; }
+
+  const std::vector<std::string>& getFields() const { return fields_; }
+
+ private:
+  size_t add(std::unique_ptr<const RexScalar> expr, const std::string& key) {
+    const auto it = expr_idx_.find(key);
+    if (it != expr_idx_.end()) {
+      return it->second;
+    }
+    const auto idx = exprs_.size();
+    expr_idx_.emplace(key, idx);
+    exprs_.push_back(std::move(expr));
+    fields_.push_back("window_input_" + std::to_string(idx));
+    return idx;
+  }
+
+  RexDeepCopyVisitor copier_;
+  std::vector<std::unique_ptr<const RexScalar>> exprs_;
+  std::vector<std::string> fields_;
+  std::unordered_map<std::string, size_t> expr_idx_;
+};
+
+int64_t double_image(const double val) {
+  return *reinterpret_cast<const int64_t*>(may_alias_ptr(&val));
+}
+
+int64_t window_value_null(const SQLTypeInfo& ti) {
+  return ti.is_fp() ? double_image(inline_fp_null_val(ti)) : inline_int_null_val(ti);
+}
+
+// Reads a materialized column into the 64-bit images the window function evaluator
+// works on.
+WindowInputColumn read_window_input_column(const int8_t* col_buff,
+                                           const size_t row_count,
+                                           const SQLTypeInfo& ti) {
+  WindowInputColumn column{
+      std::vector<int64_t>(row_count), window_value_null(ti), ti.is_fp()};
+  auto& values = column.values;
+  if (ti.is_fp()) {
+    for (size_t i = 0; i < row_count; ++i) {
+      const double val = ti.get_type() == kFLOAT
+                             ? reinterpret_cast<const float*>(col_buff)[i]
+                             : reinterpret_cast<const double*>(col_buff)[i];
+      // -0.0 and 0.0 have to be peers
+      values[i] = double_image(val == 0 ? 0. : val);
+    }
+    return column;
+  }
+  switch (ti.get_size()) {
+    case 1:
+      std::copy(col_buff, col_buff + row_count, values.begin());
+      break;
+    case 2: {
+      const auto buff = reinterpret_cast<const int16_t*>(col_buff);
+      std::copy(buff, buff + row_count, values.begin());
+      break;
+    }
+    case 4: {
+      const auto buff = reinterpret_cast<const int32_t*>(col_buff);
+      std::copy(buff, buff + row_count, values.begin());
+      break;
+    }
+    case 8: {
+      const auto buff = reinterpret_cast<const int64_t*>(col_buff);
+      std::copy(buff, buff + row_count, values.begin());
+      break;
+    }
+    default:
+      CHECK(false);
+  }
+  return column;
+}
+
+// Dictionary ids follow the insertion order of the strings. Maps them to the dense,
+// one based lexical ranks of their strings, which the window functions order on.
+WindowInputColumn rank_window_strings(const WindowInputColumn& column,
+                                      const StringDictionaryProxy* string_dict_proxy) {
+  CHECK(!column.is_fp);
+  std::unordered_map<int64_t, int64_t> string_ranks;
+  for (const auto val : column.values) {
+    if (val != column.null_val) {
+      string_ranks.emplace(val, 0);
+    }
+  }
+  std::vector<std::pair<std::string, int64_t>> strings;
+  strings.reserve(string_ranks.size());
+  for (const auto& string_rank : string_ranks) {
+    strings.emplace_back(
+        string_dict_proxy->getString(static_cast<int32_t>(string_rank.first)),
+        string_rank.first);
+  }
+  std::sort(strings.begin(), strings.end());
+  int64_t rank{0};
+  for (size_t i = 0; i < strings.size(); ++i) {
+    if (i == 0 || strings[i].first != strings[i - 1].first) {
+      ++rank;
+    }
+    string_ranks[strings[i].second] = rank;
+  }
+  // the null sentinel of narrow dictionaries can be positive, keep it apart
+  WindowInputColumn ranked_column{std::vector<int64_t>(column.values.size()),
+                                  inline_int_null_val(SQLTypeInfo(kBIGINT, false)),
+                                  false};
+  for (size_t i = 0; i < column.values.size(); ++i) {
+    const auto val = column.values[i];
+    ranked_column.values[i] =
+        val == column.null_val ? ranked_column.null_val : string_ranks[val];
+  }
+  return ranked_column;
+}
+
+WindowFrameBound to_window_frame_bound(
+    const RexWindowFunctionOperator::RexWindowBound& bound) {
+  switch (bound.type) {
+    case RexWindowFunctionOperator::BoundType::UNBOUNDED_PRECEDING:
+      return {WindowFrameBoundType::UNBOUNDED_PRECEDING, 0};
+    case RexWindowFunctionOperator::BoundType::EXPR_PRECEDING:
+      return {WindowFrameBoundType::EXPR_PRECEDING, bound.offset};
+    case RexWindowFunctionOperator::BoundType::CURRENT_ROW:
+      return {WindowFrameBoundType::CURRENT_ROW, 0};
+    case RexWindowFunctionOperator::BoundType::EXPR_FOLLOWING:
+      return {WindowFrameBoundType::EXPR_FOLLOWING, bound.offset};
+    case RexWindowFunctionOperator::BoundType::UNBOUNDED_FOLLOWING:
+      return {WindowFrameBoundType::UNBOUNDED_FOLLOWING, 0};
+  }
+  CHECK(false);
+  return {};
+}
+
+bool is_window_navigation_function(const SqlWindowFunctionKind kind) {
+  return kind == SqlWindowFunctionKind::LAG || kind == SqlWindowFunctionKind::LEAD ||
+         kind == SqlWindowFunctionKind::FIRST_VALUE ||
+         kind == SqlWindowFunctionKind::LAST_VALUE;
+}
+
+}  // namespace
+
+// A projection with window functions runs in three steps: a projection which
+// materializes the window function arguments, partition and order keys and the
+// inputs used outside of the window functions, the evaluation of the window
+// functions on the host, which produces a temporary table, and finally the original
+// projection with the window functions replaced by the columns of that table.
+ExecutionResult RelAlgExecutor::executeWindowFunctionProject(
+    const RelProject* project,
+    const CompilationOptions& co,
+    const ExecutionOptions& eo,
+    RenderInfo* render_info,
+    const int64_t queue_time_ms) {
+  CHECK_EQ(size_t(1), project->inputCount());
+  RexWindowFunctionCollector collector;
+  for (size_t i = 0; i < project->size(); ++i) {
+    collector.visit(project->getProjectAt(i));
+  }
+  const auto& inputs = collector.getInputs();
+  const auto& window_functions = collector.getWindowFunctions();
+  WindowInputProjection input_projection;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    const RexInput input(inputs[i].first, inputs[i].second);
+    CHECK_EQ(i, input_projection.add(&input));
+  }
+  std::vector<WindowFunctionSpec> specs;
+  for (const auto window_func : window_functions) {
+    const auto kind = window_func->getKind();
+    WindowFunctionSpec spec;
+    spec.kind = kind;
+    for (size_t i = 0; i < window_func->size(); ++i) {
+      // the offset of LAG and LEAD, the bucket count of NTILE and the argument of
+      // COUNT keep their type, the values and the default of LAG and LEAD don't
+      const bool is_value =
+          i == 0 ? kind != SqlWindowFunctionKind::COUNT &&
+                       kind != SqlWindowFunctionKind::NTILE
+                 : i == 2;
+      spec.args.push_back(
+          is_value ? input_projection.addWithCast(window_func->getOperand(i),
+                                                  window_func->getType())
+                   : input_projection.add(window_func->getOperand(i)));
+    }
+    for (const auto& partition_key : window_func->getPartitionKeys()) {
+      spec.partition_keys.push_back(input_projection.add(partition_key.get()));
+    }
+    const auto& order_keys = window_func->getOrderKeys();
+    for (const auto& sort_field : window_func->getCollation()) {
+      CHECK_LT(sort_field.getField(), order_keys.size());
+      spec.order_keys.push_back(
+          {input_projection.add(order_keys[sort_field.getField()].get()),
+           sort_field.getSortDir() == SortDirection::Descending,
+           sort_field.getNullsPosition() == NullSortedPosition::First});
+    }
+    spec.is_rows = window_func->isRows();
+    spec.lower_bound = to_window_frame_bound(window_func->getLowerBound());
+    spec.upper_bound = to_window_frame_bound(window_func->getUpperBound());
+    specs.push_back(spec);
+  }
+  if (input_projection.empty()) {
+    // a projection needs at least one target, only the row count matters here
+    const RexInput input(project->getInput(0), 0);
+    input_projection.add(&input);
+  }
+
+  const auto window_input =
+      std::make_shared<RelProject>(input_projection.getExpressions(),
+                                   input_projection.getFields(),
+                                   project->getAndOwnInput(0));
+  const auto input_work_unit = createProjectWorkUnit(
+      window_input.get(), {{}, SortAlgorithm::Default, 0, 0}, eo.just_explain);
+  const auto input_result = executeWorkUnit(input_work_unit,
+                                            window_input->getOutputMetainfo(),
+                                            false,
+                                            co,
+                                            eo,
+                                            nullptr,
+                                            queue_time_ms);
+  if (eo.just_explain) {
+    return input_result;
+  }
+  const auto& input_meta = window_input->getOutputMetainfo();
+  std::vector<SQLTypeInfo> input_types;
+  for (const auto& target_meta : input_meta) {
+    input_types.push_back(target_meta.get_type_info());
+  }
+  ColumnarResults columnar_input(executor_->getRowSetMemoryOwner(),
+                                 *input_result.getRows(),
+                                 input_types.size(),
+                                 input_types);
+  const auto row_count = columnar_input.size();
+  std::vector<WindowInputColumn> columns;
+  for (size_t i = 0; i < input_types.size(); ++i) {
+    columns.push_back(read_window_input_column(
+        columnar_input.getColumnBuffers()[i], row_count, input_types[i]));
+  }
+  // String order keys compare the ranks of the strings, in columns of their own
+  // since the navigation functions return the dictionary ids of the inputs.
+  std::unordered_map<size_t, size_t> string_rank_columns;
+  for (auto& spec : specs) {
+    for (auto& order_key : spec.order_keys) {
+      const auto& ti = input_types[order_key.column];
+      if (!ti.is_string()) {
+        continue;
+      }
+      CHECK_EQ(kENCODING_DICT, ti.get_compression());
+      auto it = string_rank_columns.find(order_key.column);
+      if (it == string_rank_columns.end()) {
+        const auto string_dict_proxy = executor_->getStringDictionaryProxy(
+            ti.get_comp_param(), executor_->getRowSetMemoryOwner(), true);
+        CHECK(string_dict_proxy);
+        auto ranked_column =
+            rank_window_strings(columns[order_key.column], string_dict_proxy);
+        columns.push_back(std::move(ranked_column));
+        it = string_rank_columns.emplace(order_key.column, columns.size() - 1).first;
+      }
+      order_key.column = it->second;
+    }
+  }
+
+  std::vector<TargetMetaInfo> tuple_type(input_meta.begin(),
+                                         input_meta.begin() + inputs.size());
+  for (size_t i = 0; i < window_functions.size(); ++i) {
+    auto ti = window_functions[i]->getType();
+    if (ti.is_string()) {
+      // only the navigation functions return a string, the dictionary id of the
+      // value they pick
+      if (!is_window_navigation_function(specs[i].kind)) {
+        throw std::runtime_error(window_functions[i]->getName() +
+                                 " window function not supported on strings");
+      }
+      CHECK(!specs[i].args.empty());
+      ti = input_types[specs[i].args.front()];
+    }
+    ti.set_notnull(false);
+    specs[i].is_fp = ti.is_fp();
+    specs[i].null_val = window_value_null(ti);
+    tuple_type.emplace_back(window_functions[i]->getName(), ti);
+  }
+  const auto window_values = evaluate_window_functions(row_count, columns, specs);
+
+  QueryMemoryDescriptor query_mem_desc(executor_, row_count, GroupByColRangeType::Scan);
+  std::vector<TargetInfo> target_infos;
+  for (const auto& target_meta : tuple_type) {
+    query_mem_desc.addAggColWidth(ColWidths{8, 8});
+    target_infos.emplace_back(TargetInfo{false,
+                                         kCOUNT,
+                                         target_meta.get_type_info(),
+                                         SQLTypeInfo(kNULLT, false),
+                                         false,
+                                         false});
+  }
+  auto rs = std::make_shared<ResultSet>(target_infos,
+                                        ExecutorDeviceType::CPU,
+                                        query_mem_desc,
+                                        executor_->getRowSetMemoryOwner(),
+                                        executor_);
+  if (row_count) {
+    auto buff = reinterpret_cast<int64_t*>(rs->allocateStorage()->getUnderlyingBuffer());
+    const auto col_count = tuple_type.size();
+    for (size_t i = 0; i < col_count; ++i) {
+      const auto& values =
+          i < inputs.size() ? columns[i].values : window_values[i - inputs.size()];
+      for (size_t row = 0; row < row_count; ++row) {
+        buff[row * col_count + i] = values[row];
+      }
+    }
+  }
+  const auto window_results = std::make_shared<RelLogicalValues>(tuple_type);
+  window_results->setOutputMetainfo(tuple_type);
+  const ResultPtr window_results_table = rs;
+  addTemporaryTable(-window_results->getId(), window_results_table);
+  ScopeGuard erase_window_results = [this, &window_results] {
+    temporary_tables_.erase(-window_results->getId());
+  };
+
+  RexWindowFunctionResultBinder binder(window_results.get(), collector);
+  std::vector<std::unique_ptr<const RexScalar>> exprs;
+  for (size_t i = 0; i < project->size(); ++i) {
+    exprs.push_back(binder.visit(project->getProjectAt(i)));
+  }
+  const auto window_output =
+      std::make_shared<RelProject>(exprs, project->getFields(), window_results);
+  const auto work_unit = createProjectWorkUnit(
+      window_output.get(), {{}, SortAlgorithm::Default, 0, 0}, false);
+  auto result = executeWorkUnit(work_unit,
+                                window_output->getOutputMetainfo(),
+                                false,
+                                co,
+                                eo,
+                                render_info,
+                                queue_time_ms);
+  project->setOutputMetainfo(window_output->getOutputMetainfo());
+  return result;
+}
+
 ExecutionResult RelAlgExecutor::executeLogicalValues(
     const RelLogicalValues* logical_values,
     const ExecutionOptions& eo) {
@@ -1819,7 +2433,7 @@ RelAlgExecutionUnit decide_approx_count_distinct_implementation(
         get_count_distinct_sub_bitmap_count(bitmap_sz_bits, ra_exe_unit, device_type);
     int64_t approx_bitmap_sz_bits{0};
     const auto error_rate =
-        static_cast<Analyzer::AggExpr*>(target_expr)->get_error_rate();
+        static_cast<Analyzer::AggExpr*>(target_expr)->get_arg1();
     if (error_rate) {
       CHECK(error_rate->get_type_info().get_type() == kSMALLINT);
       CHECK_GE(error_rate->get_constval().smallintval, 1);
@@ -3332,3 +3946,6 @@ RelAlgExecutor::WorkUnit RelAlgExecutor::createFilterWorkUnit(const RelFilter* f
 }
 
 SpeculativeTopNBlacklist RelAlgExecutor::speculative_topn_blacklist_;
+std::list<std::pair<std::string, std::shared_ptr<const ExecutionResult>>>
+    RelAlgExecutor::subquery_result_cache_;
+std::mutex RelAlgExecutor::subquery_result_cache_mutex_;
@@ -27,6 +27,8 @@
 #include "StreamingTopN.h"
 
 #include <ctime>
+#include <list>
+#include <mutex>
 #include <sstream>
 
 #include "StorageIOFacility.h"
@@ -56,6 +58,7 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
       , executor_(executor)
       , cat_(cat)
       , now_(0)
+      , uses_now_(false)
       , queue_time_ms_(0) {}
 
   ExecutionResult executeRelAlgQuery(const std::string& query_ra,
@@ -88,14 +91,33 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
     CHECK(it_ok.second);
   }
 
-  void registerSubquery(std::shared_ptr<RexSubQuery> subquery) noexcept {
+  void registerSubquery(std::shared_ptr<RexSubQuery> subquery,
+                        const std::string& subquery_ra) noexcept {
     subqueries_.push_back(subquery);
+    subquery_ras_.push_back(subquery_ra);
+  }
+
+  // Returns the subquery of this statement with the given serialized relational
+  // algebra, if it has been registered already.
+  std::shared_ptr<RexSubQuery> getRegisteredSubquery(
+      const std::string& subquery_ra) const noexcept {
+    CHECK_EQ(subqueries_.size(), subquery_ras_.size());
+    for (size_t i = 0; i < subquery_ras_.size(); ++i) {
+      if (subquery_ras_[i] == subquery_ra) {
+        return subqueries_[i];
+      }
+    }
+    return nullptr;
   }
 
   const std::vector<std::shared_ptr<RexSubQuery>>& getSubqueries() const noexcept {
     return subqueries_;
   };
 
+  // Whether the last query executed calls NOW(), which makes its result depend on
+  // the time it ran at.
+  bool usesNow() const noexcept { return uses_now_; }
+
   AggregatedColRange computeColRangesCache(const RelAlgNode* ra);
 
   StringDictionaryGenerations computeStringDictionaryGenerations(const RelAlgNode* ra);
@@ -106,12 +128,28 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
 
   void cleanupPostExecution();
 
+  static auto yieldCacheInvalidator() -> std::function<void()> {
+    return []() -> void {
+      std::lock_guard<std::mutex> guard(subquery_result_cache_mutex_);
+      subquery_result_cache_.clear();
+    };
+  }
+
  private:
   ExecutionResult executeRelAlgQueryNoRetry(const std::string& query_ra,
                                             const CompilationOptions& co,
                                             const ExecutionOptions& eo,
                                             RenderInfo* render_info);
 
+  std::shared_ptr<const ExecutionResult> executeSubqueryWithCache(
+      const RexSubQuery* subquery,
+      const std::string& subquery_ra,
+      const CompilationOptions& co,
+      const ExecutionOptions& eo);
+
+  std::string getSubqueryResultCacheKey(const RexSubQuery* subquery,
+                                        const std::string& subquery_ra);
+
   void executeRelAlgStep(const size_t step_idx,
                          std::vector<RaExecutionDesc>&,
                          const CompilationOptions&,
@@ -159,6 +197,12 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
                                  RenderInfo*,
                                  const int64_t queue_time_ms);
 
+  ExecutionResult executeWindowFunctionProject(const RelProject*,
+                                               const CompilationOptions&,
+                                               const ExecutionOptions&,
+                                               RenderInfo*,
+                                               const int64_t queue_time_ms);
+
   ExecutionResult executeFilter(const RelFilter*,
                                 const CompilationOptions&,
                                 const ExecutionOptions&,
@@ -286,11 +330,18 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
   const Catalog_Namespace::Catalog& cat_;
   TemporaryTables temporary_tables_;
   time_t now_;
+  bool uses_now_;
   std::vector<std::shared_ptr<Analyzer::Expr>> target_exprs_owned_;  // TODO(alex): remove
   std::vector<std::shared_ptr<RexSubQuery>> subqueries_;
+  std::vector<std::string> subquery_ras_;
   std::unordered_map<unsigned, AggregatedResult> leaf_results_;
   int64_t queue_time_ms_;
   static SpeculativeTopNBlacklist speculative_topn_blacklist_;
+  // most recently used first
+  static std::list<std::pair<std::string, std::shared_ptr<const ExecutionResult>>>
+      subquery_result_cache_;
+  static std::mutex subquery_result_cache_mutex_;
+  static const size_t max_cached_subquery_rows{10000};
   static const size_t max_groups_buffer_entry_default_guess{16384};
 };
 
@@ -188,6 +188,36 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateScalarRex(
   return nullptr;
 }
 
+namespace {
+
+// The quantile of APPROX_PERCENTILE as a DOUBLE constant, APPROX_MEDIAN has none.
+std::shared_ptr<Analyzer::Constant> translate_approx_percentile_param(
+    const RexAgg* rex,
+    const std::vector<std::shared_ptr<Analyzer::Expr>>& scalar_sources) {
+  Datum d;
+  d.doubleval = 0.5;
+  if (rex->size() == 1) {
+    return makeExpr<Analyzer::Constant>(SQLTypeInfo(kDOUBLE, true), false, d);
+  }
+  CHECK_EQ(size_t(2), rex->size());
+  const auto param_literal =
+      std::dynamic_pointer_cast<Analyzer::Constant>(scalar_sources[rex->getOperand(1)]);
+  std::shared_ptr<Analyzer::Constant> param;
+  if (param_literal && !param_literal->get_is_null() &&
+      param_literal->get_type_info().is_number()) {
+    param = std::dynamic_pointer_cast<Analyzer::Constant>(
+        param_literal->deep_copy()->add_cast(SQLTypeInfo(kDOUBLE, true)));
+  }
+  if (!param || param->get_constval().doubleval < 0 ||
+      param->get_constval().doubleval > 1) {
+    throw std::runtime_error(
+        "APPROX_PERCENTILE's second parameter should be a literal between 0 and 1");
+  }
+  return param;
+}
+
+}  // namespace
+
 std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateAggregateRex(
     const RexAgg* rex,
     const std::vector<std::shared_ptr<Analyzer::Expr>>& scalar_sources) {
@@ -195,26 +225,37 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateAggregateRex(
   const bool is_distinct = rex->isDistinct();
   const bool takes_arg{rex->size() > 0};
   std::shared_ptr<Analyzer::Expr> arg_expr;
-  std::shared_ptr<Analyzer::Constant> err_rate;
+  std::shared_ptr<Analyzer::Constant> arg1;
   if (takes_arg) {
     const auto operand = rex->getOperand(0);
     CHECK_LT(operand, static_cast<ssize_t>(scalar_sources.size()));
     CHECK_LE(rex->size(), 2);
     arg_expr = scalar_sources[operand];
     if (agg_kind == kAPPROX_COUNT_DISTINCT && rex->size() == 2) {
-      err_rate = std::dynamic_pointer_cast<Analyzer::Constant>(
+      arg1 = std::dynamic_pointer_cast<Analyzer::Constant>(
           scalar_sources[rex->getOperand(1)]);
-      if (!err_rate || err_rate->get_type_info().get_type() != kSMALLINT ||
-          err_rate->get_constval().smallintval < 1 ||
-          err_rate->get_constval().smallintval > 100) {
+      if (!arg1 || arg1->get_type_info().get_type() != kSMALLINT ||
+          arg1->get_constval().smallintval < 1 ||
+          arg1->get_constval().smallintval > 100) {
         throw std::runtime_error(
             "APPROX_COUNT_DISTINCT's second parameter should be SMALLINT literal between "
             "1 and 100");
       }
     }
+    if (agg_kind == kAPPROX_PERCENTILE) {
+      arg1 = translate_approx_percentile_param(rex, scalar_sources);
+      const auto& arg_ti = arg_expr->get_type_info();
+      if (!arg_ti.is_number()) {
+        throw std::runtime_error("APPROX_PERCENTILE expects a numeric argument");
+      }
+      if (arg_ti.get_type() != kDOUBLE) {
+        arg_expr = arg_expr->deep_copy()->add_cast(
+            SQLTypeInfo(kDOUBLE, arg_ti.get_notnull()));
+      }
+    }
   }
   const auto agg_ti = get_agg_type(agg_kind, arg_expr.get());
-  return makeExpr<Analyzer::AggExpr>(agg_ti, agg_kind, arg_expr, is_distinct, err_rate);
+  return makeExpr<Analyzer::AggExpr>(agg_ti, agg_kind, arg_expr, is_distinct, arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateLiteral(
@@ -286,6 +327,8 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateScalarSubquery(
   if (row_set->rowCount() != size_t(1)) {
     throw std::runtime_error("Scalar sub-query returned multiple rows");
   }
+  // the result is shared by identical subqueries and cached across statements
+  row_set->moveToBegin();
   auto first_row = row_set->getNextRow(false, false);
   auto scalar_tv = boost::get<ScalarTargetValue>(&first_row[0]);
   auto ti = rex_subquery->getType();
@@ -24,8 +24,10 @@
 #ifndef QUERYENGINE_RESULTROWS_H
 #define QUERYENGINE_RESULTROWS_H
 
+#include "CountDistinctSet.h"
 #include "HyperLogLog.h"
 #include "OutputBufferInitialization.h"
+#include "QuantileSketch.h"
 #include "QueryMemoryDescriptor.h"
 #include "ResultSet.h"
 #include "TargetValue.h"
@@ -37,10 +39,10 @@
 #include <glog/logging.h>
 #include <boost/noncopyable.hpp>
 
+#include <algorithm>
 #include <limits>
 #include <list>
 #include <mutex>
-#include <set>
 #include <unordered_set>
 
 extern bool g_bigint_count;
@@ -201,16 +203,40 @@ class RowSetMemoryOwner : boost::noncopyable {
         CountDistinctBitmapBuffer{count_distinct_buffer, bytes, system_allocated});
   }
 
-  void addCountDistinctSet(std::set<int64_t>* count_distinct_set) {
+  void addCountDistinctSet(CountDistinctSet* count_distinct_set) {
     std::lock_guard<std::mutex> lock(state_mutex_);
     count_distinct_sets_.push_back(count_distinct_set);
   }
 
+  void addCountDistinctSparseHll(SparseHyperLogLog* sparse_hll) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    count_distinct_sparse_hlls_.push_back(sparse_hll);
+  }
+
+  void addQuantileSketch(QuantileSketch* quantile_sketch) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    quantile_sketches_.push_back(quantile_sketch);
+  }
+
   void addGroupByBuffer(int64_t* group_by_buffer) {
     std::lock_guard<std::mutex> lock(state_mutex_);
     group_by_buffers_.push_back(group_by_buffer);
   }
 
+  // Frees a group by buffer nothing is going to read anymore, false if the
+  // buffer isn't owned by this.
+  bool freeGroupByBuffer(int64_t* group_by_buffer) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    const auto it =
+        std::find(group_by_buffers_.begin(), group_by_buffers_.end(), group_by_buffer);
+    if (it == group_by_buffers_.end()) {
+      return false;
+    }
+    free(group_by_buffer);
+    group_by_buffers_.erase(it);
+    return true;
+  }
+
   std::string* addString(const std::string& str) {
     std::lock_guard<std::mutex> lock(state_mutex_);
     strings_.emplace_back(str);
@@ -271,6 +297,12 @@ class RowSetMemoryOwner : boost::noncopyable {
     for (auto count_distinct_set : count_distinct_sets_) {
       delete count_distinct_set;
     }
+    for (auto sparse_hll : count_distinct_sparse_hlls_) {
+      delete sparse_hll;
+    }
+    for (auto quantile_sketch : quantile_sketches_) {
+      delete quantile_sketch;
+    }
     for (auto group_by_buffer : group_by_buffers_) {
       free(group_by_buffer);
     }
@@ -291,7 +323,9 @@ class RowSetMemoryOwner : boost::noncopyable {
   };
 
   std::vector<CountDistinctBitmapBuffer> count_distinct_bitmaps_;
-  std::vector<std::set<int64_t>*> count_distinct_sets_;
+  std::vector<CountDistinctSet*> count_distinct_sets_;
+  std::vector<SparseHyperLogLog*> count_distinct_sparse_hlls_;
+  std::vector<QuantileSketch*> quantile_sketches_;
   std::vector<int64_t*> group_by_buffers_;
   std::list<std::string> strings_;
   std::list<std::vector<int64_t>> arrays_;
@@ -37,6 +37,7 @@
 #include <bitset>
 #include <future>
 #include <numeric>
+#include <unordered_map>
 
 ResultSetStorage::ResultSetStorage(const std::vector<TargetInfo>& targets,
                                    const QueryMemoryDescriptor& query_mem_desc,
@@ -48,7 +49,8 @@ ResultSetStorage::ResultSetStorage(const std::vector<TargetInfo>& targets,
     , buff_is_provided_(buff_is_provided) {
   for (const auto& target_info : targets_) {
     if (target_info.agg_kind == kCOUNT ||
-        target_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
+        target_info.agg_kind == kAPPROX_COUNT_DISTINCT ||
+        target_info.agg_kind == kAPPROX_PERCENTILE) {
       target_init_vals_.push_back(0);
       continue;
     }
@@ -384,6 +386,16 @@ size_t ResultSet::parallelRowCount() const {
   return row_count;
 }
 
+void ResultSet::setLazyColumnBuffer(const size_t frag_idx,
+                                    const size_t local_col_id,
+                                    const int8_t* col_buffer) {
+  for (auto& storage_col_buffers : col_buffers_) {
+    CHECK_LT(frag_idx, storage_col_buffers.size());
+    CHECK_LT(local_col_id, storage_col_buffers[frag_idx].size());
+    storage_col_buffers[frag_idx][local_col_id] = col_buffer;
+  }
+}
+
 bool ResultSet::definitelyHasNoRows() const {
   return !storage_ && !estimator_ && !just_explain_;
 }
@@ -513,15 +525,12 @@ void ResultSet::sort(const std::list<Analyzer::OrderEntry>& order_entries,
     }
     return;
   }
-  // This check isn't strictly required, but allows the index buffer to be 32-bit.
-  if (query_mem_desc_.getEntryCount() > std::numeric_limits<uint32_t>::max()) {
-    throw RowSortException("Sorting more than 4B elements not supported");
-  }
-
   CHECK(size_t(0) == query_mem_desc_.getEntryCountSmall() ||
         !query_mem_desc_.didOutputColumnar());  // TODO(alex)
   CHECK(permutation_.empty());
 
+  compressQuantileSketches(order_entries);
+
   const bool use_heap{order_entries.size() == 1 && top_n};
   if (use_heap && entryCount() > 100000) {
     if (g_enable_watchdog && (entryCount() > 20000000)) {
@@ -537,6 +546,11 @@ void ResultSet::sort(const std::list<Analyzer::OrderEntry>& order_entries,
 
   permutation_ = initPermutationBuffer(0, 1);
 
+  if (!use_heap && canNormalizeSortKeys(order_entries)) {
+    sortNormalizedPermutation(order_entries);
+    return;
+  }
+
   auto compare = createComparator(order_entries, use_heap);
 
   if (use_heap) {
@@ -546,6 +560,35 @@ void ResultSet::sort(const std::list<Analyzer::OrderEntry>& order_entries,
   }
 }
 
+// The comparator reads the quantile of a sketch many times, merge the buffered
+// values once instead of on every read.
+void ResultSet::compressQuantileSketches(
+    const std::list<Analyzer::OrderEntry>& order_entries) const {
+  for (const auto& order_entry : order_entries) {
+    const size_t target_idx = order_entry.tle_no - 1;
+    CHECK_LT(target_idx, targets_.size());
+    if (targets_[target_idx].agg_kind != kAPPROX_PERCENTILE) {
+      continue;
+    }
+    const auto total_entries =
+        query_mem_desc_.getEntryCount() + query_mem_desc_.getEntryCountSmall();
+    for (size_t i = 0; i < total_entries; ++i) {
+      const auto storage_lookup_result = findStorage(i);
+      const auto storage = storage_lookup_result.storage_ptr;
+      const auto off = storage_lookup_result.fixedup_entry_idx;
+      if (storage->isEmptyEntry(off)) {
+        continue;
+      }
+      const auto sketch_ptr =
+          getColumnInternal(storage->buff_, off, target_idx, storage_lookup_result);
+      CHECK(sketch_ptr.isInt());
+      if (sketch_ptr.i1) {
+        reinterpret_cast<QuantileSketch*>(sketch_ptr.i1)->compress();
+      }
+    }
+  }
+}
+
 #ifdef HAVE_CUDA
 void ResultSet::baselineSort(const std::list<Analyzer::OrderEntry>& order_entries,
                              const size_t top_n) {
@@ -562,10 +605,10 @@ void ResultSet::baselineSort(const std::list<Analyzer::OrderEntry>& order_entrie
 }
 #endif  // HAVE_CUDA
 
-std::vector<uint32_t> ResultSet::initPermutationBuffer(const size_t start,
-                                                       const size_t step) {
+ResultSet::Permutation ResultSet::initPermutationBuffer(const size_t start,
+                                                        const size_t step) {
   CHECK_NE(size_t(0), step);
-  std::vector<uint32_t> permutation;
+  Permutation permutation;
   const auto total_entries =
       query_mem_desc_.getEntryCount() + query_mem_desc_.getEntryCountSmall();
   permutation.reserve(total_entries / step);
@@ -581,14 +624,14 @@ std::vector<uint32_t> ResultSet::initPermutationBuffer(const size_t start,
   return permutation;
 }
 
-const std::vector<uint32_t>& ResultSet::getPermutationBuffer() const {
+const ResultSet::Permutation& ResultSet::getPermutationBuffer() const {
   return permutation_;
 }
 
 void ResultSet::parallelTop(const std::list<Analyzer::OrderEntry>& order_entries,
                             const size_t top_n) {
   const size_t step = cpu_threads();
-  std::vector<std::vector<uint32_t>> strided_permutations(step);
+  std::vector<Permutation> strided_permutations(step);
   std::vector<std::future<void>> init_futures;
   for (size_t start = 0; start < step; ++start) {
     init_futures.emplace_back(
@@ -661,10 +704,11 @@ ResultSet::StorageLookupResult ResultSet::findStorage(const size_t entry_idx) co
           static_cast<size_t>(stg_idx)};
 }
 
-std::function<bool(const uint32_t, const uint32_t)> ResultSet::createComparator(
-    const std::list<Analyzer::OrderEntry>& order_entries,
-    const bool use_heap) const {
-  return [this, &order_entries, use_heap](const uint32_t lhs, const uint32_t rhs) {
+std::function<bool(const ResultSet::PermutationIdx, const ResultSet::PermutationIdx)>
+ResultSet::createComparator(const std::list<Analyzer::OrderEntry>& order_entries,
+                            const bool use_heap) const {
+  return [this, &order_entries, use_heap](const PermutationIdx lhs,
+                                          const PermutationIdx rhs) {
     // NB: The compare function must define a strict weak ordering, otherwise
     // std::sort will trigger a segmentation fault (or corrupt memory).
     const auto lhs_storage_lookup_result = findStorage(lhs);
@@ -697,6 +741,27 @@ std::function<bool(const uint32_t, const uint32_t)> ResultSet::createComparator(
                                            fixedup_rhs,
                                            order_entry.tle_no - 1,
                                            rhs_storage_lookup_result);
+      if (UNLIKELY(agg_info.agg_kind == kAPPROX_PERCENTILE)) {
+        CHECK(lhs_v.isInt() && rhs_v.isInt());
+        const auto lhs_dval = approx_percentile_value(lhs_v.i1);
+        const auto rhs_dval = approx_percentile_value(rhs_v.i1);
+        const bool lhs_is_null = std::isnan(lhs_dval);
+        const bool rhs_is_null = std::isnan(rhs_dval);
+        if (lhs_is_null && rhs_is_null) {
+          return false;
+        }
+        if (lhs_is_null && !rhs_is_null) {
+          return use_heap ? !order_entry.nulls_first : order_entry.nulls_first;
+        }
+        if (rhs_is_null && !lhs_is_null) {
+          return use_heap ? order_entry.nulls_first : !order_entry.nulls_first;
+        }
+        if (lhs_dval == rhs_dval) {
+          continue;
+        }
+        const bool use_desc_cmp = use_heap ? !order_entry.is_desc : order_entry.is_desc;
+        return use_desc_cmp ? lhs_dval > rhs_dval : lhs_dval < rhs_dval;
+      }
       if (UNLIKELY(isNull(entry_ti, lhs_v, float_argument_input) &&
                    isNull(entry_ti, rhs_v, float_argument_input))) {
         return false;
@@ -782,11 +847,11 @@ std::function<bool(const uint32_t, const uint32_t)> ResultSet::createComparator(
 }
 
 void ResultSet::topPermutation(
-    std::vector<uint32_t>& to_sort,
+    Permutation& to_sort,
     const size_t n,
-    const std::function<bool(const uint32_t, const uint32_t)> compare) {
+    const std::function<bool(const PermutationIdx, const PermutationIdx)> compare) {
   std::make_heap(to_sort.begin(), to_sort.end(), compare);
-  std::vector<uint32_t> permutation_top;
+  Permutation permutation_top;
   permutation_top.reserve(n);
   for (size_t i = 0; i < n && !to_sort.empty(); ++i) {
     permutation_top.push_back(to_sort.front());
@@ -797,8 +862,303 @@ void ResultSet::topPermutation(
 }
 
 void ResultSet::sortPermutation(
-    const std::function<bool(const uint32_t, const uint32_t)> compare) {
-  std::sort(permutation_.begin(), permutation_.end(), compare);
+    const std::function<bool(const PermutationIdx, const PermutationIdx)> compare) {
+  const auto total_entries =
+      query_mem_desc_.getEntryCount() + query_mem_desc_.getEntryCountSmall();
+  if (total_entries > std::numeric_limits<uint32_t>::max()) {
+    std::sort(permutation_.begin(), permutation_.end(), compare);
+    return;
+  }
+  // Every entry index fits in 32 bits, sort the narrow copies to halve the memory the
+  // sort moves around.
+  std::vector<uint32_t> narrow_permutation(permutation_.begin(), permutation_.end());
+  std::sort(narrow_permutation.begin(), narrow_permutation.end(), compare);
+  std::copy(narrow_permutation.begin(), narrow_permutation.end(), permutation_.begin());
+}
+
+namespace {
+
+// Order preserving map of the doubles to unsigned words, never 0.
+uint64_t fp_sort_key(const double val) {
+  // NaN has no place in the order, put it after everything else. The only doubles
+  // which would map to 0 are NaNs.
+  if (std::isnan(val)) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  // -0.0 and 0.0 compare equal, give them the same key.
+  const double normalized_val = val == 0 ? 0 : val;
+  uint64_t bits;
+  memcpy(&bits, &normalized_val, sizeof(bits));
+  return (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+}
+
+// Sorts chunks of vals in parallel, then merges them pairwise in parallel.
+template <class T, class Compare>
+void parallel_sort(std::vector<T>& vals, Compare compare, const size_t thread_count) {
+  const size_t chunk_count = std::min(thread_count, vals.size());
+  if (chunk_count <= 1) {
+    std::sort(vals.begin(), vals.end(), compare);
+    return;
+  }
+  const size_t stride = (vals.size() + chunk_count - 1) / chunk_count;
+  std::vector<size_t> run_offsets;
+  for (size_t offset = 0; offset < vals.size(); offset += stride) {
+    run_offsets.push_back(offset);
+  }
+  run_offsets.push_back(vals.size());
+  const size_t run_count = run_offsets.size() - 1;
+  std::vector<std::future<void>> sort_threads;
+  for (size_t i = 0; i < run_count; ++i) {
+    const auto first = run_offsets[i];
+    const auto last = run_offsets[i + 1];
+    sort_threads.push_back(std::async(std::launch::async, [&vals, &compare, first, last] {
+      std::sort(vals.begin() + first, vals.begin() + last, compare);
+    }));
+  }
+  for (auto& child : sort_threads) {
+    child.get();
+  }
+  for (size_t width = 1; width < run_count; width *= 2) {
+    std::vector<std::future<void>> merge_threads;
+    for (size_t first = 0; first + width < run_count; first += 2 * width) {
+      const auto middle_offset = run_offsets[first + width];
+      const auto first_offset = run_offsets[first];
+      const auto last_offset = run_offsets[std::min(first + 2 * width, run_count)];
+      merge_threads.push_back(std::async(
+          std::launch::async,
+          [&vals, &compare, first_offset, middle_offset, last_offset] {
+            std::inplace_merge(vals.begin() + first_offset,
+                               vals.begin() + middle_offset,
+                               vals.begin() + last_offset,
+                               compare);
+          }));
+    }
+    for (auto& child : merge_threads) {
+      child.get();
+    }
+  }
+}
+
+// Positions 0, 1, ..., count - 1 sorted by compare, with the narrowest index type
+// which holds them.
+template <class T, class Compare>
+std::vector<T> sorted_positions(const size_t count,
+                                Compare compare,
+                                const size_t thread_count) {
+  std::vector<T> positions(count);
+  std::iota(positions.begin(), positions.end(), 0);
+  parallel_sort(positions, compare, thread_count);
+  return positions;
+}
+
+}  // namespace
+
+bool ResultSet::canNormalizeSortKeys(
+    const std::list<Analyzer::OrderEntry>& order_entries) const {
+  for (const auto& order_entry : order_entries) {
+    CHECK_GE(order_entry.tle_no, 1);
+    const auto& entry_ti = get_compact_type(targets_[order_entry.tle_no - 1]);
+    if (entry_ti.is_string()) {
+      // None encoded strings have no fixed width key, use the comparator for them.
+      if (entry_ti.get_compression() != kENCODING_DICT) {
+        return false;
+      }
+      continue;
+    }
+    if (!entry_ti.is_number() && !entry_ti.is_time() && !entry_ti.is_boolean()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<uint64_t> ResultSet::normalizeSortKeys(
+    const std::list<Analyzer::OrderEntry>& order_entries,
+    size_t& key_width) const {
+  // The keys follow the comparator. For the entries which can be null, the non-null
+  // values are mapped to [1, 2^64 - 1] in their order, reversed for the descending
+  // entries, and the nulls go to 0 or 2^64 - 1, with the values shifted down by one
+  // for the latter. The other entries have no null to make room for and use the whole
+  // range, a not null BIGINT can hold the smallest 64-bit value.
+  struct KeyPart {
+    size_t target_idx;
+    SQLTypeInfo entry_ti;
+    bool float_argument_input;
+    bool is_desc;
+    bool nulls_first;
+    bool nullable;
+    // Ranks of the strings of a dictionary encoded entry, one based.
+    std::unordered_map<int32_t, uint64_t> string_ranks;
+  };
+  std::vector<KeyPart> key_parts;
+  for (const auto& order_entry : order_entries) {
+    const size_t target_idx = order_entry.tle_no - 1;
+    const auto& agg_info = targets_[target_idx];
+    const auto& entry_ti = get_compact_type(agg_info);
+    bool float_argument_input = takes_float_argument(agg_info);
+    if (entry_ti.get_type() == kFLOAT &&
+        query_mem_desc_.getColumnWidth(target_idx).compact == sizeof(float)) {
+      float_argument_input = true;
+    }
+    const bool nullable =
+        !entry_ti.get_notnull() || agg_info.agg_kind == kAPPROX_PERCENTILE;
+    key_parts.push_back({target_idx,
+                         entry_ti,
+                         float_argument_input,
+                         order_entry.is_desc,
+                         order_entry.nulls_first,
+                         nullable,
+                         {}});
+  }
+  // Rank the strings once, instead of looking them up on every comparison.
+  for (auto& key_part : key_parts) {
+    if (!key_part.entry_ti.is_string()) {
+      continue;
+    }
+    CHECK_EQ(kENCODING_DICT, key_part.entry_ti.get_compression());
+    CHECK_EQ(4, key_part.entry_ti.get_logical_size());
+    std::unordered_map<int32_t, uint64_t>& string_ranks = key_part.string_ranks;
+    for (const auto entry_idx : permutation_) {
+      const auto storage_lookup_result = findStorage(entry_idx);
+      const auto storage = storage_lookup_result.storage_ptr;
+      const auto v = getColumnInternal(storage->buff_,
+                                       storage_lookup_result.fixedup_entry_idx,
+                                       key_part.target_idx,
+                                       storage_lookup_result);
+      CHECK(v.isInt());
+      if (!isNull(key_part.entry_ti, v, key_part.float_argument_input)) {
+        string_ranks.emplace(static_cast<int32_t>(v.i1), 0);
+      }
+    }
+    const auto string_dict_proxy = executor_->getStringDictionaryProxy(
+        key_part.entry_ti.get_comp_param(), row_set_mem_owner_, false);
+    std::vector<std::pair<std::string, int32_t>> strings;
+    strings.reserve(string_ranks.size());
+    for (const auto& string_rank : string_ranks) {
+      strings.emplace_back(string_dict_proxy->getString(string_rank.first),
+                           string_rank.first);
+    }
+    std::sort(strings.begin(), strings.end());
+    uint64_t rank{0};
+    for (size_t i = 0; i < strings.size(); ++i) {
+      if (i == 0 || strings[i].first != strings[i - 1].first) {
+        ++rank;
+      }
+      string_ranks[strings[i].second] = rank;
+    }
+  }
+  key_width = key_parts.size();
+  std::vector<uint64_t> keys(permutation_.size() * key_width);
+  const auto encode_keys = [this, &key_parts, &keys, key_width](const size_t start,
+                                                                const size_t end) {
+    for (size_t i = start; i < end; ++i) {
+      const auto storage_lookup_result = findStorage(permutation_[i]);
+      const auto storage = storage_lookup_result.storage_ptr;
+      const auto off = storage_lookup_result.fixedup_entry_idx;
+      for (size_t j = 0; j < key_width; ++j) {
+        const auto& key_part = key_parts[j];
+        const auto& agg_info = targets_[key_part.target_idx];
+        const auto v = getColumnInternal(
+            storage->buff_, off, key_part.target_idx, storage_lookup_result);
+        bool is_null{false};
+        uint64_t key{0};
+        if (agg_info.agg_kind == kAPPROX_PERCENTILE) {
+          CHECK(v.isInt());
+          const auto dval = approx_percentile_value(v.i1);
+          is_null = std::isnan(dval);
+          key = fp_sort_key(dval);
+        } else if (isNull(key_part.entry_ti, v, key_part.float_argument_input)) {
+          is_null = true;
+        } else if (v.isPair()) {
+          key = fp_sort_key(pair_to_double(
+              {v.i1, v.i2}, key_part.entry_ti, key_part.float_argument_input));
+        } else {
+          CHECK(v.isInt());
+          if (key_part.entry_ti.is_string()) {
+            const auto it = key_part.string_ranks.find(static_cast<int32_t>(v.i1));
+            CHECK(it != key_part.string_ranks.end());
+            key = it->second;
+          } else if (is_distinct_target(agg_info)) {
+            const auto count_distinct_desc =
+                query_mem_desc_.getCountDistinctDescriptor(key_part.target_idx);
+            key = count_distinct_set_size(v.i1, count_distinct_desc) + 1;
+          } else if (key_part.entry_ti.is_fp()) {
+            key = key_part.float_argument_input
+                      ? fp_sort_key(*reinterpret_cast<const float*>(may_alias_ptr(&v.i1)))
+                      : fp_sort_key(
+                            *reinterpret_cast<const double*>(may_alias_ptr(&v.i1)));
+          } else {
+            // The smallest value of the type is its null sentinel, so only the not
+            // null entries map a value to 0.
+            key = static_cast<uint64_t>(v.i1) ^ (uint64_t(1) << 63);
+          }
+        }
+        if (!key_part.nullable) {
+          CHECK(!is_null);
+          if (key_part.is_desc) {
+            key = ~key;
+          }
+        } else if (is_null) {
+          key = key_part.nulls_first ? 0 : std::numeric_limits<uint64_t>::max();
+        } else {
+          if (key_part.is_desc) {
+            key = -key;
+          }
+          if (!key_part.nulls_first) {
+            --key;
+          }
+        }
+        keys[i * key_width + j] = key;
+      }
+    }
+  };
+  const size_t thread_count = permutation_.size() > 100000 ? cpu_threads() : 1;
+  const size_t stride = (permutation_.size() + thread_count - 1) / thread_count;
+  std::vector<std::future<void>> encode_threads;
+  for (size_t start = 0; start < permutation_.size(); start += stride) {
+    encode_threads.push_back(std::async(std::launch::async,
+                                        encode_keys,
+                                        start,
+                                        std::min(start + stride, permutation_.size())));
+  }
+  for (auto& child : encode_threads) {
+    child.get();
+  }
+  return keys;
+}
+
+void ResultSet::sortNormalizedPermutation(
+    const std::list<Analyzer::OrderEntry>& order_entries) {
+  size_t key_width{0};
+  const auto keys = normalizeSortKeys(order_entries, key_width);
+  CHECK_EQ(permutation_.size() * key_width, keys.size());
+  // Sort the positions in permutation_, which are also the positions of the keys.
+  const auto compare = [&keys, key_width](const PermutationIdx lhs,
+                                          const PermutationIdx rhs) {
+    const auto lhs_key = &keys[lhs * key_width];
+    const auto rhs_key = &keys[rhs * key_width];
+    for (size_t i = 0; i < key_width; ++i) {
+      if (lhs_key[i] != rhs_key[i]) {
+        return lhs_key[i] < rhs_key[i];
+      }
+    }
+    return false;
+  };
+  const size_t thread_count = permutation_.size() > 100000 ? cpu_threads() : 1;
+  Permutation sorted_permutation;
+  sorted_permutation.reserve(permutation_.size());
+  if (permutation_.size() <= std::numeric_limits<uint32_t>::max()) {
+    for (const auto position :
+         sorted_positions<uint32_t>(permutation_.size(), compare, thread_count)) {
+      sorted_permutation.push_back(permutation_[position]);
+    }
+  } else {
+    for (const auto position :
+         sorted_positions<PermutationIdx>(permutation_.size(), compare, thread_count)) {
+      sorted_permutation.push_back(permutation_[position]);
+    }
+  }
+  permutation_.swap(sorted_permutation);
 }
 
 void ResultSet::radixSortOnGpu(
@@ -87,6 +87,13 @@ class ResultSetStorage {
 
   void reduce(const ResultSetStorage& that) const;
 
+  // Reduces the baseline buffers of all the given storages into this one, which
+  // must be initialized and empty. Entries are partitioned on their slot in this
+  // buffer first, so that every thread only writes to a cache sized range of it.
+  // The storages can hold scattered partial aggregates, several entries per key.
+  void reduceRadixPartitioned(
+      const std::vector<const ResultSetStorage*>& that_storages) const;
+
   int8_t* getUnderlyingBuffer() const;
 
   template <class KeyType>
@@ -117,6 +124,20 @@ class ResultSetStorage {
                               const size_t that_entry_count,
                               const ResultSetStorage& that) const;
 
+  struct EntryRef {
+    uint32_t storage_idx;
+    uint32_t entry_idx;
+  };
+  // per thread, per partition
+  using EntryPartitions = std::vector<std::vector<std::vector<EntryRef>>>;
+
+  // Buckets the non-empty baseline entries of the given storages on the partition
+  // partition_of picks for their key hash.
+  static EntryPartitions partitionEntriesBaseline(
+      const std::vector<const ResultSetStorage*>& that_storages,
+      const size_t partition_count,
+      const std::function<size_t(const uint32_t)>& partition_of);
+
   void reduceOneEntrySlotsBaseline(int64_t* this_entry_slots,
                                    const int64_t* that_buff,
                                    const size_t that_entry_idx,
@@ -152,6 +173,8 @@ class ResultSetStorage {
                                   const size_t target_logical_idx,
                                   const ResultSetStorage& that) const;
 
+  void reduceOneQuantileSketchSlot(int8_t* this_ptr1, const int8_t* that_ptr1) const;
+
   void fillOneEntryRowWise(const std::vector<int64_t>& entry);
 
   void initializeRowWise() const;
@@ -218,6 +241,11 @@ class TSerializedRows;
 
 class ResultSet {
  public:
+  // Entry indices in the sort order, wide enough for more than 4B entries. The sorts
+  // move 32-bit copies of them around when the entry count fits.
+  using PermutationIdx = uint64_t;
+  using Permutation = std::vector<PermutationIdx>;
+
   ResultSet(const std::vector<TargetInfo>& targets,
             const ExecutorDeviceType device_type,
             const QueryMemoryDescriptor& query_mem_desc,
@@ -279,6 +307,23 @@ class ResultSet {
 
   bool isRowAtEmpty(const size_t index) const;
 
+  // Entry indices of the rows getNextRow() returns, in the same order and with the
+  // same offset and limit, for the rows to be read again in any order later on.
+  std::vector<size_t> getRowEntryIndices() const;
+
+  // The row at an entry index returned by getRowEntryIndices().
+  std::vector<TargetValue> getRowAtEntry(const size_t entry_idx,
+                                         const bool translate_strings,
+                                         const bool decimal_to_double) const;
+
+  // Projections of fixed width targets which aren't sorted or truncated can be
+  // converted to columns without building every row, see ColumnarResults.
+  bool isDirectColumnarConversionPossible() const;
+
+  // Reads target col_idx of a non-empty entry the way getRowAtNoTranslations() does.
+  ScalarTargetValue getColumnValueNoTranslations(const size_t entry_idx,
+                                                 const size_t col_idx) const;
+
   void sort(const std::list<Analyzer::OrderEntry>& order_entries, const size_t top_n);
 
   void keepFirstN(const size_t n);
@@ -340,6 +385,10 @@ class ResultSet {
   void holdChunks(const std::list<std::shared_ptr<Chunk_NS::Chunk>>& chunks) {
     chunks_ = chunks;
   }
+  // Sets the buffer of a lazily fetched column the kernel ran without.
+  void setLazyColumnBuffer(const size_t frag_idx,
+                           const size_t local_col_id,
+                           const int8_t* col_buffer);
   void holdChunkIterators(const std::shared_ptr<std::list<ChunkIter>> chunk_iters) {
     chunk_iters_.push_back(chunk_iters);
   }
@@ -351,7 +400,11 @@ class ResultSet {
     return row_set_mem_owner_;
   }
 
-  const std::vector<uint32_t>& getPermutationBuffer() const;
+  const std::vector<ColumnLazyFetchInfo>& getLazyFetchInfo() const {
+    return lazy_fetch_info_;
+  }
+
+  const Permutation& getPermutationBuffer() const;
 
   std::string serialize() const;
 
@@ -480,18 +533,34 @@ class ResultSet {
 
   StorageLookupResult findStorage(const size_t entry_idx) const;
 
-  std::function<bool(const uint32_t, const uint32_t)> createComparator(
+  void compressQuantileSketches(
+      const std::list<Analyzer::OrderEntry>& order_entries) const;
+
+  std::function<bool(const PermutationIdx, const PermutationIdx)> createComparator(
       const std::list<Analyzer::OrderEntry>& order_entries,
       const bool use_heap) const;
 
   static void topPermutation(
-      std::vector<uint32_t>& to_sort,
+      Permutation& to_sort,
       const size_t n,
-      const std::function<bool(const uint32_t, const uint32_t)> compare);
+      const std::function<bool(const PermutationIdx, const PermutationIdx)> compare);
 
-  void sortPermutation(const std::function<bool(const uint32_t, const uint32_t)> compare);
+  void sortPermutation(
+      const std::function<bool(const PermutationIdx, const PermutationIdx)> compare);
 
-  std::vector<uint32_t> initPermutationBuffer(const size_t start, const size_t step);
+  // Whether every order entry can be encoded by normalizeSortKeys.
+  bool canNormalizeSortKeys(const std::list<Analyzer::OrderEntry>& order_entries) const;
+
+  // Encodes the order entries of the entries in permutation_, key_width words each,
+  // such that comparing the keys as sequences of unsigned words gives the sort order.
+  std::vector<uint64_t> normalizeSortKeys(
+      const std::list<Analyzer::OrderEntry>& order_entries,
+      size_t& key_width) const;
+
+  // Sorts permutation_ on the normalized keys, in parallel for large results.
+  void sortNormalizedPermutation(const std::list<Analyzer::OrderEntry>& order_entries);
+
+  Permutation initPermutationBuffer(const size_t start, const size_t step);
 
   void parallelTop(const std::list<Analyzer::OrderEntry>& order_entries,
                    const size_t top_n);
@@ -547,7 +616,7 @@ class ResultSet {
   size_t drop_first_;
   size_t keep_first_;
   const std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner_;
-  std::vector<uint32_t> permutation_;
+  Permutation permutation_;
   int64_t queue_time_ms_;
   int64_t render_time_ms_;
   const Executor* executor_;  // TODO(alex): remove
@@ -585,11 +654,23 @@ class ResultSet {
 
 class ResultSetManager {
  public:
-  ResultSet* reduce(std::vector<ResultSet*>&);
+  // A non-zero top_n tells the reduction that only the first top_n rows of the
+  // result sorted on order_entries are going to be read, a reduction which
+  // spills then keeps only those of every partition. A reduction which spills frees
+  // the buffers of the given result sets as it goes, see reduceWithSpill for the
+  // memory it holds.
+  ResultSet* reduce(std::vector<ResultSet*>&,
+                    const std::list<Analyzer::OrderEntry>& order_entries = {},
+                    const size_t top_n = 0);
 
   std::shared_ptr<ResultSet> getOwnResultSet();
 
  private:
+  ResultSet* reduceWithSpill(std::vector<ResultSet*>& result_sets,
+                             const size_t merged_buffer_bytes,
+                             const std::list<Analyzer::OrderEntry>& order_entries,
+                             const size_t top_n);
+
   std::shared_ptr<ResultSet> rs_;
 };
 
@@ -266,6 +266,92 @@ bool ResultSet::isRowAtEmpty(const size_t logical_index) const {
   return storage->isEmptyEntry(local_entry_idx);
 }
 
+std::vector<size_t> ResultSet::getRowEntryIndices() const {
+  std::lock_guard<std::mutex> lock(row_iteration_mutex_);
+  std::vector<size_t> entry_indices;
+  if (!storage_ || just_explain_) {
+    return entry_indices;
+  }
+  // walks the entries the way getNextRowUnlocked() does, without reading them
+  moveToBegin();
+  while (true) {
+    const auto entry_idx = advanceCursorToNextEntry();
+    if (keep_first_ && fetched_so_far_ >= drop_first_ + keep_first_) {
+      break;
+    }
+    if (crt_row_buff_idx_ >= entryCount()) {
+      CHECK_EQ(entryCount(), crt_row_buff_idx_);
+      break;
+    }
+    if (fetched_so_far_ >= drop_first_) {
+      entry_indices.push_back(entry_idx);
+    }
+    ++crt_row_buff_idx_;
+    ++fetched_so_far_;
+  }
+  moveToBegin();
+  return entry_indices;
+}
+
+std::vector<TargetValue> ResultSet::getRowAtEntry(const size_t entry_idx,
+                                                  const bool translate_strings,
+                                                  const bool decimal_to_double) const {
+  auto row = getRowAt(entry_idx, translate_strings, decimal_to_double, false);
+  CHECK(!row.empty());
+  return row;
+}
+
+bool ResultSet::isDirectColumnarConversionPossible() const {
+  if (!storage_ || just_explain_ || !permutation_.empty() || isTruncated()) {
+    return false;
+  }
+  if (query_mem_desc_.getGroupByColRangeType() != GroupByColRangeType::Projection ||
+      query_mem_desc_.didOutputColumnar() ||
+      query_mem_desc_.targetGroupbyIndicesSize()) {
+    return false;
+  }
+  for (const auto& target_info : targets_) {
+    if (target_info.is_agg) {
+      return false;
+    }
+    const auto& ti = target_info.sql_type;
+    const bool is_fixed_width =
+        ti.is_integer() || ti.is_decimal() || ti.is_fp() || ti.is_boolean() ||
+        ti.is_time() || ti.is_timeinterval() ||
+        (ti.is_string() && ti.get_compression() == kENCODING_DICT);
+    if (!is_fixed_width) {
+      return false;
+    }
+  }
+  return true;
+}
+
+ScalarTargetValue ResultSet::getColumnValueNoTranslations(const size_t entry_idx,
+                                                          const size_t col_idx) const {
+  CHECK_LT(col_idx, targets_.size());
+  const auto storage_lookup_result = findStorage(entry_idx);
+  const auto storage = storage_lookup_result.storage_ptr;
+  const auto buff = storage->buff_;
+  CHECK(buff);
+  const auto keys_ptr =
+      row_ptr_rowwise(buff, query_mem_desc_, storage_lookup_result.fixedup_entry_idx);
+  // fixed width projected targets take exactly one slot each
+  const auto target_ptr = keys_ptr +
+                          align_to_int64(get_key_bytes_rowwise(query_mem_desc_)) +
+                          get_byteoff_of_slot(col_idx, query_mem_desc_);
+  const auto& target_info = targets_[col_idx];
+  const auto tv = makeTargetValue(target_ptr,
+                                  target_info.sql_type.get_size(),
+                                  target_info,
+                                  col_idx,
+                                  false,
+                                  false,
+                                  entry_idx);
+  const auto scalar_tv = boost::get<ScalarTargetValue>(&tv);
+  CHECK(scalar_tv);
+  return *scalar_tv;
+}
+
 std::vector<TargetValue> ResultSet::getNextRow(const bool translate_strings,
                                                const bool decimal_to_double) const {
   std::lock_guard<std::mutex> lock(row_iteration_mutex_);
@@ -1123,6 +1209,10 @@ TargetValue ResultSet::makeTargetValue(const int8_t* ptr,
       }
     }
   }
+  if (target_info.agg_kind == kAPPROX_PERCENTILE) {
+    const auto dval = approx_percentile_value(ival);
+    return ScalarTargetValue(std::isnan(dval) ? NULL_DOUBLE : dval);
+  }
   if (chosen_type.is_fp()) {
     switch (actual_compact_sz) {
       case 8: {
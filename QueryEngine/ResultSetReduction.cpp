@@ -23,15 +23,23 @@
  */
 
 #include "DynamicWatchdog.h"
+#include "Execute.h"
 #include "ResultRows.h"
 #include "ResultSet.h"
 #include "RuntimeFunctions.h"
 #include "SqlTypesLayout.h"
 
 #include "Shared/likely.h"
+#include "Shared/scope.h"
 #include "Shared/thread_count.h"
 
+#include <boost/filesystem.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
 #include <algorithm>
+#include <atomic>
+#include <fstream>
 #include <future>
 #include <numeric>
 
@@ -39,10 +47,42 @@ extern bool g_enable_dynamic_watchdog;
 
 namespace {
 
+size_t get_physical_memory_bytes() {
+  return static_cast<size_t>(sysconf(_SC_PHYS_PAGES)) * sysconf(_SC_PAGESIZE);
+}
+
+}  // namespace
+
+// Merged baseline group by buffers bigger than this are reduced one partition
+// at a time through files in the data directory, 0 never spills.
+size_t g_reduction_spill_threshold{get_physical_memory_bytes() / 4};
+
+namespace {
+
 bool use_multithreaded_reduction(const size_t entry_count) {
   return entry_count > 100000;
 }
 
+// The merged baseline buffer is sized from the cardinality estimate, partition
+// the reduction when it's too big to stay in the last level cache. Kernels which
+// scatter partial aggregates leave this partitioning to the reduction as well.
+bool use_radix_partitioned_reduction(const QueryMemoryDescriptor& query_mem_desc) {
+  return query_mem_desc.getEntryCount() * get_row_bytes(query_mem_desc) >
+         (size_t(32) << 20);
+}
+
+size_t get_radix_partition_count(const QueryMemoryDescriptor& query_mem_desc,
+                                 const size_t thread_count) {
+  const size_t partition_bytes{1 << 20};
+  const size_t buffer_bytes =
+      query_mem_desc.getEntryCount() * get_row_bytes(query_mem_desc);
+  size_t partition_count = 1;
+  while (partition_count < std::min(buffer_bytes / partition_bytes, size_t(4096))) {
+    partition_count <<= 1;
+  }
+  return std::max(partition_count, thread_count);
+}
+
 size_t get_row_qw_count(const QueryMemoryDescriptor& query_mem_desc) {
   const auto row_bytes = get_row_bytes(query_mem_desc);
   CHECK_EQ(size_t(0), row_bytes % 8);
@@ -428,20 +468,21 @@ GroupValueInfo get_group_value_columnar_reduction(
     const uint32_t groups_buffer_entry_count,
     const int64_t* key,
     const uint32_t key_qw_count) {
-  uint32_t h = key_hash(key, key_qw_count, sizeof(int64_t)) % groups_buffer_entry_count;
+  uint32_t h = get_group_hash_slot(key_hash(key, key_qw_count, sizeof(int64_t)),
+                                   groups_buffer_entry_count);
   auto matching_gvi = get_matching_group_value_columnar_reduction(
       groups_buffer, h, key, key_qw_count, groups_buffer_entry_count);
   if (matching_gvi.first) {
     return matching_gvi;
   }
-  uint32_t h_probe = (h + 1) % groups_buffer_entry_count;
+  uint32_t h_probe = get_group_probe_slot(h, groups_buffer_entry_count);
   while (h_probe != h) {
     matching_gvi = get_matching_group_value_columnar_reduction(
         groups_buffer, h_probe, key, key_qw_count, groups_buffer_entry_count);
     if (matching_gvi.first) {
       return matching_gvi;
     }
-    h_probe = (h_probe + 1) % groups_buffer_entry_count;
+    h_probe = get_group_probe_slot(h_probe, groups_buffer_entry_count);
   }
   return {nullptr, true};
 }
@@ -546,7 +587,8 @@ GroupValueInfo get_group_value_reduction(int64_t* groups_buffer,
                                          const size_t that_entry_idx,
                                          const size_t that_entry_count,
                                          const uint32_t row_size_quad) {
-  uint32_t h = key_hash(key, key_count, key_width) % groups_buffer_entry_count;
+  uint32_t h = get_group_hash_slot(key_hash(key, key_count, key_width),
+                                   groups_buffer_entry_count);
   auto matching_gvi = get_matching_group_value_reduction(groups_buffer,
                                                          h,
                                                          key,
@@ -560,7 +602,7 @@ GroupValueInfo get_group_value_reduction(int64_t* groups_buffer,
   if (matching_gvi.first) {
     return matching_gvi;
   }
-  uint32_t h_probe = (h + 1) % groups_buffer_entry_count;
+  uint32_t h_probe = get_group_probe_slot(h, groups_buffer_entry_count);
   while (h_probe != h) {
     matching_gvi = get_matching_group_value_reduction(groups_buffer,
                                                       h_probe,
@@ -575,7 +617,7 @@ GroupValueInfo get_group_value_reduction(int64_t* groups_buffer,
     if (matching_gvi.first) {
       return matching_gvi;
     }
-    h_probe = (h_probe + 1) % groups_buffer_entry_count;
+    h_probe = get_group_probe_slot(h_probe, groups_buffer_entry_count);
   }
   return {nullptr, true};
 }
@@ -760,6 +802,127 @@ void ResultSetStorage::moveEntriesToBuffer(int8_t* new_buff,
   }
 }
 
+ResultSetStorage::EntryPartitions ResultSetStorage::partitionEntriesBaseline(
+    const std::vector<const ResultSetStorage*>& that_storages,
+    const size_t partition_count,
+    const std::function<size_t(const uint32_t)>& partition_of) {
+  CHECK(!that_storages.empty());
+  CHECK_LT(that_storages.size(), size_t(std::numeric_limits<uint32_t>::max()));
+  const auto& query_mem_desc = that_storages.front()->query_mem_desc_;
+  CHECK(GroupByColRangeType::MultiCol == query_mem_desc.getGroupByColRangeType());
+  const auto key_count = query_mem_desc.getGroupbyColCount();
+  const auto key_byte_width = query_mem_desc.getEffectiveKeyWidth();
+  const auto row_qw_count = get_row_qw_count(query_mem_desc);
+  const size_t thread_count = cpu_threads();
+  // each thread takes a stripe of every storage
+  EntryPartitions thread_partitions(thread_count,
+                                    std::vector<std::vector<EntryRef>>(partition_count));
+  std::vector<std::future<void>> partition_threads;
+  for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+    partition_threads.emplace_back(std::async(
+        std::launch::async,
+        [thread_idx,
+         thread_count,
+         key_count,
+         key_byte_width,
+         row_qw_count,
+         &query_mem_desc,
+         &that_storages,
+         &partition_of,
+         &partitions = thread_partitions[thread_idx]] {
+          for (size_t storage_idx = 0; storage_idx < that_storages.size();
+               ++storage_idx) {
+            const auto& that = *that_storages[storage_idx];
+            const auto that_entry_count = that.query_mem_desc_.getEntryCount();
+            const auto that_buff_i64 = reinterpret_cast<const int64_t*>(that.buff_);
+            const auto thread_entry_count =
+                (that_entry_count + thread_count - 1) / thread_count;
+            const auto start_index = thread_idx * thread_entry_count;
+            const auto end_index =
+                std::min(start_index + thread_entry_count, that_entry_count);
+            for (size_t entry_idx = start_index; entry_idx < end_index; ++entry_idx) {
+              check_watchdog(entry_idx);
+              if (that.isEmptyEntry(entry_idx)) {
+                continue;
+              }
+              uint32_t h{0};
+              if (query_mem_desc.didOutputColumnar()) {
+                const auto key = make_key(
+                    &that_buff_i64[key_offset_colwise(entry_idx, 0, that_entry_count)],
+                    that_entry_count,
+                    key_count);
+                h = key_hash(&key[0], key_count, sizeof(int64_t));
+              } else {
+                h = key_hash(&that_buff_i64[row_qw_count * entry_idx],
+                             key_count,
+                             key_byte_width);
+              }
+              partitions[partition_of(h)].push_back(
+                  {static_cast<uint32_t>(storage_idx), static_cast<uint32_t>(entry_idx)});
+            }
+          }
+        }));
+  }
+  for (auto& partition_thread : partition_threads) {
+    partition_thread.wait();
+  }
+  for (auto& partition_thread : partition_threads) {
+    partition_thread.get();
+  }
+  return thread_partitions;
+}
+
+void ResultSetStorage::reduceRadixPartitioned(
+    const std::vector<const ResultSetStorage*>& that_storages) const {
+  CHECK(GroupByColRangeType::MultiCol == query_mem_desc_.getGroupByColRangeType());
+  CHECK(!query_mem_desc_.hasKeylessHash());
+  const auto entry_count = query_mem_desc_.getEntryCount();
+  const size_t thread_count = cpu_threads();
+  const auto partition_count = get_radix_partition_count(query_mem_desc_, thread_count);
+  const auto partition_entry_count =
+      (entry_count + partition_count - 1) / partition_count;
+
+  // first pass: bucket the entries of all storages on the partition of their
+  // home slot in this buffer
+  const auto thread_partitions = partitionEntriesBaseline(
+      that_storages,
+      partition_count,
+      [entry_count, partition_entry_count](const uint32_t h) {
+        return get_group_hash_slot(h, entry_count) / partition_entry_count;
+      });
+
+  // second pass: reduce the partitions in parallel. Probing can run past the end
+  // of a partition into its neighbour, which the reduction already handles.
+  std::atomic<size_t> next_partition_idx{0};
+  std::vector<std::future<void>> reduction_threads;
+  for (size_t thread_idx = 0; thread_idx < std::min(thread_count, partition_count);
+       ++thread_idx) {
+    reduction_threads.emplace_back(std::async(
+        std::launch::async,
+        [this, &next_partition_idx, partition_count, &that_storages, &thread_partitions] {
+          for (auto partition_idx = next_partition_idx++; partition_idx < partition_count;
+               partition_idx = next_partition_idx++) {
+            for (const auto& partitions : thread_partitions) {
+              for (const auto& entry_ref : partitions[partition_idx]) {
+                const auto& that = *that_storages[entry_ref.storage_idx];
+                reduceOneEntryBaseline(buff_,
+                                       that.buff_,
+                                       entry_ref.entry_idx,
+                                       that.query_mem_desc_.getEntryCount(),
+                                       that);
+              }
+            }
+          }
+        }));
+  }
+  for (auto& reduction_thread : reduction_threads) {
+    reduction_thread.wait();
+  }
+  for (auto& reduction_thread : reduction_threads) {
+    reduction_thread.get();
+  }
+}
+
 void ResultSet::initializeStorage() const {
   if (query_mem_desc_.didOutputColumnar()) {
     storage_->initializeColWise();
@@ -771,7 +934,9 @@ void ResultSet::initializeStorage() const {
 // Driver for reductions. Needed because the result of a reduction on the baseline
 // layout, which can have collisions, cannot be done in place and something needs
 // to take the ownership of the new result set with the bigger underlying buffer.
-ResultSet* ResultSetManager::reduce(std::vector<ResultSet*>& result_sets) {
+ResultSet* ResultSetManager::reduce(std::vector<ResultSet*>& result_sets,
+                                    const std::list<Analyzer::OrderEntry>& order_entries,
+                                    const size_t top_n) {
   CHECK(!result_sets.empty());
   auto result_rs = result_sets.front();
   CHECK(result_rs->storage_);
@@ -797,6 +962,14 @@ ResultSet* ResultSetManager::reduce(std::vector<ResultSet*>& result_sets) {
     CHECK(total_entry_count);
     auto query_mem_desc = first_result.query_mem_desc_;
     query_mem_desc.setEntryCount(total_entry_count);
+    // the merged buffer has one entry per group
+    query_mem_desc.setScattersPartialAggregates(false);
+    const auto merged_buffer_bytes =
+        query_mem_desc.getBufferSizeBytes(ExecutorDeviceType::CPU);
+    if (!query_mem_desc.didOutputColumnar() && g_reduction_spill_threshold &&
+        merged_buffer_bytes > g_reduction_spill_threshold) {
+      return reduceWithSpill(result_sets, merged_buffer_bytes, order_entries, top_n);
+    }
     rs_.reset(new ResultSet(first_result.targets_,
                             ExecutorDeviceType::CPU,
                             query_mem_desc,
@@ -804,6 +977,17 @@ ResultSet* ResultSetManager::reduce(std::vector<ResultSet*>& result_sets) {
                             executor));
     auto result_storage = rs_->allocateStorage(first_result.target_init_vals_);
     rs_->initializeStorage();
+    // moving the entries of the first buffer would lose the duplicate keys of
+    // scattered partial aggregates, which need to be reduced
+    if (use_radix_partitioned_reduction(query_mem_desc) ||
+        first_result.query_mem_desc_.scattersPartialAggregates()) {
+      std::vector<const ResultSetStorage*> storages;
+      for (const auto result_set : result_sets) {
+        storages.push_back(result_set->storage_.get());
+      }
+      result_storage->reduceRadixPartitioned(storages);
+      return rs_.get();
+    }
     switch (query_mem_desc.getEffectiveKeyWidth()) {
       case 4:
         first_result.moveEntriesToBuffer<int32_t>(result_storage->getUnderlyingBuffer(),
@@ -826,6 +1010,289 @@ ResultSet* ResultSetManager::reduce(std::vector<ResultSet*>& result_sets) {
   return result_rs;
 }
 
+namespace {
+
+// The non-empty entries of one input buffer, written to a file partition after
+// partition. The file descriptor is read with pread, from several threads.
+struct SpillRun {
+  std::string path;
+  int fd;
+  // in rows, partition_count + 1 of them
+  std::vector<size_t> partition_offsets;
+};
+
+void read_spill_run(const SpillRun& run,
+                    const size_t offset,
+                    const size_t bytes,
+                    int8_t* buff) {
+  size_t read_bytes{0};
+  while (read_bytes < bytes) {
+    const auto crt_read_bytes =
+        pread(run.fd, buff + read_bytes, bytes - read_bytes, offset + read_bytes);
+    if (crt_read_bytes <= 0) {
+      throw std::runtime_error("Failed to read reduction spill file " + run.path);
+    }
+    read_bytes += crt_read_bytes;
+  }
+}
+
+}  // namespace
+
+// Reduction of baseline buffers whose merged buffer would take too much memory.
+// The entries of every input buffer are bucketed on the high bits of their key
+// hash and written to a file under the data directory, one input at a time, and
+// the input buffer is freed right after. Every bucket is then reduced on its own
+// into a buffer sized for its entries and its distinct groups are written back,
+// only its top_n ones when the result is only read sorted up to top_n. Once the
+// number of groups is known, the output buffer is allocated and filled from the
+// files.
+//
+// The kernels have filled all the input buffers by the time this runs, so their
+// total size is not bounded here. The input buffers are released one by one, each
+// once its run file is written. A buffer which belongs to neither the result set
+// nor the row set memory owner stays until its owner frees it. After that, every
+// reduction thread holds one partition buffer and one block read from a run. A
+// partition gets about spill_partition_bytes of input entries, or more once the
+// partition count hits its cap, and its buffer has twice to four times as many
+// entries. The output buffer then takes twice to four times the size of the groups,
+// and with top_n there are at most partition_count * top_n groups.
+ResultSet* ResultSetManager::reduceWithSpill(
+    std::vector<ResultSet*>& result_sets,
+    const size_t merged_buffer_bytes,
+    const std::list<Analyzer::OrderEntry>& order_entries,
+    const size_t top_n) {
+  // the input buffers go away as they're spilled, keep what describes them
+  const auto targets = result_sets.front()->storage_->targets_;
+  const auto target_init_vals = result_sets.front()->storage_->target_init_vals_;
+  auto query_mem_desc = result_sets.front()->storage_->query_mem_desc_;
+  CHECK(!query_mem_desc.didOutputColumnar());
+  // the partition and output buffers have one entry per group
+  query_mem_desc.setScattersPartialAggregates(false);
+  const auto row_set_mem_owner = result_sets.front()->row_set_mem_owner_;
+  const auto executor = result_sets.front()->executor_;
+  const auto row_bytes = get_row_bytes(query_mem_desc);
+  const auto key_bytes_with_padding =
+      align_to_int64(get_key_bytes_rowwise(query_mem_desc));
+
+  const size_t spill_partition_bytes{size_t(16) << 20};
+  size_t partition_count = 1;
+  while (partition_count < std::min(merged_buffer_bytes / spill_partition_bytes,
+                                    size_t(16384))) {
+    partition_count <<= 1;
+  }
+  // the high bits pick the partition, the low ones the slot within it
+  const auto partition_of = [partition_count](const uint32_t h) {
+    return static_cast<size_t>((uint64_t(h) * partition_count) >> 32);
+  };
+
+  const auto spill_root =
+      executor && executor->getCatalog()
+          ? boost::filesystem::path(executor->getCatalog()->get_basePath()) /
+                "mapd_spill"
+          : boost::filesystem::temp_directory_path();
+  const auto spill_dir =
+      spill_root / boost::filesystem::unique_path("reduction_%%%%-%%%%-%%%%-%%%%");
+  boost::filesystem::create_directories(spill_dir);
+  std::vector<SpillRun> runs;
+  ScopeGuard remove_spill_dir = [&spill_dir, &runs] {
+    for (const auto& run : runs) {
+      close(run.fd);
+    }
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(spill_dir, ec);
+  };
+  LOG(INFO) << "Reducing " << result_sets.size() << " baseline buffers in "
+            << partition_count << " partitions spilled to " << spill_dir.string()
+            << ", merged buffer would take " << merged_buffer_bytes << " bytes";
+
+  for (size_t storage_idx = 0; storage_idx < result_sets.size(); ++storage_idx) {
+    auto result_set = result_sets[storage_idx];
+    const auto& that = *result_set->storage_;
+    const auto thread_partitions = ResultSetStorage::partitionEntriesBaseline(
+        {&that}, partition_count, partition_of);
+    SpillRun run{(spill_dir / ("run_" + std::to_string(storage_idx))).string(), -1, {0}};
+    std::ofstream run_file(run.path, std::ios::binary);
+    for (size_t partition_idx = 0; partition_idx < partition_count; ++partition_idx) {
+      size_t partition_row_count{0};
+      for (const auto& partitions : thread_partitions) {
+        for (const auto& entry_ref : partitions[partition_idx]) {
+          run_file.write(
+              reinterpret_cast<const char*>(that.buff_ + entry_ref.entry_idx * row_bytes),
+              row_bytes);
+        }
+        partition_row_count += partitions[partition_idx].size();
+      }
+      run.partition_offsets.push_back(run.partition_offsets.back() + partition_row_count);
+    }
+    run_file.close();
+    if (!run_file) {
+      throw std::runtime_error("Failed to write reduction spill file " + run.path);
+    }
+    run.fd = open(run.path.c_str(), O_RDONLY);
+    if (run.fd < 0) {
+      throw std::runtime_error("Failed to open reduction spill file " + run.path);
+    }
+    runs.push_back(run);
+    // nothing reads the inputs of a reduction once it's done, give the buffer
+    // back now unless it belongs to someone else
+    const auto buff = that.buff_;
+    if (!that.buff_is_provided_) {
+      free(buff);
+      result_set->storage_.reset();
+    } else if (row_set_mem_owner &&
+               row_set_mem_owner->freeGroupByBuffer(reinterpret_cast<int64_t*>(buff))) {
+      result_set->storage_.reset();
+    }
+  }
+
+  const auto partition_path = [&spill_dir](const size_t partition_idx) {
+    return (spill_dir / std::to_string(partition_idx)).string();
+  };
+  const bool keep_top_n = top_n && !order_entries.empty();
+  std::vector<size_t> partition_group_counts(partition_count, 0);
+  std::atomic<size_t> next_partition_idx{0};
+  std::vector<std::future<void>> reduction_threads;
+  for (size_t thread_idx = 0;
+       thread_idx < std::min(static_cast<size_t>(cpu_threads()), partition_count);
+       ++thread_idx) {
+    reduction_threads.emplace_back(std::async(std::launch::async, [&] {
+      std::vector<int64_t> block;
+      for (auto partition_idx = next_partition_idx++; partition_idx < partition_count;
+           partition_idx = next_partition_idx++) {
+        size_t partition_entry_count{0};
+        for (const auto& run : runs) {
+          partition_entry_count += run.partition_offsets[partition_idx + 1] -
+                                   run.partition_offsets[partition_idx];
+        }
+        if (!partition_entry_count) {
+          continue;
+        }
+        // keep the same 50% fill rate as the merged buffer
+        size_t partition_buffer_entry_count = 1;
+        while (partition_buffer_entry_count < 2 * partition_entry_count) {
+          partition_buffer_entry_count <<= 1;
+        }
+        auto partition_query_mem_desc = query_mem_desc;
+        partition_query_mem_desc.setEntryCount(partition_buffer_entry_count);
+        ResultSet partition_rs(targets,
+                               ExecutorDeviceType::CPU,
+                               partition_query_mem_desc,
+                               row_set_mem_owner,
+                               executor);
+        const auto partition_storage = partition_rs.allocateStorage(target_init_vals);
+        partition_rs.initializeStorage();
+        for (const auto& run : runs) {
+          const auto first_row = run.partition_offsets[partition_idx];
+          const auto block_entry_count =
+              run.partition_offsets[partition_idx + 1] - first_row;
+          if (!block_entry_count) {
+            continue;
+          }
+          block.resize(block_entry_count * row_bytes / sizeof(int64_t));
+          auto block_buff = reinterpret_cast<int8_t*>(&block[0]);
+          read_spill_run(
+              run, first_row * row_bytes, block_entry_count * row_bytes, block_buff);
+          auto block_query_mem_desc = query_mem_desc;
+          block_query_mem_desc.setEntryCount(block_entry_count);
+          ResultSetStorage block_storage(targets, block_query_mem_desc, block_buff, true);
+          block_storage.target_init_vals_ = target_init_vals;
+          for (size_t i = 0; i < block_entry_count; ++i) {
+            partition_storage->reduceOneEntryBaseline(partition_storage->buff_,
+                                                      block_buff,
+                                                      i,
+                                                      block_entry_count,
+                                                      block_storage);
+          }
+        }
+        std::ofstream spill_file(partition_path(partition_idx), std::ios::binary);
+        const auto write_entry = [&](const size_t i) {
+          spill_file.write(
+              reinterpret_cast<const char*>(partition_storage->buff_ + i * row_bytes),
+              row_bytes);
+        };
+        size_t group_count{0};
+        if (keep_top_n) {
+          // groups don't span partitions, the top_n of the result are among
+          // the top_n of the partitions
+          partition_rs.sort(order_entries, top_n);
+          const auto& permutation = partition_rs.getPermutationBuffer();
+          group_count = std::min(top_n, permutation.size());
+          for (size_t i = 0; i < group_count; ++i) {
+            write_entry(permutation[i]);
+          }
+        } else {
+          for (size_t i = 0; i < partition_buffer_entry_count; ++i) {
+            if (!partition_storage->isEmptyEntry(i)) {
+              write_entry(i);
+              ++group_count;
+            }
+          }
+        }
+        spill_file.close();
+        if (!spill_file) {
+          throw std::runtime_error("Failed to write reduction spill file " +
+                                   partition_path(partition_idx));
+        }
+        partition_group_counts[partition_idx] = group_count;
+      }
+    }));
+  }
+  for (auto& reduction_thread : reduction_threads) {
+    reduction_thread.wait();
+  }
+  for (auto& reduction_thread : reduction_threads) {
+    reduction_thread.get();
+  }
+
+  const auto group_count = std::accumulate(
+      partition_group_counts.begin(), partition_group_counts.end(), size_t(0));
+  size_t entry_count = 1;
+  while (entry_count < 2 * group_count) {
+    entry_count <<= 1;
+  }
+  auto result_query_mem_desc = query_mem_desc;
+  result_query_mem_desc.setEntryCount(entry_count);
+  rs_.reset(new ResultSet(targets,
+                          ExecutorDeviceType::CPU,
+                          result_query_mem_desc,
+                          row_set_mem_owner,
+                          executor));
+  const auto result_storage = rs_->allocateStorage(target_init_vals);
+  rs_->initializeStorage();
+  auto result_buff_i64 = reinterpret_cast<int64_t*>(result_storage->buff_);
+  const auto key_count = query_mem_desc.getGroupbyColCount();
+  const auto key_byte_width = query_mem_desc.getEffectiveKeyWidth();
+  std::vector<int64_t> row(row_bytes / sizeof(int64_t));
+  for (size_t partition_idx = 0; partition_idx < partition_count; ++partition_idx) {
+    if (!partition_group_counts[partition_idx]) {
+      continue;
+    }
+    std::ifstream spill_file(partition_path(partition_idx), std::ios::binary);
+    for (size_t i = 0; i < partition_group_counts[partition_idx]; ++i) {
+      spill_file.read(reinterpret_cast<char*>(&row[0]), row_bytes);
+      if (!spill_file) {
+        throw std::runtime_error("Failed to read reduction spill file " +
+                                 partition_path(partition_idx));
+      }
+      // groups are unique across partitions, every key is a new entry
+      auto slots = get_group_value(result_buff_i64,
+                                   entry_count,
+                                   &row[0],
+                                   key_count,
+                                   key_byte_width,
+                                   row.size(),
+                                   nullptr);
+      CHECK(slots);
+      memcpy(slots,
+             reinterpret_cast<const int8_t*>(&row[0]) + key_bytes_with_padding,
+             row_bytes - key_bytes_with_padding);
+    }
+    spill_file.close();
+    boost::filesystem::remove(partition_path(partition_idx));
+  }
+  return rs_.get();
+}
+
 std::shared_ptr<ResultSet> ResultSetManager::getOwnResultSet() {
   return rs_;
 }
@@ -1136,6 +1603,11 @@ void ResultSetStorage::reduceOneSlot(int8_t* this_ptr1,
             max, this_ptr1, that_ptr1, init_val, chosen_bytes, target_info);
         break;
       }
+      case kAPPROX_PERCENTILE: {
+        CHECK_EQ(static_cast<size_t>(chosen_bytes), sizeof(int64_t));
+        reduceOneQuantileSketchSlot(this_ptr1, that_ptr1);
+        break;
+      }
       default:
         CHECK(false);
     }
@@ -1170,6 +1642,23 @@ void ResultSetStorage::reduceOneSlot(int8_t* this_ptr1,
   }
 }
 
+// Either sketch can be missing when the slot comes from an empty input.
+void ResultSetStorage::reduceOneQuantileSketchSlot(int8_t* this_ptr1,
+                                                   const int8_t* that_ptr1) const {
+  CHECK(this_ptr1 && that_ptr1);
+  auto this_sketch_ptr = reinterpret_cast<int64_t*>(this_ptr1);
+  const auto that_sketch_ptr = *reinterpret_cast<const int64_t*>(that_ptr1);
+  if (!that_sketch_ptr || *this_sketch_ptr == that_sketch_ptr) {
+    return;
+  }
+  if (!*this_sketch_ptr) {
+    *this_sketch_ptr = that_sketch_ptr;
+    return;
+  }
+  reinterpret_cast<QuantileSketch*>(*this_sketch_ptr)
+      ->merge(*reinterpret_cast<const QuantileSketch*>(that_sketch_ptr));
+}
+
 void ResultSetStorage::reduceOneCountDistinctSlot(int8_t* this_ptr1,
                                                   const int8_t* that_ptr1,
                                                   const size_t target_logical_idx,
@@ -146,12 +146,13 @@ void ResultSet::doBaselineSort(const ExecutorDeviceType device_type,
     topPermutation(permutation_, top_n, compare);
     return;
   } else {
-    permutation_ =
+    const auto permutation =
         (key_bytewidth == 4)
             ? baseline_sort<int32_t>(
                   device_type, 0, data_mgr, groupby_buffer, pod_oe, layout, top_n, 0, 1)
             : baseline_sort<int64_t>(
                   device_type, 0, data_mgr, groupby_buffer, pod_oe, layout, top_n, 0, 1);
+    permutation_.assign(permutation.begin(), permutation.end());
   }
 }
 
@@ -162,11 +163,16 @@ bool ResultSet::canUseFastBaselineSort(
       query_mem_desc_.sortOnGpu()) {
     return false;
   }
+  // The baseline sort produces 32-bit entry indices.
+  if (query_mem_desc_.getEntryCount() > std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
   const auto& order_entry = order_entries.front();
   CHECK_GE(order_entry.tle_no, 1);
   CHECK_LE(static_cast<size_t>(order_entry.tle_no), targets_.size());
   const auto& target_info = targets_[order_entry.tle_no - 1];
-  if (!target_info.sql_type.is_number() || is_distinct_target(target_info)) {
+  if (!target_info.sql_type.is_number() || is_distinct_target(target_info) ||
+      target_info.agg_kind == kAPPROX_PERCENTILE) {
     return false;
   }
   return (query_mem_desc_.getGroupByColRangeType() == GroupByColRangeType::MultiCol ||
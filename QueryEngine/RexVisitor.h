@@ -88,6 +88,17 @@ class RexVisitor : public RexVisitorBase<T> {
       T operandResult = RexVisitorBase<T>::visit(operand);
       result = aggregateResult(result, operandResult);
     }
+    const auto rex_window_function_operator =
+        dynamic_cast<const RexWindowFunctionOperator*>(rex_operator);
+    if (rex_window_function_operator) {
+      for (const auto& partition_key :
+           rex_window_function_operator->getPartitionKeys()) {
+        result = aggregateResult(result, RexVisitorBase<T>::visit(partition_key.get()));
+      }
+      for (const auto& order_key : rex_window_function_operator->getOrderKeys()) {
+        result = aggregateResult(result, RexVisitorBase<T>::visit(order_key.get()));
+      }
+    }
     return result;
   }
 
@@ -130,6 +141,11 @@ class RexDeepCopyVisitor : public RexVisitorBase<std::unique_ptr<const RexScalar
   RetType visitRef(const RexRef* ref) const override { return ref->deepCopy(); }
 
   RetType visitOperator(const RexOperator* rex_operator) const override {
+    const auto rex_window_function_operator =
+        dynamic_cast<const RexWindowFunctionOperator*>(rex_operator);
+    if (rex_window_function_operator) {
+      return visitWindowFunctionOperator(rex_window_function_operator);
+    }
     const size_t operand_count = rex_operator->size();
     std::vector<RetType> new_opnds;
     for (size_t i = 0; i < operand_count; ++i) {
@@ -138,6 +154,28 @@ class RexDeepCopyVisitor : public RexVisitorBase<std::unique_ptr<const RexScalar
     return rex_operator->getDisambiguated(new_opnds);
   }
 
+  virtual RetType visitWindowFunctionOperator(
+      const RexWindowFunctionOperator* rex_window_function_operator) const {
+    const size_t operand_count = rex_window_function_operator->size();
+    std::vector<RetType> new_opnds;
+    for (size_t i = 0; i < operand_count; ++i) {
+      new_opnds.push_back(visit(rex_window_function_operator->getOperand(i)));
+    }
+    std::vector<RetType> new_partition_keys;
+    for (const auto& partition_key : rex_window_function_operator->getPartitionKeys()) {
+      new_partition_keys.push_back(visit(partition_key.get()));
+    }
+    std::vector<RetType> new_order_keys;
+    for (const auto& order_key : rex_window_function_operator->getOrderKeys()) {
+      new_order_keys.push_back(visit(order_key.get()));
+    }
+    return rex_window_function_operator->disambiguatedOperands(
+        new_opnds,
+        new_partition_keys,
+        new_order_keys,
+        rex_window_function_operator->getCollation());
+  }
+
   RetType visitCase(const RexCase* rex_case) const override {
     std::vector<std::pair<RetType, RetType>> new_pair_list;
     for (size_t i = 0; i < rex_case->branchCount(); ++i) {
@@ -21,15 +21,17 @@
 #include "RuntimeFunctions.h"
 #include "../Shared/funcannotations.h"
 #include "BufferCompaction.h"
+#include "CountDistinctSet.h"
 #include "HyperLogLogRank.h"
 #include "MurmurHash.h"
+#include "QuantileSketch.h"
+#include "SparseHyperLogLog.h"
 #include "TypePunning.h"
 
 #include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <cstring>
-#include <set>
 #include <thread>
 #include <tuple>
 
@@ -266,7 +268,7 @@ extern "C" ALWAYS_INLINE uint64_t agg_count(uint64_t* agg, const int64_t) {
 }
 
 extern "C" ALWAYS_INLINE void agg_count_distinct(int64_t* agg, const int64_t val) {
-  reinterpret_cast<std::set<int64_t>*>(*agg)->insert(val);
+  reinterpret_cast<CountDistinctSet*>(*agg)->insert(val);
 }
 
 extern "C" ALWAYS_INLINE void agg_count_distinct_bitmap(int64_t* agg,
@@ -296,12 +298,35 @@ extern "C" NEVER_INLINE void agg_approximate_count_distinct(int64_t* agg,
   M[index] = std::max(M[index], rank);
 }
 
+extern "C" NEVER_INLINE void agg_approximate_count_distinct_sparse(int64_t* agg,
+                                                                   const int64_t key,
+                                                                   const uint32_t b) {
+  const uint64_t hash = MurmurHash64A(&key, sizeof(key), 0);
+  const uint32_t index = hash >> (64 - b);
+  const uint8_t rank = get_rank(hash << b, 64 - b);
+  reinterpret_cast<SparseHyperLogLog*>(*agg)->update(index, rank, b);
+}
+
 extern "C" GPU_RT_STUB void agg_approximate_count_distinct_gpu(int64_t*,
                                                                const int64_t,
                                                                const uint32_t,
                                                                const int64_t,
                                                                const int64_t) {}
 
+extern "C" NEVER_INLINE void agg_approx_percentile_double(int64_t* agg,
+                                                          const double val) {
+  reinterpret_cast<QuantileSketch*>(*agg)->add(val);
+}
+
+extern "C" ALWAYS_INLINE void agg_approx_percentile_double_skip_val(
+    int64_t* agg,
+    const double val,
+    const double skip_val) {
+  if (val != skip_val) {
+    agg_approx_percentile_double(agg, val);
+  }
+}
+
 extern "C" ALWAYS_INLINE int8_t bit_is_set(const int64_t bitset,
                                            const int64_t val,
                                            const int64_t min_val,
@@ -321,6 +346,17 @@ extern "C" ALWAYS_INLINE int8_t bit_is_set(const int64_t bitset,
              : 0;
 }
 
+// The lexical rank of a dictionary-encoded string in a table built on the host, see
+// get_streaming_top_n_packed_key. Nulls get the rank of the first string, the caller
+// replaces it.
+extern "C" ALWAYS_INLINE int64_t get_string_rank(const int64_t string_ranks,
+                                                 const int64_t string_id,
+                                                 const int64_t null_val) {
+  return string_id == null_val
+             ? reinterpret_cast<const int64_t*>(string_ranks)[0]
+             : reinterpret_cast<const int64_t*>(string_ranks)[string_id];
+}
+
 extern "C" ALWAYS_INLINE int64_t agg_sum(int64_t* agg, const int64_t val) {
   const auto old = *agg;
   *agg += val;
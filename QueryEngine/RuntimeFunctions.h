@@ -104,6 +104,12 @@ extern "C" uint32_t key_hash(const int64_t* key,
                              const uint32_t key_qw_count,
                              const uint32_t key_byte_width);
 
+extern "C" uint32_t get_group_hash_slot(const uint32_t h,
+                                        const uint32_t groups_buffer_entry_count);
+
+extern "C" uint32_t get_group_probe_slot(const uint32_t slot,
+                                         const uint32_t groups_buffer_entry_count);
+
 extern "C" int64_t* get_group_value(int64_t* groups_buffer,
                                     const uint32_t groups_buffer_entry_count,
                                     const int64_t* key,
@@ -121,6 +127,15 @@ extern "C" int64_t* get_group_value_with_watchdog(
     const uint32_t row_size_quad,
     const int64_t* init_val = nullptr);
 
+extern "C" int64_t* get_scatter_group_value(int64_t* groups_buffer,
+                                            const uint32_t groups_buffer_entry_count,
+                                            const uint32_t pos,
+                                            const int64_t* key,
+                                            const uint32_t key_count,
+                                            const uint32_t key_width,
+                                            const uint32_t row_size_quad,
+                                            const int64_t* init_vals = nullptr);
+
 extern "C" int64_t* get_group_value_columnar(int64_t* groups_buffer,
                                              const uint32_t groups_buffer_entry_count,
                                              const int64_t* key,
@@ -0,0 +1,203 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RuntimeJoinFilter.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <future>
+#include <limits>
+
+namespace {
+
+int64_t read_key(const JoinColumn& join_column,
+                 const JoinColumnTypeInfo& type_info,
+                 const size_t i) {
+  switch (type_info.elem_sz) {
+    case 1:
+      return reinterpret_cast<const int8_t*>(join_column.col_buff)[i];
+    case 2:
+      return type_info.is_unsigned
+                 ? reinterpret_cast<const uint16_t*>(join_column.col_buff)[i]
+                 : reinterpret_cast<const int16_t*>(join_column.col_buff)[i];
+    case 4:
+      return reinterpret_cast<const int32_t*>(join_column.col_buff)[i];
+    case 8:
+      return reinterpret_cast<const int64_t*>(join_column.col_buff)[i];
+    default:
+      CHECK(false);
+  }
+  return 0;
+}
+
+uint64_t mix_key(const int64_t val) {
+  auto h = static_cast<uint64_t>(val);
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+// The bloom filter sets three bits of a single word per key, so that a probe
+// touches one cache line.
+size_t bloom_word_idx(const uint64_t h, const size_t word_count) {
+  return (h >> 18) & (word_count - 1);
+}
+
+uint64_t bloom_word_mask(const uint64_t h) {
+  return (uint64_t(1) << (h & 63)) | (uint64_t(1) << ((h >> 6) & 63)) |
+         (uint64_t(1) << ((h >> 12) & 63));
+}
+
+// Distance between two values, without overflow for the whole 64-bit domain.
+uint64_t range_distance(const int64_t lo, const int64_t hi) {
+  return static_cast<uint64_t>(hi) - static_cast<uint64_t>(lo);
+}
+
+}  // namespace
+
+RuntimeJoinFilter::RuntimeJoinFilter(const JoinColumn& join_column,
+                                     const JoinColumnTypeInfo& type_info,
+                                     const int thread_count)
+    : min_(std::numeric_limits<int64_t>::max())
+    , max_(std::numeric_limits<int64_t>::min())
+    , is_bitmap_(true) {
+  CHECK_GT(thread_count, 0);
+  const size_t num_elems = join_column.num_elems;
+  const size_t step = (num_elems + thread_count - 1) / thread_count;
+  std::vector<std::future<std::pair<int64_t, int64_t>>> range_threads;
+  std::vector<std::future<void>> set_bits_threads;
+  for (size_t start = 0; start < num_elems; start += step) {
+    const size_t end = std::min(start + step, num_elems);
+    range_threads.push_back(
+        std::async(std::launch::async, [&join_column, &type_info, start, end] {
+          int64_t min_key = std::numeric_limits<int64_t>::max();
+          int64_t max_key = std::numeric_limits<int64_t>::min();
+          for (size_t i = start; i < end; ++i) {
+            const auto key = read_key(join_column, type_info, i);
+            if (key == type_info.null_val) {
+              continue;
+            }
+            min_key = std::min(min_key, key);
+            max_key = std::max(max_key, key);
+          }
+          return std::make_pair(min_key, max_key);
+        }));
+  }
+  for (auto& range_thread : range_threads) {
+    const auto thread_range = range_thread.get();
+    min_ = std::min(min_, thread_range.first);
+    max_ = std::max(max_, thread_range.second);
+  }
+  if (empty()) {
+    return;
+  }
+  const uint64_t max_bitmap_bits =
+      std::max(static_cast<uint64_t>(num_elems) * 16, uint64_t(1) << 16);
+  const auto range_bits = range_distance(min_, max_);
+  if (range_bits < max_bitmap_bits) {
+    bits_.resize((range_bits + 1 + 63) / 64);
+  } else {
+    is_bitmap_ = false;
+    size_t word_count = 1;
+    while (word_count * 64 < num_elems * 8) {
+      word_count *= 2;
+    }
+    bits_.resize(word_count);
+  }
+  for (size_t start = 0; start < num_elems; start += step) {
+    const size_t end = std::min(start + step, num_elems);
+    set_bits_threads.push_back(
+        std::async(std::launch::async, [this, &join_column, &type_info, start, end] {
+          for (size_t i = start; i < end; ++i) {
+            const auto key = read_key(join_column, type_info, i);
+            if (key != type_info.null_val) {
+              setBit(key);
+            }
+          }
+        }));
+  }
+  for (auto& set_bits_thread : set_bits_threads) {
+    set_bits_thread.get();
+  }
+}
+
+void RuntimeJoinFilter::setBit(const int64_t val) {
+  if (is_bitmap_) {
+    const auto bit_idx = range_distance(min_, val);
+    __sync_fetch_and_or(&bits_[bit_idx >> 6], uint64_t(1) << (bit_idx & 63));
+    return;
+  }
+  const auto h = mix_key(val);
+  __sync_fetch_and_or(&bits_[bloom_word_idx(h, bits_.size())], bloom_word_mask(h));
+}
+
+bool RuntimeJoinFilter::mayContain(const int64_t val) const {
+  if (val < min_ || val > max_) {
+    return false;
+  }
+  if (is_bitmap_) {
+    const auto bit_idx = range_distance(min_, val);
+    return bits_[bit_idx >> 6] & (uint64_t(1) << (bit_idx & 63));
+  }
+  const auto h = mix_key(val);
+  const auto mask = bloom_word_mask(h);
+  return (bits_[bloom_word_idx(h, bits_.size())] & mask) == mask;
+}
+
+bool RuntimeJoinFilter::mayContainAnyOf(const int64_t range_min,
+                                        const int64_t range_max) const {
+  const auto lo = std::max(range_min, min_);
+  const auto hi = std::min(range_max, max_);
+  if (lo > hi) {
+    return false;
+  }
+  if (is_bitmap_) {
+    if (range_distance(lo, hi) >= static_cast<uint64_t>(max_bitmap_scan_range)) {
+      return true;
+    }
+    const auto lo_bit = range_distance(min_, lo);
+    const auto hi_bit = range_distance(min_, hi);
+    for (auto word_idx = lo_bit >> 6; word_idx <= hi_bit >> 6; ++word_idx) {
+      auto word = bits_[word_idx];
+      if (word_idx == lo_bit >> 6) {
+        word &= ~uint64_t(0) << (lo_bit & 63);
+      }
+      if (word_idx == hi_bit >> 6) {
+        word &= ~uint64_t(0) >> (63 - (hi_bit & 63));
+      }
+      if (word) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (range_distance(lo, hi) >= static_cast<uint64_t>(max_bloom_probe_range)) {
+    return true;
+  }
+  for (auto val = lo;; ++val) {
+    if (mayContain(val)) {
+      return true;
+    }
+    if (val == hi) {
+      break;
+    }
+  }
+  return false;
+}
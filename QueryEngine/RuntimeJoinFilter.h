@@ -0,0 +1,73 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    RuntimeJoinFilter.h
+ * @brief   Summary of the build side keys of a hash join.
+ *
+ * Built along with the join hash table from the inner key column: the minimum and
+ * the maximum of the keys, plus a bitmap over [min, max] if the domain is small
+ * enough or a blocked bloom filter otherwise. The probe side uses it to skip the
+ * outer fragments whose chunk metadata range cannot contain any of the keys, which
+ * is what makes a selective filter on a small dimension table cheap for the fact
+ * table as well. Nulls never match an equijoin and aren't part of the summary.
+ */
+
+#ifndef QUERYENGINE_RUNTIMEJOINFILTER_H
+#define QUERYENGINE_RUNTIMEJOINFILTER_H
+
+#include "HashJoinRuntime.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class RuntimeJoinFilter {
+ public:
+  RuntimeJoinFilter(const JoinColumn& join_column,
+                    const JoinColumnTypeInfo& type_info,
+                    const int thread_count);
+
+  // No key, an inner join on this column cannot produce any row.
+  bool empty() const { return min_ > max_; }
+
+  int64_t getMin() const { return min_; }
+
+  int64_t getMax() const { return max_; }
+
+  bool isBitmap() const { return is_bitmap_; }
+
+  // False only if none of the keys is val.
+  bool mayContain(const int64_t val) const;
+
+  // False only if none of the keys is in [range_min, range_max].
+  bool mayContainAnyOf(const int64_t range_min, const int64_t range_max) const;
+
+ private:
+  void setBit(const int64_t val);
+
+  int64_t min_;
+  int64_t max_;
+  bool is_bitmap_;
+  std::vector<uint64_t> bits_;
+
+  // A range gets probed value by value in the bloom filter only up to this size.
+  static const int64_t max_bloom_probe_range{256};
+  // Don't scan more than this many bits of the bitmap for a range.
+  static const int64_t max_bitmap_scan_range{1 << 22};
+};
+
+#endif  // QUERYENGINE_RUNTIMEJOINFILTER_H
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    SparseHyperLogLog.h
+ * @brief   HyperLogLog registers for APPROX_COUNT_DISTINCT in CPU group by queries.
+ *
+ * Most groups only ever see a handful of distinct values, so instead of allocating
+ * 2^b registers up front the non-zero registers are kept as a sorted vector of
+ * (index, rank) pairs. Past a fraction of the dense size the registers get promoted
+ * to a regular dense array. Both representations hold exactly the same registers,
+ * the estimate doesn't depend on which one is used.
+ *
+ * Included by the runtime functions, which get compiled to bitcode as C++11 and
+ * without glog, keep it that way.
+ */
+
+#ifndef QUERYENGINE_SPARSEHYPERLOGLOG_H
+#define QUERYENGINE_SPARSEHYPERLOGLOG_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+class SparseHyperLogLog {
+ public:
+  void update(const uint32_t index, const uint8_t rank, const uint32_t bitmap_sz_bits) {
+    if (!dense_.empty()) {
+      dense_[index] = std::max(dense_[index], rank);
+      return;
+    }
+    auto it = std::lower_bound(sparse_.begin(), sparse_.end(), encode(index, 0));
+    if (it != sparse_.end() && decode_index(*it) == index) {
+      if (decode_rank(*it) < rank) {
+        *it = encode(index, rank);
+      }
+      return;
+    }
+    if (sparse_.size() < max_sparse_size(bitmap_sz_bits)) {
+      sparse_.insert(it, encode(index, rank));
+      return;
+    }
+    toDense(bitmap_sz_bits);
+    dense_[index] = rank;
+  }
+
+  // Both sides must use the same number of registers.
+  void unite(const SparseHyperLogLog& that, const uint32_t bitmap_sz_bits) {
+    if (this == &that) {
+      return;
+    }
+    if (!that.dense_.empty()) {
+      if (dense_.empty()) {
+        toDense(bitmap_sz_bits);
+      }
+      const size_t m = dense_.size();
+      uint8_t* __restrict lhs = dense_.data();
+      const uint8_t* __restrict rhs = that.dense_.data();
+      for (size_t r = 0; r < m; ++r) {
+        lhs[r] = std::max(lhs[r], rhs[r]);
+      }
+      return;
+    }
+    if (!dense_.empty()) {
+      for (const auto reg : that.sparse_) {
+        update(decode_index(reg), decode_rank(reg), bitmap_sz_bits);
+      }
+      return;
+    }
+    std::vector<uint32_t> united;
+    united.reserve(sparse_.size() + that.sparse_.size());
+    auto lhs_it = sparse_.begin();
+    auto rhs_it = that.sparse_.begin();
+    while (lhs_it != sparse_.end() && rhs_it != that.sparse_.end()) {
+      const auto lhs_index = decode_index(*lhs_it);
+      const auto rhs_index = decode_index(*rhs_it);
+      if (lhs_index < rhs_index) {
+        united.push_back(*lhs_it++);
+      } else if (rhs_index < lhs_index) {
+        united.push_back(*rhs_it++);
+      } else {
+        // same index, the encoding orders by rank next
+        united.push_back(std::max(*lhs_it++, *rhs_it++));
+      }
+    }
+    std::copy(lhs_it, sparse_.end(), std::back_inserter(united));
+    std::copy(rhs_it, that.sparse_.end(), std::back_inserter(united));
+    sparse_.swap(united);
+    if (sparse_.size() > max_sparse_size(bitmap_sz_bits)) {
+      toDense(bitmap_sz_bits);
+    }
+  }
+
+  bool isDense() const { return !dense_.empty(); }
+
+  const uint8_t* denseRegisters() const { return dense_.data(); }
+
+  // Number of non-zero registers of a sparse set.
+  size_t sparseRegisterCount() const { return sparse_.size(); }
+
+  template <class FUNC>
+  void forEachSparseRegister(FUNC func) const {
+    for (const auto reg : sparse_) {
+      func(decode_index(reg), decode_rank(reg));
+    }
+  }
+
+  // Stay sparse while the (index, rank) pairs use less than half the dense size.
+  static size_t max_sparse_size(const uint32_t bitmap_sz_bits) {
+    return std::max((size_t(1) << bitmap_sz_bits) / (2 * sizeof(uint32_t)), size_t(1));
+  }
+
+ private:
+  // The index takes at most 16 bits and the rank at most 8, the encoded registers
+  // sort by index first.
+  static uint32_t encode(const uint32_t index, const uint8_t rank) {
+    return (index << 8) | rank;
+  }
+
+  static uint32_t decode_index(const uint32_t reg) { return reg >> 8; }
+
+  static uint8_t decode_rank(const uint32_t reg) { return reg & 0xff; }
+
+  void toDense(const uint32_t bitmap_sz_bits) {
+    dense_.assign(size_t(1) << bitmap_sz_bits, 0);
+    for (const auto reg : sparse_) {
+      dense_[decode_index(reg)] = decode_rank(reg);
+    }
+    std::vector<uint32_t>().swap(sparse_);
+  }
+
+  std::vector<uint32_t> sparse_;
+  std::vector<uint8_t> dense_;
+};
+
+#endif  // QUERYENGINE_SPARSEHYPERLOGLOG_H
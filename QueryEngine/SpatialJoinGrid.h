@@ -0,0 +1,45 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    SpatialJoinGrid.h
+ * @brief   Cell of a coordinate in the uniform grid of a spatial join table.
+ *
+ * Shared by the build of the table on the host and the probe from the generated
+ * code, both must map a coordinate to the same cell.
+ */
+
+#ifndef QUERYENGINE_SPATIALJOINGRID_H
+#define QUERYENGINE_SPATIALJOINGRID_H
+
+#include <stdint.h>
+#include "../Shared/funcannotations.h"
+
+// Column (or row) of the grid which contains val, -1 if it's outside of [min, max]. The
+// mapping is monotonic, the cells of the corners of a box bound the cells of its points.
+inline DEVICE int64_t spatial_join_grid_coord(const double val,
+                                              const double min,
+                                              const double max,
+                                              const double inv_cell_size,
+                                              const int64_t dim) {
+  if (!(val >= min && val <= max)) {
+    return -1;
+  }
+  const auto coord = static_cast<int64_t>((val - min) * inv_cell_size);
+  return coord < dim ? coord : dim - 1;
+}
+
+#endif  // QUERYENGINE_SPATIALJOINGRID_H
@@ -0,0 +1,531 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SpatialJoinTable.h"
+#include "Execute.h"
+#include "ExpressionRange.h"
+#include "GpuMemUtils.h"
+#include "JoinHashTable.h"
+#include "SpatialJoinGrid.h"
+
+#include "../Chunk/Chunk.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace {
+
+// Boxes are widened by more than the tolerance box_contains_point allows and the
+// rounding of the distance computation, a wider box only adds candidates.
+double box_margin(const double coord) {
+  return 1e-8 * (1. + std::fabs(coord));
+}
+
+// Decoded like decompress_coord in ExtensionFunctionsGeo.hpp does.
+double decompress_point_coord(const int8_t* coords,
+                              const int32_t compression,
+                              const bool is_x) {
+  if (compression == 1) {
+    const auto compressed_coord = reinterpret_cast<const int32_t*>(coords)[is_x ? 0 : 1];
+    return static_cast<double>(compressed_coord) *
+           (is_x ? 8.3819031754424345e-08 : 4.1909515877212172e-08);
+  }
+  return reinterpret_cast<const double*>(coords)[is_x ? 0 : 1];
+}
+
+bool get_int_arg(const Analyzer::FunctionOper* func_oper,
+                 const size_t i,
+                 int32_t& val) {
+  const auto arg = dynamic_cast<const Analyzer::Constant*>(func_oper->getArg(i));
+  if (!arg || arg->get_is_null() || arg->get_type_info().get_type() != kINT) {
+    return false;
+  }
+  val = arg->get_constval().intval;
+  return true;
+}
+
+bool get_distance(const Analyzer::Expr* expr, double& distance) {
+  const auto constant = dynamic_cast<const Analyzer::Constant*>(expr);
+  if (!constant || constant->get_is_null()) {
+    return false;
+  }
+  const auto& ti = constant->get_type_info();
+  if (ti.is_fp()) {
+    distance = get_value_from_datum<double>(constant->get_constval(), ti.get_type());
+    return true;
+  }
+  if (ti.is_integer()) {
+    distance = get_value_from_datum<int64_t>(constant->get_constval(), ti.get_type());
+    return true;
+  }
+  return false;
+}
+
+std::shared_ptr<Analyzer::ColumnVar> get_geo_col(
+    const std::shared_ptr<Analyzer::Expr>& expr) {
+  const auto col = std::dynamic_pointer_cast<Analyzer::ColumnVar>(expr);
+  return col && col->get_type_info().is_geometry() ? col : nullptr;
+}
+
+bool is_outer_point(const std::shared_ptr<Analyzer::ColumnVar>& col,
+                    const int inner_rte_idx) {
+  return col && col->get_type_info().get_type() == kPOINT &&
+         col->get_rte_idx() < inner_rte_idx;
+}
+
+bool is_inner_geo_col(const std::shared_ptr<Analyzer::ColumnVar>& col,
+                      const int inner_rte_idx) {
+  return col && col->get_rte_idx() == inner_rte_idx && col->get_table_id() > 0;
+}
+
+// Chunk of a column of a physical table on the host, null for an empty fragment.
+std::shared_ptr<Chunk_NS::Chunk> get_chunk(
+    const int table_id,
+    const int col_id,
+    const Fragmenter_Namespace::FragmentInfo& fragment,
+    const Catalog_Namespace::Catalog& catalog) {
+  if (fragment.isEmptyPhysicalFragment()) {
+    return nullptr;
+  }
+  const auto cd = get_column_descriptor(col_id, table_id, catalog);
+  CHECK(cd);
+  const auto chunk_meta_it = fragment.getChunkMetadataMap().find(col_id);
+  CHECK(chunk_meta_it != fragment.getChunkMetadataMap().end());
+  ChunkKey chunk_key{catalog.get_currentDB().dbId,
+                     fragment.physicalTableId,
+                     col_id,
+                     fragment.fragmentId};
+  return Chunk_NS::Chunk::getChunk(cd,
+                                   &catalog.get_dataMgr(),
+                                   chunk_key,
+                                   Data_Namespace::CPU_LEVEL,
+                                   0,
+                                   chunk_meta_it->second.numBytes,
+                                   chunk_meta_it->second.numElements);
+}
+
+}  // namespace
+
+std::shared_ptr<SpatialJoinTable> SpatialJoinTable::getInstance(
+    const std::list<std::shared_ptr<Analyzer::Expr>>& join_quals,
+    const int inner_rte_idx,
+    const std::vector<InputTableInfo>& query_infos,
+    const Data_Namespace::MemoryLevel memory_level,
+    const int device_count,
+    Executor* executor) {
+  for (const auto& join_qual : join_quals) {
+    SpatialQual spatial_qual;
+    if (!getSpatialQual(join_qual, inner_rte_idx, spatial_qual)) {
+      continue;
+    }
+    if (g_cluster) {
+      const auto inner_td = executor->getCatalog()->getMetadataForTable(
+          spatial_qual.inner_col->get_table_id());
+      CHECK(inner_td);
+      if (!table_is_replicated(inner_td)) {
+        throw HashJoinFail("Join table " + inner_td->tableName + " must be replicated");
+      }
+    }
+    auto spatial_join_table = std::shared_ptr<SpatialJoinTable>(
+        new SpatialJoinTable(spatial_qual, query_infos, memory_level, executor));
+    try {
+      spatial_join_table->reify(device_count);
+    } catch (const HashJoinFail&) {
+      throw;
+    } catch (const std::exception& e) {
+      throw HashJoinFail(std::string("Could not build the spatial join table | ") +
+                         e.what());
+    }
+    return spatial_join_table;
+  }
+  throw HashJoinFail("No spatial join condition found");
+}
+
+// ST_Contains(inner polygon, outer point), with the arguments the translator adds:
+// polygon, bounds, point, then the compression and srid of both and the output srid.
+// ST_Distance(inner point, outer point) < distance, or the other way around, has the
+// two points followed by the same compression and srid arguments.
+bool SpatialJoinTable::getSpatialQual(const std::shared_ptr<Analyzer::Expr>& qual,
+                                      const int inner_rte_idx,
+                                      SpatialQual& spatial_qual) {
+  auto func_oper = std::dynamic_pointer_cast<Analyzer::FunctionOper>(qual);
+  if (func_oper) {
+    const auto name = func_oper->getName();
+    if ((name != "ST_Contains_Polygon_Point" &&
+         name != "ST_Contains_MultiPolygon_Point") ||
+        func_oper->getArity() != 8) {
+      return false;
+    }
+    const auto poly_col = get_geo_col(func_oper->getOwnArg(0));
+    const auto bounds_col =
+        std::dynamic_pointer_cast<Analyzer::ColumnVar>(func_oper->getOwnArg(1));
+    const auto point_col = get_geo_col(func_oper->getOwnArg(2));
+    int32_t poly_srid{0};
+    int32_t output_srid{0};
+    if (!is_inner_geo_col(poly_col, inner_rte_idx) || !bounds_col ||
+        !bounds_col->get_type_info().is_array() ||
+        bounds_col->get_rte_idx() != inner_rte_idx ||
+        !is_outer_point(point_col, inner_rte_idx) ||
+        !get_int_arg(func_oper.get(), 4, poly_srid) ||
+        !get_int_arg(func_oper.get(), 7, output_srid)) {
+      return false;
+    }
+    // The bounds are in the coordinates of the polygon as stored.
+    if (poly_srid != output_srid) {
+      return false;
+    }
+    spatial_qual.inner_col = poly_col;
+    spatial_qual.inner_bounds_col = bounds_col;
+    spatial_qual.outer_point_args = {point_col,
+                                     func_oper->getOwnArg(5),
+                                     func_oper->getOwnArg(6),
+                                     func_oper->getOwnArg(7)};
+    spatial_qual.inner_compression = 0;
+    spatial_qual.distance = 0;
+    return true;
+  }
+  const auto bin_oper = std::dynamic_pointer_cast<Analyzer::BinOper>(qual);
+  if (!bin_oper || bin_oper->get_qualifier() != kONE) {
+    return false;
+  }
+  auto optype = bin_oper->get_optype();
+  auto distance_expr = bin_oper->get_own_right_operand();
+  func_oper = std::dynamic_pointer_cast<Analyzer::FunctionOper>(
+      bin_oper->get_own_left_operand());
+  if (!func_oper) {
+    optype = COMMUTE_COMPARISON(optype);
+    distance_expr = bin_oper->get_own_left_operand();
+    func_oper = std::dynamic_pointer_cast<Analyzer::FunctionOper>(
+        bin_oper->get_own_right_operand());
+  }
+  double distance{0};
+  if ((optype != kLT && optype != kLE) || !func_oper ||
+      func_oper->getName() != "ST_Distance_Point_Point" || func_oper->getArity() != 7 ||
+      !get_distance(distance_expr.get(), distance)) {
+    return false;
+  }
+  for (const size_t inner_arg_idx : {size_t(0), size_t(1)}) {
+    const auto inner_col = get_geo_col(func_oper->getOwnArg(inner_arg_idx));
+    const auto outer_col = get_geo_col(func_oper->getOwnArg(1 - inner_arg_idx));
+    int32_t inner_compression{0};
+    int32_t inner_srid{0};
+    int32_t output_srid{0};
+    if (!is_inner_geo_col(inner_col, inner_rte_idx) ||
+        inner_col->get_type_info().get_type() != kPOINT ||
+        !is_outer_point(outer_col, inner_rte_idx) ||
+        !get_int_arg(func_oper.get(), 2 + 2 * inner_arg_idx, inner_compression) ||
+        !get_int_arg(func_oper.get(), 3 + 2 * inner_arg_idx, inner_srid) ||
+        !get_int_arg(func_oper.get(), 6, output_srid) || inner_srid != output_srid) {
+      continue;
+    }
+    const size_t outer_arg_idx = 1 - inner_arg_idx;
+    spatial_qual.inner_col = inner_col;
+    spatial_qual.inner_bounds_col = nullptr;
+    spatial_qual.outer_point_args = {outer_col,
+                                     func_oper->getOwnArg(2 + 2 * outer_arg_idx),
+                                     func_oper->getOwnArg(3 + 2 * outer_arg_idx),
+                                     func_oper->getOwnArg(6)};
+    spatial_qual.inner_compression = inner_compression;
+    spatial_qual.distance = std::max(distance, 0.);
+    return true;
+  }
+  return false;
+}
+
+SpatialJoinTable::SpatialJoinTable(const SpatialQual& spatial_qual,
+                                   const std::vector<InputTableInfo>& query_infos,
+                                   const Data_Namespace::MemoryLevel memory_level,
+                                   Executor* executor)
+    : spatial_qual_(spatial_qual)
+    , query_infos_(query_infos)
+    , memory_level_(memory_level)
+    , executor_(executor)
+    , min_x_(0)
+    , max_x_(0)
+    , min_y_(0)
+    , max_y_(0)
+    , inv_cell_width_(0)
+    , inv_cell_height_(0)
+    , dim_x_(1)
+    , dim_y_(1) {}
+
+void SpatialJoinTable::reify(const int device_count) {
+  const auto boxes = fetchBoundingBoxes();
+  if (boxes.size() > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+    throw TooManyHashEntries();
+  }
+  buildGrid(boxes);
+#ifdef HAVE_CUDA
+  if (memory_level_ == Data_Namespace::GPU_LEVEL) {
+    auto& data_mgr = executor_->getCatalog()->get_dataMgr();
+    const auto buff_size = cpu_buff_.size() * sizeof(cpu_buff_[0]);
+    gpu_buff_.resize(device_count);
+    for (int device_id = 0; device_id < device_count; ++device_id) {
+      gpu_buff_[device_id] = alloc_gpu_mem(&data_mgr, buff_size, device_id, nullptr);
+      copy_to_gpu(&data_mgr, gpu_buff_[device_id], &cpu_buff_[0], buff_size, device_id);
+    }
+  }
+#else
+  CHECK_EQ(Data_Namespace::CPU_LEVEL, memory_level_);
+#endif
+}
+
+std::vector<std::array<double, 4>> SpatialJoinTable::fetchBoundingBoxes() {
+  const auto& catalog = *executor_->getCatalog();
+  const auto& inner_col = spatial_qual_.inner_col;
+  const auto table_id = inner_col->get_table_id();
+  // The coordinates of a point are the first physical column after the geo column.
+  const int col_id = spatial_qual_.inner_bounds_col
+                         ? spatial_qual_.inner_bounds_col->get_column_id()
+                         : inner_col->get_column_id() + 1;
+  const auto margin = spatial_qual_.distance;
+  const auto& fragments = get_inner_query_info(table_id, query_infos_).info.fragments;
+  std::vector<std::array<double, 4>> boxes;
+  for (const auto& fragment : fragments) {
+    const auto chunk = get_chunk(table_id, col_id, fragment, catalog);
+    if (!chunk) {
+      continue;
+    }
+    const auto& chunk_meta = fragment.getChunkMetadataMap().find(col_id)->second;
+    auto chunk_iter = chunk->begin_iterator(chunk_meta);
+    for (size_t i = 0; i < chunk_meta.numElements; ++i) {
+      VarlenDatum vd;
+      bool is_end{false};
+      ChunkIter_get_nth(&chunk_iter, i, false, &vd, &is_end);
+      CHECK(!is_end);
+      std::array<double, 4> box{1, 1, 0, 0};
+      if (spatial_qual_.inner_bounds_col) {
+        if (!vd.is_null && vd.length >= static_cast<int>(4 * sizeof(double))) {
+          const auto bounds = reinterpret_cast<const double*>(vd.pointer);
+          box = {bounds[0], bounds[1], bounds[2], bounds[3]};
+        }
+      } else if (!vd.is_null && vd.length > 0) {
+        const auto x =
+            decompress_point_coord(vd.pointer, spatial_qual_.inner_compression, true);
+        const auto y =
+            decompress_point_coord(vd.pointer, spatial_qual_.inner_compression, false);
+        box = {x - margin, y - margin, x + margin, y + margin};
+      }
+      if (box[0] <= box[2] && box[1] <= box[3]) {
+        box[0] -= box_margin(box[0]);
+        box[1] -= box_margin(box[1]);
+        box[2] += box_margin(box[2]);
+        box[3] += box_margin(box[3]);
+      }
+      boxes.push_back(box);
+    }
+  }
+  return boxes;
+}
+
+// The cells are about the size of an average box and the grid has about as many cells
+// as boxes. It gets coarser while the big boxes make the copies of the row ids
+// outnumber the boxes too much.
+void SpatialJoinTable::buildGrid(const std::vector<std::array<double, 4>>& boxes) {
+  size_t box_count{0};
+  double width_sum{0};
+  double height_sum{0};
+  min_x_ = min_y_ = std::numeric_limits<double>::max();
+  max_x_ = max_y_ = std::numeric_limits<double>::lowest();
+  for (const auto& box : boxes) {
+    // Also skips the boxes with NaN coordinates.
+    if (!(box[0] <= box[2] && box[1] <= box[3])) {
+      continue;
+    }
+    ++box_count;
+    width_sum += box[2] - box[0];
+    height_sum += box[3] - box[1];
+    min_x_ = std::min(min_x_, box[0]);
+    min_y_ = std::min(min_y_, box[1]);
+    max_x_ = std::max(max_x_, box[2]);
+    max_y_ = std::max(max_y_, box[3]);
+  }
+  if (!box_count) {
+    min_x_ = min_y_ = max_x_ = max_y_ = 0;
+  }
+  const double width = max_x_ - min_x_;
+  const double height = max_y_ - min_y_;
+  const auto get_dim = [box_count](const double extent, const double box_size_sum) {
+    if (!box_count || !(extent > 0)) {
+      return size_t(1);
+    }
+    const auto cell_size = std::max(extent / std::sqrt(static_cast<double>(box_count)),
+                                    box_size_sum / box_count);
+    const size_t max_dim{1 << 12};
+    return static_cast<size_t>(
+        std::min(std::ceil(extent / cell_size), static_cast<double>(max_dim)));
+  };
+  dim_x_ = std::max(get_dim(width, width_sum), size_t(1));
+  dim_y_ = std::max(get_dim(height, height_sum), size_t(1));
+  std::vector<std::array<int64_t, 4>> box_cells;
+  size_t entry_count{0};
+  while (true) {
+    inv_cell_width_ = width > 0 ? dim_x_ / width : 0;
+    inv_cell_height_ = height > 0 ? dim_y_ / height : 0;
+    box_cells.clear();
+    entry_count = 0;
+    for (const auto& box : boxes) {
+      if (!(box[0] <= box[2] && box[1] <= box[3])) {
+        box_cells.push_back({1, 1, 0, 0});
+        continue;
+      }
+      const std::array<int64_t, 4> cells{
+          spatial_join_grid_coord(box[0], min_x_, max_x_, inv_cell_width_, dim_x_),
+          spatial_join_grid_coord(box[1], min_y_, max_y_, inv_cell_height_, dim_y_),
+          spatial_join_grid_coord(box[2], min_x_, max_x_, inv_cell_width_, dim_x_),
+          spatial_join_grid_coord(box[3], min_y_, max_y_, inv_cell_height_, dim_y_)};
+      CHECK_GE(cells[0], 0);
+      CHECK_GE(cells[1], 0);
+      entry_count += (cells[2] - cells[0] + 1) * (cells[3] - cells[1] + 1);
+      box_cells.push_back(cells);
+    }
+    if (entry_count <= std::max(16 * box_count, dim_x_ * dim_y_) ||
+        (dim_x_ == 1 && dim_y_ == 1)) {
+      break;
+    }
+    dim_x_ = (dim_x_ + 1) / 2;
+    dim_y_ = (dim_y_ + 1) / 2;
+  }
+  if (entry_count > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+    throw TooManyHashEntries();
+  }
+  const auto cell_count = dim_x_ * dim_y_;
+  cpu_buff_.assign(2 * cell_count + entry_count, 0);
+  auto offsets = &cpu_buff_[0];
+  auto counts = offsets + cell_count;
+  auto row_ids = counts + cell_count;
+  const auto for_each_cell = [this](const std::array<int64_t, 4>& cells,
+                                    const std::function<void(const size_t)>& func) {
+    for (int64_t cell_y = cells[1]; cell_y <= cells[3]; ++cell_y) {
+      for (int64_t cell_x = cells[0]; cell_x <= cells[2]; ++cell_x) {
+        func(cell_y * dim_x_ + cell_x);
+      }
+    }
+  };
+  for (const auto& cells : box_cells) {
+    for_each_cell(cells, [counts](const size_t cell) { ++counts[cell]; });
+  }
+  int32_t offset{0};
+  for (size_t cell = 0; cell < cell_count; ++cell) {
+    offsets[cell] = offset;
+    offset += counts[cell];
+  }
+  std::fill(counts, counts + cell_count, 0);
+  for (size_t i = 0; i < box_cells.size(); ++i) {
+    for_each_cell(box_cells[i], [offsets, counts, row_ids, i](const size_t cell) {
+      row_ids[offsets[cell] + counts[cell]++] = i;
+    });
+  }
+}
+
+int64_t SpatialJoinTable::getJoinHashBuffer(const ExecutorDeviceType device_type,
+                                            const int device_id) noexcept {
+#ifdef HAVE_CUDA
+  if (device_type == ExecutorDeviceType::GPU) {
+    CHECK_LT(static_cast<size_t>(device_id), gpu_buff_.size());
+    return gpu_buff_[device_id];
+  }
+#endif
+  CHECK(device_type == ExecutorDeviceType::CPU);
+  return reinterpret_cast<int64_t>(&cpu_buff_[0]);
+}
+
+// No qual holds for all the candidates, there's no tautology to replace.
+llvm::Value* SpatialJoinTable::codegenSlotIsValid(const CompilationOptions&,
+                                                  const size_t) {
+  CHECK(false);
+  return nullptr;
+}
+
+llvm::Value* SpatialJoinTable::codegenSlot(const CompilationOptions&, const size_t) {
+  CHECK(false);
+  return nullptr;
+}
+
+#define LL_CONTEXT executor_->cgen_state_->context_
+#define LL_BUILDER executor_->cgen_state_->ir_builder_
+#define LL_INT(v) executor_->ll_int(v)
+#define LL_FP(v) executor_->ll_fp(v)
+
+HashJoinMatchingSet SpatialJoinTable::codegenMatchingSet(const CompilationOptions& co,
+                                                         const size_t index) {
+  const auto x_lv = codegenPointCoord(true, co);
+  const auto y_lv = codegenPointCoord(false, co);
+  const auto cell_lv =
+      executor_->cgen_state_->emitCall("spatial_join_cell",
+                                       {x_lv,
+                                        y_lv,
+                                        LL_FP(min_x_),
+                                        LL_FP(max_x_),
+                                        LL_FP(min_y_),
+                                        LL_FP(max_y_),
+                                        LL_FP(inv_cell_width_),
+                                        LL_FP(inv_cell_height_),
+                                        LL_INT(static_cast<int64_t>(dim_x_)),
+                                        LL_INT(static_cast<int64_t>(dim_y_))});
+  const auto cell_valid_lv = LL_BUILDER.CreateICmpSGE(cell_lv, LL_INT(int64_t(0)));
+  const auto slot_lv =
+      LL_BUILDER.CreateSelect(cell_valid_lv, cell_lv, LL_INT(int64_t(0)));
+  auto buff_lv = JoinHashTable::codegenHashTableLoad(index, executor_);
+  if (buff_lv->getType()->isPointerTy()) {
+    buff_lv = LL_BUILDER.CreatePtrToInt(buff_lv, llvm::Type::getInt64Ty(LL_CONTEXT));
+  }
+  CHECK(buff_lv->getType()->isIntegerTy(64));
+  const auto offsets_lv =
+      LL_BUILDER.CreateIntToPtr(buff_lv, llvm::Type::getInt32PtrTy(LL_CONTEXT));
+  const auto cell_count = static_cast<int64_t>(getCellCount());
+  const auto offset_lv = LL_BUILDER.CreateSExt(
+      LL_BUILDER.CreateLoad(LL_BUILDER.CreateGEP(offsets_lv, slot_lv)),
+      llvm::Type::getInt64Ty(LL_CONTEXT));
+  const auto count_lv = LL_BUILDER.CreateSExt(
+      LL_BUILDER.CreateLoad(LL_BUILDER.CreateGEP(
+          offsets_lv, LL_BUILDER.CreateAdd(slot_lv, LL_INT(cell_count)))),
+      llvm::Type::getInt64Ty(LL_CONTEXT));
+  const auto elements_lv = LL_BUILDER.CreateGEP(
+      offsets_lv, LL_BUILDER.CreateAdd(offset_lv, LL_INT(2 * cell_count)));
+  return {elements_lv,
+          LL_BUILDER.CreateSelect(cell_valid_lv, count_lv, LL_INT(int64_t(0))),
+          slot_lv};
+}
+
+// The coordinate the predicate sees, through the accessor function of ST_X and ST_Y.
+llvm::Value* SpatialJoinTable::codegenPointCoord(const bool is_x,
+                                                 const CompilationOptions& co) {
+  const auto coord_expr =
+      makeExpr<Analyzer::FunctionOper>(SQLTypeInfo(kDOUBLE, false),
+                                       is_x ? "ST_X_Point" : "ST_Y_Point",
+                                       spatial_qual_.outer_point_args);
+  const auto coord_lvs = executor_->codegen(coord_expr.get(), true, co);
+  CHECK_EQ(size_t(1), coord_lvs.size());
+  return coord_lvs.front();
+}
+
+#undef LL_FP
+#undef LL_INT
+#undef LL_BUILDER
+#undef LL_CONTEXT
+
+int SpatialJoinTable::getInnerTableId() const noexcept {
+  return spatial_qual_.inner_col->get_table_id();
+}
+
+int SpatialJoinTable::getInnerTableRteIdx() const noexcept {
+  return spatial_qual_.inner_col->get_rte_idx();
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    SpatialJoinTable.h
+ * @brief   Uniform grid over the bounding boxes of the inner table of a spatial join.
+ *
+ * Joins on ST_Contains(polygon, point) or on ST_Distance(point, point) below a
+ * constant can't use a hash table and would run as a loop join. Instead, the bounding
+ * box of every inner row (from the bounds column of the polygons, or the point
+ * widened by the distance) is added to the cells of a uniform grid it overlaps. An
+ * outer point only looks at the rows of its cell, which are candidates: the join qual
+ * remains a filter. The layout is the one of the one to many hash tables, offsets
+ * and counts for every cell followed by the row ids.
+ */
+
+#ifndef QUERYENGINE_SPATIALJOINTABLE_H
+#define QUERYENGINE_SPATIALJOINTABLE_H
+
+#include "../Analyzer/Analyzer.h"
+#include "../DataMgr/MemoryLevel.h"
+#include "ColumnarResults.h"
+#include "InputMetadata.h"
+#include "JoinHashTableInterface.h"
+
+#ifdef HAVE_CUDA
+#include <cuda.h>
+#endif
+
+#include <array>
+#include <list>
+#include <memory>
+#include <vector>
+
+class Executor;
+
+class SpatialJoinTable : public JoinHashTableInterface {
+ public:
+  // Throws HashJoinFail if none of the quals is a spatial predicate between a geo
+  // column of the inner table at inner_rte_idx and a point of the outer tables.
+  static std::shared_ptr<SpatialJoinTable> getInstance(
+      const std::list<std::shared_ptr<Analyzer::Expr>>& join_quals,
+      const int inner_rte_idx,
+      const std::vector<InputTableInfo>& query_infos,
+      const Data_Namespace::MemoryLevel memory_level,
+      const int device_count,
+      Executor* executor);
+
+  int64_t getJoinHashBuffer(const ExecutorDeviceType device_type,
+                            const int device_id) noexcept override;
+
+  llvm::Value* codegenSlotIsValid(const CompilationOptions&, const size_t) override;
+
+  llvm::Value* codegenSlot(const CompilationOptions&, const size_t) override;
+
+  HashJoinMatchingSet codegenMatchingSet(const CompilationOptions&,
+                                         const size_t) override;
+
+  int getInnerTableId() const noexcept override;
+
+  int getInnerTableRteIdx() const noexcept override;
+
+  JoinHashTableInterface::HashType getHashType() const noexcept override {
+    return JoinHashTableInterface::HashType::OneToMany;
+  }
+
+  const std::vector<OuterColumnRuntimeFilter>& getRuntimeFilters() const
+      noexcept override {
+    return runtime_filters_;
+  }
+
+  size_t getCellCount() const { return dim_x_ * dim_y_; }
+
+  virtual ~SpatialJoinTable() {}
+
+ private:
+  // The inner geo column, through its bounds column for polygons, and the outer point
+  // with the srid and compression arguments of the predicate.
+  struct SpatialQual {
+    std::shared_ptr<Analyzer::ColumnVar> inner_col;
+    std::shared_ptr<Analyzer::ColumnVar> inner_bounds_col;
+    std::vector<std::shared_ptr<Analyzer::Expr>> outer_point_args;
+    int32_t inner_compression;
+    double distance;
+  };
+
+  static bool getSpatialQual(const std::shared_ptr<Analyzer::Expr>& qual,
+                             const int inner_rte_idx,
+                             SpatialQual& spatial_qual);
+
+  SpatialJoinTable(const SpatialQual& spatial_qual,
+                   const std::vector<InputTableInfo>& query_infos,
+                   const Data_Namespace::MemoryLevel memory_level,
+                   Executor* executor);
+
+  void reify(const int device_count);
+
+  // Bounding boxes of the inner rows as min x, min y, max x, max y, in the order of the
+  // row ids. The rows without a box, null or empty geometries, have min x > max x.
+  std::vector<std::array<double, 4>> fetchBoundingBoxes();
+
+  void buildGrid(const std::vector<std::array<double, 4>>& boxes);
+
+  llvm::Value* codegenPointCoord(const bool is_x, const CompilationOptions& co);
+
+  const SpatialQual spatial_qual_;
+  const std::vector<InputTableInfo>& query_infos_;
+  const Data_Namespace::MemoryLevel memory_level_;
+  Executor* executor_;
+  double min_x_;
+  double max_x_;
+  double min_y_;
+  double max_y_;
+  double inv_cell_width_;
+  double inv_cell_height_;
+  size_t dim_x_;
+  size_t dim_y_;
+  std::vector<int32_t> cpu_buff_;
+#ifdef HAVE_CUDA
+  std::vector<CUdeviceptr> gpu_buff_;
+#endif
+  std::vector<OuterColumnRuntimeFilter> runtime_filters_;
+};
+
+#endif  // QUERYENGINE_SPATIALJOINTABLE_H
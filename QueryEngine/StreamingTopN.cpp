@@ -55,6 +55,13 @@ bool use_streaming_top_n(const RelAlgExecutionUnit& ra_exe_unit,
     }
   }
 
+  if (!query_mem_desc.canOutputColumnar() &&  // TODO(miyu): relax this limitation
+      ra_exe_unit.sort_info.order_entries.size() > 1 && ra_exe_unit.sort_info.limit &&
+      ra_exe_unit.sort_info.algorithm == SortAlgorithm::StreamingTopN) {
+    const auto n = ra_exe_unit.sort_info.offset + ra_exe_unit.sort_info.limit;
+    return !query_mem_desc.getStreamingTopNPackedKey().empty() && n <= 100000;
+  }
+
   if (!query_mem_desc.canOutputColumnar() &&  // TODO(miyu): relax this limitation
       ra_exe_unit.sort_info.order_entries.size() == 1 && ra_exe_unit.sort_info.limit &&
       ra_exe_unit.sort_info.algorithm == SortAlgorithm::StreamingTopN) {
@@ -83,11 +90,34 @@ std::vector<int8_t> pick_top_n_rows_from_dev_heaps(
     const size_t thread_count,
     const int device_id) {
   CHECK(!query_mem_desc.canOutputColumnar());
+  const auto n = ra_exe_unit.sort_info.offset + ra_exe_unit.sort_info.limit;
+  const auto group_key_bytes = query_mem_desc.getEffectiveKeyWidth();
+  if (!query_mem_desc.getStreamingTopNPackedKey().empty()) {
+    // the packed keys are in the key slot of the rows, never null and ascending
+    CHECK_EQ(group_key_bytes, sizeof(int64_t));
+    const PodOrderEntry pod_oe{1, false, false};
+    GroupByBufferLayoutInfo key_layout{
+        n * thread_count,
+        0,
+        sizeof(int64_t),
+        query_mem_desc.getRowSize(),
+        TargetInfo{false, kMIN, SQLTypeInfo(kBIGINT, true), SQLTypeInfo(), false, false},
+        -1};
+    return pop_n_rows_from_merged_heaps_gpu(
+        data_mgr,
+        dev_heaps_buffer,
+        query_mem_desc.getBufferSizeBytes(
+            ra_exe_unit, thread_count, ExecutorDeviceType::GPU),
+        n,
+        pod_oe,
+        key_layout,
+        group_key_bytes,
+        thread_count,
+        device_id);
+  }
   CHECK_EQ(ra_exe_unit.sort_info.order_entries.size(), size_t(1));
   const auto& only_oe = ra_exe_unit.sort_info.order_entries.back();
   const auto oe_col_idx = only_oe.tle_no - 1;
-  const auto n = ra_exe_unit.sort_info.offset + ra_exe_unit.sort_info.limit;
-  const auto group_key_bytes = query_mem_desc.getEffectiveKeyWidth();
   const PodOrderEntry pod_oe{only_oe.tle_no, only_oe.is_desc, only_oe.nulls_first};
   GroupByBufferLayoutInfo oe_layout{
       n * thread_count,
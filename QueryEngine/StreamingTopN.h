@@ -31,6 +31,23 @@
 
 namespace streaming_top_n {
 
+// An order entry in the 64-bit key the heaps order the rows on when the query sorts
+// on several columns. Its rank in the value range of the entry, with nulls at either
+// end, sits at `shift`; the first order entry has the most significant bits. Floats
+// are ranked by their bits with the order of the values, dictionary-encoded strings
+// by the lexical order of the dictionary.
+struct PackedKeyField {
+  size_t target_idx;
+  bool is_desc;
+  bool nulls_first;
+  bool has_nulls;
+  int64_t min;
+  int64_t max;
+  size_t shift;
+  // lexical rank of every string of the dictionary by id, null for other types
+  const int64_t* string_ranks;
+};
+
 size_t get_heap_size(const size_t row_size, const size_t n, const size_t thread_count);
 
 size_t get_rows_offset_of_heaps(const size_t n, const size_t thread_count);
@@ -261,3 +261,34 @@ DEF_GET_BIN_FROM_K_HEAP(int32_t)
 DEF_GET_BIN_FROM_K_HEAP(int64_t)
 DEF_GET_BIN_FROM_K_HEAP(float)
 DEF_GET_BIN_FROM_K_HEAP(double)
+
+// Keeps the rows with the k smallest keys, the key packs all the order entries and
+// takes the key slot of the row instead of the bin index. This function only works on
+// rowwise layout.
+extern "C" NEVER_INLINE DEVICE int64_t* get_bin_from_k_heap_packed_key(
+    int64_t* heaps,
+    const uint32_t k,
+    const uint32_t row_size_quad,
+    const int64_t curr_key) {
+  const int32_t thread_global_index = pos_start_impl(nullptr);
+  const int32_t thread_count = pos_step_impl();
+  int64_t& node_count = heaps[thread_global_index];
+  int64_t* heap_ptr = heaps + thread_count + thread_global_index * k;
+  int64_t* rows_ptr =
+      heaps + thread_count + thread_count * k + thread_global_index * row_size_quad * k;
+  KeyComparator<int64_t> compare(HeapOrdering::MAX, false, 0, NullsOrdering::LAST);
+  KeyAccessor<int64_t, int64_t> accessor(
+      reinterpret_cast<int8_t*>(rows_ptr), row_size_quad * sizeof(int64_t), 0);
+  if (node_count < static_cast<int64_t>(k)) {
+    push_heap(
+        heap_ptr, rows_ptr, node_count, row_size_quad, 0, compare, accessor, curr_key);
+    return rows_ptr + (node_count - 1) * row_size_quad + 1;
+  }
+  const int64_t top_bin_idx = heap_ptr[0];
+  const bool rejected = !pop_and_push_heap(
+      heap_ptr, rows_ptr, node_count, row_size_quad, 0, compare, accessor, curr_key);
+  if (rejected) {
+    return nullptr;
+  }
+  return rows_ptr + top_bin_idx * row_size_quad + 1;
+}
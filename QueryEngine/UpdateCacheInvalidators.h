@@ -7,8 +7,11 @@
 #include "BaselineJoinHashTable.h"
 #include "JoinHashTable.h"
 
+// holds the subquery results reused across statements, see RelAlgExecutor.h
+class RelAlgExecutor;
+
 using UpdateTriggeredCacheInvalidator =
-    CacheInvalidator<BaselineJoinHashTable, JoinHashTable>;
+    CacheInvalidator<BaselineJoinHashTable, JoinHashTable, RelAlgExecutor>;
 using DeleteTriggeredCacheInvalidator = UpdateTriggeredCacheInvalidator;
 
 #endif
@@ -0,0 +1,779 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "WindowFunctionEvaluator.h"
+#include "TypePunning.h"
+
+#include "../Shared/thread_count.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace {
+
+// Smaller inputs get partitioned, sorted and evaluated on the calling thread.
+const size_t min_parallel_row_count{20000};
+
+double as_double(const int64_t image) {
+  return *reinterpret_cast<const double*>(may_alias_ptr(&image));
+}
+
+int64_t double_image(const double val) {
+  return *reinterpret_cast<const int64_t*>(may_alias_ptr(&val));
+}
+
+template <class T>
+T decode(const int64_t image);
+
+template <>
+int64_t decode<int64_t>(const int64_t image) {
+  return image;
+}
+
+template <>
+double decode<double>(const int64_t image) {
+  return as_double(image);
+}
+
+int64_t encode(const int64_t val, const bool is_fp) {
+  return is_fp ? double_image(val) : val;
+}
+
+int64_t encode(const double val, const bool is_fp) {
+  return is_fp ? double_image(val) : static_cast<int64_t>(val);
+}
+
+// Converts a value of an input column to the result type of a window function.
+int64_t convert_image(const int64_t image,
+                      const WindowInputColumn& column,
+                      const WindowFunctionSpec& window_function) {
+  if (image == column.null_val) {
+    return window_function.null_val;
+  }
+  if (column.is_fp == window_function.is_fp) {
+    return image;
+  }
+  return column.is_fp ? encode(as_double(image), window_function.is_fp)
+                      : encode(image, window_function.is_fp);
+}
+
+// Runs work(i) for every i in [0, task_count) on up to worker_count threads.
+template <class WORK>
+void run_tasks(const size_t task_count, const size_t worker_count, WORK work) {
+  if (worker_count <= 1 || task_count <= 1) {
+    for (size_t i = 0; i < task_count; ++i) {
+      work(i);
+    }
+    return;
+  }
+  std::atomic<size_t> next_task{0};
+  std::vector<std::future<void>> workers;
+  for (size_t i = 0; i < std::min(worker_count, task_count); ++i) {
+    workers.push_back(std::async(std::launch::async, [&next_task, task_count, &work] {
+      for (size_t task = next_task++; task < task_count; task = next_task++) {
+        work(task);
+      }
+    }));
+  }
+  for (auto& worker : workers) {
+    worker.wait();
+  }
+  for (auto& worker : workers) {
+    worker.get();
+  }
+}
+
+// Orders row indices on the partition keys, the order keys and the index itself,
+// which makes the order total and the evaluation deterministic. The partition keys
+// only have to group equal values together and get compared as images.
+class WindowRowComparator {
+ public:
+  WindowRowComparator(const std::vector<WindowInputColumn>& columns,
+                      const WindowFunctionSpec& window_function)
+      : columns_(columns)
+      , partition_keys_(window_function.partition_keys)
+      , order_keys_(window_function.order_keys) {}
+
+  bool operator()(const size_t lhs, const size_t rhs) const {
+    for (const auto partition_key : partition_keys_) {
+      const auto& values = columns_[partition_key].values;
+      if (values[lhs] != values[rhs]) {
+        return values[lhs] < values[rhs];
+      }
+    }
+    for (const auto& order_key : order_keys_) {
+      const int cmp = compareOrderKey(order_key, lhs, rhs);
+      if (cmp) {
+        return cmp < 0;
+      }
+    }
+    return lhs < rhs;
+  }
+
+  bool samePartition(const size_t lhs, const size_t rhs) const {
+    for (const auto partition_key : partition_keys_) {
+      const auto& values = columns_[partition_key].values;
+      if (values[lhs] != values[rhs]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool arePeers(const size_t lhs, const size_t rhs) const {
+    for (const auto& order_key : order_keys_) {
+      if (compareOrderKey(order_key, lhs, rhs)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool hasPartitionKeys() const { return !partition_keys_.empty(); }
+
+ private:
+  int compareOrderKey(const WindowOrderKey& order_key,
+                      const size_t lhs,
+                      const size_t rhs) const {
+    const auto& column = columns_[order_key.column];
+    const auto lhs_val = column.values[lhs];
+    const auto rhs_val = column.values[rhs];
+    const bool lhs_null = lhs_val == column.null_val;
+    const bool rhs_null = rhs_val == column.null_val;
+    if (lhs_null || rhs_null) {
+      if (lhs_null && rhs_null) {
+        return 0;
+      }
+      return lhs_null == order_key.nulls_first ? -1 : 1;
+    }
+    int cmp{0};
+    if (column.is_fp) {
+      const auto lhs_dval = as_double(lhs_val);
+      const auto rhs_dval = as_double(rhs_val);
+      cmp = lhs_dval < rhs_dval ? -1 : (lhs_dval > rhs_dval ? 1 : 0);
+    } else {
+      cmp = lhs_val < rhs_val ? -1 : (lhs_val > rhs_val ? 1 : 0);
+    }
+    return order_key.descending ? -cmp : cmp;
+  }
+
+  const std::vector<WindowInputColumn>& columns_;
+  const std::vector<size_t> partition_keys_;
+  const std::vector<WindowOrderKey> order_keys_;
+};
+
+// Sorts the chunks of the rows in parallel, then merges pairs of sorted runs in
+// parallel until a single run is left.
+void parallel_sort(std::vector<size_t>& rows,
+                   const WindowRowComparator& comparator,
+                   const size_t worker_count) {
+  const size_t chunk_count = std::min(worker_count, rows.size());
+  if (chunk_count <= 1) {
+    std::sort(rows.begin(), rows.end(), comparator);
+    return;
+  }
+  const size_t stride = (rows.size() + chunk_count - 1) / chunk_count;
+  std::vector<size_t> run_offsets;
+  for (size_t offset = 0; offset < rows.size(); offset += stride) {
+    run_offsets.push_back(offset);
+  }
+  run_offsets.push_back(rows.size());
+  const size_t run_count = run_offsets.size() - 1;
+  run_tasks(run_count, worker_count, [&rows, &run_offsets, &comparator](const size_t i) {
+    std::sort(
+        rows.begin() + run_offsets[i], rows.begin() + run_offsets[i + 1], comparator);
+  });
+  for (size_t width = 1; width < run_count; width *= 2) {
+    const size_t merge_count = (run_count + 2 * width - 1) / (2 * width);
+    run_tasks(merge_count,
+              worker_count,
+              [&rows, &run_offsets, &comparator, width, run_count](const size_t i) {
+                const size_t first = i * 2 * width;
+                const size_t middle = std::min(first + width, run_count);
+                const size_t last = std::min(first + 2 * width, run_count);
+                if (middle == last) {
+                  return;
+                }
+                std::inplace_merge(rows.begin() + run_offsets[first],
+                                   rows.begin() + run_offsets[middle],
+                                   rows.begin() + run_offsets[last],
+                                   comparator);
+              });
+  }
+}
+
+uint64_t partition_hash(const std::vector<WindowInputColumn>& columns,
+                        const std::vector<size_t>& partition_keys,
+                        const size_t row) {
+  uint64_t hash{0};
+  for (const auto partition_key : partition_keys) {
+    hash = (hash ^ static_cast<uint64_t>(columns[partition_key].values[row])) *
+           0x9E3779B97F4A7C15ULL;
+    hash ^= hash >> 32;
+  }
+  return hash;
+}
+
+// The sorted row indices, grouped in buckets which hold whole partitions.
+struct SortedRows {
+  std::vector<size_t> rows;
+  std::vector<size_t> bucket_offsets;
+};
+
+// Hash partitions the rows into buckets, with a count and a scatter pass over
+// chunks of the input, then sorts every bucket on its own.
+SortedRows sort_rows(const size_t row_count,
+                     const std::vector<WindowInputColumn>& columns,
+                     const WindowFunctionSpec& window_function,
+                     const WindowRowComparator& comparator,
+                     const size_t worker_count) {
+  SortedRows sorted_rows;
+  auto& rows = sorted_rows.rows;
+  auto& bucket_offsets = sorted_rows.bucket_offsets;
+  const auto& partition_keys = window_function.partition_keys;
+  if (partition_keys.empty() || worker_count <= 1) {
+    rows.resize(row_count);
+    std::iota(rows.begin(), rows.end(), size_t(0));
+    parallel_sort(rows, comparator, worker_count);
+    bucket_offsets = {0, row_count};
+    return sorted_rows;
+  }
+  const size_t bucket_count = 4 * worker_count;
+  const size_t chunk_count = worker_count;
+  const size_t stride = (row_count + chunk_count - 1) / chunk_count;
+  std::vector<uint32_t> row_buckets(row_count);
+  std::vector<std::vector<size_t>> chunk_bucket_offsets(
+      chunk_count, std::vector<size_t>(bucket_count, 0));
+  run_tasks(chunk_count, worker_count, [&](const size_t chunk_idx) {
+    auto& bucket_sizes = chunk_bucket_offsets[chunk_idx];
+    const size_t end = std::min(row_count, (chunk_idx + 1) * stride);
+    for (size_t row = chunk_idx * stride; row < end; ++row) {
+      const auto bucket = partition_hash(columns, partition_keys, row) % bucket_count;
+      row_buckets[row] = bucket;
+      ++bucket_sizes[bucket];
+    }
+  });
+  // Buckets are laid out one after the other, the chunks in input order within
+  // each bucket.
+  bucket_offsets.resize(bucket_count + 1);
+  size_t offset{0};
+  for (size_t bucket = 0; bucket < bucket_count; ++bucket) {
+    bucket_offsets[bucket] = offset;
+    for (size_t chunk_idx = 0; chunk_idx < chunk_count; ++chunk_idx) {
+      const auto bucket_size = chunk_bucket_offsets[chunk_idx][bucket];
+      chunk_bucket_offsets[chunk_idx][bucket] = offset;
+      offset += bucket_size;
+    }
+  }
+  CHECK_EQ(row_count, offset);
+  bucket_offsets[bucket_count] = offset;
+  rows.resize(row_count);
+  run_tasks(chunk_count, worker_count, [&](const size_t chunk_idx) {
+    auto& next_positions = chunk_bucket_offsets[chunk_idx];
+    const size_t end = std::min(row_count, (chunk_idx + 1) * stride);
+    for (size_t row = chunk_idx * stride; row < end; ++row) {
+      rows[next_positions[row_buckets[row]]++] = row;
+    }
+  });
+  run_tasks(bucket_count, worker_count, [&](const size_t bucket) {
+    std::sort(rows.begin() + bucket_offsets[bucket],
+              rows.begin() + bucket_offsets[bucket + 1],
+              comparator);
+  });
+  return sorted_rows;
+}
+
+// Peer groups of a partition: rows which are equal on the order keys. Indices are
+// relative to the start of the partition.
+struct PartitionPeers {
+  std::vector<int64_t> peer_start;
+  std::vector<int64_t> peer_end;  // exclusive
+  std::vector<int64_t> dense_rank;
+};
+
+PartitionPeers find_peers(const size_t* rows,
+                          const size_t row_count,
+                          const WindowRowComparator& comparator) {
+  PartitionPeers peers;
+  peers.peer_start.resize(row_count);
+  peers.peer_end.resize(row_count);
+  peers.dense_rank.resize(row_count);
+  int64_t group_start{0};
+  int64_t group_idx{0};
+  for (size_t i = 0; i < row_count; ++i) {
+    if (i && !comparator.arePeers(rows[i - 1], rows[i])) {
+      group_start = i;
+      ++group_idx;
+    }
+    peers.peer_start[i] = group_start;
+    peers.dense_rank[i] = group_idx + 1;
+  }
+  int64_t group_end = row_count;
+  for (size_t i = row_count; i > 0; --i) {
+    peers.peer_end[i - 1] = group_end;
+    if (peers.peer_start[i - 1] == static_cast<int64_t>(i - 1)) {
+      group_end = i - 1;
+    }
+  }
+  return peers;
+}
+
+int64_t frame_bound(const WindowFrameBound& bound,
+                    const bool is_lower,
+                    const bool is_rows,
+                    const int64_t i,
+                    const int64_t row_count,
+                    const PartitionPeers& peers) {
+  const auto offset = std::min(bound.offset, row_count);
+  switch (bound.type) {
+    case WindowFrameBoundType::UNBOUNDED_PRECEDING:
+      return is_lower ? 0 : -1;
+    case WindowFrameBoundType::EXPR_PRECEDING:
+      return i - offset;
+    case WindowFrameBoundType::CURRENT_ROW:
+      if (is_rows) {
+        return i;
+      }
+      return is_lower ? peers.peer_start[i] : peers.peer_end[i] - 1;
+    case WindowFrameBoundType::EXPR_FOLLOWING:
+      return i + offset;
+    case WindowFrameBoundType::UNBOUNDED_FOLLOWING:
+      return is_lower ? row_count : row_count - 1;
+  }
+  CHECK(false);
+  return 0;
+}
+
+// Inclusive bounds of the frame of every row of the partition, empty frames have
+// the first row after the last.
+std::vector<std::pair<int64_t, int64_t>> get_frames(
+    const WindowFunctionSpec& window_function,
+    const int64_t row_count,
+    const PartitionPeers& peers) {
+  std::vector<std::pair<int64_t, int64_t>> frames(row_count);
+  for (int64_t i = 0; i < row_count; ++i) {
+    const auto first = frame_bound(
+        window_function.lower_bound, true, window_function.is_rows, i, row_count, peers);
+    const auto last = frame_bound(
+        window_function.upper_bound, false, window_function.is_rows, i, row_count, peers);
+    frames[i] = {std::max(first, int64_t(0)), std::min(last, row_count - 1)};
+  }
+  return frames;
+}
+
+template <class T, class COMBINE>
+class SegmentTree {
+ public:
+  SegmentTree(const std::vector<T>& leaves, const T identity, COMBINE combine)
+      : leaf_count_(leaves.size())
+      , identity_(identity)
+      , combine_(combine)
+      , nodes_(2 * leaves.size(), identity) {
+    std::copy(leaves.begin(), leaves.end(), nodes_.begin() + leaf_count_);
+    for (size_t i = leaf_count_ - 1; i > 0; --i) {
+      nodes_[i] = combine_(nodes_[2 * i], nodes_[2 * i + 1]);
+    }
+  }
+
+  // Combines the leaves in [first, last].
+  T query(size_t first, size_t last) const {
+    T result = identity_;
+    for (first += leaf_count_, last += leaf_count_ + 1; first < last;
+         first >>= 1, last >>= 1) {
+      if (first & 1) {
+        result = combine_(result, nodes_[first++]);
+      }
+      if (last & 1) {
+        result = combine_(result, nodes_[--last]);
+      }
+    }
+    return result;
+  }
+
+ private:
+  const size_t leaf_count_;
+  const T identity_;
+  const COMBINE combine_;
+  std::vector<T> nodes_;
+};
+
+// Combines the values of every frame. Frames which start with the partition only
+// ever grow, a running accumulator extends them; other frames query a segment tree.
+template <class T, class COMBINE>
+std::vector<T> combine_frames(const std::vector<T>& values,
+                              const std::vector<std::pair<int64_t, int64_t>>& frames,
+                              const bool frames_start_with_partition,
+                              const T identity,
+                              COMBINE combine) {
+  std::vector<T> results(frames.size(), identity);
+  if (frames_start_with_partition) {
+    T accumulator = identity;
+    int64_t accumulated_last{-1};
+    for (size_t i = 0; i < frames.size(); ++i) {
+      const auto& frame = frames[i];
+      while (accumulated_last < frame.second) {
+        accumulator = combine(accumulator, values[++accumulated_last]);
+      }
+      if (frame.first <= frame.second) {
+        results[i] = accumulator;
+      }
+    }
+    return results;
+  }
+  const SegmentTree<T, COMBINE> segment_tree(values, identity, combine);
+  for (size_t i = 0; i < frames.size(); ++i) {
+    const auto& frame = frames[i];
+    if (frame.first <= frame.second) {
+      results[i] = segment_tree.query(frame.first, frame.second);
+    }
+  }
+  return results;
+}
+
+// SUM, AVG, MIN and MAX over the frames, nulls are skipped.
+template <class T>
+void evaluate_frame_aggregate(const size_t* rows,
+                              const std::vector<std::pair<int64_t, int64_t>>& frames,
+                              const std::vector<int64_t>& non_null_counts,
+                              const WindowInputColumn& arg,
+                              const WindowFunctionSpec& window_function,
+                              std::vector<int64_t>& output) {
+  const auto kind = window_function.kind;
+  const bool is_sum = kind == SqlWindowFunctionKind::SUM ||
+                      kind == SqlWindowFunctionKind::SUM_INTERNAL ||
+                      kind == SqlWindowFunctionKind::AVG;
+  const T identity = is_sum ? T(0)
+                            : (kind == SqlWindowFunctionKind::MIN
+                                   ? std::numeric_limits<T>::max()
+                                   : std::numeric_limits<T>::lowest());
+  std::vector<T> values(frames.size());
+  for (size_t i = 0; i < frames.size(); ++i) {
+    const auto image = arg.values[rows[i]];
+    values[i] = image == arg.null_val ? identity : decode<T>(image);
+  }
+  const bool frames_start_with_partition =
+      window_function.lower_bound.type == WindowFrameBoundType::UNBOUNDED_PRECEDING;
+  std::vector<T> aggregates;
+  if (is_sum && std::is_integral<T>::value) {
+    // Integer sums are invertible, prefix sums answer every frame. Wrap around
+    // instead of overflowing.
+    std::vector<uint64_t> prefix_sums(values.size() + 1, 0);
+    for (size_t i = 0; i < values.size(); ++i) {
+      prefix_sums[i + 1] = prefix_sums[i] + static_cast<uint64_t>(values[i]);
+    }
+    aggregates.resize(frames.size(), identity);
+    for (size_t i = 0; i < frames.size(); ++i) {
+      const auto& frame = frames[i];
+      if (frame.first <= frame.second) {
+        aggregates[i] =
+            static_cast<T>(prefix_sums[frame.second + 1] - prefix_sums[frame.first]);
+      }
+    }
+  } else if (is_sum) {
+    aggregates = combine_frames(values,
+                                frames,
+                                frames_start_with_partition,
+                                identity,
+                                [](const T lhs, const T rhs) { return lhs + rhs; });
+  } else if (kind == SqlWindowFunctionKind::MIN) {
+    aggregates = combine_frames(values,
+                                frames,
+                                frames_start_with_partition,
+                                identity,
+                                [](const T lhs, const T rhs) {
+                                  return std::min(lhs, rhs);
+                                });
+  } else {
+    CHECK(kind == SqlWindowFunctionKind::MAX);
+    aggregates = combine_frames(values,
+                                frames,
+                                frames_start_with_partition,
+                                identity,
+                                [](const T lhs, const T rhs) {
+                                  return std::max(lhs, rhs);
+                                });
+  }
+  for (size_t i = 0; i < frames.size(); ++i) {
+    const auto& frame = frames[i];
+    const auto count =
+        frame.first <= frame.second
+            ? non_null_counts[frame.second + 1] - non_null_counts[frame.first]
+            : 0;
+    int64_t result = window_function.null_val;
+    if (count) {
+      if (kind == SqlWindowFunctionKind::AVG) {
+        result = window_function.is_fp
+                     ? encode(static_cast<double>(aggregates[i]) / count, true)
+                     : encode(aggregates[i] / static_cast<T>(count), false);
+      } else {
+        result = encode(aggregates[i], window_function.is_fp);
+      }
+    } else if (kind == SqlWindowFunctionKind::SUM_INTERNAL) {
+      result = encode(int64_t(0), window_function.is_fp);
+    }
+    output[rows[i]] = result;
+  }
+}
+
+void evaluate_window_function(const size_t* rows,
+                              const size_t row_count,
+                              const PartitionPeers& peers,
+                              const std::vector<WindowInputColumn>& columns,
+                              const WindowFunctionSpec& window_function,
+                              std::vector<int64_t>& output) {
+  const auto& args = window_function.args;
+  const bool is_fp = window_function.is_fp;
+  const int64_t partition_size = row_count;
+  switch (window_function.kind) {
+    case SqlWindowFunctionKind::ROW_NUMBER: {
+      for (int64_t i = 0; i < partition_size; ++i) {
+        output[rows[i]] = encode(i + 1, is_fp);
+      }
+      break;
+    }
+    case SqlWindowFunctionKind::RANK: {
+      for (int64_t i = 0; i < partition_size; ++i) {
+        output[rows[i]] = encode(peers.peer_start[i] + 1, is_fp);
+      }
+      break;
+    }
+    case SqlWindowFunctionKind::DENSE_RANK: {
+      for (int64_t i = 0; i < partition_size; ++i) {
+        output[rows[i]] = encode(peers.dense_rank[i], is_fp);
+      }
+      break;
+    }
+    case SqlWindowFunctionKind::PERCENT_RANK: {
+      for (int64_t i = 0; i < partition_size; ++i) {
+        const double percent_rank =
+            partition_size > 1
+                ? static_cast<double>(peers.peer_start[i]) / (partition_size - 1)
+                : 0;
+        output[rows[i]] = encode(percent_rank, is_fp);
+      }
+      break;
+    }
+    case SqlWindowFunctionKind::CUME_DIST: {
+      for (int64_t i = 0; i < partition_size; ++i) {
+        const double cume_dist = static_cast<double>(peers.peer_end[i]) / partition_size;
+        output[rows[i]] = encode(cume_dist, is_fp);
+      }
+      break;
+    }
+    case SqlWindowFunctionKind::NTILE: {
+      CHECK_EQ(size_t(1), args.size());
+      const auto& arg = columns[args.front()];
+      const auto image = arg.values[rows[0]];
+      const int64_t tile_count =
+          arg.is_fp ? static_cast<int64_t>(as_double(image)) : image;
+      if (image == arg.null_val || tile_count <= 0) {
+        throw std::runtime_error("NTILE argument must be a positive integer");
+      }
+      // The first partition_size % tile_count tiles get one more row.
+      const int64_t tile_size = partition_size / tile_count;
+      const int64_t large_tile_rows = (partition_size % tile_count) * (tile_size + 1);
+      for (int64_t i = 0; i < partition_size; ++i) {
+        const int64_t tile = i < large_tile_rows
+                                 ? i / (tile_size + 1)
+                                 : (i - large_tile_rows) / tile_size +
+                                       partition_size % tile_count;
+        output[rows[i]] = encode(tile + 1, is_fp);
+      }
+      break;
+    }
+    case SqlWindowFunctionKind::LAG:
+    case SqlWindowFunctionKind::LEAD: {
+      CHECK(!args.empty() && args.size() <= 3);
+      const auto& arg = columns[args[0]];
+      const int64_t direction =
+          window_function.kind == SqlWindowFunctionKind::LAG ? -1 : 1;
+      for (int64_t i = 0; i < partition_size; ++i) {
+        int64_t offset{1};
+        if (args.size() > 1) {
+          const auto& offset_arg = columns[args[1]];
+          const auto image = offset_arg.values[rows[i]];
+          if (image == offset_arg.null_val) {
+            output[rows[i]] = window_function.null_val;
+            continue;
+          }
+          offset = offset_arg.is_fp ? static_cast<int64_t>(as_double(image)) : image;
+        }
+        offset = std::max(std::min(offset, partition_size), -partition_size);
+        const auto target = i + direction * offset;
+        if (target >= 0 && target < partition_size) {
+          output[rows[i]] = convert_image(arg.values[rows[target]], arg, window_function);
+        } else if (args.size() > 2) {
+          const auto& default_arg = columns[args[2]];
+          output[rows[i]] =
+              convert_image(default_arg.values[rows[i]], default_arg, window_function);
+        } else {
+          output[rows[i]] = window_function.null_val;
+        }
+      }
+      break;
+    }
+    case SqlWindowFunctionKind::FIRST_VALUE:
+    case SqlWindowFunctionKind::LAST_VALUE: {
+      CHECK_EQ(size_t(1), args.size());
+      const auto& arg = columns[args.front()];
+      const auto frames = get_frames(window_function, partition_size, peers);
+      for (int64_t i = 0; i < partition_size; ++i) {
+        const auto& frame = frames[i];
+        if (frame.first > frame.second) {
+          output[rows[i]] = window_function.null_val;
+          continue;
+        }
+        const auto pos =
+            window_function.kind == SqlWindowFunctionKind::FIRST_VALUE ? frame.first
+                                                                        : frame.second;
+        output[rows[i]] = convert_image(arg.values[rows[pos]], arg, window_function);
+      }
+      break;
+    }
+    case SqlWindowFunctionKind::COUNT:
+    case SqlWindowFunctionKind::AVG:
+    case SqlWindowFunctionKind::MIN:
+    case SqlWindowFunctionKind::MAX:
+    case SqlWindowFunctionKind::SUM:
+    case SqlWindowFunctionKind::SUM_INTERNAL: {
+      const auto frames = get_frames(window_function, partition_size, peers);
+      // COUNT(*) counts every row of the frame.
+      const WindowInputColumn* arg = args.empty() ? nullptr : &columns[args.front()];
+      std::vector<int64_t> non_null_counts(partition_size + 1, 0);
+      for (int64_t i = 0; i < partition_size; ++i) {
+        const bool is_null = arg && arg->values[rows[i]] == arg->null_val;
+        non_null_counts[i + 1] = non_null_counts[i] + (is_null ? 0 : 1);
+      }
+      if (window_function.kind == SqlWindowFunctionKind::COUNT) {
+        for (int64_t i = 0; i < partition_size; ++i) {
+          const auto& frame = frames[i];
+          const auto count = frame.first <= frame.second
+                                 ? non_null_counts[frame.second + 1] -
+                                       non_null_counts[frame.first]
+                                 : 0;
+          output[rows[i]] = encode(count, is_fp);
+        }
+        break;
+      }
+      CHECK(arg);
+      if (arg->is_fp) {
+        evaluate_frame_aggregate<double>(
+            rows, frames, non_null_counts, *arg, window_function, output);
+      } else {
+        evaluate_frame_aggregate<int64_t>(
+            rows, frames, non_null_counts, *arg, window_function, output);
+      }
+      break;
+    }
+    default:
+      CHECK(false);
+  }
+}
+
+bool same_window(const WindowFunctionSpec& lhs, const WindowFunctionSpec& rhs) {
+  if (lhs.partition_keys != rhs.partition_keys ||
+      lhs.order_keys.size() != rhs.order_keys.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < lhs.order_keys.size(); ++i) {
+    const auto& lhs_key = lhs.order_keys[i];
+    const auto& rhs_key = rhs.order_keys[i];
+    if (lhs_key.column != rhs_key.column || lhs_key.descending != rhs_key.descending ||
+        lhs_key.nulls_first != rhs_key.nulls_first) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+std::vector<std::vector<int64_t>> evaluate_window_functions(
+    const size_t row_count,
+    const std::vector<WindowInputColumn>& columns,
+    const std::vector<WindowFunctionSpec>& window_functions) {
+  for (const auto& column : columns) {
+    CHECK_EQ(row_count, column.values.size());
+  }
+  std::vector<std::vector<int64_t>> results(window_functions.size(),
+                                            std::vector<int64_t>(row_count));
+  if (!row_count) {
+    return results;
+  }
+  const size_t worker_count = row_count >= min_parallel_row_count ? cpu_threads() : 1;
+  std::vector<bool> evaluated(window_functions.size(), false);
+  for (size_t i = 0; i < window_functions.size(); ++i) {
+    if (evaluated[i]) {
+      continue;
+    }
+    // Window functions over the same window share the sorted rows.
+    std::vector<size_t> same_window_functions;
+    for (size_t j = i; j < window_functions.size(); ++j) {
+      if (!evaluated[j] && same_window(window_functions[i], window_functions[j])) {
+        same_window_functions.push_back(j);
+        evaluated[j] = true;
+      }
+    }
+    const WindowRowComparator comparator(columns, window_functions[i]);
+    const auto sorted_rows =
+        sort_rows(row_count, columns, window_functions[i], comparator, worker_count);
+    const auto& rows = sorted_rows.rows;
+    const auto& bucket_offsets = sorted_rows.bucket_offsets;
+    const size_t bucket_count = bucket_offsets.size() - 1;
+    if (bucket_count == 1 && !comparator.hasPartitionKeys()) {
+      // A single partition, evaluate the window functions in parallel instead.
+      const auto peers = find_peers(&rows[0], row_count, comparator);
+      run_tasks(same_window_functions.size(), worker_count, [&](const size_t k) {
+        const auto window_function_idx = same_window_functions[k];
+        evaluate_window_function(&rows[0],
+                                 row_count,
+                                 peers,
+                                 columns,
+                                 window_functions[window_function_idx],
+                                 results[window_function_idx]);
+      });
+      continue;
+    }
+    run_tasks(bucket_count, worker_count, [&](const size_t bucket) {
+      const auto bucket_end = bucket_offsets[bucket + 1];
+      for (size_t start = bucket_offsets[bucket]; start < bucket_end;) {
+        size_t end = start + 1;
+        while (end < bucket_end && comparator.samePartition(rows[start], rows[end])) {
+          ++end;
+        }
+        const auto peers = find_peers(&rows[start], end - start, comparator);
+        for (const auto window_function_idx : same_window_functions) {
+          evaluate_window_function(&rows[start],
+                                   end - start,
+                                   peers,
+                                   columns,
+                                   window_functions[window_function_idx],
+                                   results[window_function_idx]);
+        }
+        start = end;
+      }
+    });
+  }
+  return results;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    WindowFunctionEvaluator.h
+ * @brief   Evaluation of window functions over materialized input columns.
+ *
+ * The rows are hash partitioned on the partition keys into buckets, which get
+ * sorted in parallel on the partition keys, the order keys and the row index. Each
+ * bucket is then a sequence of whole partitions, which get evaluated in parallel.
+ * Frame aggregates use prefix sums, running accumulators for frames which start at
+ * the beginning of the partition and a segment tree for the other sliding frames.
+ * Window functions with the same partition and order keys share the sorting.
+ */
+
+#ifndef QUERYENGINE_WINDOWFUNCTIONEVALUATOR_H
+#define QUERYENGINE_WINDOWFUNCTIONEVALUATOR_H
+
+#include "../Shared/sqldefs.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A column of window function inputs. The values are stored as 64-bit images:
+// integers and dictionary ids sign extended, floating point values as the bits of
+// a double.
+struct WindowInputColumn {
+  std::vector<int64_t> values;
+  int64_t null_val;
+  bool is_fp;
+};
+
+struct WindowOrderKey {
+  size_t column;
+  bool descending;
+  bool nulls_first;
+};
+
+enum class WindowFrameBoundType {
+  UNBOUNDED_PRECEDING,
+  EXPR_PRECEDING,
+  CURRENT_ROW,
+  EXPR_FOLLOWING,
+  UNBOUNDED_FOLLOWING
+};
+
+struct WindowFrameBound {
+  WindowFrameBoundType type;
+  int64_t offset;
+};
+
+// The arguments, partition keys and order keys index the input columns. The
+// arguments of LAG and LEAD are the value, the offset and the default, NTILE takes
+// the number of buckets. Ranking and navigation functions ignore the frame.
+struct WindowFunctionSpec {
+  SqlWindowFunctionKind kind;
+  std::vector<size_t> args;
+  std::vector<size_t> partition_keys;
+  std::vector<WindowOrderKey> order_keys;
+  bool is_rows;
+  WindowFrameBound lower_bound;
+  WindowFrameBound upper_bound;
+  // type of the result, as an image like the input columns
+  bool is_fp;
+  int64_t null_val;
+};
+
+// Evaluates the window functions over the columns, which all have row_count values.
+// Returns a column of result images for every window function, in input row order.
+std::vector<std::vector<int64_t>> evaluate_window_functions(
+    const size_t row_count,
+    const std::vector<WindowInputColumn>& columns,
+    const std::vector<WindowFunctionSpec>& window_functions);
+
+#endif  // QUERYENGINE_WINDOWFUNCTIONEVALUATOR_H
@@ -67,7 +67,16 @@ enum SQLOps {
 
 enum SQLQualifier { kONE, kANY, kALL };
 
-enum SQLAgg { kAVG, kMIN, kMAX, kSUM, kCOUNT, kAPPROX_COUNT_DISTINCT, kSAMPLE };
+enum SQLAgg {
+  kAVG,
+  kMIN,
+  kMAX,
+  kSUM,
+  kCOUNT,
+  kAPPROX_COUNT_DISTINCT,
+  kSAMPLE,
+  kAPPROX_PERCENTILE
+};
 
 enum SQLStmtType { kSELECT, kUPDATE, kINSERT, kDELETE, kCREATE_TABLE };
 
@@ -77,4 +86,23 @@ enum ViewRefreshOption { kMANUAL = 0, kAUTO = 1, kIMMEDIATE = 2 };
 
 enum class JoinType { INNER, LEFT, INVALID };
 
+enum class SqlWindowFunctionKind {
+  ROW_NUMBER,
+  RANK,
+  DENSE_RANK,
+  PERCENT_RANK,
+  CUME_DIST,
+  NTILE,
+  LAG,
+  LEAD,
+  FIRST_VALUE,
+  LAST_VALUE,
+  AVG,
+  MIN,
+  MAX,
+  SUM,
+  COUNT,
+  SUM_INTERNAL  // Calcite's $SUM0: zero instead of null for an empty frame
+};
+
 #endif  // SQLDEFS_H
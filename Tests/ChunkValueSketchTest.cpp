@@ -0,0 +1,105 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../DataMgr/ChunkValueSketch.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <set>
+#include <vector>
+
+TEST(ChunkValueSketch, BloomFilter) {
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<int32_t> val_dist(0, 1 << 30);
+  const int32_t null_val = std::numeric_limits<int32_t>::min();
+  std::vector<int32_t> vals{null_val};
+  std::set<int64_t> val_set;
+  for (size_t i = 0; i < 1000; ++i) {
+    vals.push_back(val_dist(gen) * 2);
+    val_set.insert(vals.back());
+  }
+  ChunkValueSketch sketch;
+  sketch.add(vals.data(), vals.size(), null_val);
+  ASSERT_TRUE(sketch.hasBloomFilter());
+  for (const auto val : val_set) {
+    ASSERT_TRUE(sketch.mayContain(val));
+  }
+  ASSERT_FALSE(sketch.mayContain(null_val));
+  size_t false_positives{0};
+  const size_t probe_count{100000};
+  for (size_t i = 0; i < probe_count; ++i) {
+    false_positives += sketch.mayContain(val_dist(gen) * 2 + 1);
+  }
+  // 16 bits per value and 3 hash functions, the rate should stay below 2%.
+  ASSERT_LT(false_positives, probe_count / 50);
+}
+
+TEST(ChunkValueSketch, SaturatedBloomFilter) {
+  std::vector<int64_t> vals;
+  for (int64_t i = 0; i < 100000; ++i) {
+    vals.push_back(i);
+  }
+  ChunkValueSketch sketch;
+  sketch.add(vals.data(), vals.size(), std::numeric_limits<int64_t>::min());
+  ASSERT_FALSE(sketch.hasBloomFilter());
+  ASSERT_TRUE(sketch.mayContain(-1));
+  ASSERT_TRUE(sketch.mayContain(100000));
+}
+
+TEST(ChunkValueSketch, DistinctCount) {
+  std::mt19937 gen(2);
+  for (const size_t ndv : {1, 10, 100, 1000, 100000}) {
+    std::uniform_int_distribution<int64_t> val_dist(0, ndv - 1);
+    std::vector<int64_t> vals;
+    for (size_t i = 0; i < ndv; ++i) {
+      vals.push_back(i);
+    }
+    for (size_t i = 0; i < ndv * 3; ++i) {
+      vals.push_back(val_dist(gen));
+    }
+    ChunkValueSketch sketch;
+    sketch.add(vals.data(), vals.size(), std::numeric_limits<int64_t>::min());
+    const auto estimate = static_cast<double>(sketch.approxDistinctCount());
+    // 64 registers give a standard error around 13%.
+    ASSERT_LT(std::abs(estimate - ndv), ndv * 0.4 + 1);
+  }
+}
+
+TEST(ChunkValueSketch, Persistence) {
+  const std::vector<int16_t> vals{3, 5, 7, 11, 13};
+  ChunkValueSketch sketch;
+  sketch.add(vals.data(), vals.size(), std::numeric_limits<int16_t>::min());
+  auto f = tmpfile();
+  ASSERT_TRUE(f);
+  sketch.write(f);
+  rewind(f);
+  ChunkValueSketch read_sketch;
+  read_sketch.read(f);
+  fclose(f);
+  ASSERT_EQ(sketch.hasBloomFilter(), read_sketch.hasBloomFilter());
+  ASSERT_EQ(sketch.approxDistinctCount(), read_sketch.approxDistinctCount());
+  for (int64_t val = -100; val < 100; ++val) {
+    ASSERT_EQ(sketch.mayContain(val), read_sketch.mayContain(val));
+  }
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
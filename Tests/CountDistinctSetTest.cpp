@@ -0,0 +1,123 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../QueryEngine/CountDistinctSet.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+
+void check_set(const CountDistinctSet& count_distinct_set,
+               const std::set<int64_t>& expected) {
+  ASSERT_EQ(expected.size(), count_distinct_set.size());
+  std::set<int64_t> actual;
+  count_distinct_set.forEach([&actual](const int64_t val) { actual.insert(val); });
+  ASSERT_EQ(expected, actual);
+}
+
+void fill(CountDistinctSet& count_distinct_set,
+          std::set<int64_t>& expected,
+          const size_t count,
+          const int64_t min_val,
+          const int64_t max_val,
+          const unsigned seed) {
+  std::mt19937_64 gen(seed);
+  std::uniform_int_distribution<int64_t> dist(min_val, max_val);
+  for (size_t i = 0; i < count; ++i) {
+    const auto val = dist(gen);
+    count_distinct_set.insert(val);
+    expected.insert(val);
+  }
+}
+
+}  // namespace
+
+TEST(CountDistinctSet, Small) {
+  CountDistinctSet count_distinct_set;
+  std::set<int64_t> expected;
+  const std::vector<int64_t> vals{5, -3, 5, 0, std::numeric_limits<int64_t>::min(), -3};
+  for (const auto val : vals) {
+    count_distinct_set.insert(val);
+    expected.insert(val);
+  }
+  ASSERT_EQ(CountDistinctSet::Impl::SortedVector, count_distinct_set.getImpl());
+  check_set(count_distinct_set, expected);
+}
+
+TEST(CountDistinctSet, Sparse) {
+  CountDistinctSet count_distinct_set;
+  std::set<int64_t> expected;
+  count_distinct_set.insert(std::numeric_limits<int64_t>::min());
+  expected.insert(std::numeric_limits<int64_t>::min());
+  fill(count_distinct_set,
+       expected,
+       200000,
+       std::numeric_limits<int64_t>::min(),
+       std::numeric_limits<int64_t>::max(),
+       1);
+  ASSERT_EQ(CountDistinctSet::Impl::HashSet, count_distinct_set.getImpl());
+  check_set(count_distinct_set, expected);
+}
+
+TEST(CountDistinctSet, Clustered) {
+  CountDistinctSet count_distinct_set;
+  std::set<int64_t> expected;
+  fill(count_distinct_set, expected, 500000, -1000000, 3000000, 2);
+  ASSERT_EQ(CountDistinctSet::Impl::Compressed, count_distinct_set.getImpl());
+  check_set(count_distinct_set, expected);
+}
+
+TEST(CountDistinctSet, Unite) {
+  const std::vector<std::pair<size_t, int64_t>> shapes{
+      {10, 100}, {50, 1 << 20}, {20000, 1L << 40}, {100000, 1 << 18}, {100000, 1 << 22}};
+  unsigned seed = 3;
+  for (const auto& lhs_shape : shapes) {
+    for (const auto& rhs_shape : shapes) {
+      CountDistinctSet lhs;
+      std::set<int64_t> expected;
+      fill(lhs, expected, lhs_shape.first, -lhs_shape.second, lhs_shape.second, ++seed);
+      CountDistinctSet rhs;
+      std::set<int64_t> rhs_expected;
+      fill(rhs, rhs_expected, rhs_shape.first, 0, rhs_shape.second, ++seed);
+      lhs.unite(rhs);
+      expected.insert(rhs_expected.begin(), rhs_expected.end());
+      check_set(lhs, expected);
+      check_set(rhs, rhs_expected);
+    }
+  }
+}
+
+TEST(CountDistinctSet, Copy) {
+  CountDistinctSet count_distinct_set;
+  std::set<int64_t> expected;
+  fill(count_distinct_set, expected, 200000, 0, 1 << 20, 4);
+  CountDistinctSet copy(count_distinct_set);
+  count_distinct_set.insert(-1);
+  check_set(copy, expected);
+  copy = count_distinct_set;
+  expected.insert(-1);
+  check_set(copy, expected);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
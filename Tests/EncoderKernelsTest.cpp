@@ -0,0 +1,215 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../DataMgr/EncoderKernels.h"
+#include "../DataMgr/FixedLengthEncoder.h"
+#include "../DataMgr/NoneEncoder.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+// The per value loop of NoneEncoder::appendData the kernels replaced.
+template <typename T>
+EncoderKernels::BatchStats<T> scalar_stats(const std::vector<T>& data, const T null_val) {
+  EncoderKernels::BatchStats<T> stats;
+  for (const auto val : data) {
+    if (val == null_val) {
+      stats.has_nulls = true;
+    } else {
+      stats.min = std::min(stats.min, val);
+      stats.max = std::max(stats.max, val);
+    }
+  }
+  return stats;
+}
+
+// The per value loop of FixedLengthEncoder::appendData the kernels replaced.
+template <typename T, typename V>
+EncoderKernels::BatchStats<T> scalar_encode(const std::vector<T>& src,
+                                            std::vector<V>& dst) {
+  EncoderKernels::BatchStats<T> stats;
+  dst.resize(src.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    dst[i] = static_cast<V>(src[i]);
+    if (src[i] != dst[i]) {
+      stats.has_overflow = true;
+    } else if (src[i] == std::numeric_limits<V>::min()) {
+      stats.has_nulls = true;
+    } else {
+      stats.min = std::min(stats.min, src[i]);
+      stats.max = std::max(stats.max, src[i]);
+    }
+  }
+  return stats;
+}
+
+template <typename T>
+void check_stats(const EncoderKernels::BatchStats<T>& expected,
+                 const EncoderKernels::BatchStats<T>& actual) {
+  ASSERT_EQ(expected.min, actual.min);
+  ASSERT_EQ(expected.max, actual.max);
+  ASSERT_EQ(expected.has_nulls, actual.has_nulls);
+  ASSERT_EQ(expected.has_overflow, actual.has_overflow);
+}
+
+// Values around the limits of V, the null sentinel included, mixed with random ones.
+template <typename T, typename V>
+std::vector<T> boundary_values(const size_t random_count) {
+  std::vector<T> vals{static_cast<T>(std::numeric_limits<V>::min()),
+                      static_cast<T>(std::numeric_limits<V>::min() + 1),
+                      static_cast<T>(std::numeric_limits<V>::max()),
+                      static_cast<T>(std::numeric_limits<V>::max() - 1),
+                      0,
+                      -1};
+  if (sizeof(T) > sizeof(V)) {
+    vals.push_back(static_cast<T>(std::numeric_limits<V>::max()) + 1);
+    vals.push_back(static_cast<T>(std::numeric_limits<V>::min()) - 1);
+    vals.push_back(std::numeric_limits<T>::max());
+    vals.push_back(std::numeric_limits<T>::min());
+  }
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<T> val_dist(std::numeric_limits<V>::min(),
+                                            std::numeric_limits<V>::max());
+  for (size_t i = 0; i < random_count; ++i) {
+    vals.push_back(val_dist(gen));
+  }
+  std::shuffle(vals.begin(), vals.end(), gen);
+  return vals;
+}
+
+template <typename T, typename V>
+void check_encode(const std::vector<T>& src) {
+  std::vector<V> expected_dst;
+  const auto expected = scalar_encode(src, expected_dst);
+  std::vector<V> dst(src.size());
+  const auto actual =
+      EncoderKernels::encode_and_compute_stats(src.data(), dst.data(), src.size());
+  check_stats(expected, actual);
+  ASSERT_EQ(expected_dst, dst);
+}
+
+template <typename T, typename V>
+void check_encode_boundaries() {
+  const auto vals = boundary_values<T, V>(1000);
+  check_encode<T, V>(vals);
+  // without the values which don't fit, so that only the nulls are skipped
+  std::vector<T> fitting_vals;
+  for (const auto val : vals) {
+    if (static_cast<T>(static_cast<V>(val)) == val) {
+      fitting_vals.push_back(val);
+    }
+  }
+  check_encode<T, V>(fitting_vals);
+  check_encode<T, V>({});
+  check_encode<T, V>({static_cast<T>(std::numeric_limits<V>::min())});
+}
+
+}  // namespace
+
+TEST(EncoderKernels, ComputeStats) {
+  const auto vals = boundary_values<int32_t, int32_t>(1000);
+  const auto null_val = std::numeric_limits<int32_t>::min();
+  check_stats(scalar_stats(vals, null_val),
+              EncoderKernels::compute_stats(vals.data(), vals.size(), null_val));
+  const std::vector<int32_t> nulls(10, null_val);
+  const auto null_stats =
+      EncoderKernels::compute_stats(nulls.data(), nulls.size(), null_val);
+  check_stats(scalar_stats(nulls, null_val), null_stats);
+  ASSERT_TRUE(null_stats.has_nulls);
+  ASSERT_GT(null_stats.min, null_stats.max);
+}
+
+TEST(EncoderKernels, ComputeStatsFp) {
+  const auto null_val = none_encoded_null_value<double>();
+  std::vector<double> vals{null_val,
+                           std::numeric_limits<double>::lowest(),
+                           std::numeric_limits<double>::max(),
+                           std::numeric_limits<double>::min(),
+                           -0.5,
+                           0.};
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<double> val_dist(-1e6, 1e6);
+  for (size_t i = 0; i < 1000; ++i) {
+    vals.push_back(val_dist(gen));
+  }
+  check_stats(scalar_stats(vals, null_val),
+              EncoderKernels::compute_stats(vals.data(), vals.size(), null_val));
+}
+
+TEST(EncoderKernels, EncodeAndComputeStats) {
+  check_encode_boundaries<int64_t, int8_t>();
+  check_encode_boundaries<int64_t, int16_t>();
+  check_encode_boundaries<int64_t, int32_t>();
+  check_encode_boundaries<int32_t, int8_t>();
+  check_encode_boundaries<int32_t, int16_t>();
+  check_encode_boundaries<int16_t, int8_t>();
+}
+
+namespace {
+
+// Feeds the same values to the per value and the batched updateStats.
+template <typename ENCODER, typename S>
+void check_batched_update_stats(const std::vector<S>& vals, const S null_val) {
+  ENCODER scalar_encoder(nullptr);
+  ENCODER batched_encoder(nullptr);
+  for (const auto val : vals) {
+    scalar_encoder.updateStats(val, val == null_val);
+  }
+  // in two batches, like the executor does once it has filled a batch
+  const size_t first_batch_size = vals.size() / 3;
+  batched_encoder.updateStats(vals.data(), first_batch_size, null_val);
+  batched_encoder.updateStats(
+      vals.data() + first_batch_size, vals.size() - first_batch_size, null_val);
+  ASSERT_EQ(scalar_encoder.dataMin, batched_encoder.dataMin);
+  ASSERT_EQ(scalar_encoder.dataMax, batched_encoder.dataMax);
+  ASSERT_EQ(scalar_encoder.has_nulls, batched_encoder.has_nulls);
+}
+
+}  // namespace
+
+TEST(EncoderKernels, BatchedUpdateStats) {
+  const auto int_null_val = std::numeric_limits<int64_t>::min();
+  const auto int_vals = boundary_values<int64_t, int32_t>(1000);
+  check_batched_update_stats<NoneEncoder<int64_t>>(int_vals, int_null_val);
+  // the values out of the range of int32_t get narrowed like in the scalar path
+  check_batched_update_stats<NoneEncoder<int32_t>>(int_vals, int_null_val);
+  check_batched_update_stats<FixedLengthEncoder<int64_t, int16_t>>(int_vals,
+                                                                    int_null_val);
+  const std::vector<int64_t> int_nulls(10, int_null_val);
+  check_batched_update_stats<NoneEncoder<int64_t>>(int_nulls, int_null_val);
+
+  const auto fp_null_val = static_cast<double>(none_encoded_null_value<float>());
+  std::vector<double> fp_vals{fp_null_val, std::numeric_limits<float>::max(), -1.5};
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<float> val_dist(-1e6, 1e6);
+  for (size_t i = 0; i < 1000; ++i) {
+    fp_vals.push_back(val_dist(gen));
+  }
+  check_batched_update_stats<NoneEncoder<float>>(fp_vals, fp_null_val);
+  check_batched_update_stats<NoneEncoder<double>>(fp_vals, fp_null_val);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
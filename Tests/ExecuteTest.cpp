@@ -20,6 +20,7 @@
 #include "../Parser/parser.h"
 #include "../QueryEngine/ArrowResultSet.h"
 #include "../QueryEngine/Execute.h"
+#include "../QueryEngine/JoinHashTable.h"
 #include "../QueryEngine/RelAlgExecutionDescriptor.h"
 #include "../QueryRunner/QueryRunner.h"
 #include "../Shared/ConfigResolve.h"
@@ -1189,6 +1190,111 @@ TEST(Select, ApproxCountDistinct) {
   }
 }
 
+TEST(Select, ApproxPercentile) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT APPROX_PERCENTILE(x, 0), APPROX_PERCENTILE(x, 1) FROM test;",
+      "SELECT CAST(MIN(x) AS DOUBLE), CAST(MAX(x) AS DOUBLE) FROM test;",
+      dt);
+    c("SELECT APPROX_PERCENTILE(dn, 0.0), APPROX_PERCENTILE(dn, 1.0) FROM test;",
+      "SELECT MIN(dn), MAX(dn) FROM test;",
+      dt);
+    c("SELECT y, APPROX_PERCENTILE(z, 0), APPROX_PERCENTILE(f, 1) FROM test GROUP BY y "
+      "ORDER BY y;",
+      "SELECT y, CAST(MIN(z) AS DOUBLE), CAST(MAX(f) AS DOUBLE) FROM test GROUP BY y "
+      "ORDER BY y;",
+      dt);
+    c("SELECT x, APPROX_PERCENTILE(dn, 0.5) AS p FROM test GROUP BY x ORDER BY p;",
+      "SELECT x, MIN(dn) AS p FROM test GROUP BY x ORDER BY p;",
+      dt);
+    ASSERT_NEAR(static_cast<double>(101),
+                v<double>(run_simple_agg("SELECT APPROX_MEDIAN(z) FROM test;", dt)),
+                static_cast<double>(0.01));
+    ASSERT_NEAR(
+        static_cast<double>(101),
+        v<double>(run_simple_agg("SELECT APPROX_PERCENTILE(z, 0.5) FROM test;", dt)),
+        static_cast<double>(0.01));
+    ASSERT_EQ(inline_fp_null_val(SQLTypeInfo(kDOUBLE, false)),
+              v<double>(run_simple_agg(
+                  "SELECT APPROX_PERCENTILE(x, 0.5) FROM test WHERE x < 0;", dt)));
+    EXPECT_THROW(run_multiple_agg("SELECT APPROX_PERCENTILE(x, 2) FROM test;", dt),
+                 std::runtime_error);
+    EXPECT_THROW(run_multiple_agg("SELECT APPROX_PERCENTILE(x, y) FROM test;", dt),
+                 std::runtime_error);
+  }
+}
+
+TEST(Select, WindowFunctions) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT x, y, COUNT(*) OVER (PARTITION BY x) AS n FROM test ORDER BY x, y, n;",
+      "SELECT x, y, (SELECT COUNT(*) FROM test AS t WHERE t.x = test.x) AS n FROM test "
+      "ORDER BY x, y, n;",
+      dt);
+    c("SELECT x, y, SUM(z) OVER (PARTITION BY x, y) AS s, AVG(d) OVER (PARTITION BY x) "
+      "AS a FROM test ORDER BY x, y, s;",
+      "SELECT x, y, (SELECT SUM(z) FROM test AS t WHERE t.x = test.x AND t.y = test.y) "
+      "AS s, (SELECT AVG(d) FROM test AS t WHERE t.x = test.x) AS a FROM test ORDER BY "
+      "x, y, s;",
+      dt);
+    c("SELECT x, y, RANK() OVER (PARTITION BY x ORDER BY y) AS r, DENSE_RANK() OVER "
+      "(PARTITION BY x ORDER BY y DESC) AS dr FROM test ORDER BY x, y, r, dr;",
+      "SELECT x, y, (SELECT COUNT(*) FROM test AS t WHERE t.x = test.x AND t.y < test.y) "
+      "+ 1 AS r, (SELECT COUNT(DISTINCT t.y) FROM test AS t WHERE t.x = test.x AND t.y > "
+      "test.y) + 1 AS dr FROM test ORDER BY x, y, r, dr;",
+      dt);
+    c("SELECT x, str, FIRST_VALUE(str) OVER (PARTITION BY x ORDER BY str) AS fv FROM "
+      "test ORDER BY x, str, fv;",
+      "SELECT x, str, (SELECT MIN(t.str) FROM test AS t WHERE t.x = test.x) AS fv FROM "
+      "test ORDER BY x, str, fv;",
+      dt);
+    c("SELECT x, str, LAST_VALUE(str) OVER (PARTITION BY x ORDER BY str ROWS BETWEEN "
+      "UNBOUNDED PRECEDING AND UNBOUNDED FOLLOWING) AS lv FROM test ORDER BY x, str, lv;",
+      "SELECT x, str, (SELECT MAX(t.str) FROM test AS t WHERE t.x = test.x) AS lv FROM "
+      "test ORDER BY x, str, lv;",
+      dt);
+    c("SELECT x, str, RANK() OVER (PARTITION BY x ORDER BY str DESC) AS r FROM test "
+      "ORDER BY x, str, r;",
+      "SELECT x, str, (SELECT COUNT(*) FROM test AS t WHERE t.x = test.x AND t.str > "
+      "test.str) + 1 AS r FROM test ORDER BY x, str, r;",
+      dt);
+    c("SELECT y, fixed_str, DENSE_RANK() OVER (PARTITION BY y ORDER BY fixed_str) AS dr "
+      "FROM test WHERE fixed_str IS NOT NULL ORDER BY y, fixed_str, dr;",
+      "SELECT y, fixed_str, (SELECT COUNT(DISTINCT t.fixed_str) FROM test AS t WHERE "
+      "t.y = test.y AND t.fixed_str < test.fixed_str) + 1 AS dr FROM test WHERE "
+      "fixed_str IS NOT NULL ORDER BY y, fixed_str, dr;",
+      dt);
+    ASSERT_EQ(int64_t(135),
+              v<int64_t>(run_simple_agg(
+                  "SELECT SUM(rn) FROM (SELECT ROW_NUMBER() OVER (PARTITION BY x ORDER "
+                  "BY y) AS rn FROM test);",
+                  dt)));
+    ASSERT_EQ(int64_t(18),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(l) FROM (SELECT LAG(y) OVER (PARTITION BY x ORDER BY y) "
+                  "AS l FROM test);",
+                  dt)));
+    ASSERT_EQ(int64_t(764),
+              v<int64_t>(run_simple_agg(
+                  "SELECT SUM(l) FROM (SELECT LAG(y) OVER (PARTITION BY x ORDER BY y) "
+                  "AS l FROM test);",
+                  dt)));
+    ASSERT_EQ(int64_t(1520),
+              v<int64_t>(run_simple_agg(
+                  "SELECT MAX(s) FROM (SELECT SUM(z) OVER (PARTITION BY x ORDER BY y "
+                  "ROWS BETWEEN UNBOUNDED PRECEDING AND CURRENT ROW) AS s FROM test);",
+                  dt)));
+    EXPECT_THROW(run_multiple_agg("SELECT SUM(x) OVER (ORDER BY y RANGE BETWEEN 1 "
+                                  "PRECEDING AND CURRENT ROW) FROM test;",
+                                  dt),
+                 std::runtime_error);
+  }
+}
+
 TEST(Select, ScanNoAggregation) {
   SKIP_ALL_ON_AGGREGATOR();
 
@@ -1301,6 +1407,70 @@ TEST(Select, OrderBy) {
   }
 }
 
+TEST(Select, OrderByMultipleKeys) {
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT x, y, COUNT(*) n FROM test GROUP BY x, y ORDER BY x DESC, y, n;", dt);
+    c("SELECT str, x, SUM(y) s FROM test GROUP BY str, x ORDER BY str DESC, x ASC;", dt);
+    c("SELECT x, AVG(y) a, COUNT(*) n FROM test GROUP BY x ORDER BY a DESC, n, x;", dt);
+    c("SELECT dn, fn, COUNT(*) n FROM test GROUP BY dn, fn ORDER BY dn ASC NULLS FIRST, "
+      "fn DESC NULLS LAST;",
+      "SELECT dn, fn, COUNT(*) n FROM test GROUP BY dn, fn ORDER BY dn ASC, fn DESC;",
+      dt);
+    c("SELECT x, y, str FROM test ORDER BY str, y DESC, x LIMIT 10;", dt);
+  }
+}
+
+TEST(Select, OrderByMultipleKeysLimit) {
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT x, y, z FROM test ORDER BY x DESC, y, z LIMIT 5;", dt);
+    c("SELECT x, z, t FROM test WHERE y > 41 ORDER BY z DESC, x, t LIMIT 3 OFFSET 1;",
+      dt);
+    c("SELECT dd, x, y FROM test ORDER BY dd, x DESC, y LIMIT 4;", dt);
+    c("SELECT ofd, x, y FROM test ORDER BY ofd ASC NULLS FIRST, x DESC, y LIMIT 4;",
+      "SELECT ofd, x, y FROM test ORDER BY ofd ASC, x DESC, y LIMIT 4;",
+      dt);
+    c("SELECT ofd, x, y FROM test ORDER BY ofd DESC NULLS LAST, x, y LIMIT 20;",
+      "SELECT ofd, x, y FROM test ORDER BY ofd DESC, x, y LIMIT 20;",
+      dt);
+    c("SELECT f, x, y FROM test ORDER BY f DESC, x, y LIMIT 5;", dt);
+    c("SELECT fn, x, y FROM test ORDER BY fn ASC NULLS FIRST, x DESC, y LIMIT 4;",
+      "SELECT fn, x, y FROM test ORDER BY fn ASC, x DESC, y LIMIT 4;",
+      dt);
+    c("SELECT fn, x, y FROM test ORDER BY x, fn DESC NULLS LAST, y LIMIT 20;",
+      "SELECT fn, x, y FROM test ORDER BY x, fn DESC, y LIMIT 20;",
+      dt);
+    c("SELECT str, x, y FROM test ORDER BY str DESC, x, y LIMIT 5;", dt);
+    c("SELECT null_str, x, y FROM test ORDER BY null_str ASC NULLS FIRST, x, y LIMIT 4;",
+      "SELECT null_str, x, y FROM test ORDER BY null_str ASC, x, y LIMIT 4;",
+      dt);
+    c("SELECT x, str, y FROM test ORDER BY x DESC, str, y LIMIT 20;", dt);
+    // doubles take the full sort
+    c("SELECT d, x, y FROM test ORDER BY d, x DESC, y LIMIT 5;", dt);
+  }
+}
+
+TEST(Select, LateMaterialization) {
+  const auto enable_late_materialization = g_enable_late_materialization;
+  for (const bool late_materialization : {true, false}) {
+    g_enable_late_materialization = late_materialization;
+    for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+      SKIP_NO_GPU();
+      c("SELECT x, y, str, real_str, d FROM test WHERE y = 43 ORDER BY x, str, d;", dt);
+      c("SELECT real_str, f, t FROM test WHERE x > 7 AND z < 102 ORDER BY real_str, f, "
+        "t;",
+        dt);
+      c("SELECT str, real_str, dd FROM test WHERE x = 9;", dt);
+      c("SELECT y, real_str FROM test WHERE real_str LIKE 'real_f%' ORDER BY y, "
+        "real_str;",
+        dt);
+      c("SELECT x, str, real_str FROM test ORDER BY x, str, real_str;", dt);
+    }
+  }
+  g_enable_late_materialization = enable_late_materialization;
+}
+
 TEST(Select, ComplexQueries) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -4691,7 +4861,44 @@ TEST(Select, Subqueries) {
                 v<double>(run_simple_agg(
                     "SELECT AVG(dd) / (SELECT STDDEV(dd) FROM test) FROM test;", dt)),
                 static_cast<double>(0.10));
+    c("SELECT COUNT(*) FROM test WHERE x > (SELECT MIN(x) FROM test) OR y < (SELECT "
+      "MIN(x) FROM test);",
+      dt);
+    c("SELECT COUNT(*) FROM test WHERE x IN (SELECT x FROM test_inner) AND y NOT IN "
+      "(SELECT x FROM test_inner);",
+      dt);
+  }
+}
+
+TEST(Select, SubqueryResultCache) {
+  const auto cache_entries = g_subquery_result_cache_entries;
+  g_subquery_result_cache_entries = 16;
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    const std::string drop_subquery_cache_test(
+        "DROP TABLE IF EXISTS subquery_cache_test;");
+    run_ddl_statement(drop_subquery_cache_test);
+    g_sqlite_comparator.query(drop_subquery_cache_test);
+    run_ddl_statement("CREATE TABLE subquery_cache_test(x int);");
+    g_sqlite_comparator.query("CREATE TABLE subquery_cache_test(x int);");
+    for (const auto val : {"7", "8"}) {
+      const std::string insert_query{"INSERT INTO subquery_cache_test VALUES(" +
+                                     std::string(val) + ");"};
+      run_multiple_agg(insert_query, dt);
+      g_sqlite_comparator.query(insert_query);
+      // the second run reuses the result of the subquery, the insert must not
+      for (size_t i = 0; i < 2; ++i) {
+        c("SELECT COUNT(*) FROM test WHERE x IN (SELECT x FROM subquery_cache_test);",
+          dt);
+        c("SELECT COUNT(*) FROM test WHERE x >= (SELECT MAX(x) FROM "
+          "subquery_cache_test);",
+          dt);
+      }
+    }
+    run_ddl_statement(drop_subquery_cache_test);
+    g_sqlite_comparator.query(drop_subquery_cache_test);
   }
+  g_subquery_result_cache_entries = cache_entries;
 }
 
 TEST(Select, Joins_Arrays) {
@@ -5209,6 +5416,154 @@ TEST(Select, Joins_InnerJoin_Filters) {
   }
 }
 
+TEST(Select, FragmentSkipping) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT COUNT(*) FROM coalesce_cols_test_2 WHERE x < 3 OR x > 16;", dt);
+    c("SELECT COUNT(*) FROM coalesce_cols_test_2 WHERE (x BETWEEN 2 AND 4 OR x >= 18) "
+      "AND y > 0;",
+      dt);
+    c("SELECT COUNT(*) FROM coalesce_cols_test_2 WHERE x IN (1, 7, 19);", dt);
+    c("SELECT COUNT(*) FROM coalesce_cols_test_2 WHERE x NOT IN (1, 7, 19);", dt);
+    c("SELECT COUNT(*) FROM coalesce_cols_test_2 WHERE NOT (x < 5 OR x > 10);", dt);
+    c("SELECT COUNT(*) FROM coalesce_cols_test_2 WHERE str IN ('test1', 'test3');", dt);
+    c("SELECT COUNT(*) FROM coalesce_cols_test_2 WHERE str = 'test2' OR x = 0;", dt);
+    c("SELECT COUNT(*) FROM coalesce_cols_test_2 WHERE str = 'not in dictionary';", dt);
+    c("SELECT COUNT(*) FROM coalesce_cols_test_2 WHERE d = '2016-01-01' OR d > "
+      "'2017-06-01';",
+      dt);
+    c("SELECT COUNT(*) FROM coalesce_cols_test_2 WHERE tz IS NULL OR x = 3;", dt);
+    c("SELECT COUNT(*) FROM coalesce_cols_test_2 WHERE dn > 15 OR dn < 2;", dt);
+    ASSERT_EQ(int64_t(5),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM coalesce_cols_test_2 WHERE CAST(tz AS DATE) = "
+                  "'2016-01-01';",
+                  dt)));
+    ASSERT_EQ(int64_t(5),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM coalesce_cols_test_2 WHERE DATE_TRUNC(day, tz) = "
+                  "'2015-01-01 00:00:00';",
+                  dt)));
+    ASSERT_EQ(int64_t(10),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM coalesce_cols_test_2 WHERE EXTRACT(year FROM tz) "
+                  "IN (2015, 2017);",
+                  dt)));
+  }
+
+  // The dictionary ids of the strings follow their insertion order, a range of ids
+  // doesn't bound the strings alphabetically.
+  run_ddl_statement("DROP TABLE IF EXISTS dict_order_skipping_test;");
+  run_ddl_statement(
+      "CREATE TABLE dict_order_skipping_test(s text encoding dict) WITH "
+      "(fragment_size=1);");
+  run_multiple_agg("INSERT INTO dict_order_skipping_test VALUES('b');",
+                   ExecutorDeviceType::CPU);
+  run_multiple_agg("INSERT INTO dict_order_skipping_test VALUES('a');",
+                   ExecutorDeviceType::CPU);
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    ASSERT_EQ(int64_t(1),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM dict_order_skipping_test WHERE s < 'b';", dt)));
+    ASSERT_EQ(int64_t(1),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM dict_order_skipping_test WHERE s > 'a';", dt)));
+    ASSERT_EQ(int64_t(1),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM dict_order_skipping_test WHERE NOT (s >= 'b');",
+                  dt)));
+    ASSERT_EQ(int64_t(1),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM dict_order_skipping_test WHERE s = 'a';", dt)));
+  }
+  run_ddl_statement("DROP TABLE dict_order_skipping_test;");
+}
+
+TEST(Select, Joins_RuntimeFilters) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT COUNT(*) FROM emp a JOIN dept b ON a.deptno = b.deptno WHERE b.dname = "
+      "'Dev';",
+      dt);
+    c("SELECT a.ename FROM emp a JOIN dept b ON a.deptno = b.deptno WHERE b.deptno < 20 "
+      "ORDER BY a.ename;",
+      dt);
+    c("SELECT COUNT(*) FROM emp a JOIN dept b ON a.deptno = b.deptno WHERE b.deptno > "
+      "40;",
+      dt);
+    c("SELECT a.ename, b.dname FROM emp a LEFT JOIN dept b ON a.deptno = b.deptno ORDER "
+      "BY a.ename;",
+      dt);
+    c("SELECT a.ename FROM emp a JOIN emp b ON a.empno = b.empno AND a.deptno = b.deptno "
+      "WHERE b.deptno = 60 ORDER BY a.ename;",
+      dt);
+    c("SELECT a.ename FROM emp a JOIN (SELECT deptno FROM dept WHERE dname = 'Sales') b "
+      "ON a.deptno = b.deptno ORDER BY a.ename;",
+      dt);
+  }
+  // the filters built by the first run are taken from the cache by the second one
+  for (size_t i = 0; i < 2; ++i) {
+    c("SELECT COUNT(*) FROM emp a JOIN dept b ON a.deptno = b.deptno WHERE b.deptno > "
+      "40;",
+      ExecutorDeviceType::CPU);
+    c("SELECT a.ename FROM emp a JOIN emp b ON a.empno = b.empno AND a.deptno = b.deptno "
+      "WHERE b.deptno = 60 ORDER BY a.ename;",
+      ExecutorDeviceType::CPU);
+  }
+}
+
+TEST(Select, Joins_PartitionedHashTableBuild) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  const auto partitioned_threshold = g_partitioned_hash_build_threshold;
+  // the hash tables built so far are cached, they must be built again
+  JoinHashTable::yieldCacheInvalidator()();
+  g_partitioned_hash_build_threshold = 0;
+  const auto dt = ExecutorDeviceType::CPU;
+  c("SELECT COUNT(*) FROM test a JOIN single_row_test b ON a.x = b.x;", dt);
+  c("SELECT a.y, z FROM test a JOIN test_inner b ON a.x = b.x order by a.y;", dt);
+  c("SELECT COUNT(*) FROM test a JOIN join_test b ON a.str = b.dup_str;", dt);
+  c("SELECT a.x FROM test_inner_x a JOIN test_x b ON a.x = b.x ORDER BY a.x;", dt);
+  c("SELECT a.ename, b.dname FROM emp a LEFT JOIN dept b ON a.deptno = b.deptno ORDER "
+    "BY a.ename;",
+    dt);
+  c("SELECT COUNT(*) FROM test, test_inner WHERE test.y = test_inner.y OR (test.y IS "
+    "NULL AND test_inner.y IS NULL);",
+    dt);
+  g_partitioned_hash_build_threshold = partitioned_threshold;
+  JoinHashTable::yieldCacheInvalidator()();
+}
+
+TEST(Select, Joins_RangeJoin) {
+  SKIP_ALL_ON_AGGREGATOR();
+  // test_inner is small enough to be loop joined even without loop joins allowed
+  const auto trivial_loop_join_threshold = g_trivial_loop_join_threshold;
+  g_trivial_loop_join_threshold = 0;
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT COUNT(*) FROM test a JOIN test_inner b ON a.x < b.x;", dt);
+    c("SELECT COUNT(*) FROM test a JOIN test_inner b ON a.x >= b.x;", dt);
+    c("SELECT COUNT(*) FROM test a JOIN test_inner b ON a.y BETWEEN b.x AND b.y;", dt);
+    c("SELECT COUNT(*) FROM test a JOIN join_test b ON a.x <= b.x AND a.y > b.y;", dt);
+    c("SELECT a.x, COUNT(*) FROM test a JOIN test_inner b ON b.x > a.x - 1 AND b.x <= "
+      "a.x + 1 GROUP BY a.x ORDER BY a.x;",
+      dt);
+    c("SELECT a.x, b.x FROM test a JOIN join_test b ON a.z < b.x AND a.x <> b.x ORDER BY "
+      "a.x, b.x;",
+      dt);
+    // the sorted inner column replaces the loop join
+    EXPECT_NO_THROW(run_multiple_agg(
+        "SELECT COUNT(*) FROM test a JOIN test_inner b ON a.x < b.x;", dt, false));
+  }
+  g_trivial_loop_join_threshold = trivial_loop_join_threshold;
+}
+
 TEST(Select, Joins_LeftOuterJoin) {
   SKIP_ALL_ON_AGGREGATOR();
   auto save_watchdog = g_enable_watchdog;
@@ -9931,6 +10286,43 @@ TEST(Select, GeoSpatial_Projection) {
   }
 }
 
+TEST(Select, GeoSpatial_Join) {
+  SKIP_ALL_ON_AGGREGATOR();
+  // geospatial_test is small enough to be loop joined even without loop joins allowed
+  const auto trivial_loop_join_threshold = g_trivial_loop_join_threshold;
+  g_trivial_loop_join_threshold = 0;
+
+  // The join quals under a CASE can't use the spatial join table, they give the
+  // results of the loop join.
+  const auto check_spatial_join = [](const std::string& join_qual,
+                                     const ExecutorDeviceType dt) {
+    const auto expected = v<int64_t>(run_simple_agg(
+        "SELECT COUNT(*) FROM geospatial_test a, geospatial_test b WHERE CASE WHEN " +
+            join_qual + " THEN 1 ELSE 0 END = 1;",
+        dt));
+    // without loop joins
+    const auto rows = run_multiple_agg(
+        "SELECT COUNT(*) FROM geospatial_test a, geospatial_test b WHERE " + join_qual +
+            ";",
+        dt,
+        false);
+    const auto crt_row = rows->getNextRow(true, true);
+    ASSERT_EQ(size_t(1), crt_row.size());
+    ASSERT_EQ(expected, v<int64_t>(crt_row[0]));
+  };
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    check_spatial_join("ST_Contains(b.poly, a.p)", dt);
+    check_spatial_join("ST_Contains(b.mpoly, a.p)", dt);
+    check_spatial_join("ST_Contains(b.gpoly4326, a.gp4326)", dt);
+    check_spatial_join("ST_Distance(a.p, b.p) < 2.5", dt);
+    check_spatial_join("ST_Distance(b.p, a.p) <= 1.5", dt);
+    check_spatial_join("ST_Distance(a.gp4326, b.gp4326) < 3", dt);
+    check_spatial_join("0 >= ST_Distance(a.p, b.p)", dt);
+  }
+  g_trivial_loop_join_threshold = trivial_loop_join_threshold;
+}
+
 TEST(Rounding, ROUND) {
   SKIP_ALL_ON_AGGREGATOR();
 
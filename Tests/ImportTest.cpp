@@ -17,8 +17,10 @@
 #include "TestHelpers.h"
 
 #include "../Import/Importer.h"
+#include "../Import/StreamIngestor.h"
 
 #include <algorithm>
+#include <fstream>
 #include <string>
 
 #include <glog/logging.h>
@@ -246,6 +248,64 @@ TEST(Detect, Numeric) {
   // d(kDOUBLE, "1.2345678901");
   // d(kDOUBLE, "1.23456789012345678901234567890");
   d(kTEXT, "1.22.22");
+  // bytes above 0x7f and embedded NULs are never part of a number
+  d(kTEXT, "1\xc3\xa9");
+  d(kTEXT, std::string("12\0", 3));
+}
+
+// Writes a header and row_count lines whose values change type from tail_start on:
+// the id stays an integer, the second column turns into text and the third into a
+// decimal number.
+boost::filesystem::path write_detect_file(const size_t row_count,
+                                          const size_t tail_start) {
+  const auto file_path = boost::filesystem::temp_directory_path() /
+                         boost::filesystem::unique_path("detect_%%%%-%%%%.csv");
+  std::ofstream file(file_path.string());
+  file << "id,val,num\n";
+  for (size_t i = 0; i < row_count; ++i) {
+    file << i << ",";
+    if (i < tail_start) {
+      file << i % 1000 << "," << i % 1000 << "\n";
+    } else {
+      file << "val_" << i << "," << i % 1000 << ".5\n";
+    }
+  }
+  return file_path;
+}
+
+// The head of the input only has integers, the sample must reach the tail.
+void check_detect_tail(const size_t row_count,
+                       const size_t tail_start,
+                       const size_t sample_rows) {
+  const auto file_path = write_detect_file(row_count, tail_start);
+  Importer_NS::CopyParams copy_params;
+  copy_params.detect_sample_rows = sample_rows;
+  Importer_NS::Detector detector(file_path, copy_params);
+  boost::filesystem::remove(file_path);
+  ASSERT_TRUE(detector.has_headers);
+  ASSERT_EQ(size_t(3), detector.best_sqltypes.size());
+  ASSERT_TRUE(IS_INTEGER(detector.best_sqltypes[0]));
+  ASSERT_EQ(TypeToString(kTEXT), TypeToString(detector.best_sqltypes[1]));
+  ASSERT_EQ(TypeToString(kFLOAT), TypeToString(detector.best_sqltypes[2]));
+  // the header, then at most sample_rows lines in file order
+  const auto& raw_rows = detector.raw_rows;
+  ASSERT_GE(raw_rows.size(), size_t(2));
+  ASSERT_LE(raw_rows.size(), sample_rows + 1);
+  ASSERT_EQ("id", raw_rows.front()[0]);
+  ASSERT_GE(std::stoul(raw_rows.back()[0]), tail_start);
+  for (size_t i = 2; i < raw_rows.size(); ++i) {
+    ASSERT_LT(std::stoul(raw_rows[i - 1][0]), std::stoul(raw_rows[i][0]));
+  }
+}
+
+TEST(Detect, SampleReachesTail) {
+  // streamed, the reservoir sample covers the whole input
+  check_detect_tail(100000, 90000, 1000);
+}
+
+TEST(Detect, LargeFileSampleReachesTail) {
+  // over 64MB, read in blocks spread over the whole file
+  check_detect_tail(6000000, 5700000, 10000);
 }
 
 const char* create_table_fix1 =
@@ -278,6 +338,268 @@ TEST_F(ImportTestFix1, Fix_failed_import_arrays_after_geos) {
   CHECK_EQ(int64_t(1), v<int64_t>(crt_row[0]));
 }
 
+class MultiFragmentImportTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    ASSERT_NO_THROW(run_ddl_statement("drop table if exists multi_frag;"););
+    ASSERT_NO_THROW(run_ddl_statement(
+        "create table multi_frag (id INTEGER, name TEXT ENCODING DICT(32), descr TEXT "
+        "ENCODING NONE, vals INTEGER[]) WITH (fragment_size=" +
+        std::to_string(fragment_size) + ");"););
+  }
+
+  virtual void TearDown() {
+    ASSERT_NO_THROW(run_ddl_statement("drop table multi_frag;"););
+    boost::filesystem::remove(file_path);
+  }
+
+  // one copy batch of row_count rows, over the parallel append threshold
+  void writeFile() {
+    file_path = boost::filesystem::temp_directory_path() /
+                boost::filesystem::unique_path("multi_frag_%%%%-%%%%.csv");
+    std::ofstream file(file_path.string());
+    for (size_t i = 0; i < row_count; ++i) {
+      file << i << ",name_" << i % 7 << ",descr_" << i << ",{" << i << "," << i + 1
+           << "}\n";
+    }
+  }
+
+  const size_t fragment_size{4000};
+  const size_t row_count{25000};
+  boost::filesystem::path file_path;
+};
+
+TEST_F(MultiFragmentImportTest, RowsAndFragmentMetadata) {
+  writeFile();
+  ASSERT_NO_THROW(run_ddl_statement("COPY multi_frag FROM '" + file_path.string() +
+                                    "' WITH (header='false', threads=1);"));
+  {
+    auto rows = run_query(
+        "SELECT COUNT(*), COUNT(DISTINCT id), SUM(id), COUNT(DISTINCT name), "
+        "SUM(vals[1]), SUM(vals[2]) FROM multi_frag;");
+    auto crt_row = rows->getNextRow(true, true);
+    CHECK_EQ(size_t(6), crt_row.size());
+    const int64_t id_sum = row_count * (row_count - 1) / 2;
+    ASSERT_EQ(int64_t(row_count), v<int64_t>(crt_row[0]));
+    ASSERT_EQ(int64_t(row_count), v<int64_t>(crt_row[1]));
+    ASSERT_EQ(id_sum, v<int64_t>(crt_row[2]));
+    ASSERT_EQ(int64_t(7), v<int64_t>(crt_row[3]));
+    ASSERT_EQ(id_sum, v<int64_t>(crt_row[4]));
+    ASSERT_EQ(id_sum + int64_t(row_count), v<int64_t>(crt_row[5]));
+  }
+  // the rows on both sides of every fragment boundary
+  for (size_t id = fragment_size - 1; id < row_count; id += fragment_size) {
+    for (const auto boundary_id : {id, id + 1}) {
+      auto rows = run_query("SELECT name, descr, vals[2] FROM multi_frag WHERE id = " +
+                            std::to_string(boundary_id) + ";");
+      ASSERT_EQ(size_t(1), rows->rowCount());
+      auto crt_row = rows->getNextRow(true, true);
+      CHECK_EQ(size_t(3), crt_row.size());
+      ASSERT_EQ("name_" + std::to_string(boundary_id % 7),
+                boost::get<std::string>(v<NullableString>(crt_row[0])));
+      ASSERT_EQ("descr_" + std::to_string(boundary_id),
+                boost::get<std::string>(v<NullableString>(crt_row[1])));
+      ASSERT_EQ(int64_t(boundary_id + 1), v<int64_t>(crt_row[2]));
+    }
+  }
+
+  auto& cat = g_session->get_catalog();
+  const auto td = cat.getMetadataForTable("multi_frag");
+  CHECK(td);
+  const auto id_cd = cat.getMetadataForColumn(td->tableId, "id");
+  CHECK(id_cd);
+  const auto table_info = td->fragmenter->getFragmentsForQuery();
+  ASSERT_EQ((row_count + fragment_size - 1) / fragment_size,
+            table_info.fragments.size());
+  size_t fragment_row_start = 0;
+  for (const auto& fragment : table_info.fragments) {
+    const auto fragment_row_count = fragment.getPhysicalNumTuples();
+    ASSERT_EQ(std::min(fragment_size, row_count - fragment_row_start),
+              fragment_row_count);
+    const auto& chunk_metadata_map = fragment.getChunkMetadataMapPhysical();
+    ASSERT_GE(chunk_metadata_map.size(), size_t(4));
+    for (const auto& chunk_metadata : chunk_metadata_map) {
+      ASSERT_EQ(fragment_row_count, chunk_metadata.second.numElements);
+    }
+    // a single import thread appends the rows in file order
+    const auto& id_stats = chunk_metadata_map.at(id_cd->columnId).chunkStats;
+    ASSERT_EQ(int32_t(fragment_row_start), id_stats.min.intval);
+    ASSERT_EQ(int32_t(fragment_row_start + fragment_row_count - 1),
+              id_stats.max.intval);
+    ASSERT_FALSE(id_stats.has_nulls);
+    fragment_row_start += fragment_row_count;
+  }
+  ASSERT_EQ(row_count, fragment_row_start);
+}
+
+// in-process stand-in for a message broker: partitions are plain logs,
+// offsets are positions in them
+class InProcessStreamSource : public Importer_NS::StreamSource {
+ public:
+  InProcessStreamSource(const size_t partition_count) : logs_(partition_count) {}
+
+  void produce(const int32_t partition, const std::string& payload) {
+    logs_[partition].push_back(payload);
+  }
+
+  std::vector<Importer_NS::StreamMessage> consume(
+      const size_t max_messages,
+      const std::chrono::milliseconds timeout) override {
+    std::vector<Importer_NS::StreamMessage> messages;
+    for (int32_t partition = 0; partition < static_cast<int32_t>(logs_.size());
+         ++partition) {
+      auto& offset = positions_[partition];
+      while (messages.size() < max_messages &&
+             offset < static_cast<int64_t>(logs_[partition].size())) {
+        messages.push_back({partition, offset, logs_[partition][offset]});
+        ++offset;
+      }
+    }
+    return messages;
+  }
+
+  void commit(const Importer_NS::StreamCheckpoint& checkpoint) override {
+    committed_ = checkpoint;
+  }
+
+  void seek(const std::map<int32_t, int64_t>& offsets) override {
+    for (const auto& partition_offset : offsets) {
+      positions_[partition_offset.first] = partition_offset.second;
+    }
+  }
+
+  std::map<int32_t, int64_t> getStartOffsets() override {
+    std::map<int32_t, int64_t> offsets;
+    for (int32_t partition = 0; partition < static_cast<int32_t>(logs_.size());
+         ++partition) {
+      offsets[partition] = positions_[partition];
+    }
+    return offsets;
+  }
+
+  const Importer_NS::StreamCheckpoint& committed() const { return committed_; }
+
+ private:
+  std::vector<std::vector<std::string>> logs_;
+  std::map<int32_t, int64_t> positions_;
+  Importer_NS::StreamCheckpoint committed_;
+};
+
+class StreamIngestTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    ASSERT_NO_THROW(run_ddl_statement("drop table if exists stream_t;"););
+    ASSERT_NO_THROW(run_ddl_statement(
+        "create table stream_t (id INTEGER, name TEXT ENCODING DICT(32));"););
+  }
+
+  virtual void TearDown() { ASSERT_NO_THROW(run_ddl_statement("drop table stream_t;");); }
+
+  std::unique_ptr<Importer_NS::StreamIngestor> makeIngestor(
+      InProcessStreamSource& source) {
+    auto& cat = g_session->get_catalog();
+    const auto td = cat.getMetadataForTable("stream_t");
+    CHECK(td);
+    Importer_NS::CopyParams copy_params;
+    copy_params.has_header = false;
+    Importer_NS::MicroBatchPolicy policy;
+    policy.max_rows = 300;
+    policy.max_latency = std::chrono::milliseconds(100);
+    return std::make_unique<Importer_NS::StreamIngestor>(
+        cat, td, copy_params, source, policy);
+  }
+
+  static void produce(InProcessStreamSource& source, const int begin, const int end) {
+    for (int i = begin; i < end; ++i) {
+      source.produce(i % 2, std::to_string(i) + ",name_" + std::to_string(i % 7));
+    }
+  }
+
+  static void check_ids(const int64_t expected_count) {
+    auto rows = run_query("SELECT COUNT(*), COUNT(DISTINCT id), SUM(id) FROM stream_t;");
+    auto crt_row = rows->getNextRow(true, true);
+    CHECK_EQ(size_t(3), crt_row.size());
+    ASSERT_EQ(expected_count, v<int64_t>(crt_row[0]));
+    ASSERT_EQ(expected_count, v<int64_t>(crt_row[1]));
+    ASSERT_EQ(expected_count * (expected_count - 1) / 2, v<int64_t>(crt_row[2]));
+  }
+};
+
+TEST_F(StreamIngestTest, MicroBatches) {
+  InProcessStreamSource source(2);
+  produce(source, 0, 1000);
+  auto ingestor = makeIngestor(source);
+  ingestor->recover();
+  size_t batch_count = 0;
+  while (ingestor->ingestMicroBatch().rows_completed > 0) {
+    ++batch_count;
+  }
+  ASSERT_EQ(size_t(4), batch_count);
+  check_ids(1000);
+  ASSERT_EQ(int64_t(500), source.committed().offsets.at(0));
+  ASSERT_EQ(int64_t(500), source.committed().offsets.at(1));
+  ASSERT_EQ(ingestor->get_checkpoint().epoch, source.committed().epoch);
+  boost::filesystem::remove(ingestor->get_checkpoint_path());
+}
+
+TEST_F(StreamIngestTest, NoDuplicatesAfterLostOffsets) {
+  InProcessStreamSource source(2);
+  produce(source, 0, 900);
+  std::string checkpoint_path;
+  Importer_NS::StreamCheckpoint first_checkpoint;
+  {
+    auto ingestor = makeIngestor(source);
+    ingestor->recover();
+    ASSERT_EQ(size_t(300), ingestor->ingestMicroBatch().rows_completed);
+    first_checkpoint = ingestor->get_checkpoint();
+    ASSERT_EQ(size_t(300), ingestor->ingestMicroBatch().rows_completed);
+    checkpoint_path = ingestor->get_checkpoint_path();
+  }
+  // the second batch is in the table, but the server went down
+  // before the offsets recorded with its epoch hit the disk
+  Importer_NS::StreamIngestor::writeCheckpoint(checkpoint_path, first_checkpoint);
+  InProcessStreamSource restarted_source(2);
+  produce(restarted_source, 0, 900);
+  auto ingestor = makeIngestor(restarted_source);
+  ingestor->recover();
+  check_ids(300);
+  while (ingestor->ingestMicroBatch().rows_completed > 0) {
+  }
+  check_ids(900);
+  boost::filesystem::remove(checkpoint_path);
+}
+
+TEST_F(StreamIngestTest, NoDuplicatesAfterLostFirstOffsets) {
+  InProcessStreamSource source(2);
+  produce(source, 0, 600);
+  std::string checkpoint_path;
+  Importer_NS::StreamCheckpoint initial_checkpoint;
+  {
+    auto ingestor = makeIngestor(source);
+    ingestor->recover();
+    initial_checkpoint = ingestor->get_checkpoint();
+    ASSERT_EQ(size_t(2), initial_checkpoint.offsets.size());
+    ASSERT_EQ(initial_checkpoint.epoch,
+              Importer_NS::StreamIngestor::readCheckpoint(ingestor->get_checkpoint_path())
+                  .epoch);
+    ASSERT_EQ(size_t(300), ingestor->ingestMicroBatch().rows_completed);
+    checkpoint_path = ingestor->get_checkpoint_path();
+  }
+  // the first batch is in the table, its offsets never hit the disk
+  Importer_NS::StreamIngestor::writeCheckpoint(checkpoint_path, initial_checkpoint);
+  InProcessStreamSource restarted_source(2);
+  produce(restarted_source, 0, 600);
+  auto ingestor = makeIngestor(restarted_source);
+  ingestor->recover();
+  auto rows = run_query("SELECT COUNT(*) FROM stream_t;");
+  auto crt_row = rows->getNextRow(true, true);
+  ASSERT_EQ(int64_t(0), v<int64_t>(crt_row[0]));
+  while (ingestor->ingestMicroBatch().rows_completed > 0) {
+  }
+  check_ids(600);
+  boost::filesystem::remove(checkpoint_path);
+}
+
 // don't use R"()" format; somehow it causes many blank lines
 // to be output on console. how come?
 const char* create_table_trips =
@@ -22,6 +22,7 @@
  * Copyright (c) 2016 MapD Technologies, Inc.  All rights reserved.
  */
 #include "ProfileTest.h"
+#include "../QueryEngine/HashJoinRuntime.h"
 #include "../QueryEngine/ResultRows.h"
 #include "../QueryEngine/ResultSet.h"
 #include "Shared/measure.h"
@@ -36,7 +37,9 @@
 
 #include <algorithm>
 #include <future>
+#include <numeric>
 #include <random>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -1146,6 +1149,67 @@ TEST(Hash, Baseline) {
   }
 }
 
+TEST(Hash, PerfectJoinBuild) {
+  // Compares the row by row one-to-one hash join build with the radix partitioned
+  // build picked above g_partitioned_hash_build_threshold on shuffled unique keys.
+  const int32_t thread_count = cpu_threads();
+  const int32_t invalid_slot_val{-1};
+  std::mt19937 gen(42);
+  for (const size_t row_count : {size_t(1) << 20,
+                                 size_t(1) << 22,
+                                 size_t(1) << 24,
+                                 size_t(1) << 26}) {
+    std::vector<int32_t> keys(row_count);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), gen);
+    const JoinColumn join_column{reinterpret_cast<const int8_t*>(&keys[0]), row_count};
+    const JoinColumnTypeInfo type_info{sizeof(int32_t), 0, NULL_INT, false, 0, false};
+    std::vector<int32_t> buff(row_count);
+    std::vector<int32_t> partitioned_buff(row_count);
+    const auto row_by_row_ms = measure<>::execution([&]() {
+      std::vector<std::thread> threads;
+      for (int32_t i = 0; i < thread_count; ++i) {
+        threads.emplace_back([&, i] {
+          init_hash_join_buff(&buff[0], row_count, invalid_slot_val, i, thread_count);
+        });
+      }
+      for (auto& t : threads) {
+        t.join();
+      }
+      threads.clear();
+      for (int32_t i = 0; i < thread_count; ++i) {
+        threads.emplace_back([&, i] {
+          fill_hash_join_buff(&buff[0],
+                              invalid_slot_val,
+                              join_column,
+                              type_info,
+                              nullptr,
+                              nullptr,
+                              i,
+                              thread_count);
+        });
+      }
+      for (auto& t : threads) {
+        t.join();
+      }
+    });
+    const auto partitioned_ms = measure<>::execution([&]() {
+      fill_hash_join_buff_partitioned(&partitioned_buff[0],
+                                      row_count,
+                                      invalid_slot_val,
+                                      join_column,
+                                      type_info,
+                                      nullptr,
+                                      nullptr,
+                                      thread_count);
+    });
+    std::cout << "Building a " << row_count << " entry join hash table took "
+              << row_by_row_ms << " ms row by row and " << partitioned_ms
+              << " ms partitioned on " << thread_count << " threads.\n";
+    ASSERT_EQ(buff, partitioned_buff);
+  }
+}
+
 namespace {
 
 template <typename KeyT = int64_t>
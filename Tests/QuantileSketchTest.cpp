@@ -0,0 +1,114 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../QueryEngine/QuantileSketch.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Fraction of the values which are smaller than the estimate, to be compared
+// against the requested quantile.
+double rank_of(const std::vector<double>& sorted_values, const double estimate) {
+  return static_cast<double>(std::lower_bound(sorted_values.begin(),
+                                              sorted_values.end(),
+                                              estimate) -
+                             sorted_values.begin()) /
+         sorted_values.size();
+}
+
+std::vector<double> random_values(const size_t count, const unsigned seed) {
+  std::mt19937 gen(seed);
+  std::lognormal_distribution<double> dist(0, 2);
+  std::vector<double> values;
+  for (size_t i = 0; i < count; ++i) {
+    values.push_back(dist(gen));
+  }
+  return values;
+}
+
+}  // namespace
+
+TEST(QuantileSketch, Empty) {
+  QuantileSketch sketch(0.5);
+  ASSERT_TRUE(sketch.empty());
+  ASSERT_TRUE(std::isnan(sketch.quantile()));
+}
+
+TEST(QuantileSketch, Small) {
+  const std::vector<double> values{3, 1, 2};
+  QuantileSketch median(0.5);
+  QuantileSketch min(0);
+  QuantileSketch max(1);
+  for (const auto value : values) {
+    median.add(value);
+    min.add(value);
+    max.add(value);
+  }
+  ASSERT_DOUBLE_EQ(2, median.quantile());
+  ASSERT_DOUBLE_EQ(1, min.quantile());
+  ASSERT_DOUBLE_EQ(3, max.quantile());
+}
+
+TEST(QuantileSketch, Accuracy) {
+  auto values = random_values(1000000, 1);
+  const std::vector<double> quantiles{0, 0.001, 0.01, 0.25, 0.5, 0.75, 0.99, 0.999, 1};
+  std::vector<QuantileSketch> sketches;
+  for (const auto q : quantiles) {
+    sketches.emplace_back(q);
+  }
+  for (const auto value : values) {
+    for (auto& sketch : sketches) {
+      sketch.add(value);
+    }
+  }
+  std::sort(values.begin(), values.end());
+  for (auto& sketch : sketches) {
+    sketch.compress();
+    ASSERT_LE(sketch.centroidCount(), size_t(QuantileSketch::compression));
+    const auto q = sketch.getQuantileParam();
+    // the error shrinks towards the tails
+    ASSERT_NEAR(q, rank_of(values, sketch.quantile()), 0.002 + 0.02 * q * (1 - q));
+  }
+  ASSERT_DOUBLE_EQ(values.front(), sketches.front().quantile());
+  ASSERT_DOUBLE_EQ(values.back(), sketches.back().quantile());
+}
+
+TEST(QuantileSketch, Merge) {
+  std::vector<double> values;
+  QuantileSketch merged(0.9);
+  for (unsigned seed = 2; seed < 10; ++seed) {
+    const auto part = random_values(seed * 10000, seed);
+    QuantileSketch sketch(0.9);
+    for (const auto value : part) {
+      sketch.add(value);
+    }
+    merged.merge(sketch);
+    values.insert(values.end(), part.begin(), part.end());
+  }
+  ASSERT_LE(merged.centroidCount(), size_t(QuantileSketch::compression));
+  std::sort(values.begin(), values.end());
+  ASSERT_NEAR(0.9, rank_of(values, merged.quantile()), 0.005);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
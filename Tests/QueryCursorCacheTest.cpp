@@ -0,0 +1,171 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../ThriftHandler/QueryCursorCache.h"
+#include "../QueryEngine/ResultSet.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+std::shared_ptr<QueryCursorCache::Cursor> make_cursor(const size_t row_count = 0) {
+  std::vector<QueryCursorCache::Row> rows;
+  for (size_t i = 0; i < row_count; ++i) {
+    rows.push_back({ScalarTargetValue(static_cast<int64_t>(i))});
+  }
+  const std::vector<TargetMetaInfo> targets{
+      TargetMetaInfo("x", SQLTypeInfo(kBIGINT, false))};
+  return std::make_shared<QueryCursorCache::Cursor>(std::move(rows), targets);
+}
+
+std::shared_ptr<QueryCursorCache::Cursor> make_table_cursor() {
+  const std::vector<TargetMetaInfo> targets{
+      TargetMetaInfo("x", SQLTypeInfo(kBIGINT, false))};
+  return std::make_shared<QueryCursorCache::Cursor>(
+      std::make_shared<ResultSet>(""),
+      std::vector<size_t>{},
+      targets,
+      std::map<std::string, bool>{{"t", false}},
+      std::vector<TableEpochInfo>{{1, 1, 1}});
+}
+
+std::vector<int64_t> read_page(const QueryCursorCache::Page& page) {
+  std::vector<int64_t> values;
+  while (true) {
+    const auto crt_row = page.getNextRow(true, true);
+    if (crt_row.empty()) {
+      break;
+    }
+    EXPECT_EQ(page.colCount(), crt_row.size());
+    const auto scalar = boost::get<ScalarTargetValue>(&crt_row[0]);
+    values.push_back(*boost::get<int64_t>(scalar));
+  }
+  return values;
+}
+
+const std::chrono::milliseconds long_ttl{std::chrono::hours(1)};
+
+}  // namespace
+
+TEST(QueryCursorCache, GetAndErase) {
+  QueryCursorCache cache(1 << 20, long_ttl);
+  const auto cursor = make_cursor();
+  const auto cursor_id = cache.put("session", cursor, 100);
+  ASSERT_EQ(cursor, cache.get("session", cursor_id));
+  ASSERT_EQ(nullptr, cache.get("session", cursor_id + 1));
+  ASSERT_EQ(size_t(1), cache.size());
+  ASSERT_EQ(size_t(100), cache.bytes());
+  ASSERT_TRUE(cache.erase("session", cursor_id));
+  ASSERT_FALSE(cache.erase("session", cursor_id));
+  ASSERT_EQ(nullptr, cache.get("session", cursor_id));
+  ASSERT_EQ(size_t(0), cache.bytes());
+}
+
+TEST(QueryCursorCache, OwnedBySession) {
+  QueryCursorCache cache(1 << 20, long_ttl);
+  const auto cursor_id = cache.put("session", make_cursor(), 100);
+  const auto other_cursor_id = cache.put("other_session", make_cursor(), 100);
+  ASSERT_NE(cursor_id, other_cursor_id);
+  ASSERT_EQ(nullptr, cache.get("other_session", cursor_id));
+  ASSERT_FALSE(cache.erase("other_session", cursor_id));
+  cache.eraseSession("session");
+  ASSERT_EQ(nullptr, cache.get("session", cursor_id));
+  ASSERT_NE(nullptr, cache.get("other_session", other_cursor_id));
+}
+
+TEST(QueryCursorCache, EraseTableCursors) {
+  QueryCursorCache cache(1 << 20, long_ttl);
+  const auto cursor_id = cache.put("session", make_cursor(), 100);
+  const auto table_cursor_id = cache.put("session", make_table_cursor(), 100);
+  cache.eraseTableCursors();
+  ASSERT_NE(nullptr, cache.get("session", cursor_id));
+  ASSERT_EQ(nullptr, cache.get("session", table_cursor_id));
+  ASSERT_EQ(size_t(100), cache.bytes());
+}
+
+TEST(QueryCursorCache, Expire) {
+  QueryCursorCache cache(1 << 20, std::chrono::milliseconds(50));
+  const auto cursor_id = cache.put("session", make_cursor(), 100);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  ASSERT_EQ(nullptr, cache.get("session", cursor_id));
+  ASSERT_EQ(size_t(0), cache.size());
+}
+
+TEST(QueryCursorCache, SweepExpired) {
+  QueryCursorCache cache(1 << 20, std::chrono::milliseconds(50));
+  cache.put("session", make_cursor(), 100);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  // closed without any other access to the cache
+  ASSERT_EQ(size_t(0), cache.size());
+  ASSERT_EQ(size_t(0), cache.bytes());
+}
+
+TEST(QueryCursorCache, CloseLeastRecentlyRead) {
+  QueryCursorCache cache(250, long_ttl);
+  const auto first_cursor_id = cache.put("session", make_cursor(), 100);
+  const auto second_cursor_id = cache.put("session", make_cursor(), 100);
+  ASSERT_NE(nullptr, cache.get("session", first_cursor_id));
+  const auto third_cursor_id = cache.put("session", make_cursor(), 100);
+  ASSERT_NE(nullptr, cache.get("session", first_cursor_id));
+  ASSERT_EQ(nullptr, cache.get("session", second_cursor_id));
+  ASSERT_NE(nullptr, cache.get("session", third_cursor_id));
+  ASSERT_EQ(size_t(200), cache.bytes());
+}
+
+TEST(QueryCursorCache, TooLarge) {
+  QueryCursorCache cache(64, long_ttl);
+  const auto cursor_id = cache.put("session", make_cursor(), 64);
+  ASSERT_THROW(cache.put("session", make_cursor(), 65), std::runtime_error);
+  ASSERT_NE(nullptr, cache.get("session", cursor_id));
+}
+
+TEST(QueryCursorCache, Pages) {
+  const auto cursor = make_cursor(10);
+  ASSERT_EQ(std::vector<int64_t>({0, 1, 2}),
+            read_page(QueryCursorCache::Page(*cursor, 0, 3)));
+  ASSERT_EQ(std::vector<int64_t>({7, 8, 9}),
+            read_page(QueryCursorCache::Page(*cursor, 7, 5)));
+  // earlier offsets are read directly, without going through the rows before
+  ASSERT_EQ(std::vector<int64_t>({4, 5}),
+            read_page(QueryCursorCache::Page(*cursor, 4, 2)));
+  ASSERT_TRUE(read_page(QueryCursorCache::Page(*cursor, 10, 2)).empty());
+  ASSERT_TRUE(read_page(QueryCursorCache::Page(*cursor, 20, 2)).empty());
+  ASSERT_TRUE(read_page(QueryCursorCache::Page(*cursor, 3, 0)).empty());
+}
+
+TEST(QueryCursorCache, EstimateSize) {
+  const QueryCursorCache::Row int_row{ScalarTargetValue(int64_t(1))};
+  const QueryCursorCache::Row str_row{
+      ScalarTargetValue(NullableString(std::string(1000, 'a')))};
+  ASSERT_GE(QueryCursorCache::estimateSize(str_row),
+            QueryCursorCache::estimateSize(int_row) + 1000);
+  const QueryCursorCache::Row arr_row{
+      std::vector<ScalarTargetValue>(100, ScalarTargetValue(int64_t(1)))};
+  ASSERT_GE(QueryCursorCache::estimateSize(arr_row),
+            QueryCursorCache::estimateSize(int_row) + 99 * sizeof(ScalarTargetValue));
+  const QueryCursorCache::Row geo_row{
+      GeoTargetValue(GeoLineStringTargetValue(std::vector<double>(100, 1.)))};
+  ASSERT_GE(QueryCursorCache::estimateSize(geo_row),
+            QueryCursorCache::estimateSize(int_row) + 100 * sizeof(double));
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
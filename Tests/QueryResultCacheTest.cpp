@@ -0,0 +1,132 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../ThriftHandler/QueryResultCache.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TQueryResult make_result(const size_t row_count) {
+  TQueryResult result;
+  result.row_set.is_columnar = true;
+  TColumn col;
+  for (size_t i = 0; i < row_count; ++i) {
+    col.data.int_col.push_back(i);
+    col.nulls.push_back(false);
+  }
+  result.row_set.columns.push_back(col);
+  return result;
+}
+
+const std::vector<TableEpochInfo> table_epochs{{1, 2, 3}};
+
+}  // namespace
+
+TEST(QueryResultCache, HitAndMiss) {
+  QueryResultCache cache(1 << 20);
+  const auto key = QueryResultCache::makeKey("ra", table_epochs, true, -1, -1);
+  TQueryResult result;
+  ASSERT_FALSE(cache.get(key, result));
+  cache.put(key, table_epochs, make_result(10), cache.getGeneration());
+  ASSERT_TRUE(cache.get(key, result));
+  ASSERT_EQ(size_t(10), result.row_set.columns.front().data.int_col.size());
+  const auto stats = cache.getStats();
+  ASSERT_EQ(1, stats.hits);
+  ASSERT_EQ(1, stats.misses);
+  ASSERT_EQ(1, stats.entries);
+}
+
+TEST(QueryResultCache, HitKeepsCallerTimings) {
+  QueryResultCache cache(1 << 20);
+  const auto key = QueryResultCache::makeKey("ra", table_epochs, true, -1, -1);
+  auto executed = make_result(10);
+  executed.execution_time_ms = 1000;
+  executed.total_time_ms = 1500;
+  cache.put(key, table_epochs, executed, cache.getGeneration());
+  TQueryResult result;
+  result.execution_time_ms = 1;
+  ASSERT_TRUE(cache.get(key, result));
+  ASSERT_EQ(1, result.execution_time_ms);
+  ASSERT_EQ(0, result.total_time_ms);
+}
+
+TEST(QueryResultCache, KeyedByEpoch) {
+  QueryResultCache cache(1 << 20);
+  cache.put(QueryResultCache::makeKey("ra", table_epochs, true, -1, -1),
+            table_epochs,
+            make_result(10),
+            cache.getGeneration());
+  const std::vector<TableEpochInfo> next_epochs{{1, 2, 4}};
+  TQueryResult result;
+  ASSERT_FALSE(
+      cache.get(QueryResultCache::makeKey("ra", next_epochs, true, -1, -1), result));
+  ASSERT_FALSE(
+      cache.get(QueryResultCache::makeKey("ra", table_epochs, false, -1, -1), result));
+}
+
+TEST(QueryResultCache, Invalidate) {
+  QueryResultCache cache(1 << 20);
+  const auto key = QueryResultCache::makeKey("ra", table_epochs, true, -1, -1);
+  const auto generation = cache.getGeneration();
+  cache.put(key, table_epochs, make_result(10), generation);
+  cache.invalidateTable(1, 5);
+  TQueryResult result;
+  ASSERT_TRUE(cache.get(key, result));
+  cache.invalidateTable(1, 2);
+  ASSERT_FALSE(cache.get(key, result));
+  // results computed before the invalidation must not make it in
+  cache.put(key, table_epochs, make_result(10), generation);
+  ASSERT_FALSE(cache.get(key, result));
+  cache.put(key, table_epochs, make_result(10), cache.getGeneration());
+  cache.invalidateDatabase(1);
+  ASSERT_FALSE(cache.get(key, result));
+  ASSERT_EQ(0, cache.getStats().bytes);
+}
+
+TEST(QueryResultCache, EvictLeastRecentlyUsed) {
+  const auto entry_bytes = QueryResultCache::estimateSize(make_result(1000));
+  QueryResultCache cache(entry_bytes * 2 + entry_bytes / 2);
+  std::vector<std::string> keys;
+  for (const auto ra : {"ra0", "ra1", "ra2"}) {
+    keys.push_back(QueryResultCache::makeKey(ra, table_epochs, true, -1, -1));
+  }
+  TQueryResult result;
+  cache.put(keys[0], table_epochs, make_result(1000), cache.getGeneration());
+  cache.put(keys[1], table_epochs, make_result(1000), cache.getGeneration());
+  ASSERT_TRUE(cache.get(keys[0], result));
+  cache.put(keys[2], table_epochs, make_result(1000), cache.getGeneration());
+  ASSERT_TRUE(cache.get(keys[0], result));
+  ASSERT_FALSE(cache.get(keys[1], result));
+  ASSERT_TRUE(cache.get(keys[2], result));
+  const auto stats = cache.getStats();
+  ASSERT_EQ(1, stats.evictions);
+  ASSERT_EQ(2, stats.entries);
+  ASSERT_LE(stats.bytes, static_cast<int64_t>(entry_bytes * 2 + entry_bytes / 2));
+}
+
+TEST(QueryResultCache, TooLarge) {
+  QueryResultCache cache(64);
+  const auto key = QueryResultCache::makeKey("ra", table_epochs, true, -1, -1);
+  cache.put(key, table_epochs, make_result(1000), cache.getGeneration());
+  TQueryResult result;
+  ASSERT_FALSE(cache.get(key, result));
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -23,9 +23,11 @@
  */
 #include "ResultSetTestUtils.h"
 
+#include "../QueryEngine/ColumnarResults.h"
 #include "../QueryEngine/ResultRows.h"
 #include "../QueryEngine/ResultSet.h"
 #include "../QueryEngine/RuntimeFunctions.h"
+#include "../Shared/scope.h"
 #include "../StringDictionary/StringDictionary.h"
 
 #include <glog/logging.h>
@@ -36,6 +38,8 @@
 #include <queue>
 #include <random>
 
+extern size_t g_reduction_spill_threshold;
+
 TEST(Construct, Allocate) {
   std::vector<TargetInfo> target_infos;
   QueryMemoryDescriptor query_mem_desc;
@@ -2001,6 +2005,40 @@ TEST(Iterate, BaselineHashColumnar) {
   test_iterate(target_infos, query_mem_desc);
 }
 
+TEST(Iterate, RowEntryIndices) {
+  const auto target_infos = generate_test_target_infos();
+  const auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 99);
+  auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>();
+  StringDictionaryProxy* sdp =
+      row_set_mem_owner->addStringDict(g_sd, 1, g_sd->storageEntryCount());
+  ResultSet result_set(
+      target_infos, ExecutorDeviceType::CPU, query_mem_desc, row_set_mem_owner, nullptr);
+  for (size_t i = 0; i < query_mem_desc.getEntryCount(); ++i) {
+    sdp->getOrAddTransient(std::to_string(i));
+  }
+  const auto storage = result_set.allocateStorage();
+  EvenNumberGenerator generator;
+  // every other entry is empty
+  fill_storage_buffer(
+      storage->getUnderlyingBuffer(), target_infos, query_mem_desc, generator, 2);
+  result_set.dropFirstN(3);
+  result_set.keepFirstN(5);
+  const auto entry_indices = result_set.getRowEntryIndices();
+  ASSERT_EQ(size_t(5), entry_indices.size());
+  // read backwards, the first three rows are dropped
+  for (size_t i = entry_indices.size(); i > 0; --i) {
+    const auto row = result_set.getRowAtEntry(entry_indices[i - 1], true, false);
+    ASSERT_EQ(target_infos.size(), row.size());
+    ASSERT_EQ(static_cast<int64_t>(2 * (3 + i - 1)), v<int64_t>(row[0]));
+  }
+  for (const auto entry_idx : entry_indices) {
+    const auto row = result_set.getNextRow(true, false);
+    ASSERT_EQ(v<int64_t>(row[0]),
+              v<int64_t>(result_set.getRowAtEntry(entry_idx, true, false)[0]));
+  }
+  ASSERT_TRUE(result_set.getNextRow(true, false).empty());
+}
+
 TEST(Reduce, PerfectHashOneCol) {
   const auto target_infos = generate_test_target_infos();
   const auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 99);
@@ -2170,6 +2208,308 @@ TEST(Reduce, BaselineHashColumnar) {
   test_reduce(target_infos, query_mem_desc, generator1, generator2, 1);
 }
 
+TEST(Reduce, BaselineHashRadixPartitioned) {
+  const auto target_infos = generate_test_target_infos();
+  auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  // big enough for the reduced buffer to go through the partitioned reduction
+  query_mem_desc.setEntryCount(1 << 19);
+  EvenNumberGenerator generator1;
+  ReverseOddOrEvenNumberGenerator generator2(2 * query_mem_desc.getEntryCount() - 1);
+  test_reduce(target_infos, query_mem_desc, generator1, generator2, 1);
+}
+
+TEST(Reduce, BaselineHashScattered) {
+  const auto target_infos = generate_test_target_infos();
+  auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  query_mem_desc.setEntryCount(1 << 12);
+  query_mem_desc.setScattersPartialAggregates(true);
+  const auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>();
+  row_set_mem_owner->addStringDict(g_sd, 1, g_sd->storageEntryCount());
+  const auto rs = boost::make_unique<ResultSet>(
+      target_infos, ExecutorDeviceType::CPU, query_mem_desc, row_set_mem_owner, nullptr);
+  const auto storage = rs->allocateStorage();
+  const auto i64_buff = reinterpret_cast<int64_t*>(storage->getUnderlyingBuffer());
+  const auto key_count = query_mem_desc.getKeyCount();
+  const auto target_slot_count = get_slot_count(target_infos);
+  std::fill(i64_buff,
+            i64_buff + query_mem_desc.getEntryCount() * (key_count + target_slot_count),
+            EMPTY_KEY_64);
+  // every group gets two entries, a kernel would leave the last ones empty
+  const size_t group_count{1000};
+  for (size_t i = 0; i < 2 * group_count; ++i) {
+    const int64_t val = i % group_count;
+    const std::vector<int64_t> key(key_count, val);
+    auto value_slots = get_scatter_group_value(i64_buff,
+                                               query_mem_desc.getEntryCount(),
+                                               i,
+                                               &key[0],
+                                               key.size(),
+                                               sizeof(int64_t),
+                                               key_count + target_slot_count);
+    ASSERT_TRUE(value_slots);
+    fill_one_entry_baseline(value_slots, val, target_infos);
+  }
+  ResultSetManager rs_manager;
+  std::vector<ResultSet*> storage_set{rs.get()};
+  auto result_rs = rs_manager.reduce(storage_set);
+  ASSERT_NE(rs.get(), result_rs);
+  ASSERT_FALSE(result_rs->getQueryMemDesc().scattersPartialAggregates());
+  ASSERT_EQ(group_count, result_rs->rowCount());
+  std::list<Analyzer::OrderEntry> order_entries;
+  order_entries.emplace_back(1, false, false);
+  result_rs->sort(order_entries, 0);
+  for (int64_t ref_val = 0; ref_val < static_cast<int64_t>(group_count); ++ref_val) {
+    const auto row = result_rs->getNextRow(false, false);
+    ASSERT_EQ(target_infos.size(), row.size());
+    ASSERT_EQ(ref_val, v<int64_t>(row[0]));
+    ASSERT_TRUE(approx_eq(static_cast<double>(ref_val), v<double>(row[1])));
+    ASSERT_EQ(2 * ref_val, v<int64_t>(row[2]));
+  }
+  ASSERT_TRUE(result_rs->getNextRow(false, false).empty());
+}
+
+TEST(Reduce, BaselineHashSpilled) {
+  const auto target_infos = generate_test_target_infos();
+  auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  query_mem_desc.setEntryCount(1 << 12);
+  const auto spill_threshold = g_reduction_spill_threshold;
+  ScopeGuard reset_spill_threshold = [spill_threshold] {
+    g_reduction_spill_threshold = spill_threshold;
+  };
+  g_reduction_spill_threshold = 1;
+  EvenNumberGenerator generator1;
+  ReverseOddOrEvenNumberGenerator generator2(2 * query_mem_desc.getEntryCount() - 1);
+  test_reduce(target_infos, query_mem_desc, generator1, generator2, 1);
+}
+
+TEST(Reduce, BaselineHashSpilledTopN) {
+  const auto target_infos = generate_test_target_infos();
+  auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  query_mem_desc.setEntryCount(1 << 12);
+  const auto spill_threshold = g_reduction_spill_threshold;
+  ScopeGuard reset_spill_threshold = [spill_threshold] {
+    g_reduction_spill_threshold = spill_threshold;
+  };
+  const auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>();
+  row_set_mem_owner->addStringDict(g_sd, 1, g_sd->storageEntryCount());
+  const auto make_input = [&](NumberGenerator& generator) {
+    auto rs = boost::make_unique<ResultSet>(target_infos,
+                                            ExecutorDeviceType::CPU,
+                                            query_mem_desc,
+                                            row_set_mem_owner,
+                                            nullptr);
+    const auto storage = rs->allocateStorage();
+    fill_storage_buffer(
+        storage->getUnderlyingBuffer(), target_infos, query_mem_desc, generator, 1);
+    return rs;
+  };
+  EvenNumberGenerator generator1;
+  ReverseOddOrEvenNumberGenerator generator2(2 * query_mem_desc.getEntryCount() - 1);
+  std::list<Analyzer::OrderEntry> order_entries;
+  order_entries.emplace_back(1, false, false);
+  {
+    // a threshold of 0 never spills, the inputs stay as they are
+    g_reduction_spill_threshold = 0;
+    const auto rs1 = make_input(generator1);
+    const auto rs2 = make_input(generator2);
+    ResultSetManager rs_manager;
+    std::vector<ResultSet*> storage_set{rs1.get(), rs2.get()};
+    rs_manager.reduce(storage_set, order_entries, 10);
+    ASSERT_TRUE(rs1->getStorage());
+    ASSERT_TRUE(rs2->getStorage());
+  }
+  generator1.reset();
+  generator2.reset();
+  g_reduction_spill_threshold = 1;
+  const auto rs1 = make_input(generator1);
+  const auto rs2 = make_input(generator2);
+  ResultSetManager rs_manager;
+  std::vector<ResultSet*> storage_set{rs1.get(), rs2.get()};
+  auto result_rs = rs_manager.reduce(storage_set, order_entries, 10);
+  // the inputs are freed once spilled
+  ASSERT_FALSE(rs1->getStorage());
+  ASSERT_FALSE(rs2->getStorage());
+  // only the first 10 groups of the partition made it to the result
+  ASSERT_EQ(size_t(32), result_rs->entryCount());
+  result_rs->sort(order_entries, 10);
+  for (int64_t ref_val = 0; ref_val < 10; ++ref_val) {
+    const auto row = result_rs->getNextRow(false, false);
+    ASSERT_EQ(target_infos.size(), row.size());
+    ASSERT_EQ(ref_val, v<int64_t>(row[0]));
+  }
+  ASSERT_TRUE(result_rs->getNextRow(false, false).empty());
+}
+
+TEST(Reduce, BaselineHashSpilledFreesKernelBuffers) {
+  const auto target_infos = generate_test_target_infos();
+  auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  query_mem_desc.setEntryCount(1 << 12);
+  const auto spill_threshold = g_reduction_spill_threshold;
+  ScopeGuard reset_spill_threshold = [spill_threshold] {
+    g_reduction_spill_threshold = spill_threshold;
+  };
+  g_reduction_spill_threshold = 1;
+  const auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>();
+  row_set_mem_owner->addStringDict(g_sd, 1, g_sd->storageEntryCount());
+  const auto buffer_bytes = query_mem_desc.getBufferSizeBytes(ExecutorDeviceType::CPU);
+  // the first two buffers belong to the row set memory owner, like kernel outputs,
+  // the last one to the test
+  std::vector<int64_t> test_buffer(buffer_bytes / sizeof(int64_t));
+  std::vector<std::unique_ptr<ResultSet>> inputs;
+  EvenNumberGenerator generator1;
+  ReverseOddOrEvenNumberGenerator generator2(2 * query_mem_desc.getEntryCount() - 1);
+  EvenNumberGenerator generator3;
+  for (NumberGenerator* generator :
+       std::vector<NumberGenerator*>{&generator1, &generator2, &generator3}) {
+    auto buff = reinterpret_cast<int8_t*>(&test_buffer[0]);
+    if (inputs.size() < 2) {
+      buff = static_cast<int8_t*>(checked_malloc(buffer_bytes));
+      row_set_mem_owner->addGroupByBuffer(reinterpret_cast<int64_t*>(buff));
+    }
+    inputs.emplace_back(new ResultSet(target_infos,
+                                      ExecutorDeviceType::CPU,
+                                      query_mem_desc,
+                                      row_set_mem_owner,
+                                      nullptr));
+    inputs.back()->allocateStorage(buff, {});
+    fill_storage_buffer(buff, target_infos, query_mem_desc, *generator, 1);
+  }
+  ResultSetManager rs_manager;
+  std::vector<ResultSet*> storage_set{inputs[0].get(), inputs[1].get(), inputs[2].get()};
+  auto result_rs = rs_manager.reduce(storage_set);
+  ASSERT_FALSE(inputs[0]->getStorage());
+  ASSERT_FALSE(inputs[1]->getStorage());
+  ASSERT_TRUE(inputs[2]->getStorage());
+  ASSERT_EQ(reinterpret_cast<int8_t*>(&test_buffer[0]),
+            inputs[2]->getStorage()->getUnderlyingBuffer());
+  // the keys of the first two buffers are distinct, the third repeats the first
+  ASSERT_EQ(2 * query_mem_desc.getEntryCount(), result_rs->rowCount());
+}
+
+namespace {
+
+// Sorts a perfect hash result of a not null BIGINT, which holds the smallest and the
+// largest 64-bit values, a nullable INT and a nullable DOUBLE on their normalized keys
+// and checks that the rows come out in the order of order_entries.
+void test_sort_normalized_keys(const size_t entry_count,
+                               const std::list<Analyzer::OrderEntry>& order_entries) {
+  SQLTypeInfo bigint_ti(kBIGINT, true);
+  SQLTypeInfo int_ti(kINT, false);
+  SQLTypeInfo double_ti(kDOUBLE, false);
+  SQLTypeInfo null_ti(kNULLT, false);
+  const std::vector<TargetInfo> target_infos{
+      TargetInfo{false, kMIN, bigint_ti, null_ti, true, false},
+      TargetInfo{false, kMIN, int_ti, null_ti, true, false},
+      TargetInfo{false, kMIN, double_ti, null_ti, true, false}};
+  const auto query_mem_desc =
+      perfect_hash_one_col_desc(target_infos, 8, 0, entry_count - 1);
+  const auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>();
+  ResultSet rs(target_infos,
+               ExecutorDeviceType::CPU,
+               query_mem_desc,
+               row_set_mem_owner,
+               nullptr);
+  const auto storage = rs.allocateStorage();
+  const auto buff = storage->getUnderlyingBuffer();
+  EvenNumberGenerator generator;
+  fill_storage_buffer(buff, target_infos, query_mem_desc, generator, 1);
+  const std::vector<int64_t> bigint_vals{std::numeric_limits<int64_t>::min(),
+                                         -1,
+                                         0,
+                                         1,
+                                         std::numeric_limits<int64_t>::max()};
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<int64_t> dist(0, 9);
+  // every other entry is filled, see fill_storage_buffer_perfect_hash_rowwise
+  for (size_t i = 0; i < entry_count; i += 2) {
+    const auto slot = [buff, &query_mem_desc, i](const size_t target_idx) {
+      return reinterpret_cast<int64_t*>(buff +
+                                        query_mem_desc.getColOffInBytes(i, target_idx));
+    };
+    *slot(0) = bigint_vals[dist(gen) % bigint_vals.size()];
+    const auto int_val = dist(gen);
+    *slot(1) = int_val < 2 ? NULL_INT : int_val - 5;
+    const auto fp_val = dist(gen);
+    const double dval = fp_val < 2 ? NULL_DOUBLE : (fp_val - 5) * 0.5;
+    memcpy(slot(2), &dval, sizeof(dval));
+  }
+  rs.sort(order_entries, 0);
+  std::vector<OneRow> rows;
+  while (true) {
+    const auto row = rs.getNextRow(false, false);
+    if (row.empty()) {
+      break;
+    }
+    rows.push_back(row);
+  }
+  ASSERT_EQ(entry_count / 2, rows.size());
+  // -1, 0 or 1 as lhs comes before, ties with or comes after rhs on order_entry
+  const auto compare = [](const OneRow& lhs,
+                          const OneRow& rhs,
+                          const Analyzer::OrderEntry& order_entry) {
+    const size_t target_idx = order_entry.tle_no - 1;
+    bool lhs_is_null{false};
+    bool rhs_is_null{false};
+    int cmp{0};
+    if (target_idx == 2) {
+      const auto lhs_val = v<double>(lhs[target_idx]);
+      const auto rhs_val = v<double>(rhs[target_idx]);
+      lhs_is_null = lhs_val == NULL_DOUBLE;
+      rhs_is_null = rhs_val == NULL_DOUBLE;
+      cmp = lhs_val < rhs_val ? -1 : lhs_val > rhs_val;
+    } else {
+      const auto lhs_val = v<int64_t>(lhs[target_idx]);
+      const auto rhs_val = v<int64_t>(rhs[target_idx]);
+      lhs_is_null = target_idx == 1 && lhs_val == NULL_INT;
+      rhs_is_null = target_idx == 1 && rhs_val == NULL_INT;
+      cmp = lhs_val < rhs_val ? -1 : lhs_val > rhs_val;
+    }
+    if (lhs_is_null || rhs_is_null) {
+      if (lhs_is_null == rhs_is_null) {
+        return 0;
+      }
+      return lhs_is_null == order_entry.nulls_first ? -1 : 1;
+    }
+    return order_entry.is_desc ? -cmp : cmp;
+  };
+  for (size_t i = 1; i < rows.size(); ++i) {
+    for (const auto& order_entry : order_entries) {
+      const auto cmp = compare(rows[i - 1], rows[i], order_entry);
+      ASSERT_LE(cmp, 0);
+      if (cmp) {
+        break;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(Sort, NormalizedKeys) {
+  std::list<Analyzer::OrderEntry> order_entries;
+  order_entries.emplace_back(1, false, false);
+  test_sort_normalized_keys(1 << 10, order_entries);
+  order_entries.clear();
+  order_entries.emplace_back(1, true, false);
+  order_entries.emplace_back(2, false, false);
+  order_entries.emplace_back(3, true, true);
+  test_sort_normalized_keys(1 << 10, order_entries);
+}
+
+TEST(Sort, NormalizedKeysParallel) {
+  // over 100000 entries, the keys are encoded and sorted in parallel
+  std::list<Analyzer::OrderEntry> order_entries;
+  order_entries.emplace_back(1, true, false);
+  order_entries.emplace_back(2, false, true);
+  order_entries.emplace_back(3, false, false);
+  test_sort_normalized_keys(1 << 18, order_entries);
+  order_entries.clear();
+  order_entries.emplace_back(3, true, true);
+  order_entries.emplace_back(2, true, false);
+  order_entries.emplace_back(1, false, false);
+  test_sort_normalized_keys(1 << 18, order_entries);
+}
+
 TEST(MoreReduce, MissingValues) {
   std::vector<TargetInfo> target_infos;
   SQLTypeInfo bigint_ti(kBIGINT, false);
@@ -2280,6 +2620,87 @@ TEST(MoreReduce, MissingValuesKeyless) {
   }
 }
 
+namespace {
+
+std::unique_ptr<ResultSet> make_projection_rs(
+    const std::vector<TargetInfo>& target_infos,
+    const size_t entry_count,
+    const int64_t first_val,
+    const std::shared_ptr<RowSetMemoryOwner>& row_set_mem_owner) {
+  QueryMemoryDescriptor query_mem_desc(GroupByColRangeType::Projection, 0, 0, false, {8});
+  for (size_t i = 0; i < target_infos.size(); ++i) {
+    query_mem_desc.addAggColWidth(ColWidths{8, 8});
+  }
+  query_mem_desc.setEntryCount(entry_count);
+  auto rs = boost::make_unique<ResultSet>(
+      target_infos, ExecutorDeviceType::CPU, query_mem_desc, row_set_mem_owner, nullptr);
+  const auto storage = rs->allocateStorage();
+  auto buff = reinterpret_cast<int64_t*>(storage->getUnderlyingBuffer());
+  const auto row_slots = target_infos.size() + 1;
+  for (size_t i = 0; i < entry_count; ++i) {
+    auto row = buff + i * row_slots;
+    const int64_t val = first_val + i;
+    // leave every fifth entry empty, every seventh value null
+    row[0] = i % 5 == 4 ? EMPTY_KEY_64 : i;
+    row[1] = i % 7 == 6 ? inline_int_null_val(target_infos[0].sql_type) : val;
+    row[2] = i % 7 == 6 ? inline_int_null_val(target_infos[1].sql_type) : -val;
+    const double dval = i % 7 == 6 ? NULL_DOUBLE : val * 0.5;
+    row[3] = *reinterpret_cast<const int64_t*>(may_alias_ptr(&dval));
+  }
+  return rs;
+}
+
+void check_columnarized_projection(const ResultSet& rs, const size_t expected_rows) {
+  ASSERT_TRUE(rs.isDirectColumnarConversionPossible());
+  const auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>();
+  std::vector<SQLTypeInfo> col_types;
+  for (size_t i = 0; i < rs.colCount(); ++i) {
+    col_types.push_back(rs.getColType(i));
+  }
+  ColumnarResults columnar(row_set_mem_owner, rs, rs.colCount(), col_types);
+  ASSERT_EQ(expected_rows, columnar.size());
+  const auto& cols = columnar.getColumnBuffers();
+  size_t row_idx = 0;
+  for (size_t entry_idx = 0; entry_idx < rs.entryCount(); ++entry_idx) {
+    const auto row = rs.getRowAtNoTranslations(entry_idx);
+    if (row.empty()) {
+      continue;
+    }
+    ASSERT_LT(row_idx, expected_rows);
+    ASSERT_EQ(v<int64_t>(row[0]), reinterpret_cast<const int64_t*>(cols[0])[row_idx]);
+    ASSERT_EQ(v<int64_t>(row[1]), reinterpret_cast<const int32_t*>(cols[1])[row_idx]);
+    ASSERT_EQ(v<double>(row[2]), reinterpret_cast<const double*>(cols[2])[row_idx]);
+    ++row_idx;
+  }
+  ASSERT_EQ(expected_rows, row_idx);
+}
+
+std::vector<TargetInfo> projection_target_infos() {
+  SQLTypeInfo null_ti(kNULLT, false);
+  return {TargetInfo{false, kMIN, SQLTypeInfo(kBIGINT, false), null_ti, false, false},
+          TargetInfo{false, kMIN, SQLTypeInfo(kINT, false), null_ti, false, false},
+          TargetInfo{false, kMIN, SQLTypeInfo(kDOUBLE, false), null_ti, false, false}};
+}
+
+}  // namespace
+
+TEST(Columnarize, ProjectionDirect) {
+  const auto target_infos = projection_target_infos();
+  const auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>();
+  const auto rs = make_projection_rs(target_infos, 100, 0, row_set_mem_owner);
+  check_columnarized_projection(*rs, 80);
+}
+
+TEST(Columnarize, ProjectionDirectParallelAppended) {
+  const auto target_infos = projection_target_infos();
+  const auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>();
+  const auto rs = make_projection_rs(target_infos, 50000, 0, row_set_mem_owner);
+  const auto rs_appended =
+      make_projection_rs(target_infos, 25000, 1000000, row_set_mem_owner);
+  rs->append(*rs_appended);
+  check_columnarized_projection(*rs, 60000);
+}
+
 /* FLOW #1: Perfect_Hash_Row_Based testcases */
 TEST(ReduceRandomGroups, PerfectHashOneCol_Small_2525) {
   const auto target_infos = generate_random_groups_target_infos();
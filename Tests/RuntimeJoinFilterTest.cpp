@@ -0,0 +1,114 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../QueryEngine/RuntimeJoinFilter.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+
+template <class T>
+RuntimeJoinFilter build_filter(const std::vector<T>& keys, const int thread_count) {
+  const JoinColumn join_column{reinterpret_cast<const int8_t*>(keys.data()),
+                               keys.size()};
+  const JoinColumnTypeInfo type_info{sizeof(T),
+                                     0,
+                                     std::numeric_limits<T>::min(),
+                                     false,
+                                     0,
+                                     false};
+  return RuntimeJoinFilter(join_column, type_info, thread_count);
+}
+
+// A range contains a key iff the filter says so, as long as the filter is exact.
+bool contains_any_of(const std::set<int64_t>& keys, const int64_t lo, const int64_t hi) {
+  const auto it = keys.lower_bound(lo);
+  return it != keys.end() && *it <= hi;
+}
+
+}  // namespace
+
+TEST(RuntimeJoinFilter, Empty) {
+  const std::vector<int32_t> keys{std::numeric_limits<int32_t>::min(),
+                                  std::numeric_limits<int32_t>::min()};
+  const auto filter = build_filter(keys, 4);
+  ASSERT_TRUE(filter.empty());
+  ASSERT_FALSE(filter.mayContain(0));
+  ASSERT_FALSE(filter.mayContainAnyOf(std::numeric_limits<int64_t>::min(),
+                                      std::numeric_limits<int64_t>::max()));
+}
+
+TEST(RuntimeJoinFilter, Bitmap) {
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<int32_t> key_dist(-5000, 5000);
+  std::vector<int32_t> keys{std::numeric_limits<int32_t>::min()};
+  std::set<int64_t> key_set;
+  for (size_t i = 0; i < 300; ++i) {
+    keys.push_back(key_dist(gen));
+    key_set.insert(keys.back());
+  }
+  const auto filter = build_filter(keys, 3);
+  ASSERT_TRUE(filter.isBitmap());
+  ASSERT_EQ(*key_set.begin(), filter.getMin());
+  ASSERT_EQ(*key_set.rbegin(), filter.getMax());
+  for (int64_t val = -6000; val <= 6000; ++val) {
+    ASSERT_EQ(key_set.count(val) > 0, filter.mayContain(val));
+  }
+  std::uniform_int_distribution<int64_t> range_dist(-6000, 6000);
+  for (size_t i = 0; i < 10000; ++i) {
+    auto lo = range_dist(gen);
+    auto hi = lo + range_dist(gen) % 200;
+    ASSERT_EQ(contains_any_of(key_set, lo, hi), filter.mayContainAnyOf(lo, hi));
+  }
+}
+
+TEST(RuntimeJoinFilter, BloomFilter) {
+  std::mt19937 gen(2);
+  std::uniform_int_distribution<int64_t> key_dist(0, int64_t(1) << 40);
+  std::vector<int64_t> keys;
+  std::set<int64_t> key_set;
+  for (size_t i = 0; i < 10000; ++i) {
+    keys.push_back(key_dist(gen) * 1000);
+    key_set.insert(keys.back());
+  }
+  const auto filter = build_filter(keys, 4);
+  ASSERT_FALSE(filter.isBitmap());
+  for (const auto key : key_set) {
+    ASSERT_TRUE(filter.mayContain(key));
+    ASSERT_TRUE(filter.mayContainAnyOf(key - 10, key + 10));
+  }
+  size_t false_positives{0};
+  const size_t probe_count{100000};
+  for (size_t i = 0; i < probe_count; ++i) {
+    const auto val = key_dist(gen) * 1000 + 1;
+    false_positives += filter.mayContain(val);
+  }
+  // 8 bits per key and 3 hash functions, the rate should stay below 5%.
+  ASSERT_LT(false_positives, probe_count / 20);
+  ASSERT_FALSE(filter.mayContainAnyOf(filter.getMin() - 100, filter.getMin() - 1));
+  ASSERT_FALSE(filter.mayContainAnyOf(filter.getMax() + 1, filter.getMax() + 100));
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
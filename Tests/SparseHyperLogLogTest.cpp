@@ -0,0 +1,117 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../QueryEngine/HyperLogLog.h"
+#include "../QueryEngine/SparseHyperLogLog.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+const uint32_t bitmap_sz_bits{11};
+
+// Feeds the same random register updates to the sparse registers and a dense array.
+void fill(SparseHyperLogLog& sparse_hll,
+          std::vector<int8_t>& dense_hll,
+          const size_t count,
+          const unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<uint32_t> index_dist(0, (1 << bitmap_sz_bits) - 1);
+  std::geometric_distribution<int> rank_dist(0.5);
+  for (size_t i = 0; i < count; ++i) {
+    const auto index = index_dist(gen);
+    const auto rank = static_cast<uint8_t>(std::min(rank_dist(gen) + 1, 53));
+    sparse_hll.update(index, rank, bitmap_sz_bits);
+    dense_hll[index] = std::max(dense_hll[index], static_cast<int8_t>(rank));
+  }
+}
+
+}  // namespace
+
+TEST(SparseHyperLogLog, Empty) {
+  SparseHyperLogLog sparse_hll;
+  ASSERT_FALSE(sparse_hll.isDense());
+  ASSERT_EQ(size_t(0), hll_size(sparse_hll, bitmap_sz_bits));
+}
+
+TEST(SparseHyperLogLog, Sparse) {
+  SparseHyperLogLog sparse_hll;
+  std::vector<int8_t> dense_hll(1 << bitmap_sz_bits);
+  fill(sparse_hll, dense_hll, 100, 1);
+  ASSERT_FALSE(sparse_hll.isDense());
+  ASSERT_LE(sparse_hll.sparseRegisterCount(),
+            SparseHyperLogLog::max_sparse_size(bitmap_sz_bits));
+  ASSERT_EQ(hll_size(&dense_hll[0], bitmap_sz_bits), hll_size(sparse_hll, bitmap_sz_bits));
+}
+
+TEST(SparseHyperLogLog, Promote) {
+  SparseHyperLogLog sparse_hll;
+  std::vector<int8_t> dense_hll(1 << bitmap_sz_bits);
+  fill(sparse_hll, dense_hll, 100000, 2);
+  ASSERT_TRUE(sparse_hll.isDense());
+  for (size_t i = 0; i < dense_hll.size(); ++i) {
+    ASSERT_EQ(dense_hll[i], static_cast<int8_t>(sparse_hll.denseRegisters()[i]));
+  }
+  ASSERT_EQ(hll_size(&dense_hll[0], bitmap_sz_bits), hll_size(sparse_hll, bitmap_sz_bits));
+}
+
+TEST(SparseHyperLogLog, Unite) {
+  const std::vector<size_t> counts{0, 10, 200, 100000};
+  unsigned seed = 3;
+  for (const auto lhs_count : counts) {
+    for (const auto rhs_count : counts) {
+      SparseHyperLogLog lhs;
+      std::vector<int8_t> lhs_dense(1 << bitmap_sz_bits);
+      fill(lhs, lhs_dense, lhs_count, ++seed);
+      SparseHyperLogLog rhs;
+      std::vector<int8_t> rhs_dense(1 << bitmap_sz_bits);
+      fill(rhs, rhs_dense, rhs_count, ++seed);
+      const auto rhs_size = hll_size(rhs, bitmap_sz_bits);
+      lhs.unite(rhs, bitmap_sz_bits);
+      hll_unify(&lhs_dense[0], &rhs_dense[0], lhs_dense.size());
+      ASSERT_EQ(hll_size(&lhs_dense[0], bitmap_sz_bits), hll_size(lhs, bitmap_sz_bits));
+      ASSERT_EQ(rhs_size, hll_size(rhs, bitmap_sz_bits));
+    }
+  }
+}
+
+TEST(HyperLogLog, UnifyMixedWidths) {
+  std::vector<int8_t> cpu_hll(1 << bitmap_sz_bits);
+  std::vector<int32_t> gpu_hll(1 << bitmap_sz_bits);
+  std::mt19937 gen(4);
+  std::uniform_int_distribution<int> rank_dist(0, 20);
+  for (size_t i = 0; i < cpu_hll.size(); ++i) {
+    cpu_hll[i] = rank_dist(gen);
+    gpu_hll[i] = rank_dist(gen);
+  }
+  auto cpu_copy = cpu_hll;
+  hll_unify(&gpu_hll[0], &cpu_hll[0], cpu_hll.size());
+  for (size_t i = 0; i < cpu_hll.size(); ++i) {
+    ASSERT_EQ(gpu_hll[i], cpu_hll[i]);
+    ASSERT_GE(cpu_hll[i], cpu_copy[i]);
+  }
+  hll_unify(&cpu_copy[0], &cpu_hll[0], cpu_hll.size());
+  ASSERT_EQ(cpu_hll, cpu_copy);
+  ASSERT_EQ(hll_size(&cpu_hll[0], bitmap_sz_bits), hll_size(&gpu_hll[0], bitmap_sz_bits));
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
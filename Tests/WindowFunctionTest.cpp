@@ -0,0 +1,298 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../QueryEngine/WindowFunctionEvaluator.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+
+const int64_t null_int{std::numeric_limits<int64_t>::min()};
+
+double as_double(const int64_t image) {
+  double val;
+  std::memcpy(&val, &image, sizeof(val));
+  return val;
+}
+
+int64_t double_image(const double val) {
+  int64_t image;
+  std::memcpy(&image, &val, sizeof(image));
+  return image;
+}
+
+WindowInputColumn int_column(const std::vector<int64_t>& values) {
+  return {values, null_int, false};
+}
+
+WindowFunctionSpec make_spec(const SqlWindowFunctionKind kind,
+                             const std::vector<size_t>& args,
+                             const std::vector<size_t>& partition_keys,
+                             const std::vector<WindowOrderKey>& order_keys) {
+  return {kind,
+          args,
+          partition_keys,
+          order_keys,
+          false,
+          {WindowFrameBoundType::UNBOUNDED_PRECEDING, 0},
+          {order_keys.empty() ? WindowFrameBoundType::UNBOUNDED_FOLLOWING
+                              : WindowFrameBoundType::CURRENT_ROW,
+           0},
+          false,
+          null_int};
+}
+
+// Straightforward evaluation of a frame aggregate: sorts every partition and
+// visits the whole frame of every row.
+std::vector<int64_t> reference_aggregate(const std::vector<WindowInputColumn>& columns,
+                                         const WindowFunctionSpec& spec) {
+  const size_t row_count = columns.front().values.size();
+  std::map<std::vector<int64_t>, std::vector<size_t>> partitions;
+  for (size_t row = 0; row < row_count; ++row) {
+    std::vector<int64_t> key;
+    for (const auto partition_key : spec.partition_keys) {
+      key.push_back(columns[partition_key].values[row]);
+    }
+    partitions[key].push_back(row);
+  }
+  CHECK_EQ(size_t(1), spec.order_keys.size());
+  const auto& order_key = spec.order_keys.front();
+  const auto& order_column = columns[order_key.column].values;
+  const auto order_less = [&order_column, &order_key](const size_t lhs,
+                                                      const size_t rhs) {
+    return order_key.descending ? order_column[lhs] > order_column[rhs]
+                                : order_column[lhs] < order_column[rhs];
+  };
+  const auto& arg = columns[spec.args.front()];
+  std::vector<int64_t> results(row_count);
+  for (auto& partition : partitions) {
+    auto& rows = partition.second;
+    std::stable_sort(rows.begin(), rows.end(), order_less);
+    const int64_t n = rows.size();
+    for (int64_t i = 0; i < n; ++i) {
+      int64_t first = 0;
+      int64_t last = n - 1;
+      if (spec.lower_bound.type == WindowFrameBoundType::EXPR_PRECEDING) {
+        first = i - spec.lower_bound.offset;
+      }
+      if (spec.upper_bound.type == WindowFrameBoundType::EXPR_FOLLOWING) {
+        last = i + spec.upper_bound.offset;
+      } else if (spec.upper_bound.type == WindowFrameBoundType::CURRENT_ROW) {
+        last = i;
+        if (!spec.is_rows) {
+          while (last + 1 < n && !order_less(rows[i], rows[last + 1])) {
+            ++last;
+          }
+        }
+      }
+      first = std::max(first, int64_t(0));
+      last = std::min(last, n - 1);
+      double sum{0};
+      int64_t count{0};
+      double min_val{0};
+      double max_val{0};
+      for (int64_t j = first; j <= last; ++j) {
+        const auto image = arg.values[rows[j]];
+        if (image == arg.null_val) {
+          continue;
+        }
+        const double val = arg.is_fp ? as_double(image) : image;
+        min_val = count ? std::min(min_val, val) : val;
+        max_val = count ? std::max(max_val, val) : val;
+        sum += val;
+        ++count;
+      }
+      double result{0};
+      switch (spec.kind) {
+        case SqlWindowFunctionKind::COUNT:
+          results[rows[i]] = count;
+          continue;
+        case SqlWindowFunctionKind::SUM:
+          result = sum;
+          break;
+        case SqlWindowFunctionKind::MIN:
+          result = min_val;
+          break;
+        case SqlWindowFunctionKind::MAX:
+          result = max_val;
+          break;
+        default:
+          CHECK(false);
+      }
+      results[rows[i]] = count ? (spec.is_fp ? double_image(result)
+                                             : static_cast<int64_t>(result))
+                               : spec.null_val;
+    }
+  }
+  return results;
+}
+
+void check_against_reference(const size_t row_count,
+                             const size_t partition_count,
+                             const bool fp_arg,
+                             const bool running_frames,
+                             const unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int64_t> partition_dist(0, partition_count - 1);
+  std::uniform_int_distribution<int64_t> order_dist(0, 1000);
+  std::uniform_int_distribution<int64_t> value_dist(-100, 100);
+  std::vector<int64_t> partitions(row_count);
+  std::vector<int64_t> order(row_count);
+  std::vector<int64_t> values(row_count);
+  const int64_t null_val = fp_arg ? double_image(std::numeric_limits<double>::min())
+                                  : null_int;
+  for (size_t i = 0; i < row_count; ++i) {
+    partitions[i] = partition_dist(gen);
+    order[i] = order_dist(gen);
+    const auto val = value_dist(gen);
+    values[i] = val % 10 == 0 ? null_val : (fp_arg ? double_image(val / 4.) : val);
+  }
+  const std::vector<WindowInputColumn> columns{
+      int_column(partitions), int_column(order), {values, null_val, fp_arg}};
+  const std::vector<size_t> partition_keys =
+      partition_count > 1 ? std::vector<size_t>{0} : std::vector<size_t>{};
+  std::vector<WindowFunctionSpec> specs;
+  for (const auto kind : {SqlWindowFunctionKind::SUM,
+                          SqlWindowFunctionKind::MIN,
+                          SqlWindowFunctionKind::MAX,
+                          SqlWindowFunctionKind::COUNT}) {
+    for (const bool descending : {false, true}) {
+      auto spec = make_spec(kind, {2}, partition_keys, {{1, descending, false}});
+      spec.is_fp = fp_arg && kind != SqlWindowFunctionKind::COUNT;
+      spec.null_val = spec.is_fp ? null_val : null_int;
+      // running frame over peers, slow to check on large partitions
+      if (running_frames) {
+        specs.push_back(spec);
+      }
+      // sliding frames
+      spec.is_rows = true;
+      spec.lower_bound = {WindowFrameBoundType::EXPR_PRECEDING, 3};
+      spec.upper_bound = {WindowFrameBoundType::EXPR_FOLLOWING, 2};
+      specs.push_back(spec);
+      spec.upper_bound = {WindowFrameBoundType::CURRENT_ROW, 0};
+      specs.push_back(spec);
+    }
+  }
+  const auto results = evaluate_window_functions(row_count, columns, specs);
+  ASSERT_EQ(specs.size(), results.size());
+  for (size_t i = 0; i < specs.size(); ++i) {
+    const auto expected = reference_aggregate(columns, specs[i]);
+    for (size_t row = 0; row < row_count; ++row) {
+      if (specs[i].is_fp && expected[row] != null_val) {
+        ASSERT_NEAR(as_double(expected[row]), as_double(results[i][row]), 1e-9);
+      } else {
+        ASSERT_EQ(expected[row], results[i][row]);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(WindowFunction, Ranks) {
+  // partition 0: order 1, 2, 2, 3; partition 1: order 5, 5
+  const std::vector<WindowInputColumn> columns{int_column({0, 1, 0, 0, 1, 0}),
+                                               int_column({2, 5, 1, 3, 5, 2})};
+  std::vector<WindowFunctionSpec> specs;
+  for (const auto kind : {SqlWindowFunctionKind::ROW_NUMBER,
+                          SqlWindowFunctionKind::RANK,
+                          SqlWindowFunctionKind::DENSE_RANK,
+                          SqlWindowFunctionKind::PERCENT_RANK,
+                          SqlWindowFunctionKind::CUME_DIST}) {
+    specs.push_back(make_spec(kind, {}, {0}, {{1, false, false}}));
+  }
+  specs[3].is_fp = specs[4].is_fp = true;
+  const auto results = evaluate_window_functions(6, columns, specs);
+  ASSERT_EQ(std::vector<int64_t>({2, 1, 1, 4, 2, 3}), results[0]);
+  ASSERT_EQ(std::vector<int64_t>({2, 1, 1, 4, 1, 2}), results[1]);
+  ASSERT_EQ(std::vector<int64_t>({2, 1, 1, 3, 1, 2}), results[2]);
+  const std::vector<double> percent_ranks{1. / 3, 0, 0, 1, 0, 1. / 3};
+  const std::vector<double> cume_dists{.75, 1, .25, 1, 1, .75};
+  for (size_t i = 0; i < 6; ++i) {
+    ASSERT_DOUBLE_EQ(percent_ranks[i], as_double(results[3][i]));
+    ASSERT_DOUBLE_EQ(cume_dists[i], as_double(results[4][i]));
+  }
+}
+
+TEST(WindowFunction, Navigation) {
+  const std::vector<WindowInputColumn> columns{
+      int_column({3, 1, 2, 5, 4}), int_column({30, 10, 20, null_int, 40}),
+      int_column({2, 2, 2, 2, 2}), int_column({-1, -1, -1, -1, -1})};
+  std::vector<WindowFunctionSpec> specs{
+      make_spec(SqlWindowFunctionKind::LAG, {1}, {}, {{0, false, false}}),
+      make_spec(SqlWindowFunctionKind::LEAD, {1, 2, 3}, {}, {{0, false, false}}),
+      make_spec(SqlWindowFunctionKind::FIRST_VALUE, {1}, {}, {{0, true, false}}),
+      make_spec(SqlWindowFunctionKind::LAST_VALUE, {1}, {}, {{0, false, false}}),
+      make_spec(SqlWindowFunctionKind::NTILE, {2}, {}, {{0, false, false}})};
+  const auto results = evaluate_window_functions(5, columns, specs);
+  ASSERT_EQ(std::vector<int64_t>({20, null_int, 10, 40, 30}), results[0]);
+  ASSERT_EQ(std::vector<int64_t>({null_int, 30, 40, -1, -1}), results[1]);
+  ASSERT_EQ(std::vector<int64_t>({null_int, null_int, null_int, null_int, null_int}),
+            results[2]);
+  ASSERT_EQ(std::vector<int64_t>({30, 10, 20, null_int, 40}), results[3]);
+  ASSERT_EQ(std::vector<int64_t>({1, 1, 1, 2, 2}), results[4]);
+}
+
+TEST(WindowFunction, Sum0OfEmptyFrame) {
+  const std::vector<WindowInputColumn> columns{int_column({1, 2, 3}),
+                                               int_column({null_int, 5, 7})};
+  auto spec =
+      make_spec(SqlWindowFunctionKind::SUM_INTERNAL, {1}, {}, {{0, false, false}});
+  spec.is_rows = true;
+  spec.lower_bound = {WindowFrameBoundType::EXPR_PRECEDING, 1};
+  spec.upper_bound = {WindowFrameBoundType::EXPR_PRECEDING, 1};
+  auto sum_spec = spec;
+  sum_spec.kind = SqlWindowFunctionKind::SUM;
+  const auto results = evaluate_window_functions(3, columns, {spec, sum_spec});
+  ASSERT_EQ(std::vector<int64_t>({0, 0, 5}), results[0]);
+  ASSERT_EQ(std::vector<int64_t>({null_int, null_int, 5}), results[1]);
+}
+
+TEST(WindowFunction, Empty) {
+  const auto results = evaluate_window_functions(
+      0,
+      {int_column({})},
+      {make_spec(SqlWindowFunctionKind::ROW_NUMBER, {}, {}, {{0, false, false}})});
+  ASSERT_EQ(size_t(1), results.size());
+  ASSERT_TRUE(results.front().empty());
+}
+
+TEST(WindowFunction, SmallPartitions) {
+  check_against_reference(1000, 30, false, true, 1);
+  check_against_reference(1000, 30, true, true, 2);
+}
+
+TEST(WindowFunction, ParallelPartitions) {
+  check_against_reference(50000, 2000, false, true, 3);
+  check_against_reference(50000, 2000, true, true, 4);
+}
+
+TEST(WindowFunction, ParallelSinglePartition) {
+  check_against_reference(30000, 1, false, false, 5);
+  check_against_reference(30000, 1, true, false, 6);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -178,6 +178,14 @@ MapDHandler::MapDHandler(const std::vector<LeafHostInfo>& db_leaves,
                                               total_reserved,
                                               num_reader_threads));
 
+  if (g_result_cache_size) {
+    result_cache_.reset(new QueryResultCache(g_result_cache_size));
+  }
+  if (g_cursor_memory_budget) {
+    cursor_cache_.reset(new QueryCursorCache(
+        g_cursor_memory_budget, std::chrono::seconds(g_cursor_ttl_seconds)));
+  }
+
   std::string calcite_session_prefix = "calcite-" + generate_random_string(64);
 
   calcite_ = std::make_shared<Calcite>(mapd_parameters.mapd_server_port,
@@ -340,6 +348,9 @@ void MapDHandler::disconnect(const TSessionId& session) {
   LOG(INFO) << "User " << session_it->second->get_currentUser().userName
             << " disconnected from database " << dbname << std::endl;
   sessions_.erase(session_it);
+  if (cursor_cache_) {
+    cursor_cache_->eraseSession(session);
+  }
 }
 
 void MapDHandler::interrupt(const TSessionId& session) {
@@ -384,6 +395,13 @@ void MapDHandler::get_server_status(TServerStatus& _return, const TSessionId& se
   _return.start_time = start_time_;
   _return.edition = MAPD_EDITION;
   _return.host_name = "aggregator";
+  if (result_cache_) {
+    const auto stats = result_cache_->getStats();
+    _return.result_cache_hits = stats.hits;
+    _return.result_cache_misses = stats.misses;
+    _return.result_cache_entries = stats.entries;
+    _return.result_cache_bytes = stats.bytes;
+  }
 }
 
 void MapDHandler::get_status(std::vector<TServerStatus>& _return,
@@ -397,6 +415,13 @@ void MapDHandler::get_status(std::vector<TServerStatus>& _return,
   ret.start_time = start_time_;
   ret.edition = MAPD_EDITION;
   ret.host_name = "aggregator";
+  if (result_cache_) {
+    const auto stats = result_cache_->getStats();
+    ret.result_cache_hits = stats.hits;
+    ret.result_cache_misses = stats.misses;
+    ret.result_cache_entries = stats.entries;
+    ret.result_cache_bytes = stats.bytes;
+  }
   _return.push_back(ret);
   if (leaf_aggregator_.leafCount() > 0) {
     std::vector<TServerStatus> leaf_status = leaf_aggregator_.getLeafStatus(session);
@@ -785,6 +810,197 @@ void MapDHandler::sql_execute_gdf(TDataFrame& _return,
   sql_execute_df(_return, session, query_str, TDeviceType::GPU, device_id, first_n);
 }
 
+namespace {
+
+// Collects the epochs of the physical tables read by a query, returns false if one
+// of them is a view, is written to or doesn't have an epoch.
+bool get_table_epochs(std::vector<TableEpochInfo>& table_epochs,
+                      const Catalog& cat,
+                      const std::map<std::string, bool>& table_names) {
+  const auto db_id = cat.get_currentDB().dbId;
+  for (const auto& table : table_names) {
+    if (table.second) {
+      return false;
+    }
+    const auto td = cat.getMetadataForTable(table.first, false);
+    if (!td || td->isView) {
+      return false;
+    }
+    const auto epoch = cat.getTableEpoch(db_id, td->tableId);
+    if (epoch < 0) {
+      return false;
+    }
+    table_epochs.push_back({db_id, td->tableId, epoch});
+  }
+  return !table_epochs.empty();
+}
+
+bool same_table_epochs(const std::vector<TableEpochInfo>& lhs,
+                       const std::vector<TableEpochInfo>& rhs) {
+  return std::equal(lhs.begin(),
+                    lhs.end(),
+                    rhs.begin(),
+                    rhs.end(),
+                    [](const TableEpochInfo& lhs_table, const TableEpochInfo& rhs_table) {
+                      return lhs_table.db_id == rhs_table.db_id &&
+                             lhs_table.table_id == rhs_table.table_id &&
+                             lhs_table.epoch == rhs_table.epoch;
+                    });
+}
+
+}  // namespace
+
+void MapDHandler::sql_execute_cursor(TCursor& _return,
+                                     const TSessionId& session,
+                                     const std::string& query_str,
+                                     const std::string& nonce) {
+  const auto session_info = MapDHandler::get_session(session);
+  if (!cursor_cache_) {
+    THROW_MAPD_EXCEPTION(std::string("Exception: cursors are disabled on this server"));
+  }
+  if (leaf_aggregator_.leafCount() > 0) {
+    THROW_MAPD_EXCEPTION(
+        std::string("Exception: cursors are not supported in distributed mode"));
+  }
+  LOG(INFO) << "sql_execute_cursor :" << session_info.get_currentUser().userName << "_"
+            << session.substr(0, 3) << " :query_str:" << hide_sensitive_data(query_str);
+  _return.nonce = nonce;
+  _return.execution_time_ms = 0;
+  _return.total_time_ms = measure<>::execution([&]() {
+    try {
+      ParserWrapper pw{query_str};
+      if (!is_calcite_path_permissable(pw, read_only_) || pw.is_update_dml ||
+          pw.is_select_explain || pw.is_select_calcite_explain) {
+        throw std::runtime_error("cursors can only be opened on SELECT queries");
+      }
+      std::string query_ra;
+      std::map<std::string, bool> tableNames;
+      _return.execution_time_ms += measure<>::execution(
+          [&]() { query_ra = parse_to_ra(query_str, session_info, &tableNames); });
+
+      // COPY_TO/SELECT: get read ExecutorOuterLock >> read UpdateDeleteLock locks
+      mapd_shared_lock<mapd_shared_mutex> executeReadLock(
+          *LockMgr<mapd_shared_mutex, bool>::getMutex(ExecutorOuterLock, true));
+      std::vector<std::shared_ptr<VLock>> upddelLocks;
+      getTableLocks<mapd_shared_mutex>(session_info.get_catalog(),
+                                       tableNames,
+                                       upddelLocks,
+                                       LockType::UpdateDeleteLock);
+      const auto result = execute_rel_alg_rows(query_ra,
+                                                session_info,
+                                                session_info.get_executor_device_type(),
+                                                false,
+                                                false,
+                                                _return.execution_time_ms);
+      const auto rows = result.getRows();
+      CHECK(rows);
+      std::shared_ptr<QueryCursorCache::Cursor> cursor;
+      size_t cursor_bytes{0};
+      std::vector<TableEpochInfo> table_epochs;
+      if (get_table_epochs(table_epochs, session_info.get_catalog(), tableNames)) {
+        // the result set keeps the chunks its lazily fetched columns point into,
+        // fetches lock the tables again and check their epochs before reading it
+        auto entries = rows->getRowEntryIndices();
+        cursor_bytes = QueryCursorCache::estimateSize(*rows, entries.size());
+        cursor = std::make_shared<QueryCursorCache::Cursor>(rows,
+                                                            std::move(entries),
+                                                            result.getTargetsMeta(),
+                                                            tableNames,
+                                                            std::move(table_epochs));
+      } else {
+        // the tables behind a view aren't known, copy the rows out while the
+        // locks keep the chunks in place
+        std::vector<QueryCursorCache::Row> cursor_rows;
+        while (true) {
+          auto crt_row = rows->getNextRow(true, true);
+          if (crt_row.empty()) {
+            break;
+          }
+          cursor_bytes += QueryCursorCache::estimateSize(crt_row);
+          if (cursor_bytes > g_cursor_memory_budget) {
+            throw std::runtime_error(
+                "The result takes more than the cursor memory budget of " +
+                std::to_string(g_cursor_memory_budget) + " bytes");
+          }
+          cursor_rows.push_back(std::move(crt_row));
+        }
+        cursor = std::make_shared<QueryCursorCache::Cursor>(std::move(cursor_rows),
+                                                            result.getTargetsMeta());
+      }
+      _return.row_desc = convert_target_metainfo(result.getTargetsMeta());
+      _return.row_count = cursor->rowCount();
+      _return.cursor_id = cursor_cache_->put(session, cursor, cursor_bytes);
+    } catch (std::exception& e) {
+      THROW_MAPD_EXCEPTION(std::string("Exception: ") + e.what());
+    }
+  });
+  LOG(INFO) << "sql_execute_cursor-COMPLETED cursor " << _return.cursor_id
+            << " Total: " << _return.total_time_ms
+            << " (ms), Execution: " << _return.execution_time_ms << " (ms)";
+}
+
+void MapDHandler::fetch_cursor(TQueryResult& _return,
+                               const TSessionId& session,
+                               const int64_t cursor_id,
+                               const int64_t offset,
+                               const int32_t row_count,
+                               const bool column_format) {
+  const auto session_info = MapDHandler::get_session(session);
+  if (!cursor_cache_) {
+    THROW_MAPD_EXCEPTION(std::string("Exception: cursors are disabled on this server"));
+  }
+  if (offset < 0 || row_count < 0) {
+    THROW_MAPD_EXCEPTION(
+        std::string("Exception: offset and row_count can't be negative"));
+  }
+  // declared before the cursor so the chunks its result set holds are released
+  // before a statement waiting on these locks deletes them
+  mapd_shared_lock<mapd_shared_mutex> executeReadLock;
+  std::vector<std::shared_ptr<VLock>> upddelLocks;
+  auto cursor = cursor_cache_->get(session, cursor_id);
+  if (!cursor) {
+    THROW_MAPD_EXCEPTION("Exception: cursor " + std::to_string(cursor_id) +
+                         " is closed or has expired");
+  }
+  _return.execution_time_ms = 0;
+  _return.total_time_ms = measure<>::execution([&]() {
+    try {
+      if (cursor->result_set) {
+        // SELECT: get read ExecutorOuterLock >> read UpdateDeleteLock locks
+        auto& cat = session_info.get_catalog();
+        executeReadLock = mapd_shared_lock<mapd_shared_mutex>(
+            *LockMgr<mapd_shared_mutex, bool>::getMutex(ExecutorOuterLock, true));
+        getTableLocks<mapd_shared_mutex>(
+            cat, cursor->table_names, upddelLocks, LockType::UpdateDeleteLock);
+        // loads, updates and deletes move the epochs of the tables they write to
+        // and may move the buffers the result set points into
+        std::vector<TableEpochInfo> table_epochs;
+        if (!get_table_epochs(table_epochs, cat, cursor->table_names) ||
+            !same_table_epochs(table_epochs, cursor->table_epochs)) {
+          cursor_cache_->erase(session, cursor_id);
+          throw std::runtime_error("the tables read by cursor " +
+                                   std::to_string(cursor_id) +
+                                   " changed since it was opened");
+        }
+      }
+      std::lock_guard<std::mutex> fetch_lock(cursor->fetch_mutex);
+      const QueryCursorCache::Page page(
+          *cursor, static_cast<size_t>(offset), static_cast<size_t>(row_count));
+      convert_rows(_return, cursor->targets, page, column_format, -1, -1);
+    } catch (std::exception& e) {
+      THROW_MAPD_EXCEPTION(std::string("Exception: ") + e.what());
+    }
+  });
+}
+
+void MapDHandler::close_cursor(const TSessionId& session, const int64_t cursor_id) {
+  MapDHandler::get_session(session);
+  if (!cursor_cache_ || !cursor_cache_->erase(session, cursor_id)) {
+    THROW_MAPD_EXCEPTION("Exception: cursor " + std::to_string(cursor_id) +
+                         " is closed or has expired");
+  }
+}
+
 // For now we have only one user of a data frame in all cases.
 void MapDHandler::deallocate_df(const TSessionId& session,
                                 const TDataFrame& df,
@@ -1644,7 +1860,15 @@ void MapDHandler::clear_gpu_memory(const TSessionId& session) {
 
 void MapDHandler::clear_cpu_memory(const TSessionId& session) {
   const auto session_info = get_session(session);
+  if (cursor_cache_) {
+    // the chunks the cursors hold stay pinned otherwise
+    cursor_cache_->eraseTableCursors();
+  }
   SysCatalog::instance().get_dataMgr().clearMemory(MemoryLevel::CPU_LEVEL);
+  if (result_cache_) {
+    result_cache_->clear();
+  }
+  RelAlgExecutor::yieldCacheInvalidator()();
   if (render_handler_) {
     render_handler_->clear_cpu_memory();
   }
@@ -1775,6 +1999,9 @@ void MapDHandler::load_table_binary(const TSessionId& session,
                                     const std::vector<TRow>& rows) {
   check_read_only("load_table_binary");
   const auto session_info = get_session(session);
+  ScopeGuard invalidate_cached_results = [this, &session_info, &table_name] {
+    invalidate_result_cache(session_info.get_catalog(), table_name);
+  };
   auto& cat = session_info.get_catalog();
   if (g_cluster && !leaf_aggregator_.leafCount()) {
     // Sharded table rows need to be routed to the leaf by an aggregator.
@@ -1868,6 +2095,9 @@ void MapDHandler::load_table_binary_columnar(const TSessionId& session,
   std::unique_ptr<Importer_NS::Loader> loader;
   std::vector<std::unique_ptr<Importer_NS::TypedImportBuffer>> import_buffers;
   const auto session_info = get_session(session);
+  ScopeGuard invalidate_cached_results = [this, &session_info, &table_name] {
+    invalidate_result_cache(session_info.get_catalog(), table_name);
+  };
   prepare_columnar_loader(
       session_info, table_name, cols.size(), &loader, &import_buffers);
 
@@ -1960,6 +2190,9 @@ void MapDHandler::load_table_binary_arrow(const TSessionId& session,
   std::unique_ptr<Importer_NS::Loader> loader;
   std::vector<std::unique_ptr<Importer_NS::TypedImportBuffer>> import_buffers;
   const auto session_info = get_session(session);
+  ScopeGuard invalidate_cached_results = [this, &session_info, &table_name] {
+    invalidate_result_cache(session_info.get_catalog(), table_name);
+  };
   prepare_columnar_loader(session_info,
                           table_name,
                           static_cast<size_t>(batch->num_columns()),
@@ -1988,6 +2221,9 @@ void MapDHandler::load_table(const TSessionId& session,
                              const std::vector<TStringRow>& rows) {
   check_read_only("load_table");
   const auto session_info = get_session(session);
+  ScopeGuard invalidate_cached_results = [this, &session_info, &table_name] {
+    invalidate_result_cache(session_info.get_catalog(), table_name);
+  };
   auto& cat = session_info.get_catalog();
   if (g_cluster && !leaf_aggregator_.leafCount()) {
     // Sharded table rows need to be routed to the leaf by an aggregator.
@@ -3082,6 +3318,9 @@ void MapDHandler::import_table(const TSessionId& session,
   check_read_only("import_table");
   LOG(INFO) << "import_table " << table_name << " from " << file_name_in;
   const auto session_info = get_session(session);
+  ScopeGuard invalidate_cached_results = [this, &session_info, &table_name] {
+    invalidate_result_cache(session_info.get_catalog(), table_name);
+  };
   auto& cat = session_info.get_catalog();
 
   const TableDescriptor* td = cat.getMetadataForTable(table_name);
@@ -3504,16 +3743,14 @@ void MapDHandler::set_execution_mode_nolock(Catalog_Namespace::SessionInfo* sess
   }
 }
 
-void MapDHandler::execute_rel_alg(TQueryResult& _return,
-                                  const std::string& query_ra,
-                                  const bool column_format,
-                                  const Catalog_Namespace::SessionInfo& session_info,
-                                  const ExecutorDeviceType executor_device_type,
-                                  const int32_t first_n,
-                                  const int32_t at_most_n,
-                                  const bool just_explain,
-                                  const bool just_validate) const {
-  INJECT_TIMER(execute_rel_alg);
+ExecutionResult MapDHandler::execute_rel_alg_rows(
+    const std::string& query_ra,
+    const Catalog_Namespace::SessionInfo& session_info,
+    const ExecutorDeviceType executor_device_type,
+    const bool just_explain,
+    const bool just_validate,
+    int64_t& execution_time_ms,
+    bool* uses_now) const {
   const auto& cat = session_info.get_catalog();
   CompilationOptions co = {
       executor_device_type, true, ExecutorOptLevel::Default, g_enable_dynamic_watchdog};
@@ -3538,10 +3775,34 @@ void MapDHandler::execute_rel_alg(TQueryResult& _return,
                                                      nullptr,
                                                      nullptr),
                          {}};
-  _return.execution_time_ms += measure<>::execution(
+  execution_time_ms += measure<>::execution(
       [&]() { result = ra_executor.executeRelAlgQuery(query_ra, co, eo, nullptr); });
   // reduce execution time by the time spent during queue waiting
-  _return.execution_time_ms -= result.getRows()->getQueueTime();
+  execution_time_ms -= result.getRows()->getQueueTime();
+  if (uses_now) {
+    *uses_now = ra_executor.usesNow();
+  }
+  return result;
+}
+
+void MapDHandler::execute_rel_alg(TQueryResult& _return,
+                                  const std::string& query_ra,
+                                  const bool column_format,
+                                  const Catalog_Namespace::SessionInfo& session_info,
+                                  const ExecutorDeviceType executor_device_type,
+                                  const int32_t first_n,
+                                  const int32_t at_most_n,
+                                  const bool just_explain,
+                                  const bool just_validate,
+                                  bool* uses_now) const {
+  INJECT_TIMER(execute_rel_alg);
+  const auto result = execute_rel_alg_rows(query_ra,
+                                           session_info,
+                                           executor_device_type,
+                                           just_explain,
+                                           just_validate,
+                                           _return.execution_time_ms,
+                                           uses_now);
   if (just_explain) {
     convert_explain(_return, *result.getRows(), column_format);
   } else {
@@ -3820,6 +4081,32 @@ void check_table_not_sharded(const Catalog& cat, const int table_id) {
 
 }  // namespace
 
+// Collects the epochs of the physical tables read by a query, returns false if
+// its result must not be cached. Queries calling NOW() are only known once their
+// plan has been analyzed, see sql_execute_impl.
+bool MapDHandler::get_result_cache_epochs(
+    std::vector<TableEpochInfo>& table_epochs,
+    const Catalog& cat,
+    const std::map<std::string, bool>& table_names) const {
+  if (!result_cache_ || leaf_aggregator_.leafCount() > 0) {
+    return false;
+  }
+  return get_table_epochs(table_epochs, cat, table_names);
+}
+
+void MapDHandler::invalidate_result_cache(const Catalog& cat,
+                                          const std::string& table_name) {
+  if (!result_cache_) {
+    return;
+  }
+  const auto td = cat.getMetadataForTable(table_name, false);
+  if (td) {
+    result_cache_->invalidateTable(cat.get_currentDB().dbId, td->tableId);
+  } else {
+    result_cache_->invalidateDatabase(cat.get_currentDB().dbId);
+  }
+}
+
 void MapDHandler::sql_execute_impl(TQueryResult& _return,
                                    const Catalog_Namespace::SessionInfo& session_info,
                                    const std::string& query_str,
@@ -3886,6 +4173,33 @@ void MapDHandler::sql_execute_impl(TQueryResult& _return,
                                        tableNames,
                                        upddelLocks,
                                        LockType::UpdateDeleteLock);
+      // UPDATE / DELETE drop the cached results of the tables they modify, even
+      // when they fail half way through
+      ScopeGuard invalidate_modified = [this, &cat, &tableNames] {
+        for (const auto& table : tableNames) {
+          if (table.second) {
+            invalidate_result_cache(cat, table.first);
+          }
+        }
+      };
+      std::vector<TableEpochInfo> table_epochs;
+      std::string cache_key;
+      // taken before the epochs, so that an invalidation racing with reading them
+      // keeps the result out of the cache
+      const uint64_t cache_generation =
+          result_cache_ ? result_cache_->getGeneration() : 0;
+      if (!pw.is_select_explain &&
+          get_result_cache_epochs(table_epochs, cat, tableNames)) {
+        cache_key = QueryResultCache::makeKey(
+            query_ra, table_epochs, column_format, first_n, at_most_n);
+        bool cache_hit{false};
+        _return.execution_time_ms += measure<>::execution(
+            [&]() { cache_hit = result_cache_->get(cache_key, _return); });
+        if (cache_hit) {
+          return;
+        }
+      }
+      bool uses_now{false};
       execute_rel_alg(_return,
                       query_ra,
                       column_format,
@@ -3894,7 +4208,13 @@ void MapDHandler::sql_execute_impl(TQueryResult& _return,
                       first_n,
                       at_most_n,
                       pw.is_select_explain,
-                      false);
+                      false,
+                      &uses_now);
+      // NOW() is folded into a constant when the plan is translated, a later run
+      // would see a different time
+      if (!cache_key.empty() && !uses_now) {
+        result_cache_->put(cache_key, table_epochs, _return, cache_generation);
+      }
       return;
     }
     LOG(INFO) << "passing query to legacy processor";
@@ -3927,6 +4247,17 @@ void MapDHandler::sql_execute_impl(TQueryResult& _return,
       if (ddl != nullptr) {
         explain_stmt = dynamic_cast<Parser::ExplainStmt*>(ddl);
       }
+      // the legacy path doesn't tell which tables a statement writes to, so any
+      // statement which might write drops the cached results of the database
+      ScopeGuard invalidate_modified = [this, &cat, select_stmt, explain_stmt] {
+        if (select_stmt || explain_stmt) {
+          return;
+        }
+        if (result_cache_) {
+          result_cache_->invalidateDatabase(cat.get_currentDB().dbId);
+        }
+        RelAlgExecutor::yieldCacheInvalidator()();
+      };
       if (ddl != nullptr && explain_stmt == nullptr) {
         const auto copy_stmt = dynamic_cast<Parser::CopyTableStmt*>(ddl);
         if (auto stmtp = dynamic_cast<Parser::ExportQueryStmt*>(stmt.get())) {
@@ -3966,6 +4297,11 @@ void MapDHandler::sql_execute_impl(TQueryResult& _return,
               *stmtp->get_table(),
               LockType::UpdateDeleteLock);
         }
+        // cursors hold the chunks of the tables they read, which dropping or
+        // truncating a table deletes even when they are pinned
+        if (cursor_cache_ && !dynamic_cast<Parser::ExportQueryStmt*>(stmt.get())) {
+          cursor_cache_->eraseTableCursors();
+        }
         if (g_cluster && copy_stmt && !leaf_aggregator_.leafCount()) {
           // Sharded table rows need to be routed to the leaf by an aggregator.
           check_table_not_sharded(cat, copy_stmt->get_table());
@@ -4330,6 +4666,10 @@ void MapDHandler::set_table_epoch(const TSessionId& session,
     return leaf_aggregator_.set_table_epochLeaf(session_info, db_id, table_id, new_epoch);
   }
   cat.setTableEpoch(db_id, table_id, new_epoch);
+  if (result_cache_) {
+    // the epoch may go back to one which cached results were keyed with
+    result_cache_->invalidateTable(db_id, table_id);
+  }
 }
 
 // check and reset epoch if a request has been made
@@ -4350,6 +4690,9 @@ void MapDHandler::set_table_epoch_by_name(const TSessionId& session,
         session_info, db_id, td->tableId, new_epoch);
   }
   cat.setTableEpoch(db_id, td->tableId, new_epoch);
+  if (result_cache_) {
+    result_cache_->invalidateTable(db_id, td->tableId);
+  }
 }
 
 int32_t MapDHandler::get_table_epoch(const TSessionId& session,
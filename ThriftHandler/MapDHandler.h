@@ -25,6 +25,8 @@
 #define MAPDHANDLER_H
 
 #include "LeafAggregator.h"
+#include "QueryCursorCache.h"
+#include "QueryResultCache.h"
 #ifdef HAVE_PROFILER
 #include <gperftools/heap-profiler.h>
 #endif  // HAVE_PROFILER
@@ -201,6 +203,17 @@ class MapDHandler : public MapDIf {
                        const std::string& query,
                        const int32_t device_id,
                        const int32_t first_n);
+  void sql_execute_cursor(TCursor& _return,
+                          const TSessionId& session,
+                          const std::string& query,
+                          const std::string& nonce);
+  void fetch_cursor(TQueryResult& _return,
+                    const TSessionId& session,
+                    const int64_t cursor_id,
+                    const int64_t offset,
+                    const int32_t row_count,
+                    const bool column_format);
+  void close_cursor(const TSessionId& session, const int64_t cursor_id);
   void deallocate_df(const TSessionId& session,
                      const TDataFrame& df,
                      const TDeviceType::type device_type,
@@ -415,6 +428,8 @@ class MapDHandler : public MapDIf {
   std::unique_ptr<MapDRenderHandler> render_handler_;
   std::unique_ptr<MapDAggHandler> agg_handler_;
   std::unique_ptr<MapDLeafHandler> leaf_handler_;
+  std::unique_ptr<QueryResultCache> result_cache_;
+  std::unique_ptr<QueryCursorCache> cursor_cache_;
   std::shared_ptr<Calcite> calcite_;
   const bool legacy_syntax_;
   Catalog_Namespace::SessionInfo get_session(const TSessionId& session);
@@ -445,6 +460,12 @@ class MapDHandler : public MapDIf {
                           const Catalog_Namespace::SessionInfo& session_info,
                           std::map<std::string, bool>* tableNames = nullptr);
 
+  bool get_result_cache_epochs(std::vector<TableEpochInfo>& table_epochs,
+                               const Catalog_Namespace::Catalog& cat,
+                               const std::map<std::string, bool>& table_names) const;
+  void invalidate_result_cache(const Catalog_Namespace::Catalog& cat,
+                               const std::string& table_name);
+
   void sql_execute_impl(TQueryResult& _return,
                         const Catalog_Namespace::SessionInfo& session_info,
                         const std::string& query_str,
@@ -469,7 +490,16 @@ class MapDHandler : public MapDIf {
                        const int32_t first_n,
                        const int32_t at_most_n,
                        const bool just_explain,
-                       const bool just_validate) const;
+                       const bool just_validate,
+                       bool* uses_now = nullptr) const;
+  // Runs query_ra and returns the result set without converting it.
+  ExecutionResult execute_rel_alg_rows(const std::string& query_ra,
+                                       const Catalog_Namespace::SessionInfo& session_info,
+                                       const ExecutorDeviceType executor_device_type,
+                                       const bool just_explain,
+                                       const bool just_validate,
+                                       int64_t& execution_time_ms,
+                                       bool* uses_now = nullptr) const;
   void execute_rel_alg_df(TDataFrame& _return,
                           const std::string& query_ra,
                           const Catalog_Namespace::SessionInfo& session_info,
@@ -0,0 +1,213 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryCursorCache.h"
+
+#include <glog/logging.h>
+#include <stdexcept>
+
+#include "QueryEngine/ResultSet.h"
+
+size_t g_cursor_memory_budget{size_t(1) << 30};
+size_t g_cursor_ttl_seconds{300};
+
+namespace {
+
+// the characters of a string value, other values are stored inline
+size_t get_string_size(const ScalarTargetValue& value) {
+  const auto nullable_str = boost::get<NullableString>(&value);
+  const auto str = nullable_str ? boost::get<std::string>(nullable_str) : nullptr;
+  return str ? str->size() : 0;
+}
+
+template <typename T>
+size_t estimate_vector_size(const std::shared_ptr<std::vector<T>>& values) {
+  return values ? sizeof(std::vector<T>) + values->size() * sizeof(T) : 0;
+}
+
+struct GeoSizeVisitor : boost::static_visitor<size_t> {
+  size_t operator()(const GeoPointTargetValue& point) const {
+    return estimate_vector_size(point.coords);
+  }
+  size_t operator()(const GeoLineStringTargetValue& linestring) const {
+    return estimate_vector_size(linestring.coords);
+  }
+  size_t operator()(const GeoPolyTargetValue& poly) const {
+    return estimate_vector_size(poly.coords) + estimate_vector_size(poly.ring_sizes);
+  }
+  size_t operator()(const GeoMultiPolyTargetValue& multipoly) const {
+    return estimate_vector_size(multipoly.coords) +
+           estimate_vector_size(multipoly.ring_sizes) +
+           estimate_vector_size(multipoly.poly_rings);
+  }
+};
+
+}  // namespace
+
+QueryCursorCache::Row QueryCursorCache::Page::getNextRow(
+    const bool translate_strings,
+    const bool decimal_to_double) const {
+  if (crt_row_ >= end_row_) {
+    return {};
+  }
+  const auto row_idx = crt_row_++;
+  if (cursor_.result_set) {
+    return cursor_.result_set->getRowAtEntry(
+        cursor_.entries[row_idx], translate_strings, decimal_to_double);
+  }
+  CHECK(translate_strings && decimal_to_double);
+  return cursor_.rows[row_idx];
+}
+
+QueryCursorCache::QueryCursorCache(const size_t max_bytes,
+                                   const std::chrono::milliseconds ttl)
+    : max_bytes_(max_bytes), ttl_(ttl), sweeper_([this] { sweep(); }) {}
+
+QueryCursorCache::~QueryCursorCache() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_sweeper_ = true;
+  }
+  sweeper_cv_.notify_one();
+  sweeper_.join();
+}
+
+int64_t QueryCursorCache::put(const std::string& session,
+                              const std::shared_ptr<Cursor>& cursor,
+                              const size_t bytes) {
+  if (bytes > max_bytes_) {
+    throw std::runtime_error("The result takes " + std::to_string(bytes) +
+                             " bytes, more than the cursor memory budget of " +
+                             std::to_string(max_bytes_));
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto now = Clock::now();
+  evictExpired(now);
+  while (!lru_.empty() && bytes_ + bytes > max_bytes_) {
+    eraseEntry(std::prev(lru_.end()));
+  }
+  const auto cursor_id = next_cursor_id_++;
+  lru_.push_front(Entry{cursor_id, session, cursor, bytes, now});
+  entries_.emplace(cursor_id, lru_.begin());
+  bytes_ += bytes;
+  return cursor_id;
+}
+
+std::shared_ptr<QueryCursorCache::Cursor> QueryCursorCache::get(
+    const std::string& session,
+    const int64_t cursor_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto now = Clock::now();
+  evictExpired(now);
+  const auto it = entries_.find(cursor_id);
+  if (it == entries_.end() || it->second->session != session) {
+    return nullptr;
+  }
+  it->second->last_access = now;
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->cursor;
+}
+
+bool QueryCursorCache::erase(const std::string& session, const int64_t cursor_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = entries_.find(cursor_id);
+  if (it == entries_.end() || it->second->session != session) {
+    return false;
+  }
+  eraseEntry(it->second);
+  return true;
+}
+
+void QueryCursorCache::eraseSession(const std::string& session) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = lru_.begin(); it != lru_.end();) {
+    const auto crt_it = it++;
+    if (crt_it->session == session) {
+      eraseEntry(crt_it);
+    }
+  }
+}
+
+void QueryCursorCache::eraseTableCursors() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = lru_.begin(); it != lru_.end();) {
+    const auto crt_it = it++;
+    if (crt_it->cursor->result_set) {
+      eraseEntry(crt_it);
+    }
+  }
+}
+
+size_t QueryCursorCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+size_t QueryCursorCache::bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return bytes_;
+}
+
+size_t QueryCursorCache::estimateSize(const Row& row) {
+  size_t bytes = sizeof(Row);
+  for (const auto& value : row) {
+    bytes += sizeof(TargetValue);
+    if (const auto scalar = boost::get<ScalarTargetValue>(&value)) {
+      bytes += get_string_size(*scalar);
+    } else if (const auto list = boost::get<std::vector<ScalarTargetValue>>(&value)) {
+      for (const auto& elem : *list) {
+        bytes += sizeof(ScalarTargetValue) + get_string_size(elem);
+      }
+    } else {
+      const auto geo = boost::get<GeoTargetValue>(&value);
+      bytes += geo ? boost::apply_visitor(GeoSizeVisitor(), *geo) : 0;
+    }
+  }
+  return bytes;
+}
+
+size_t QueryCursorCache::estimateSize(const ResultSet& result_set,
+                                      const size_t entry_count) {
+  const auto buffer_bytes =
+      result_set.getStorage()
+          ? result_set.getQueryMemDesc().getBufferSizeBytes(ExecutorDeviceType::CPU)
+          : 0;
+  return buffer_bytes +
+         result_set.getPermutationBuffer().size() * sizeof(ResultSet::PermutationIdx) +
+         entry_count * sizeof(size_t);
+}
+
+void QueryCursorCache::eraseEntry(EntryList::iterator it) {
+  // a fetch in progress keeps its cursor alive through its own reference
+  bytes_ -= it->bytes;
+  entries_.erase(it->cursor_id);
+  lru_.erase(it);
+}
+
+void QueryCursorCache::evictExpired(const Clock::time_point now) {
+  // the least recently read cursors are at the back
+  while (!lru_.empty() && now - lru_.back().last_access > ttl_) {
+    eraseEntry(std::prev(lru_.end()));
+  }
+}
+
+void QueryCursorCache::sweep() {
+  const auto period = std::max(ttl_ / 2, std::chrono::milliseconds(1));
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!sweeper_cv_.wait_for(lock, period, [this] { return stop_sweeper_; })) {
+    evictExpired(Clock::now());
+  }
+}
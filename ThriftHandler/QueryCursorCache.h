@@ -0,0 +1,171 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file QueryCursorCache.h
+ * @brief Results of queries kept on the server for clients to fetch page by page
+ *
+ * A cursor keeps the result set of a query, sorted if the query sorts, so pages
+ * are read from it instead of running the query again with a different OFFSET.
+ * The result set holds the chunks its lazily fetched columns point into, fetches
+ * take the table locks again and check the epochs of the tables before reading
+ * it. Queries on views copy their rows out instead. Cursors belong to the session
+ * which opened them, expire once they haven't been read for the TTL and the least
+ * recently read ones are closed when the open cursors would take more than the
+ * memory budget.
+ */
+
+#ifndef QUERYCURSORCACHE_H
+#define QUERYCURSORCACHE_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "QueryEngine/TargetMetaInfo.h"
+#include "QueryEngine/TargetValue.h"
+#include "QueryResultCache.h"
+
+class ResultSet;
+
+extern size_t g_cursor_memory_budget;
+extern size_t g_cursor_ttl_seconds;
+
+class QueryCursorCache {
+ public:
+  using Row = std::vector<TargetValue>;
+
+  struct Cursor {
+    // Rows read from the result set on every fetch, at the given entry indices.
+    Cursor(const std::shared_ptr<ResultSet>& result_set,
+           std::vector<size_t>&& entries,
+           const std::vector<TargetMetaInfo>& targets,
+           const std::map<std::string, bool>& table_names,
+           std::vector<TableEpochInfo>&& table_epochs)
+        : result_set(result_set)
+        , entries(std::move(entries))
+        , targets(targets)
+        , table_names(table_names)
+        , table_epochs(std::move(table_epochs)) {}
+
+    // Rows copied out of the result set, with strings translated and decimals
+    // converted to doubles.
+    Cursor(std::vector<Row>&& rows, const std::vector<TargetMetaInfo>& targets)
+        : rows(std::move(rows)), targets(targets) {}
+
+    size_t rowCount() const { return result_set ? entries.size() : rows.size(); }
+
+    const std::shared_ptr<ResultSet> result_set;
+    const std::vector<size_t> entries;
+    const std::vector<Row> rows;
+    const std::vector<TargetMetaInfo> targets;
+    // the tables to lock and the epochs they must still be at for a fetch to read
+    // the result set
+    const std::map<std::string, bool> table_names;
+    const std::vector<TableEpochInfo> table_epochs;
+    // fetches of the same cursor read its result set one at a time
+    std::mutex fetch_mutex;
+  };
+
+  // The rows of a cursor from an offset on, iterated the way convert_rows
+  // iterates a result set. Fetches index the rows directly, whatever the offset.
+  class Page {
+   public:
+    Page(const Cursor& cursor, const size_t offset, const size_t row_count)
+        : cursor_(cursor)
+        , crt_row_(std::min(offset, cursor.rowCount()))
+        , end_row_(crt_row_ + std::min(row_count, cursor.rowCount() - crt_row_)) {}
+
+    size_t colCount() const { return cursor_.targets.size(); }
+
+    // Empty past the last row of the page. Copied rows can only be read the way
+    // they were converted, with both flags set.
+    Row getNextRow(const bool translate_strings, const bool decimal_to_double) const;
+
+   private:
+    const Cursor& cursor_;
+    mutable size_t crt_row_;
+    const size_t end_row_;
+  };
+
+  // Closes the expired cursors every half TTL, even if nothing reads the cache.
+  QueryCursorCache(const size_t max_bytes, const std::chrono::milliseconds ttl);
+  ~QueryCursorCache();
+
+  // Returns the id of the new cursor. Throws std::runtime_error if the cursor
+  // doesn't fit in the budget, even with all the other cursors closed.
+  int64_t put(const std::string& session,
+              const std::shared_ptr<Cursor>& cursor,
+              const size_t bytes);
+
+  // nullptr if the cursor is closed, expired or opened by another session.
+  std::shared_ptr<Cursor> get(const std::string& session, const int64_t cursor_id);
+
+  bool erase(const std::string& session, const int64_t cursor_id);
+  void eraseSession(const std::string& session);
+  // Closes the cursors which keep the result sets of their queries, the ones
+  // with copied rows stay open.
+  void eraseTableCursors();
+
+  size_t size() const;
+  size_t bytes() const;
+
+  // host memory taken by the values of a copied row
+  static size_t estimateSize(const Row& row);
+
+  // host memory taken by the result set of a cursor and its entry indices,
+  // the chunks it holds stay in the buffer pool
+  static size_t estimateSize(const ResultSet& result_set, const size_t entry_count);
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry {
+    int64_t cursor_id;
+    std::string session;
+    std::shared_ptr<Cursor> cursor;
+    size_t bytes;
+    Clock::time_point last_access;
+  };
+  using EntryList = std::list<Entry>;
+
+  void eraseEntry(EntryList::iterator it);
+  void evictExpired(const Clock::time_point now);
+  void sweep();
+
+  const size_t max_bytes_;
+  const std::chrono::milliseconds ttl_;
+  // most recently read first
+  EntryList lru_;
+  std::unordered_map<int64_t, EntryList::iterator> entries_;
+  size_t bytes_{0};
+  int64_t next_cursor_id_{1};
+  mutable std::mutex mutex_;
+  bool stop_sweeper_{false};
+  std::condition_variable sweeper_cv_;
+  std::thread sweeper_;
+};
+
+#endif  // QUERYCURSORCACHE_H
@@ -0,0 +1,189 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryResultCache.h"
+
+size_t g_result_cache_size{0};
+
+namespace {
+
+size_t estimate_column_size(const TColumn& col) {
+  size_t bytes = sizeof(TColumn) + col.nulls.size() * sizeof(bool);
+  bytes += col.data.int_col.size() * sizeof(int64_t);
+  bytes += col.data.real_col.size() * sizeof(double);
+  for (const auto& str : col.data.str_col) {
+    bytes += sizeof(std::string) + str.size();
+  }
+  for (const auto& arr : col.data.arr_col) {
+    bytes += estimate_column_size(arr);
+  }
+  return bytes;
+}
+
+size_t estimate_datum_size(const TDatum& datum) {
+  size_t bytes = sizeof(TDatum) + datum.val.str_val.size();
+  for (const auto& elem : datum.val.arr_val) {
+    bytes += estimate_datum_size(elem);
+  }
+  return bytes;
+}
+
+}  // namespace
+
+std::string QueryResultCache::makeKey(const std::string& query_ra,
+                                      const std::vector<TableEpochInfo>& table_epochs,
+                                      const bool column_format,
+                                      const int32_t first_n,
+                                      const int32_t at_most_n) {
+  std::string key;
+  for (const auto& table_epoch : table_epochs) {
+    key += std::to_string(table_epoch.db_id) + ":" +
+           std::to_string(table_epoch.table_id) + "@" +
+           std::to_string(table_epoch.epoch) + ",";
+  }
+  key += column_format ? "C" : "R";
+  key += std::to_string(first_n) + "," + std::to_string(at_most_n) + "|";
+  return key + query_ra;
+}
+
+uint64_t QueryResultCache::getGeneration() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return generation_;
+}
+
+bool QueryResultCache::get(const std::string& key, TQueryResult& result) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    ++misses_;
+    return false;
+  }
+  ++hits_;
+  lru_.splice(lru_.begin(), lru_, it->second);
+  result.row_set = it->second->result.row_set;
+  return true;
+}
+
+void QueryResultCache::put(const std::string& key,
+                           const std::vector<TableEpochInfo>& table_epochs,
+                           const TQueryResult& result,
+                           const uint64_t generation) {
+  const size_t bytes = key.size() + estimateSize(result);
+  if (bytes > max_bytes_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (generation != generation_) {
+    // an input might have changed while the query was running
+    return;
+  }
+  const auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    // a concurrent execution of the same query got here first
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return;
+  }
+  evict(bytes);
+  lru_.push_front(Entry{key, table_epochs, result, bytes});
+  entries_.emplace(key, lru_.begin());
+  bytes_ += bytes;
+}
+
+void QueryResultCache::invalidateTable(const int32_t db_id, const int32_t table_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++generation_;
+  eraseIf([db_id, table_id](const Entry& entry) {
+    for (const auto& table_epoch : entry.table_epochs) {
+      if (table_epoch.db_id == db_id && table_epoch.table_id == table_id) {
+        return true;
+      }
+    }
+    return false;
+  });
+}
+
+void QueryResultCache::invalidateDatabase(const int32_t db_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++generation_;
+  eraseIf([db_id](const Entry& entry) {
+    for (const auto& table_epoch : entry.table_epochs) {
+      if (table_epoch.db_id == db_id) {
+        return true;
+      }
+    }
+    return false;
+  });
+}
+
+void QueryResultCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++generation_;
+  lru_.clear();
+  entries_.clear();
+  bytes_ = 0;
+}
+
+QueryResultCache::Stats QueryResultCache::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Stats stats;
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.evictions = evictions_;
+  stats.entries = entries_.size();
+  stats.bytes = bytes_;
+  return stats;
+}
+
+size_t QueryResultCache::estimateSize(const TQueryResult& result) {
+  const auto& row_set = result.row_set;
+  size_t bytes = sizeof(TQueryResult);
+  for (const auto& col_type : row_set.row_desc) {
+    bytes += sizeof(TColumnType) + col_type.col_name.size();
+  }
+  for (const auto& col : row_set.columns) {
+    bytes += estimate_column_size(col);
+  }
+  for (const auto& row : row_set.rows) {
+    bytes += sizeof(TRow);
+    for (const auto& datum : row.cols) {
+      bytes += estimate_datum_size(datum);
+    }
+  }
+  return bytes;
+}
+
+template <typename PRED>
+void QueryResultCache::eraseIf(PRED pred) {
+  for (auto it = lru_.begin(); it != lru_.end();) {
+    if (pred(*it)) {
+      bytes_ -= it->bytes;
+      entries_.erase(it->key);
+      it = lru_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void QueryResultCache::evict(const size_t bytes_needed) {
+  while (!lru_.empty() && bytes_ + bytes_needed > max_bytes_) {
+    const auto& victim = lru_.back();
+    bytes_ -= victim.bytes;
+    entries_.erase(victim.key);
+    lru_.pop_back();
+    ++evictions_;
+  }
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2017 MapD Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file QueryResultCache.h
+ * @brief LRU cache of serialized query results
+ *
+ * Results are keyed by the optimized relational algebra of the query along with
+ * the epoch of every physical table it reads, so a checkpoint of any input makes
+ * the old entries unreachable. Writes the server sees also drop the entries of
+ * the tables they touch right away, which covers epochs being set back.
+ */
+
+#ifndef QUERYRESULTCACHE_H
+#define QUERYRESULTCACHE_H
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gen-cpp/MapD.h"
+
+extern size_t g_result_cache_size;
+
+struct TableEpochInfo {
+  int32_t db_id;
+  int32_t table_id;
+  int32_t epoch;
+};
+
+class QueryResultCache {
+ public:
+  struct Stats {
+    int64_t hits{0};
+    int64_t misses{0};
+    int64_t evictions{0};
+    int64_t entries{0};
+    int64_t bytes{0};
+  };
+
+  QueryResultCache(const size_t max_bytes) : max_bytes_(max_bytes) {}
+
+  static std::string makeKey(const std::string& query_ra,
+                             const std::vector<TableEpochInfo>& table_epochs,
+                             const bool column_format,
+                             const int32_t first_n,
+                             const int32_t at_most_n);
+
+  // bumped by every invalidation, a result is only cached if no invalidation
+  // happened between taking the generation and putting it
+  uint64_t getGeneration() const;
+
+  // only fills the row set of result, the timings are those of the lookup
+  bool get(const std::string& key, TQueryResult& result);
+  void put(const std::string& key,
+           const std::vector<TableEpochInfo>& table_epochs,
+           const TQueryResult& result,
+           const uint64_t generation);
+
+  void invalidateTable(const int32_t db_id, const int32_t table_id);
+  void invalidateDatabase(const int32_t db_id);
+  void clear();
+
+  Stats getStats() const;
+
+  static size_t estimateSize(const TQueryResult& result);
+
+ private:
+  struct Entry {
+    std::string key;
+    std::vector<TableEpochInfo> table_epochs;
+    TQueryResult result;
+    size_t bytes;
+  };
+  using EntryList = std::list<Entry>;
+
+  template <typename PRED>
+  void eraseIf(PRED pred);
+  void evict(const size_t bytes_needed);
+
+  const size_t max_bytes_;
+  // most recently used first
+  EntryList lru_;
+  std::unordered_map<std::string, EntryList::iterator> entries_;
+  size_t bytes_{0};
+  uint64_t generation_{0};
+  int64_t hits_{0};
+  int64_t misses_{0};
+  int64_t evictions_{0};
+  mutable std::mutex mutex_;
+};
+
+#endif  // QUERYRESULTCACHE_H
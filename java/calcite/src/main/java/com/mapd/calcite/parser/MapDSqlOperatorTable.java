@@ -174,6 +174,8 @@ public class MapDSqlOperatorTable extends ChainedSqlOperatorTable {
     opTab.addOperator(new ApproxCountDistinct());
     opTab.addOperator(new Sample());
     opTab.addOperator(new LastSample());
+    opTab.addOperator(new ApproxPercentile());
+    opTab.addOperator(new ApproxMedian());
     opTab.addOperator(new MapD_GeoPolyBoundsPtr());
     opTab.addOperator(new MapD_GeoPolyRenderGroup());
     if (extSigs == null) {
@@ -1181,6 +1183,45 @@ public class MapDSqlOperatorTable extends ChainedSqlOperatorTable {
   
   }
 
+  public static class ApproxPercentile extends SqlAggFunction {
+
+    public ApproxPercentile() {
+      super("APPROX_PERCENTILE",
+              SqlKind.OTHER_FUNCTION,
+              null,
+              null,
+              OperandTypes.family(SqlTypeFamily.NUMERIC, SqlTypeFamily.NUMERIC),
+              SqlFunctionCategory.SYSTEM);
+    }
+
+    @Override
+    public RelDataType inferReturnType(SqlOperatorBinding opBinding) {
+      final RelDataTypeFactory typeFactory = opBinding.getTypeFactory();
+      return typeFactory.createTypeWithNullability(
+              typeFactory.createSqlType(SqlTypeName.DOUBLE), true);
+    }
+  }
+
+  // APPROX_PERCENTILE(x, 0.5)
+  public static class ApproxMedian extends SqlAggFunction {
+
+    public ApproxMedian() {
+      super("APPROX_MEDIAN",
+              SqlKind.OTHER_FUNCTION,
+              null,
+              null,
+              OperandTypes.NUMERIC,
+              SqlFunctionCategory.SYSTEM);
+    }
+
+    @Override
+    public RelDataType inferReturnType(SqlOperatorBinding opBinding) {
+      final RelDataTypeFactory typeFactory = opBinding.getTypeFactory();
+      return typeFactory.createTypeWithNullability(
+              typeFactory.createSqlType(SqlTypeName.DOUBLE), true);
+    }
+  }
+
   static class ExtFunction extends SqlFunction {
 
     ExtFunction(final String name, final ExtensionFunction sig) {
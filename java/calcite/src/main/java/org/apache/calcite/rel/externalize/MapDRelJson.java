@@ -36,10 +36,14 @@ import org.apache.calcite.rex.RexBuilder;
 import org.apache.calcite.rex.RexCall;
 import org.apache.calcite.rex.RexCorrelVariable;
 import org.apache.calcite.rex.RexFieldAccess;
+import org.apache.calcite.rex.RexFieldCollation;
 import org.apache.calcite.rex.RexInputRef;
 import org.apache.calcite.rex.RexLiteral;
 import org.apache.calcite.rex.RexNode;
+import org.apache.calcite.rex.RexOver;
 import org.apache.calcite.rex.RexSubQuery;
+import org.apache.calcite.rex.RexWindow;
+import org.apache.calcite.rex.RexWindowBound;
 import org.apache.calcite.sql.SemiJoinType;
 import org.apache.calcite.sql.SqlAggFunction;
 import org.apache.calcite.sql.SqlFunction;
@@ -362,6 +366,24 @@ public class MapDRelJson {
           ((RexSubQuery) node).rel.explain(subqueryWriter);
           map.put("subquery", subqueryWriter.asJsonMap());
         }
+        if (node instanceof RexOver) {
+          final RexOver over = (RexOver) node;
+          final RexWindow window = over.getWindow();
+          final List<Object> partitionKeys = jsonBuilder.list();
+          for (RexNode partitionKey : window.partitionKeys) {
+            partitionKeys.add(toJson(partitionKey));
+          }
+          map.put("partition_keys", partitionKeys);
+          final List<Object> orderKeys = jsonBuilder.list();
+          for (RexFieldCollation orderKey : window.orderKeys) {
+            orderKeys.add(toJson(orderKey));
+          }
+          map.put("order_keys", orderKeys);
+          map.put("lower_bound", toJson(window.getLowerBound()));
+          map.put("upper_bound", toJson(window.getUpperBound()));
+          map.put("is_rows", window.isRows());
+          map.put("distinct", over.isDistinct());
+        }
         if (call.getOperator() instanceof SqlFunction) {
           switch (((SqlFunction) call.getOperator()).getFunctionType()) {
           case USER_DEFINED_CONSTRUCTOR:
@@ -377,6 +399,30 @@ public class MapDRelJson {
     }
   }
 
+  private Object toJson(RexFieldCollation collation) {
+    final Map<String, Object> map = jsonBuilder.map();
+    map.put("field", toJson(collation.left));
+    final RelFieldCollation.Direction direction = collation.getDirection();
+    RelFieldCollation.NullDirection nullDirection = collation.getNullDirection();
+    if (nullDirection == RelFieldCollation.NullDirection.UNSPECIFIED) {
+      nullDirection = direction.defaultNullDirection();
+    }
+    map.put("direction", direction.name());
+    map.put("nulls", nullDirection.name());
+    return map;
+  }
+
+  private Object toJson(RexWindowBound bound) {
+    final Map<String, Object> map = jsonBuilder.map();
+    map.put("unbounded", bound.isUnbounded());
+    map.put("preceding", bound.isPreceding());
+    map.put("following", bound.isFollowing());
+    map.put("is_current_row", bound.isCurrentRow());
+    map.put("offset", bound.getOffset() == null ? null : toJson(bound.getOffset()));
+    map.put("order_key", bound.getOrderKey());
+    return map;
+  }
+
   RexNode toRex(RelInput relInput, Object o) {
     final RelOptCluster cluster = relInput.getCluster();
     final RexBuilder rexBuilder = cluster.getRexBuilder();
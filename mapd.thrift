@@ -148,6 +148,15 @@ struct TQueryResult {
   4: string nonce
 }
 
+struct TCursor {
+  1: i64 cursor_id
+  2: TRowDescriptor row_desc
+  3: i64 row_count
+  4: i64 execution_time_ms
+  5: i64 total_time_ms
+  6: string nonce
+}
+
 struct TDataFrame {
   1: binary sm_handle
   2: i64 sm_size
@@ -230,6 +239,10 @@ struct TServerStatus {
   5: string edition
   6: string host_name
   7: bool poly_rendering_enabled
+  8: i64 result_cache_hits
+  9: i64 result_cache_misses
+  10: i64 result_cache_entries
+  11: i64 result_cache_bytes
 }
 
 struct TPixel {
@@ -501,6 +514,9 @@ service MapD {
   TQueryResult sql_execute(1: TSessionId session, 2: string query 3: bool column_format, 4: string nonce, 5: i32 first_n = -1, 6: i32 at_most_n = -1) throws (1: TMapDException e)
   TDataFrame sql_execute_df(1: TSessionId session, 2: string query 3: TDeviceType device_type 4: i32 device_id = 0 5: i32 first_n = -1) throws (1: TMapDException e)
   TDataFrame sql_execute_gdf(1: TSessionId session, 2: string query 3: i32 device_id = 0, 4: i32 first_n = -1) throws (1: TMapDException e)
+  TCursor sql_execute_cursor(1: TSessionId session, 2: string query, 3: string nonce) throws (1: TMapDException e)
+  TQueryResult fetch_cursor(1: TSessionId session, 2: i64 cursor_id, 3: i64 offset, 4: i32 row_count, 5: bool column_format) throws (1: TMapDException e)
+  void close_cursor(1: TSessionId session, 2: i64 cursor_id) throws (1: TMapDException e)
   void deallocate_df(1: TSessionId session, 2: TDataFrame df, 3: TDeviceType device_type, 4: i32 device_id = 0) throws (1: TMapDException e)
   void interrupt(1: TSessionId session) throws (1: TMapDException e)
   TTableDescriptor sql_validate(1: TSessionId session, 2: string query) throws (1: TMapDException e)